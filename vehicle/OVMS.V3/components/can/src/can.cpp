@@ -389,6 +389,8 @@ void can_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
     writer->printf("Wdg Timer: %20" PRId32 " sec(s)\n",monotonictime-sbus->m_watchdog_timer);
     }
   writer->printf("Err Resets:%20d\n",sbus->m_status.error_resets);
+
+  MyCan.ShowListeners(writer, sbus);
   }
 
 void can_explain_flags(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
@@ -503,187 +505,6 @@ void can_set_register(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
   sbus->WriteReg(addr,value);
   }
 
-////////////////////////////////////////////////////////////////////////
-// CAN Filtering (software based filter)
-// The canfilter object encapsulates the filtering of CAN frames
-////////////////////////////////////////////////////////////////////////
-
-canfilter::canfilter()
-  {
-  }
-
-canfilter::~canfilter()
-  {
-  ClearFilters();
-  }
-
-void canfilter::ClearFilters()
-  {
-  for (CAN_filter_t* filter : m_filters)
-    {
-    delete filter;
-    }
-  m_filters.clear();
-  }
-
-/** Add a filter to the list (what is allowed).
- * @param bus The CAN bus 1-3  or 0 to match any.
- * @param id_from The id to match from
- * @param id_to The id to match to
- */
-
-bool canfilter::AddFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
-  {
-  if (bus > CAN_MAXBUSES)
-    return false;
-  if (id_from > id_to)
-    return false;
-  // Backwards compatible. Used to be '1' (49) for bus 1 etc
-  if (bus >= (uint8_t)'0')
-    bus -= '0';
-  if (bus > CAN_MAXBUSES)
-    return false;
-
-  CAN_filter_t* f = new CAN_filter_t;
-  f->bus = bus;
-  f->id_from = id_from;
-  f->id_to = id_to;
-  m_filters.push_back(f);
-  return true;
-  }
-/** Add a filter string.
- * The format is: <bus>[:<from>[-[<to>]]]
- * Where <bus> is 0 to match any or 1 to CAN_MAXBUSES,
- * and 'from' and 'to' are in hex.
- * <bus>          Matches anything on that bus.
- * <bus>:<value>  Matches 1 address on the specified bus.
- * <bus>:<from>-  Matches adressses >= the specified value on that bus
- * <bus>:<from>-<to>  Matches addresses  'from' <= adress <= 'to' on that bus
- * <value>        Matches 1 address on any bus.
- * <from>-        Matches adressses >= the specified value on any bus
- * <from>-<to>    Matches addresses  'from' <= adress <= 'to' on any bus
- */
-bool canfilter::AddFilter(const char* filterstring)
-  {
-  if (!*filterstring)
-    return false;
-  uint32_t bus, id_from, id_to;
-  char sep; // Consume '-' - but don't care exactly what it is.
-  int level;
-
-  switch (filterstring[1])
-    {
-    // first character is a bus
-    case '\0':
-    case ':':
-      level = sscanf(filterstring, "%" SCNu32 ":%" SCNx32 "%c%" SCNx32, &bus, &id_from, &sep, &id_to);
-      break;
-    // No bus
-    default:
-      {
-      level = sscanf(filterstring, "%" SCNx32 "%c%" SCNx32,  &id_from, &sep, &id_to);
-      if (level == 0)
-        return false;
-      bus = 0;
-      ++level;
-      break;
-      }
-    }
-
-  switch (level)
-    {
-    case 1: // eg: 1
-      id_from = 0;
-      id_to = UINT32_MAX;
-      break;
-    case 2: // eg: 1:200 or 200
-      id_to = id_from;
-      break;
-    case 3: // eg: 1:200- or 200-
-      id_to = UINT32_MAX;
-      break;
-    case 4: // eg: 1:200-7E0 or 200-7E0
-      break;
-    default:
-      return false;
-    }
-  return AddFilter(bus, id_from, id_to);
-  }
-
-bool canfilter::RemoveFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
-  {
-  if (bus >= (uint8_t)'0')
-    bus -= '0';
-  for (CAN_filter_list_t::iterator it = m_filters.begin(); it != m_filters.end(); ++it)
-    {
-    CAN_filter_t* filter = *it;
-    if ((filter->bus == bus) &&
-        (filter->id_from == id_from) &&
-        (filter->id_to == id_to))
-      {
-      delete filter;
-      m_filters.erase(it);
-      return true;
-      }
-    }
-  return false;
-  }
-
-bool canfilter::IsFiltered(const CAN_frame_t* p_frame)
-  {
-  if (m_filters.size() == 0) return true;
-  if (! p_frame) return false;
-
-  uint8_t buskey = 0;
-  if (p_frame->origin)
-    buskey = (p_frame->origin->m_busnumber + 1);
-
-  for (CAN_filter_t* filter : m_filters)
-    {
-    if ((filter->bus)&&(filter->bus != buskey)) continue;
-    if ((p_frame->MsgID >= filter->id_from) && (p_frame->MsgID <= filter->id_to))
-      return true;
-    }
-
-  return false;
-  }
-
-bool canfilter::IsFiltered(canbus* bus)
-  {
-  if (m_filters.size() == 0) return true;
-  if (bus == NULL) return true;
-
-  uint8_t buskey = bus->m_busnumber+1;
-
-  for (CAN_filter_t* filter : m_filters)
-    {
-    if ((filter->bus)&&(filter->bus == buskey)) return true;
-    }
-
-  return false;
-  }
-
-std::string canfilter::Info()
-  {
-  std::ostringstream buf;
-
-  for (CAN_filter_t* filter : m_filters)
-    {
-    if (filter->bus > 0) buf << std::setfill(' ') << std::dec << char('0'+ filter->bus) << ':';
-    buf << std::setfill('0') << std::setw(3) << std::hex;
-    if (filter->id_from == filter->id_to)
-      buf << filter->id_from << ' ';
-    else if (filter->id_to < UINT32_MAX)
-      buf << filter->id_from << '-' << filter->id_to << ' ';
-    else if (filter->id_to > 0)
-      buf << filter->id_from << "- ";
-    else
-      buf << ' ';
-    }
-
-  return buf.str();
-  }
-
 ////////////////////////////////////////////////////////////////////////
 // CAN logging and tracing
 // These structures are involved in formatting, logging and tracing of
@@ -907,6 +728,7 @@ uint32_t can::AddPlayer(canplay* player, int filterc, const char* const* filterv
   OvmsMutexLock lock(&m_playermap_mutex);
   uint32_t id = m_player_id++;
   m_playermap[id] = player;
+  player->Start();
 
   return id;
   }
@@ -936,8 +758,8 @@ bool can::RemovePlayer(uint32_t id)
   auto k = m_playermap.find(id);
   if (k != m_playermap.end())
     {
+    k->second->Stop();
     k->second->Close();
-    vTaskDelay(pdMS_TO_TICKS(100)); // give logger task time to finish
     delete k->second;
     m_playermap.erase(k);
     return true;
@@ -951,8 +773,8 @@ void can::RemovePlayers()
 
   for (canplay_map_t::iterator it=m_playermap.begin(); it!=m_playermap.end();)
     {
+    it->second->Stop();
     it->second->Close();
-    vTaskDelay(pdMS_TO_TICKS(100)); // give logger task time to finish
     delete it->second;
     it = m_playermap.erase(it);
     }
@@ -1151,8 +973,26 @@ canbus* can::GetBus(int busnumber)
   return found;
   }
 
+void CAN_timestamp_to_timeval(uint32_t timestamp_us, struct timeval* tv)
+  {
+  uint32_t now = CAN_timestamp();
+  gettimeofday(tv, NULL);
+  if (timestamp_us == 0)
+    return;
+  uint32_t age = now - timestamp_us;  // modulo 2^32, valid for ages < 71 minutes
+  tv->tv_sec -= age / 1000000;
+  tv->tv_usec -= age % 1000000;
+  if (tv->tv_usec < 0)
+    {
+    tv->tv_sec--;
+    tv->tv_usec += 1000000;
+    }
+  }
+
 void can::IncomingFrame(CAN_frame_t* p_frame)
   {
+  if (p_frame->timestamp_us == 0)
+    p_frame->timestamp_us = CAN_timestamp();
   p_frame->origin->m_status.packets_rx++;
   p_frame->origin->m_watchdog_timer = monotonictime;
 
@@ -1175,27 +1015,85 @@ void can::IncomingFrame(CAN_frame_t* p_frame)
  * aware the system will silently drop queue overflows. The vehicle poller
  * takes care of registering a queue and provides an additional filter API.
  * 
+ * If you only need specific frames, pass a canidset with the buses & IDs
+ * you want to receive. Frames not contained in the set will not be copied
+ * to your queue, saving CPU time on busy buses. The listener takes ownership
+ * of the set; it must not be changed after registration. To change the set,
+ * register the queue again with a new one.
+ * 
+ * The name is optional and used to show delivery statistics in "can status".
+ * 
  * If you need to process incoming frames or TX results as fast as possible,
  * register a synchronous CAN callback -- see below.
  */
-void can::RegisterListener(QueueHandle_t queue, bool txfeedback /*=false*/)
+void can::RegisterListener(QueueHandle_t queue, bool txfeedback /*=false*/,
+                           canidset* filter /*=NULL*/, const char* name /*=NULL*/)
   {
-  m_listeners[queue] = txfeedback;
+  if (filter && filter->IsEmpty())
+    {
+    delete filter;
+    filter = NULL;
+    }
+  CanListenerEntry* entry = new CanListenerEntry(name, txfeedback, filter);
+  OvmsRecMutexLock lock(&m_listeners_mutex);
+  auto it = m_listeners.find(queue);
+  if (it != m_listeners.end())
+    {
+    CanListenerEntry* old = it->second;
+    it->second = entry;
+    delete old;
+    }
+  else
+    {
+    m_listeners[queue] = entry;
+    }
   }
 
 void can::DeregisterListener(QueueHandle_t queue)
   {
+  OvmsRecMutexLock lock(&m_listeners_mutex);
   auto it = m_listeners.find(queue);
   if (it != m_listeners.end())
+    {
+    CanListenerEntry* entry = it->second;
     m_listeners.erase(it);
+    delete entry;
+    }
   }
 
 void can::NotifyListeners(const CAN_frame_t* frame, bool tx)
   {
+  int slot = (frame->origin) ? frame->origin->m_busnumber+1 : 0;
+  OvmsRecMutexLock lock(&m_listeners_mutex);
+  for (CanListenerMap_t::iterator it = m_listeners.begin(); it != m_listeners.end(); ++it)
+    {
+    CanListenerEntry* entry = it->second;
+    if (tx && !entry->m_txfeedback)
+      continue;
+    if (entry->m_filter && !entry->m_filter->Contains(frame))
+      continue;
+    if (xQueueSend(it->first,frame,0) == pdTRUE)
+      entry->m_delivered[slot]++;
+    else
+      entry->m_dropped[slot]++;
+    }
+  }
+
+void can::ShowListeners(OvmsWriter* writer, canbus* bus)
+  {
+  int slot = (bus) ? bus->m_busnumber+1 : 0;
+  writer->printf("\nListener            Filter   Delivered     Dropped\n");
+  OvmsRecMutexLock lock(&m_listeners_mutex);
   for (CanListenerMap_t::iterator it = m_listeners.begin(); it != m_listeners.end(); ++it)
     {
-    if (!tx || (tx && it->second))
-      xQueueSend(it->first,frame,0);
+    CanListenerEntry* entry = it->second;
+    char qname[20];
+    if (!entry->m_name)
+      snprintf(qname, sizeof(qname), "%p", it->first);
+    writer->printf("%-20.20s%-6s%12" PRIu32 "%12" PRIu32 "\n",
+      (entry->m_name) ? entry->m_name : qname,
+      (entry->m_filter) ? "ids" : "all",
+      entry->m_delivered[slot], entry->m_dropped[slot]);
     }
   }
 
@@ -1217,13 +1115,26 @@ void can::NotifyListeners(const CAN_frame_t* frame, bool tx)
  * file operations or complex calculations (floating point math), avoid
  * ESP_LOG* logging (as that may block). You may raise events from a callback,
  * and you may write to queues/semaphores non-blocking.
+ * 
+ * As with listeners, you can pass a canidset to restrict the callback to the
+ * buses & IDs you need. The callback entry takes ownership of the set.
+ * 
+ * The callback list is locked while the callbacks are executed, so a callback
+ * must not register or deregister callbacks itself.
  */
-void can::RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback /*=false*/)
+void can::RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback /*=false*/,
+                           canidset* filter /*=NULL*/)
   {
+  if (filter && filter->IsEmpty())
+    {
+    delete filter;
+    filter = NULL;
+    }
+  OvmsRecMutexLock lock(&m_callbacks_mutex);
   if (txfeedback)
-    m_txcallbacks.push_back(new CanFrameCallbackEntry(caller, callback));
+    m_txcallbacks.push_back(new CanFrameCallbackEntry(caller, callback, filter));
   else
-    m_rxcallbacks.push_back(new CanFrameCallbackEntry(caller, callback));
+    m_rxcallbacks.push_back(new CanFrameCallbackEntry(caller, callback, filter));
   }
 
 /**
@@ -1237,18 +1148,33 @@ void can::RegisterCallback(const char* caller, CanFrameCallback callback, bool t
  * call OvmsVehicle::RegisterCanBus(), so if you need to add a critical callback
  * later on, use this API method to prioritize your callback.
  */
-void can::RegisterCallbackFront(const char* caller, CanFrameCallback callback, bool txfeedback /*=false*/)
+void can::RegisterCallbackFront(const char* caller, CanFrameCallback callback, bool txfeedback /*=false*/,
+                                canidset* filter /*=NULL*/)
   {
+  if (filter && filter->IsEmpty())
+    {
+    delete filter;
+    filter = NULL;
+    }
+  OvmsRecMutexLock lock(&m_callbacks_mutex);
   if (txfeedback)
-    m_txcallbacks.push_front(new CanFrameCallbackEntry(caller, callback));
+    m_txcallbacks.push_front(new CanFrameCallbackEntry(caller, callback, filter));
   else
-    m_rxcallbacks.push_front(new CanFrameCallbackEntry(caller, callback));
+    m_rxcallbacks.push_front(new CanFrameCallbackEntry(caller, callback, filter));
   }
 
 void can::DeregisterCallback(const char* caller)
   {
-  m_rxcallbacks.remove_if([caller](CanFrameCallbackEntry* entry){ return strcmp(entry->m_caller, caller)==0; });
-  m_txcallbacks.remove_if([caller](CanFrameCallbackEntry* entry){ return strcmp(entry->m_caller, caller)==0; });
+  auto match = [caller](CanFrameCallbackEntry* entry)
+    {
+    if (strcmp(entry->m_caller, caller) != 0)
+      return false;
+    delete entry;
+    return true;
+    };
+  OvmsRecMutexLock lock(&m_callbacks_mutex);
+  m_rxcallbacks.remove_if(match);
+  m_txcallbacks.remove_if(match);
   }
 
 int can::ExecuteCallbacks(const CAN_frame_t* frame, bool tx, bool success)
@@ -1262,17 +1188,23 @@ int can::ExecuteCallbacks(const CAN_frame_t* frame, bool tx, bool success)
       (*(frame->callback))(frame, success);
       cnt++;
       }
+    OvmsRecMutexLock lock(&m_callbacks_mutex);
     for (auto entry : m_txcallbacks)
       {
       // invoke generic tx callbacks
+      if (entry->m_filter && !entry->m_filter->Contains(frame))
+        continue;
       entry->m_callback(frame, success);
       cnt++;
       }
     }
   else
     {
+    OvmsRecMutexLock lock(&m_callbacks_mutex);
     for (auto entry : m_rxcallbacks)
       {
+      if (entry->m_filter && !entry->m_filter->Contains(frame))
+        continue;
       entry->m_callback(frame, success);
       cnt++;
       }
@@ -1442,6 +1374,8 @@ bool canbus::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesRe
 
 void canbus::TxCallback(CAN_frame_t* p_frame, bool success)
   {
+  if (p_frame->timestamp_us == 0)
+    p_frame->timestamp_us = CAN_timestamp();
   if (success)
     {
     m_status.packets_tx++;
@@ -1473,6 +1407,7 @@ esp_err_t canbus::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0
   {
   m_tx_frame = *p_frame; // save a local copy of this frame to be used later in txcallback
   m_tx_frame.origin = this;
+  m_tx_frame.timestamp_us = 0; // set by the driver or TxCallback on completion
   return ESP_OK;
   }
 
@@ -40,10 +40,13 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include <stdint.h>
+#include <string.h>
 #include <functional>
 #include <list>
 #include "pcp.h"
 #include <esp_err.h>
+#include <esp_timer.h>
+#include <sys/time.h>
 #include "ovms_events.h"
 
 ////////////////////////////////////////////////////////////////////////
@@ -136,31 +139,21 @@ struct CAN_frame_t
     uint32_t  u32[2];                   // Payload u32 access (Att: little endian!)
     uint64_t  u64;                      // Payload u64 access (Att: little endian!)
     } data;
+  uint32_t    timestamp_us;             // RX/TX time, see CAN_timestamp() (0 = unknown)
 
   esp_err_t Write(canbus* bus=NULL, TickType_t maxqueuewait=0);  // bus: NULL=origin
   };
 
-// CAN status
-typedef struct
-  {
-  uint32_t interrupts;              // interrupts
-  uint32_t packets_rx;              // frames reveiced
-  uint32_t packets_tx;              // frames sent successfully
-  uint32_t txbuf_delay;             // frames routed through TX queue
-  uint16_t rxbuf_overflow;          // frames lost due to RX buffers full
-  uint16_t txbuf_overflow;          // TX queue overflows
-  uint32_t tx_fails;                // TX failures/aborts
-  uint32_t error_flags;             // driver specific bitset
-  uint16_t errors_rx;               // RX error counter
-  uint16_t errors_tx;               // TX error counter
-  uint16_t invalid_rx;              // RX invalid frame counter
-  uint16_t watchdog_resets;         // Watchdog reset counter
-  uint16_t error_resets;            // Error resolving reset counter
-  uint32_t error_time;              // monotonictime of last error state detection
-  uint16_t isr_queue_overrun;       // ISR->task service ping dropped (queue full); not a lost
-                                     // frame -- raw data stays latched in the HW RX buffer, the
-                                     // RX-stall watchdog is the backstop that re-arms the line
-  } CAN_status_t;
+// CAN frame timestamps:
+//  Monotonic microseconds (esp_timer, wrapping after ~71 minutes), taken by
+//  the drivers at reception (in the ISR where possible) and by the framework
+//  on TX completion. Loggers convert them to wall clock time, so logs show
+//  the actual bus timing independent of the queue & processing latencies.
+//  Note: this is a macro to guarantee inlining into IRAM ISR code.
+#define CAN_timestamp()   ((uint32_t)esp_timer_get_time())
+extern void CAN_timestamp_to_timeval(uint32_t timestamp_us, struct timeval* tv);
+
+#include "canstatus.h"
 
 // CAN error states
 typedef enum
@@ -202,44 +195,7 @@ typedef struct
     } body;
   } CAN_queue_msg_t;
 
-////////////////////////////////////////////////////////////////////////
-// CAN Filtering (software based filter)
-// The canfilter object encapsulates the filtering of CAN frames
-////////////////////////////////////////////////////////////////////////
-
-typedef struct
-  {
-  uint8_t bus;
-  uint32_t id_from;
-  uint32_t id_to;
-  } CAN_filter_t;
-
-typedef std::list<CAN_filter_t*> CAN_filter_list_t;
-
-class canfilter
-  {
-  public:
-    canfilter();
-    virtual ~canfilter();
-
-  public:
-    void ClearFilters();
-    bool AddFilter(uint8_t bus=0, uint32_t id_from=0, uint32_t id_to=UINT32_MAX);
-    bool AddFilter(const char* filterstring);
-    bool RemoveFilter(uint8_t bus=0, uint32_t id_from=0, uint32_t id_to=UINT32_MAX);
-
-  public:
-    bool IsFiltered(const CAN_frame_t* p_frame);
-    bool IsFiltered(canbus* bus);
-    std::string Info();
-    bool HasFilters()
-      {
-      return !m_filters.empty();
-      }
-
-  protected:
-    CAN_filter_list_t m_filters;
-  };
+#include "canfilter.h"
 
 ////////////////////////////////////////////////////////////////////////
 // CAN logging and tracing
@@ -364,21 +320,48 @@ class canbus : public pcp, public InternalRamAllocated
 // can - the CAN system controller
 ////////////////////////////////////////////////////////////////////////
 
-typedef std::map<QueueHandle_t, bool> CanListenerMap_t;
+class CanListenerEntry
+  {
+  public:
+    CanListenerEntry(const char* name, bool txfeedback, canidset* filter)
+      {
+      m_name = name;
+      m_txfeedback = txfeedback;
+      m_filter = filter;
+      memset(m_delivered, 0, sizeof(m_delivered));
+      memset(m_dropped, 0, sizeof(m_dropped));
+      }
+    ~CanListenerEntry()
+      {
+      if (m_filter) delete m_filter;
+      }
+  public:
+    const char *m_name;
+    bool m_txfeedback;
+    canidset* m_filter;                       // NULL = all frames
+    uint32_t m_delivered[CAN_IDSET_SLOTS];    // per bus, slot 0 = no origin
+    uint32_t m_dropped[CAN_IDSET_SLOTS];      // queue full
+  };
+typedef std::map<QueueHandle_t, CanListenerEntry*> CanListenerMap_t;
 
 
 class CanFrameCallbackEntry
   {
   public:
-    CanFrameCallbackEntry(const char* caller, CanFrameCallback callback)
+    CanFrameCallbackEntry(const char* caller, CanFrameCallback callback, canidset* filter=NULL)
       {
       m_caller = caller;
       m_callback = callback;
+      m_filter = filter;
+      }
+    ~CanFrameCallbackEntry()
+      {
+      if (m_filter) delete m_filter;
       }
-    ~CanFrameCallbackEntry() {}
   public:
     const char *m_caller;
     CanFrameCallback m_callback;
+    canidset* m_filter;                       // NULL = all frames
   };
 typedef std::list<CanFrameCallbackEntry*> CanFrameCallbackList_t;
 
@@ -398,13 +381,14 @@ class can : public InternalRamAllocated
     QueueHandle_t m_rxqueue;
 
   public:
-    void RegisterListener(QueueHandle_t queue, bool txfeedback=false);
+    void RegisterListener(QueueHandle_t queue, bool txfeedback=false, canidset* filter=NULL, const char* name=NULL);
     void DeregisterListener(QueueHandle_t queue);
     void NotifyListeners(const CAN_frame_t* frame, bool tx);
+    void ShowListeners(OvmsWriter* writer, canbus* bus);
 
   public:
-    void RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback=false);
-    void RegisterCallbackFront(const char* caller, CanFrameCallback callback, bool txfeedback=false);
+    void RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback=false, canidset* filter=NULL);
+    void RegisterCallbackFront(const char* caller, CanFrameCallback callback, bool txfeedback=false, canidset* filter=NULL);
     void DeregisterCallback(const char* caller);
     int ExecuteCallbacks(const CAN_frame_t* frame, bool tx, bool success);
 
@@ -445,8 +429,10 @@ class can : public InternalRamAllocated
   private:
     canbus* m_buslist[CAN_MAXBUSES];
     CanListenerMap_t m_listeners;
+    OvmsRecMutex m_listeners_mutex;
     CanFrameCallbackList_t m_rxcallbacks;
     CanFrameCallbackList_t m_txcallbacks;
+    OvmsRecMutex m_callbacks_mutex;   // rx & tx callback lists
     TaskHandle_t m_rxtask;            // Task to handle reception
   };
 
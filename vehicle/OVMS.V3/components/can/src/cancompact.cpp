@@ -0,0 +1,719 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Compact binary CAN log codec
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "cancompact.h"
+#include <string.h>
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////
+// Encoding primitives
+////////////////////////////////////////////////////////////////////////
+
+static inline size_t PutVarint(uint8_t* p, uint64_t v)
+  {
+  size_t n = 0;
+  while (v >= 0x80)
+    {
+    p[n++] = (v & 0x7f) | 0x80;
+    v >>= 7;
+    }
+  p[n++] = v;
+  return n;
+  }
+
+// Returns bytes used, 0 = incomplete, -1 = invalid
+static inline int GetVarint(const uint8_t* p, size_t len, uint64_t* v)
+  {
+  uint64_t r = 0;
+  for (size_t n = 0; n < len && n < 10; n++)
+    {
+    r |= (uint64_t)(p[n] & 0x7f) << (7*n);
+    if ((p[n] & 0x80) == 0)
+      {
+      *v = r;
+      return n+1;
+      }
+    }
+  return (len < 10) ? 0 : -1;
+  }
+
+static inline uint64_t ZigZag(int64_t v)
+  {
+  return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+  }
+
+static inline int64_t UnZigZag(uint64_t v)
+  {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+  }
+
+static inline void PutU32(uint8_t* p, uint32_t v)
+  {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+  }
+
+static inline uint32_t GetU32(const uint8_t* p)
+  {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+static inline void PutTime(uint8_t* p, int64_t time)
+  {
+  if (time < 0) time = 0;
+  PutU32(p, time / 1000000);
+  PutU32(p+4, time % 1000000);
+  }
+
+static inline int64_t GetTime(const uint8_t* p)
+  {
+  return (int64_t)GetU32(p) * 1000000 + GetU32(p+4);
+  }
+
+static inline int64_t TimevalToUs(const struct timeval* tv)
+  {
+  return (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+  }
+
+// Fletcher-16 over the segment header, check field (bytes 6-7) as zero
+static uint16_t SegmentHeaderCheck(const uint8_t* p)
+  {
+  uint16_t s1 = 0, s2 = 0;
+  for (int i = 0; i < CANCOMPACT_SEGHDR; i++)
+    {
+    s1 = (s1 + ((i == 6 || i == 7) ? 0 : p[i])) % 255;
+    s2 = (s2 + s1) % 255;
+    }
+  return (s2 << 8) | s1;
+  }
+
+static inline bool IsFrameType(CAN_log_type_t type)
+  {
+  return (type >= CAN_LogFrame_RX && type <= CAN_LogFrame_TX_Fail);
+  }
+
+static inline bool IsStatusType(CAN_log_type_t type)
+  {
+  return (type == CAN_LogStatus_Error || type == CAN_LogStatus_Statistics);
+  }
+
+static inline bool IsInfoType(CAN_log_type_t type)
+  {
+  return (type >= CAN_LogInfo_Comment && type <= CAN_LogInfo_Metric);
+  }
+
+////////////////////////////////////////////////////////////////////////
+// Encoder
+////////////////////////////////////////////////////////////////////////
+
+cancompact_encoder::cancompact_encoder()
+  {
+  Reset();
+  }
+
+void cancompact_encoder::Reset()
+  {
+  m_started = false;
+  m_insegment = false;
+  m_pos = 0;
+  m_sequence = 0;
+  m_time = 0;
+  m_dict.clear();
+  memset(&m_summary, 0, sizeof(m_summary));
+  }
+
+/**
+ * Header: start a new log, output the file header (CANCOMPACT_FILEHDR bytes)
+ */
+size_t cancompact_encoder::Header(uint8_t* out, const struct timeval* time)
+  {
+  Reset();
+  memcpy(out, "OVCL", 4);
+  out[4] = CANCOMPACT_VERSION;
+  out[5] = 0;
+  out[6] = out[7] = 0;
+  PutTime(out+8, TimevalToUs(time));
+  m_started = true;
+  return CANCOMPACT_FILEHDR;
+  }
+
+/**
+ * Encode: append a log message to the output buffer
+ *  bus: 0 = none, 1… = bus number + 1
+ *  Returns the number of bytes written (including file/segment headers &
+ *  trailers as necessary), 0 if the message type is not supported or the
+ *  buffer is smaller than CANCOMPACT_MAXLEN.
+ */
+size_t cancompact_encoder::Encode(const CAN_log_message_t* msg, uint8_t bus, uint8_t* out, size_t size)
+  {
+  if (size < CANCOMPACT_MAXLEN)
+    return 0;
+
+  bool isframe = IsFrameType(msg->type);
+  const uint8_t* payload = NULL;
+  size_t paylen = 0;
+  if (isframe)
+    {
+    // frame record: define + tag + dt + index + data
+    paylen = 7 + 1 + 10 + 5 + 8;
+    }
+  else if (IsStatusType(msg->type))
+    {
+    payload = (const uint8_t*) &msg->status;
+    paylen = sizeof(CAN_status_t);
+    }
+  else if (IsInfoType(msg->type))
+    {
+    payload = (const uint8_t*) msg->text;
+    paylen = msg->text ? strnlen(msg->text, CANCOMPACT_TEXTMAX) : 0;
+    }
+  else
+    return 0;
+
+  int64_t time = TimevalToUs(&msg->timestamp);
+  size_t n = 0;
+  if (!m_started)
+    n += Header(out, &msg->timestamp);
+
+  size_t need = isframe ? paylen : (1 + 10 + 2 + 2 + paylen);
+  if (m_insegment && m_pos + need + CANCOMPACT_TRAILERMAX > CANCOMPACT_SEGSIZE)
+    n += Close(out+n);
+  if (!m_insegment)
+    n += BeginSegment(out+n, time);
+
+  size_t start = n;
+  if (isframe)
+    {
+    uint32_t id = msg->frame.MsgID;
+    uint32_t key = (id << 1) | ((msg->frame.FIR.B.FF == CAN_frame_ext) ? 1 : 0);
+    uint32_t index;
+    n += Define(out+n, bus, key, &index);
+    uint8_t dlc = msg->frame.FIR.B.DLC;
+    out[n++] = CANCOMPACT_REC_FRAME
+      | ((msg->type - CAN_LogFrame_RX) << 5)
+      | ((msg->frame.FIR.B.RTR == CAN_RTR) ? 0x10 : 0)
+      | (dlc & 0x0f);
+    n += PutVarint(out+n, ZigZag(time - m_time));
+    n += PutVarint(out+n, index);
+    size_t len = (dlc > 8) ? 8 : dlc;
+    memcpy(out+n, msg->frame.data.u8, len);
+    n += len;
+    if (id < 0x800)
+      m_summary.stdmap[id >> 6] |= 1 << ((id >> 3) & 7);
+    else
+      m_summary.flags |= CANCOMPACT_FLAG_EXTIDS;
+    }
+  else
+    {
+    m_summary.flags |= CANCOMPACT_FLAG_INFO;
+    out[n++] = CANCOMPACT_REC_INFO;
+    n += PutVarint(out+n, ZigZag(time - m_time));
+    out[n++] = msg->type;
+    out[n++] = bus;
+    n += PutVarint(out+n, paylen);
+    if (paylen)
+      memcpy(out+n, payload, paylen);
+    n += paylen;
+    }
+
+  if (bus < 8)
+    m_summary.busmask |= 1 << bus;
+  m_summary.records++;
+  m_summary.end = time;
+  m_time = time;
+  m_pos += n - start;
+  return n;
+  }
+
+/**
+ * Close: finish the current segment (output the trailer)
+ *  Called automatically when a segment is full. A log not closed is still
+ *  readable, the last segment just lacks its summary.
+ */
+size_t cancompact_encoder::Close(uint8_t* out)
+  {
+  if (!m_insegment)
+    return 0;
+
+  size_t n = 0;
+  out[n++] = CANCOMPACT_REC_TRAILER;
+  n += PutVarint(out+n, m_summary.records);
+  n += PutVarint(out+n, m_pos);
+  PutTime(out+n, m_summary.end);
+  n += 8;
+  out[n++] = m_summary.busmask;
+  out[n++] = m_summary.flags;
+  memcpy(out+n, m_summary.stdmap, sizeof(m_summary.stdmap));
+  n += sizeof(m_summary.stdmap);
+  n += 2;
+  out[n-2] = n & 0xff;
+  out[n-1] = n >> 8;
+
+  m_insegment = false;
+  m_pos = 0;
+  return n;
+  }
+
+size_t cancompact_encoder::BeginSegment(uint8_t* out, int64_t time)
+  {
+  m_dict.clear();
+  memset(&m_summary, 0, sizeof(m_summary));
+  m_summary.end = time;
+
+  memcpy(out, "OVCS", 4);
+  out[4] = CANCOMPACT_VERSION;
+  out[5] = 0;
+  out[6] = out[7] = 0;
+  PutU32(out+8, m_sequence++);
+  PutTime(out+12, time);
+  uint16_t check = SegmentHeaderCheck(out);
+  out[6] = check & 0xff;
+  out[7] = check >> 8;
+
+  m_insegment = true;
+  m_pos = CANCOMPACT_SEGHDR;
+  m_time = time;
+  return CANCOMPACT_SEGHDR;
+  }
+
+size_t cancompact_encoder::Define(uint8_t* out, uint8_t bus, uint32_t key, uint32_t* index)
+  {
+  uint64_t dkey = ((uint64_t)bus << 32) | key;
+  auto it = m_dict.find(dkey);
+  if (it != m_dict.end())
+    {
+    *index = it->second;
+    return 0;
+    }
+  *index = m_dict.size();
+  m_dict[dkey] = *index;
+  out[0] = CANCOMPACT_REC_DEFINE;
+  out[1] = bus;
+  return 2 + PutVarint(out+2, key);
+  }
+
+////////////////////////////////////////////////////////////////////////
+// Decoder
+////////////////////////////////////////////////////////////////////////
+
+cancompact_decoder::cancompact_decoder()
+  {
+  m_segments = 0;
+  m_messages = 0;
+  m_filtered = 0;
+  m_resyncs = 0;
+  m_filter = NULL;
+  m_skipuntil = 0;
+  Reset();
+  }
+
+/**
+ * Reset: restart decoding at a file or segment header (i.e. after a seek)
+ */
+void cancompact_decoder::Reset()
+  {
+  m_started = false;
+  m_insegment = false;
+  m_resyncing = false;
+  m_time = 0;
+  m_dict.clear();
+  }
+
+/**
+ * SetFilter: skip frames not matching the filter
+ *  The filter is applied once per segment & ID on the dictionary entries,
+ *  frames of IDs filtered out are skipped without being decoded.
+ */
+void cancompact_decoder::SetFilter(canfilter* filter)
+  {
+  m_filter = filter;
+  }
+
+/**
+ * SetSkipUntil: skip messages logged before the time given [us]
+ */
+void cancompact_decoder::SetSkipUntil(int64_t time)
+  {
+  m_skipuntil = time;
+  }
+
+/**
+ * Decode: decode the next message from the buffer
+ *  Returns the number of bytes consumed. *got is set if a message has been
+ *  decoded into msg (bus: 0 = none, 1… = bus number + 1). If less than
+ *  the buffer length is consumed without a message, the remainder is an
+ *  incomplete record and needs to be passed again with more data.
+ *  Text pointers of info messages remain valid until the next call.
+ */
+size_t cancompact_decoder::Decode(const uint8_t* buf, size_t len, CAN_log_message_t* msg, uint8_t* bus, bool* got)
+  {
+  size_t pos = 0;
+  *got = false;
+
+  while (pos < len && !*got)
+    {
+    const uint8_t* p = buf + pos;
+    size_t avail = len - pos;
+
+    if (!m_started)
+      {
+      if (avail < 4) break;
+      if (memcmp(p, "OVCL", 4) == 0)
+        {
+        if (avail < CANCOMPACT_FILEHDR) break;
+        pos += CANCOMPACT_FILEHDR;
+        }
+      m_started = true;
+      continue;
+      }
+
+    if (!m_insegment)
+      {
+      if (avail < CANCOMPACT_SEGHDR) break;
+      cancompact_segment_t segment;
+      if (cancompact_file::ParseSegmentHeader(p, &segment))
+        {
+        m_insegment = true;
+        m_resyncing = false;
+        m_time = segment.start;
+        m_dict.clear();
+        m_segments++;
+        pos += CANCOMPACT_SEGHDR;
+        }
+      else
+        {
+        // scan for the next segment header:
+        if (!m_resyncing)
+          {
+          m_resyncs++;
+          m_resyncing = true;
+          }
+        pos++;
+        }
+      continue;
+      }
+
+    int used = DecodeRecord(p, avail, msg, bus, got);
+    if (used == 0)
+      break;
+    if (used < 0)
+      {
+      m_insegment = false;
+      m_resyncs++;
+      m_resyncing = true;
+      pos++;
+      continue;
+      }
+    pos += used;
+    }
+
+  return pos;
+  }
+
+/**
+ * DecodeRecord: returns bytes used, 0 = incomplete, -1 = invalid
+ */
+int cancompact_decoder::DecodeRecord(const uint8_t* p, size_t len, CAN_log_message_t* msg, uint8_t* bus, bool* got)
+  {
+  uint8_t tag = p[0];
+  size_t n = 1;
+  uint64_t dt, v;
+  int r;
+
+  if (tag & CANCOMPACT_REC_FRAME)
+    {
+    if ((r = GetVarint(p+n, len-n, &dt)) <= 0) return r;
+    n += r;
+    if ((r = GetVarint(p+n, len-n, &v)) <= 0) return r;
+    n += r;
+    uint8_t dlc = tag & 0x0f;
+    size_t dlen = (dlc > 8) ? 8 : dlc;
+    if (len - n < dlen) return 0;
+    if (v >= m_dict.size()) return -1;
+
+    m_time += UnZigZag(dt);
+    const dict_entry_t& entry = m_dict[v];
+    if (!entry.pass)
+      {
+      m_filtered++;
+      return n + dlen;
+      }
+    if (m_time < m_skipuntil)
+      return n + dlen;
+
+    memset(msg, 0, sizeof(*msg));
+    msg->type = (CAN_log_type_t)(CAN_LogFrame_RX + ((tag >> 5) & 3));
+    msg->timestamp.tv_sec = m_time / 1000000;
+    msg->timestamp.tv_usec = m_time % 1000000;
+    msg->frame.FIR.B.FF = (entry.key & 1) ? CAN_frame_ext : CAN_frame_std;
+    msg->frame.FIR.B.RTR = (tag & 0x10) ? CAN_RTR : CAN_no_RTR;
+    msg->frame.FIR.B.DLC = dlc;
+    msg->frame.MsgID = entry.key >> 1;
+    memcpy(msg->frame.data.u8, p+n, dlen);
+    *bus = entry.bus;
+    *got = true;
+    m_messages++;
+    return n + dlen;
+    }
+
+  switch (tag)
+    {
+    case CANCOMPACT_REC_DEFINE:
+      {
+      if (len < 2) return 0;
+      n = 2;
+      if ((r = GetVarint(p+n, len-n, &v)) <= 0) return r;
+      n += r;
+      if (v > 0x3fffffff) return -1;
+      dict_entry_t entry;
+      entry.bus = p[1];
+      entry.key = v;
+      entry.pass = (m_filter == NULL) || m_filter->IsFiltered(entry.bus, entry.key >> 1);
+      m_dict.push_back(entry);
+      return n;
+      }
+
+    case CANCOMPACT_REC_INFO:
+      {
+      if ((r = GetVarint(p+n, len-n, &dt)) <= 0) return r;
+      n += r;
+      if (len - n < 2) return 0;
+      CAN_log_type_t type = (CAN_log_type_t) p[n];
+      uint8_t infobus = p[n+1];
+      n += 2;
+      if ((r = GetVarint(p+n, len-n, &v)) <= 0) return r;
+      n += r;
+      if (v > CANCOMPACT_TEXTMAX && v != sizeof(CAN_status_t)) return -1;
+      if (len - n < v) return 0;
+
+      m_time += UnZigZag(dt);
+      if (m_time < m_skipuntil)
+        return n + v;
+      if (IsStatusType(type) && v != sizeof(CAN_status_t))
+        return n + v;   // other platform
+      if (!IsStatusType(type) && !IsInfoType(type))
+        return n + v;
+
+      memset(msg, 0, sizeof(*msg));
+      msg->type = type;
+      msg->timestamp.tv_sec = m_time / 1000000;
+      msg->timestamp.tv_usec = m_time % 1000000;
+      if (IsStatusType(type))
+        {
+        memcpy(&msg->status, p+n, v);
+        }
+      else
+        {
+        size_t tlen = std::min((size_t)v, (size_t)CANCOMPACT_TEXTMAX);
+        memcpy(m_text, p+n, tlen);
+        m_text[tlen] = 0;
+        msg->text = m_text;
+        }
+      *bus = infobus;
+      *got = true;
+      m_messages++;
+      return n + v;
+      }
+
+    case CANCOMPACT_REC_TRAILER:
+      {
+      if ((r = GetVarint(p+n, len-n, &v)) <= 0) return r;
+      n += r;
+      if ((r = GetVarint(p+n, len-n, &v)) <= 0) return r;
+      n += r;
+      n += 8 + 2 + 32 + 2;
+      if (len < n) return 0;
+      m_insegment = false;
+      return n;
+      }
+
+    default:
+      return -1;
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////
+// File access: segment index, seek & summaries
+////////////////////////////////////////////////////////////////////////
+
+cancompact_file::cancompact_file(FILE* file)
+  {
+  m_file = file;
+  long pos = ftell(file);
+  fseek(file, 0, SEEK_END);
+  m_size = ftell(file);
+  fseek(file, pos, SEEK_SET);
+  }
+
+bool cancompact_file::ParseSegmentHeader(const uint8_t* p, cancompact_segment_t* segment)
+  {
+  if (p[0] != 'O' || p[1] != 'V' || p[2] != 'C' || p[3] != 'S' || p[4] != CANCOMPACT_VERSION)
+    return false;
+  if (SegmentHeaderCheck(p) != (p[6] | (p[7] << 8)))
+    return false;
+  segment->offset = 0;
+  segment->sequence = GetU32(p+8);
+  segment->start = GetTime(p+12);
+  return true;
+  }
+
+/**
+ * FindSegment: find the first segment header starting in [from, to)
+ */
+bool cancompact_file::FindSegment(long from, long to, cancompact_segment_t* segment)
+  {
+  uint8_t buf[1024];
+  long pos = from;
+  while (pos < to)
+    {
+    if (fseek(m_file, pos, SEEK_SET) != 0)
+      return false;
+    size_t want = std::min((long)sizeof(buf), to - pos + CANCOMPACT_SEGHDR - 1);
+    size_t got = fread(buf, 1, want, m_file);
+    if (got < CANCOMPACT_SEGHDR)
+      return false;
+    size_t last = got - CANCOMPACT_SEGHDR;
+    for (size_t i = 0; i <= last && pos + (long)i < to; i++)
+      {
+      if (buf[i] == 'O' && ParseSegmentHeader(buf+i, segment))
+        {
+        segment->offset = pos + i;
+        return true;
+        }
+      }
+    pos += last + 1;
+    }
+  return false;
+  }
+
+bool cancompact_file::NextSegment(const cancompact_segment_t* segment, cancompact_segment_t* next)
+  {
+  return FindSegment(segment->offset + CANCOMPACT_SEGHDR, m_size, next);
+  }
+
+/**
+ * ReadSummary: read the trailer of the segment ending at end (the offset of
+ *  the next segment header or the file size)
+ *  Returns false if the segment has no (valid) trailer.
+ */
+bool cancompact_file::ReadSummary(const cancompact_segment_t* segment, long end, cancompact_summary_t* summary)
+  {
+  uint8_t buf[CANCOMPACT_TRAILERMAX];
+  if (end - segment->offset < CANCOMPACT_SEGHDR + 2)
+    return false;
+  if (fseek(m_file, end - 2, SEEK_SET) != 0 || fread(buf, 1, 2, m_file) != 2)
+    return false;
+  size_t tlen = buf[0] | (buf[1] << 8);
+  if (tlen > sizeof(buf) || (long)tlen > end - segment->offset - CANCOMPACT_SEGHDR)
+    return false;
+  long toffset = end - tlen;
+  if (fseek(m_file, toffset, SEEK_SET) != 0 || fread(buf, 1, tlen, m_file) != tlen)
+    return false;
+  if (buf[0] != CANCOMPACT_REC_TRAILER)
+    return false;
+
+  size_t n = 1;
+  uint64_t records, offset;
+  int r;
+  if ((r = GetVarint(buf+n, tlen-n, &records)) <= 0) return false;
+  n += r;
+  if ((r = GetVarint(buf+n, tlen-n, &offset)) <= 0) return false;
+  n += r;
+  if (segment->offset + (long)offset != toffset) return false;
+  if (n + 8 + 2 + 32 + 2 != tlen) return false;
+
+  summary->records = records;
+  summary->end = GetTime(buf+n);
+  n += 8;
+  summary->busmask = buf[n++];
+  summary->flags = buf[n++];
+  memcpy(summary->stdmap, buf+n, sizeof(summary->stdmap));
+  return true;
+  }
+
+/**
+ * Seek: find the segment to start decoding from for a time [us]
+ *  Binary search over the file offsets, O(log n) segment header scans.
+ *  Returns the last segment starting before the time (or the first segment).
+ */
+bool cancompact_file::Seek(int64_t time, cancompact_segment_t* segment)
+  {
+  cancompact_segment_t best, seg;
+  if (!FindSegment(0, m_size, &best))
+    return false;
+
+  long lo = best.offset + 1, hi = m_size;
+  while (lo < hi)
+    {
+    long mid = lo + (hi - lo) / 2;
+    if (!FindSegment(mid, hi, &seg))
+      {
+      hi = mid;
+      }
+    else if (seg.start < time)
+      {
+      best = seg;
+      lo = seg.offset + 1;
+      }
+    else
+      {
+      hi = mid;
+      }
+    }
+
+  *segment = best;
+  return true;
+  }
+
+/**
+ * Matches: check if a segment may contain frames passing the filter
+ *  11 bit IDs are checked at a resolution of 8 IDs, higher IDs by presence.
+ */
+bool cancompact_file::Matches(const cancompact_summary_t* summary, canfilter* filter)
+  {
+  if (filter == NULL || !filter->HasFilters())
+    return true;
+
+  for (CAN_filter_t* f : filter->GetFilterList())
+    {
+    if (f->bus > 7)
+      return true;
+    if (f->bus != 0 && (summary->busmask & (1 << f->bus)) == 0)
+      continue;
+    if (f->id_from < 0x800)
+      {
+      uint32_t to = std::min(f->id_to, (uint32_t)0x7ff);
+      for (uint32_t b = f->id_from >> 3; b <= (to >> 3); b++)
+        {
+        if (summary->stdmap[b >> 3] & (1 << (b & 7)))
+          return true;
+        }
+      }
+    if (f->id_to >= 0x800 && (summary->flags & CANCOMPACT_FLAG_EXTIDS))
+      return true;
+    }
+
+  return false;
+  }
@@ -0,0 +1,192 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Compact binary CAN log codec
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CANCOMPACT_H__
+#define __CANCOMPACT_H__
+
+// Plain C++ codec without framework dependencies (besides the CAN types),
+// used by canformat_compact and the host tests in components/can/tests.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <map>
+#include <vector>
+#include "can.h"
+
+/**
+ * Compact binary CAN log format
+ *
+ * A log is a file header followed by a sequence of segments. Each segment
+ * carries its own ID dictionary and time base, so decoding can start at
+ * any segment header:
+ *
+ *   file header    16 bytes: "OVCL", u8 version, u8 flags, u16 0, u32 sec, u32 usec
+ *   segment header 20 bytes: "OVCS", u8 version, u8 flags, u16 check,
+ *                            u32 sequence, u32 sec, u32 usec (time base)
+ *   records…
+ *   trailer        segment summary, closes the segment
+ *
+ * Records (integers little endian, varint = LEB128, dt = zigzag varint
+ * microseconds since the previous record / the segment time base):
+ *
+ *   0x01 define    u8 bus, varint key (id<<1 | extended)
+ *                  → assigns the next dictionary index in this segment
+ *   0x02 info      varint dt, u8 log type, u8 bus, varint len, payload
+ *                  (text for info messages, CAN_status_t for status messages)
+ *   0x03 trailer   varint records, varint trailer offset in segment,
+ *                  u32 end sec, u32 end usec, u8 bus mask, u8 flags,
+ *                  u8 stdmap[32] (11 bit ID presence, 8 IDs per bit),
+ *                  u16 trailer length (so it can be found from the next segment)
+ *   0x80… frame    tag bits 6-5: log type (RX/TX/TX_Queue/TX_Fail),
+ *                  bit 4: RTR, bits 3-0: DLC; varint dt, varint dictionary
+ *                  index, data[min(DLC,8)]
+ *
+ * A typical standard frame takes 11-13 bytes (CRTD: ~50 bytes).
+ *
+ * Segments are closed at CANCOMPACT_SEGSIZE, so a reader can binary search
+ * the file for a time by scanning for the next segment header from any
+ * offset (cancompact_file::Seek), and use the trailer summary to skip
+ * segments not containing the buses & IDs of interest without decoding them.
+ * After data loss, the decoder resynchronises on the next segment header.
+ */
+
+#define CANCOMPACT_VERSION      1
+#define CANCOMPACT_SEGSIZE      4096    // target segment size [bytes]
+#define CANCOMPACT_FILEHDR      16
+#define CANCOMPACT_SEGHDR       20
+#define CANCOMPACT_TRAILERMAX   56
+#define CANCOMPACT_TEXTMAX      255     // info text length limit
+#define CANCOMPACT_MAXLEN       400     // max output of a single Encode() call
+
+#define CANCOMPACT_REC_DEFINE   0x01
+#define CANCOMPACT_REC_INFO     0x02
+#define CANCOMPACT_REC_TRAILER  0x03
+#define CANCOMPACT_REC_FRAME    0x80
+
+#define CANCOMPACT_FLAG_EXTIDS  0x01    // trailer flag: IDs >= 0x800 present
+#define CANCOMPACT_FLAG_INFO    0x02    // trailer flag: info / status records present
+
+typedef struct
+  {
+  long        offset;                   // file offset of the segment header
+  uint32_t    sequence;
+  int64_t     start;                    // time base [us]
+  } cancompact_segment_t;
+
+typedef struct
+  {
+  uint32_t    records;
+  int64_t     end;                      // time of last record [us]
+  uint8_t     busmask;                  // bit N = bus N (bit 0 = no bus)
+  uint8_t     flags;
+  uint8_t     stdmap[32];
+  } cancompact_summary_t;
+
+class cancompact_encoder
+  {
+  public:
+    cancompact_encoder();
+
+  public:
+    void Reset();
+    size_t Header(uint8_t* out, const struct timeval* time);
+    size_t Encode(const CAN_log_message_t* msg, uint8_t bus, uint8_t* out, size_t size);
+    size_t Close(uint8_t* out);
+
+  protected:
+    size_t BeginSegment(uint8_t* out, int64_t time);
+    size_t Define(uint8_t* out, uint8_t bus, uint32_t key, uint32_t* index);
+
+  protected:
+    bool        m_started;              // file header written
+    bool        m_insegment;
+    size_t      m_pos;                  // bytes written to current segment
+    uint32_t    m_sequence;
+    int64_t     m_time;                 // time of last record [us]
+    std::map<uint64_t, uint32_t> m_dict;  // bus<<32 | key → index
+    cancompact_summary_t m_summary;
+  };
+
+class cancompact_decoder
+  {
+  public:
+    cancompact_decoder();
+
+  public:
+    void Reset();
+    void SetFilter(canfilter* filter);
+    void SetSkipUntil(int64_t time);
+    size_t Decode(const uint8_t* buf, size_t len, CAN_log_message_t* msg, uint8_t* bus, bool* got);
+
+  protected:
+    int DecodeRecord(const uint8_t* p, size_t len, CAN_log_message_t* msg, uint8_t* bus, bool* got);
+
+  public:
+    uint32_t    m_segments;
+    uint32_t    m_messages;
+    uint32_t    m_filtered;             // frames skipped by the filter
+    uint32_t    m_resyncs;              // format errors / data loss
+
+  protected:
+    typedef struct
+      {
+      uint8_t   bus;
+      uint32_t  key;
+      bool      pass;                   // passes the filter
+      } dict_entry_t;
+
+    bool        m_started;              // file header checked
+    bool        m_insegment;
+    bool        m_resyncing;
+    int64_t     m_time;
+    int64_t     m_skipuntil;
+    canfilter*  m_filter;
+    std::vector<dict_entry_t> m_dict;
+    char        m_text[CANCOMPACT_TEXTMAX+1];
+  };
+
+class cancompact_file
+  {
+  public:
+    cancompact_file(FILE* file);
+
+  public:
+    bool FindSegment(long from, long to, cancompact_segment_t* segment);
+    bool NextSegment(const cancompact_segment_t* segment, cancompact_segment_t* next);
+    bool ReadSummary(const cancompact_segment_t* segment, long end, cancompact_summary_t* summary);
+    bool Seek(int64_t time, cancompact_segment_t* segment);
+
+  public:
+    static bool ParseSegmentHeader(const uint8_t* p, cancompact_segment_t* segment);
+    static bool Matches(const cancompact_summary_t* summary, canfilter* filter);
+
+  public:
+    FILE*       m_file;
+    long        m_size;
+  };
+
+#endif // __CANCOMPACT_H__
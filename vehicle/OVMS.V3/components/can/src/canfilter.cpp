@@ -0,0 +1,332 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN ID sets & software filters
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "can.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <inttypes.h>
+
+////////////////////////////////////////////////////////////////////////
+// CAN ID sets
+// The canidset object is a compiled lookup structure for CAN IDs per bus
+////////////////////////////////////////////////////////////////////////
+
+canidset::canidset()
+  {
+  for (int k=0; k<CAN_IDSET_SLOTS; k++)
+    {
+    m_stdmap[k] = NULL;
+    m_extmap[k] = NULL;
+    }
+  m_empty = true;
+  }
+
+canidset::~canidset()
+  {
+  Clear();
+  }
+
+void canidset::Clear()
+  {
+  for (int k=0; k<CAN_IDSET_SLOTS; k++)
+    {
+    if (m_stdmap[k])
+      {
+      delete [] m_stdmap[k];
+      m_stdmap[k] = NULL;
+      }
+    if (m_extmap[k])
+      {
+      delete [] m_extmap[k];
+      m_extmap[k] = NULL;
+      }
+    m_ranges[k].clear();
+    m_ranges[k].shrink_to_fit();
+    }
+  m_empty = true;
+  }
+
+/**
+ * Add: add an ID range to the set for standard and extended frames
+ *  bus: 0 = any bus, 1..CAN_MAXBUSES = can1..canN (as for canfilter)
+ *  Returns false on an invalid bus or range.
+ */
+bool canidset::Add(uint8_t bus /*=0*/, uint32_t id_from /*=0*/, uint32_t id_to /*=UINT32_MAX*/)
+  {
+  return Add(bus, id_from, id_to, CAN_frame_std)
+      && Add(bus, id_from, id_to, CAN_frame_ext);
+  }
+
+/**
+ * Add: add an ID range to the set for one frame format
+ *  Standard frames only have 11 bit IDs, the range is clipped accordingly.
+ */
+bool canidset::Add(uint8_t bus, uint32_t id_from, uint32_t id_to, CAN_frame_format_t format)
+  {
+  if (bus >= CAN_IDSET_SLOTS || id_from > id_to)
+    return false;
+
+  if (id_from < CAN_IDSET_STDIDS)
+    {
+    uint32_t*& map = (format == CAN_frame_std) ? m_stdmap[bus] : m_extmap[bus];
+    if (!map)
+      map = new uint32_t[CAN_IDSET_STDIDS/32]();
+    uint32_t last = std::min(id_to, (uint32_t)CAN_IDSET_STDIDS-1);
+    for (uint32_t id = id_from; id <= last; id++)
+      map[id >> 5] |= (1UL << (id & 31));
+    }
+  if (format == CAN_frame_ext && id_to >= CAN_IDSET_STDIDS)
+    {
+    AddRange(m_ranges[bus], std::max(id_from, (uint32_t)CAN_IDSET_STDIDS), id_to);
+    }
+
+  m_empty = false;
+  return true;
+  }
+
+/**
+ * AddRange: insert a range into a sorted range list, merging overlapping
+ *  and adjacent ranges, so lookups can use a binary search
+ */
+void canidset::AddRange(CAN_idrange_list_t& list, uint32_t id_from, uint32_t id_to)
+  {
+  // Find the first range that ends at or after id_from-1:
+  uint32_t lo = (id_from > 0) ? id_from-1 : 0;
+  auto first = std::lower_bound(list.begin(), list.end(), lo,
+    [](const CAN_idrange_t& r, uint32_t v) { return r.second < v; });
+
+  // Absorb all ranges starting at or before id_to+1:
+  auto last = first;
+  while (last != list.end() && (last->first <= id_to || (id_to < UINT32_MAX && last->first == id_to+1)))
+    {
+    id_from = std::min(id_from, last->first);
+    id_to = std::max(id_to, last->second);
+    ++last;
+    }
+
+  first = list.erase(first, last);
+  list.insert(first, CAN_idrange_t(id_from, id_to));
+  }
+
+bool canidset::ContainsRange(const CAN_idrange_list_t& list, uint32_t id)
+  {
+  if (list.empty())
+    return false;
+  auto it = std::upper_bound(list.begin(), list.end(), id,
+    [](uint32_t v, const CAN_idrange_t& r) { return v < r.first; });
+  if (it == list.begin())
+    return false;
+  --it;
+  return (id <= it->second);
+  }
+
+bool canidset::Contains(const CAN_frame_t* p_frame) const
+  {
+  CAN_frame_format_t format = p_frame->FIR.B.FF;
+  if (Contains(0, format, p_frame->MsgID))
+    return true;
+  if (p_frame->origin == NULL)
+    return false;
+  int slot = p_frame->origin->m_busnumber + 1;
+  return (slot > 0 && slot < CAN_IDSET_SLOTS && Contains(slot, format, p_frame->MsgID));
+  }
+
+////////////////////////////////////////////////////////////////////////
+// CAN Filtering (software based filter)
+// The canfilter object encapsulates the filtering of CAN frames
+////////////////////////////////////////////////////////////////////////
+
+canfilter::canfilter()
+  {
+  m_busmask = 0;
+  }
+
+canfilter::~canfilter()
+  {
+  ClearFilters();
+  }
+
+void canfilter::ClearFilters()
+  {
+  for (CAN_filter_t* filter : m_filters)
+    {
+    delete filter;
+    }
+  m_filters.clear();
+  m_idset.Clear();
+  m_busmask = 0;
+  }
+
+/**
+ * Compile: rebuild the ID set & bus mask from the filter list
+ */
+void canfilter::Compile()
+  {
+  m_idset.Clear();
+  m_busmask = 0;
+  for (CAN_filter_t* filter : m_filters)
+    {
+    m_idset.Add(filter->bus, filter->id_from, filter->id_to);
+    if (filter->bus) m_busmask |= (1UL << filter->bus);
+    }
+  }
+
+/** Add a filter to the list (what is allowed).
+ * @param bus The CAN bus 1-3  or 0 to match any.
+ * @param id_from The id to match from
+ * @param id_to The id to match to
+ */
+
+bool canfilter::AddFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
+  {
+  if (bus > CAN_MAXBUSES)
+    return false;
+  if (id_from > id_to)
+    return false;
+  // Backwards compatible. Used to be '1' (49) for bus 1 etc
+  if (bus >= (uint8_t)'0')
+    bus -= '0';
+  if (bus > CAN_MAXBUSES)
+    return false;
+
+  CAN_filter_t* f = new CAN_filter_t;
+  f->bus = bus;
+  f->id_from = id_from;
+  f->id_to = id_to;
+  m_filters.push_back(f);
+  m_idset.Add(bus, id_from, id_to);
+  if (bus) m_busmask |= (1UL << bus);
+  return true;
+  }
+/** Add a filter string.
+ * The format is: <bus>[:<from>[-[<to>]]]
+ * Where <bus> is 0 to match any or 1 to CAN_MAXBUSES,
+ * and 'from' and 'to' are in hex.
+ * <bus>          Matches anything on that bus.
+ * <bus>:<value>  Matches 1 address on the specified bus.
+ * <bus>:<from>-  Matches adressses >= the specified value on that bus
+ * <bus>:<from>-<to>  Matches addresses  'from' <= adress <= 'to' on that bus
+ * <value>        Matches 1 address on any bus.
+ * <from>-        Matches adressses >= the specified value on any bus
+ * <from>-<to>    Matches addresses  'from' <= adress <= 'to' on any bus
+ */
+bool canfilter::AddFilter(const char* filterstring)
+  {
+  if (!*filterstring)
+    return false;
+  uint32_t bus, id_from, id_to;
+  char sep; // Consume '-' - but don't care exactly what it is.
+  int level;
+
+  switch (filterstring[1])
+    {
+    // first character is a bus
+    case '\0':
+    case ':':
+      level = sscanf(filterstring, "%" SCNu32 ":%" SCNx32 "%c%" SCNx32, &bus, &id_from, &sep, &id_to);
+      break;
+    // No bus
+    default:
+      {
+      level = sscanf(filterstring, "%" SCNx32 "%c%" SCNx32,  &id_from, &sep, &id_to);
+      if (level == 0)
+        return false;
+      bus = 0;
+      ++level;
+      break;
+      }
+    }
+
+  switch (level)
+    {
+    case 1: // eg: 1
+      id_from = 0;
+      id_to = UINT32_MAX;
+      break;
+    case 2: // eg: 1:200 or 200
+      id_to = id_from;
+      break;
+    case 3: // eg: 1:200- or 200-
+      id_to = UINT32_MAX;
+      break;
+    case 4: // eg: 1:200-7E0 or 200-7E0
+      break;
+    default:
+      return false;
+    }
+  return AddFilter(bus, id_from, id_to);
+  }
+
+bool canfilter::RemoveFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
+  {
+  if (bus >= (uint8_t)'0')
+    bus -= '0';
+  for (CAN_filter_list_t::iterator it = m_filters.begin(); it != m_filters.end(); ++it)
+    {
+    CAN_filter_t* filter = *it;
+    if ((filter->bus == bus) &&
+        (filter->id_from == id_from) &&
+        (filter->id_to == id_to))
+      {
+      delete filter;
+      m_filters.erase(it);
+      Compile();
+      return true;
+      }
+    }
+  return false;
+  }
+
+bool canfilter::IsFiltered(canbus* bus)
+  {
+  if (m_filters.size() == 0) return true;
+  if (bus == NULL) return true;
+
+  uint8_t buskey = bus->m_busnumber+1;
+  return (m_busmask & (1UL << buskey)) != 0;
+  }
+
+std::string canfilter::Info()
+  {
+  std::ostringstream buf;
+
+  for (CAN_filter_t* filter : m_filters)
+    {
+    if (filter->bus > 0) buf << std::setfill(' ') << std::dec << char('0'+ filter->bus) << ':';
+    buf << std::setfill('0') << std::setw(3) << std::hex;
+    if (filter->id_from == filter->id_to)
+      buf << filter->id_from << ' ';
+    else if (filter->id_to < UINT32_MAX)
+      buf << filter->id_from << '-' << filter->id_to << ' ';
+    else if (filter->id_to > 0)
+      buf << filter->id_from << "- ";
+    else
+      buf << ' ';
+    }
+
+  return buf.str();
+  }
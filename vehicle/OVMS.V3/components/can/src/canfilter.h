@@ -0,0 +1,153 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN ID sets & software filters
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CAN_FILTER_H__
+#define __CAN_FILTER_H__
+
+// Included by can.h, needs CAN_MAXBUSES, canbus, CAN_frame_t & CAN_frame_format_t from there.
+
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////
+// CAN ID sets
+// The canidset object is a compiled lookup structure for CAN IDs per bus
+// and frame format, used to route frames to callbacks and listeners. IDs
+// below 0x800 are held in a bitmap, higher (extended) IDs in a sorted list
+// of merged ranges.
+////////////////////////////////////////////////////////////////////////
+
+#define CAN_IDSET_STDIDS    0x800               // IDs covered by the bitmap
+#define CAN_IDSET_SLOTS     (CAN_MAXBUSES+1)    // Slot 0 = any bus, N = bus N
+
+typedef std::pair<uint32_t, uint32_t> CAN_idrange_t;
+typedef std::vector<CAN_idrange_t> CAN_idrange_list_t;
+
+class canidset
+  {
+  public:
+    canidset();
+    ~canidset();
+
+  private:
+    canidset(const canidset&) = delete;
+    canidset& operator=(const canidset&) = delete;
+
+  public:
+    void Clear();
+    bool Add(uint8_t bus=0, uint32_t id_from=0, uint32_t id_to=UINT32_MAX);
+    bool Add(uint8_t bus, uint32_t id_from, uint32_t id_to, CAN_frame_format_t format);
+    bool IsEmpty() const
+      {
+      return m_empty;
+      }
+
+  public:
+    bool Contains(const CAN_frame_t* p_frame) const;
+    bool Contains(uint8_t slot, CAN_frame_format_t format, uint32_t id) const
+      {
+      if (id < CAN_IDSET_STDIDS)
+        {
+        const uint32_t* map = (format == CAN_frame_std) ? m_stdmap[slot] : m_extmap[slot];
+        return map && (map[id >> 5] & (1UL << (id & 31)));
+        }
+      return (format == CAN_frame_ext) && ContainsRange(m_ranges[slot], id);
+      }
+
+  protected:
+    static bool ContainsRange(const CAN_idrange_list_t& list, uint32_t id);
+    static void AddRange(CAN_idrange_list_t& list, uint32_t id_from, uint32_t id_to);
+
+  protected:
+    uint32_t* m_stdmap[CAN_IDSET_SLOTS];    // standard frames, lazily allocated bitmaps
+    uint32_t* m_extmap[CAN_IDSET_SLOTS];    // extended frames with IDs below 0x800
+    CAN_idrange_list_t m_ranges[CAN_IDSET_SLOTS];   // extended frames, higher IDs
+    bool m_empty;
+  };
+
+////////////////////////////////////////////////////////////////////////
+// CAN Filtering (software based filter)
+// The canfilter object encapsulates the filtering of CAN frames
+////////////////////////////////////////////////////////////////////////
+
+typedef struct
+  {
+  uint8_t bus;
+  uint32_t id_from;
+  uint32_t id_to;
+  } CAN_filter_t;
+
+typedef std::list<CAN_filter_t*> CAN_filter_list_t;
+
+class canfilter
+  {
+  public:
+    canfilter();
+    virtual ~canfilter();
+
+  public:
+    void ClearFilters();
+    bool AddFilter(uint8_t bus=0, uint32_t id_from=0, uint32_t id_to=UINT32_MAX);
+    bool AddFilter(const char* filterstring);
+    bool RemoveFilter(uint8_t bus=0, uint32_t id_from=0, uint32_t id_to=UINT32_MAX);
+
+  public:
+    bool IsFiltered(const CAN_frame_t* p_frame)
+      {
+      if (m_filters.empty()) return true;
+      if (!p_frame) return false;
+      return m_idset.Contains(p_frame);
+      }
+    bool IsFiltered(uint8_t bus, uint32_t id)   // bus: 0 = none, N = bus N
+      {
+      // filters apply to both frame formats, the extended set covers all IDs:
+      if (m_filters.empty()) return true;
+      return m_idset.Contains(0, CAN_frame_ext, id)
+        || (bus > 0 && bus < CAN_IDSET_SLOTS && m_idset.Contains(bus, CAN_frame_ext, id));
+      }
+    bool IsFiltered(canbus* bus);
+    std::string Info();
+    bool HasFilters()
+      {
+      return !m_filters.empty();
+      }
+    const CAN_filter_list_t& GetFilterList() const
+      {
+      return m_filters;
+      }
+
+  protected:
+    void Compile();
+
+  protected:
+    CAN_filter_list_t m_filters;
+    canidset m_idset;                 // compiled lookup of m_filters
+    uint32_t m_busmask;               // bit N set = filter for bus N
+  };
+
+#endif //#ifndef __CAN_FILTER_H__
@@ -28,6 +28,7 @@
 static const char *TAG = "canformat";
 
 #include "canformat.h"
+#include "ovms_malloc.h"
 
 canformat::canformat_serve_mode_t GetFormatModeType(std::string name)
   {
@@ -73,6 +74,147 @@ void OvmsCanFormatFactory::RegisterCommandSet(OvmsCommand* base, const char* tit
     }
   }
 
+////////////////////////////////////////////////////////////////////////
+// Shared output cache
+////////////////////////////////////////////////////////////////////////
+
+canformat_cache MyCanFormatCache __attribute__ ((init_priority (4500)));
+
+canformat_cache::canformat_cache()
+  {
+  }
+
+canformat_cache::~canformat_cache()
+  {
+  for (auto& e : m_entries)
+    {
+    if (e.slots) free(e.slots);
+    }
+  }
+
+canformat_cache::entry_t* canformat_cache::Find(const char* type)
+  {
+  for (auto& e : m_entries)
+    {
+    if (e.type == type)
+      return &e;
+    }
+  return NULL;
+  }
+
+/**
+ * Attach: register a logger's formatter, enables sharing from the second user on
+ */
+void canformat_cache::Attach(canformat* formatter)
+  {
+  if (!formatter || !formatter->IsStateless()) return;
+  OvmsMutexLock lock(&m_mutex);
+  entry_t* e = Find(formatter->type());
+  if (!e)
+    {
+    m_entries.push_back(entry_t{formatter->type(), 0, NULL, 0, 0});
+    e = &m_entries.back();
+    }
+  if (++e->users > 1 && !e->slots)
+    {
+    e->slots = (slot_t*) ExternalRamMalloc(CANFORMAT_CACHE_SLOTS * sizeof(slot_t));
+    if (e->slots)
+      memset(e->slots, 0, CANFORMAT_CACHE_SLOTS * sizeof(slot_t));
+    else
+      ESP_LOGW(TAG, "Unable to allocate shared output cache for format %s", e->type.c_str());
+    }
+  }
+
+void canformat_cache::Detach(canformat* formatter)
+  {
+  if (!formatter || !formatter->IsStateless()) return;
+  OvmsMutexLock lock(&m_mutex);
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+    if (it->type != formatter->type()) continue;
+    if (--it->users < 2 && it->slots)
+      {
+      free(it->slots);
+      it->slots = NULL;
+      }
+    if (it->users <= 0)
+      m_entries.erase(it);
+    return;
+    }
+  }
+
+uint32_t canformat_cache::Index(const CAN_log_message_t* message)
+  {
+  uint32_t h = message->frame.MsgID * 0x9e3779b1u;
+  h ^= (uint32_t)message->timestamp.tv_usec;
+  h ^= h >> 16;
+  return h % CANFORMAT_CACHE_SLOTS;
+  }
+
+/**
+ * getinto: format a message into buffer, using the shared output if available
+ */
+size_t canformat_cache::getinto(canformat* formatter, CAN_log_message_t* message, char* buffer, size_t size)
+  {
+  if (message->type < CAN_LogFrame_RX || message->type > CAN_LogFrame_TX_Fail || !formatter->IsStateless())
+    return formatter->getinto(message, buffer, size);
+
+  uint32_t index = Index(message);
+  bool shared = false;
+    {
+    OvmsMutexLock lock(&m_mutex);
+    entry_t* e = Find(formatter->type());
+    if (e && e->slots)
+      {
+      shared = true;
+      slot_t* slot = &e->slots[index];
+      if (slot->len > 0 && slot->len <= size &&
+          slot->type == message->type &&
+          slot->timestamp.tv_sec == message->timestamp.tv_sec &&
+          slot->timestamp.tv_usec == message->timestamp.tv_usec &&
+          memcmp(&slot->frame, &message->frame, sizeof(CAN_frame_t)) == 0)
+        {
+        memcpy(buffer, slot->data, slot->len);
+        e->hits++;
+        return slot->len;
+        }
+      e->misses++;
+      }
+    }
+
+  size_t len = formatter->getinto(message, buffer, size);
+
+  if (shared && len > 0 && len <= CANFORMAT_CACHE_SLOTSIZE)
+    {
+    OvmsMutexLock lock(&m_mutex);
+    entry_t* e = Find(formatter->type());
+    if (e && e->slots)
+      {
+      slot_t* slot = &e->slots[index];
+      slot->type = message->type;
+      slot->timestamp = message->timestamp;
+      memcpy(&slot->frame, &message->frame, sizeof(CAN_frame_t));
+      memcpy(slot->data, buffer, len);
+      slot->len = len;
+      }
+    }
+
+  return len;
+  }
+
+std::string canformat_cache::GetStats()
+  {
+  std::string result;
+  OvmsMutexLock lock(&m_mutex);
+  for (auto& e : m_entries)
+    {
+    if (e.users < 2) continue;
+    result.append(string_format("Shared format %s: %d loggers, %" PRIu32 " hits, %" PRIu32 " misses%s\n",
+      e.type.c_str(), e.users, e.hits, e.misses, e.slots ? "" : " (no memory)"));
+    }
+  return result;
+  }
+
 canformat::canformat(const char* type, canformat_serve_mode_t mode)
   : m_buf(CANFORMAT_SERVE_BUFFERSIZE)
   {
@@ -95,16 +237,50 @@ std::string canformat::get(CAN_log_message_t* message)
   return std::string("");
   }
 
+/**
+ * getinto: format a message directly into a buffer, avoiding the std::string
+ *  allocation of get(). Returns the length written, 0 if the message has no
+ *  representation in this format or does not fit into the buffer.
+ *  A buffer of CANFORMAT_GET_MAXLEN bytes is sufficient for all formats.
+ *  This base implementation uses get(), formats override it where it matters.
+ */
+size_t canformat::getinto(CAN_log_message_t* message, char* buffer, size_t size)
+  {
+  std::string result = get(message);
+  if (result.length() > size) return 0;
+  memcpy(buffer, result.data(), result.length());
+  return result.length();
+  }
+
 std::string canformat::getheader(struct timeval *time)
   {
   return std::string("");
   }
 
+/**
+ * getfooter: output to end a log with (e.g. a closing record), called by
+ *  the loggers before closing a file
+ */
+std::string canformat::getfooter()
+  {
+  return std::string("");
+  }
+
 size_t canformat::put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc)
   {
   return 0;
   }
 
+/**
+ * seek: position a file for reading by put() at the first message logged
+ *  at or after the time given (relative: time is an offset from the log start).
+ *  Returns false if the format does not support seeking.
+ */
+bool canformat::seek(FILE* file, const struct timeval* time, bool relative)
+  {
+  return false;
+  }
+
 size_t canformat::Serve(uint8_t *buffer, size_t len, canlogconnection* clc)
   {
   if ((m_servediscarding)||(m_servemode == Discard))
@@ -31,13 +31,16 @@
 #include <sys/time.h>
 #include <string.h>
 #include <map>
+#include <list>
 #include "can.h"
 #include "ovms_utils.h"
+#include "ovms_mutex.h"
 #include "ovms_command.h"
 #include "ovms_buffer.h"
 using namespace std;
 
 #define CANFORMAT_SERVE_BUFFERSIZE 1024
+#define CANFORMAT_GET_MAXLEN 512          // getinto() buffer size sufficient for any message
 
 class canlogconnection;
 
@@ -55,10 +58,15 @@ class canformat
 
   public: // Conversion from OVMS CAN log messages to specific format
     virtual std::string get(CAN_log_message_t* message);
+    virtual size_t getinto(CAN_log_message_t* message, char* buffer, size_t size);
     virtual std::string getheader(struct timeval *time = NULL);
+    virtual std::string getfooter();
+    // true if get() only depends on the message (output may be shared between loggers):
+    virtual bool IsStateless() { return false; }
 
   public: // Conversion from specific format to OVMS CAN log messages
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
+    virtual bool seek(FILE* file, const struct timeval* time, bool relative=false);
 
   private:
     const char* m_type;
@@ -115,4 +123,59 @@ class OvmsCanFormatFactory
 
 extern OvmsCanFormatFactory MyCanFormatFactory;
 
+/**
+ * canformat_cache: shares formatted frames between loggers using the same format
+ *
+ * Every logger formats its messages in its own task. While multiple loggers use
+ * the same stateless format (see canformat::IsStateless()), the first one to
+ * format a frame stores the output in a small hash table for the format, the
+ * others copy it from there. Entries are matched on the complete frame, log type
+ * and timestamp, so a hit yields exactly what the logger's own formatter would
+ * produce. Only frames are shared, status & info messages are formatted per logger.
+ */
+
+#define CANFORMAT_CACHE_SLOTS     64      // entries per shared format
+#define CANFORMAT_CACHE_SLOTSIZE  80      // max output length cached [bytes]
+
+class canformat_cache
+  {
+  public:
+    canformat_cache();
+    ~canformat_cache();
+
+  public:
+    void Attach(canformat* formatter);
+    void Detach(canformat* formatter);
+    size_t getinto(canformat* formatter, CAN_log_message_t* message, char* buffer, size_t size);
+    std::string GetStats();
+
+  protected:
+    typedef struct
+      {
+      CAN_log_type_t  type;
+      struct timeval  timestamp;
+      CAN_frame_t     frame;
+      uint16_t        len;                // 0 = unused
+      char            data[CANFORMAT_CACHE_SLOTSIZE];
+      } slot_t;
+
+    typedef struct
+      {
+      std::string     type;
+      int             users;              // loggers using the format
+      slot_t*         slots;              // allocated while shared (users > 1)
+      uint32_t        hits;
+      uint32_t        misses;
+      } entry_t;
+
+    entry_t* Find(const char* type);
+    static uint32_t Index(const CAN_log_message_t* message);
+
+  protected:
+    OvmsMutex           m_mutex;
+    std::list<entry_t>  m_entries;
+  };
+
+extern canformat_cache MyCanFormatCache;
+
 #endif // __CANFORMAT_H__
@@ -0,0 +1,325 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN log compact binary format
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "canformat-compact";
+
+#include "canformat_compact.h"
+#include <algorithm>
+#include "ovms_config.h"
+#include "ovms_vfs.h"
+
+static_assert(CANCOMPACT_MAXLEN <= CANFORMAT_GET_MAXLEN, "CANFORMAT_GET_MAXLEN too small for compact format");
+
+////////////////////////////////////////////////////////////////////////
+// Log file conversion
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * can log convert <format> <infile> <outfile> [filter…]
+ *  Converts a compact or CRTD log (detected by content) into the format
+ *  given. Filters apply to frames, info messages are kept. On compact input,
+ *  segments without matching frames or info messages are skipped by their
+ *  summary, frames of other IDs are skipped without decoding them.
+ */
+static void can_log_convert(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyConfig.ProtectedPath(argv[0]) || MyConfig.ProtectedPath(argv[1]))
+    {
+    writer->puts("Error: protected path");
+    return;
+    }
+
+  canfilter* filter = NULL;
+  if (argc > 2)
+    {
+    filter = new canfilter();
+    for (int k = 2; k < argc; k++)
+      {
+      if (!filter->AddFilter(argv[k]))
+        {
+        writer->printf("Error: filter '%s' is invalid\n", argv[k]);
+        delete filter;
+        return;
+        }
+      }
+    }
+
+  FILE* in = fopen(argv[0], "r");
+  if (!in)
+    {
+    writer->printf("Error: can't read from '%s'\n", argv[0]);
+    delete filter;
+    return;
+    }
+  uint8_t magic[4];
+  bool compact = (fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, "OVCL", 4) == 0);
+  rewind(in);
+
+  FILE* out = fopen(argv[1], "w");
+  if (!out)
+    {
+    writer->printf("Error: can't write to '%s'\n", argv[1]);
+    fclose(in);
+    delete filter;
+    return;
+    }
+
+  canformat* outfmt = MyCanFormatFactory.NewFormat(cmd->GetName());
+  std::string result = outfmt->getheader();
+  fwrite(result.data(), result.length(), 1, out);
+
+  uint32_t count = 0, filtered = 0, segments = 0, skipped = 0, resyncs = 0;
+  size_t outsize = result.length();
+  CAN_log_message_t msg;
+  uint8_t buf[CANFORMAT_SERVE_BUFFERSIZE];
+
+  auto output = [&](CAN_log_message_t* message)
+    {
+    result = outfmt->get(message);
+    fwrite(result.data(), result.length(), 1, out);
+    outsize += result.length();
+    count++;
+    };
+
+  if (compact)
+    {
+    cancompact_file file(in);
+    cancompact_decoder decoder;
+    cancompact_segment_t segment, next;
+    cancompact_summary_t summary;
+    decoder.SetFilter(filter);
+    bool valid = file.FindSegment(0, file.m_size, &segment);
+    while (valid)
+      {
+      bool hasnext = file.NextSegment(&segment, &next);
+      long end = hasnext ? next.offset : file.m_size;
+      segments++;
+      if (filter && file.ReadSummary(&segment, end, &summary)
+        && !(summary.flags & CANCOMPACT_FLAG_INFO) && !cancompact_file::Matches(&summary, filter))
+        {
+        skipped++;
+        }
+      else
+        {
+        decoder.Reset();
+        fseek(in, segment.offset, SEEK_SET);
+        long remain = end - segment.offset;
+        size_t len = 0;
+        while (remain > 0)
+          {
+          size_t rd = fread(buf+len, 1, std::min((long)(sizeof(buf)-len), remain), in);
+          if (rd == 0) break;
+          remain -= rd;
+          len += rd;
+          size_t pos = 0;
+          bool got;
+          uint8_t bus;
+          do
+            {
+            pos += decoder.Decode(buf+pos, len-pos, &msg, &bus, &got);
+            if (got)
+              {
+              msg.origin = (bus > 0) ? MyCan.GetBus(bus-1) : NULL;
+              output(&msg);
+              }
+            } while (got);
+          memmove(buf, buf+pos, len-pos);
+          len -= pos;
+          }
+        }
+      segment = next;
+      valid = hasnext;
+      }
+    filtered = decoder.m_filtered;
+    resyncs = decoder.m_resyncs;
+    }
+  else
+    {
+    canformat* infmt = MyCanFormatFactory.NewFormat("crtd");
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), in)) > 0)
+      {
+      size_t pos = 0;
+      while (true)
+        {
+        memset(&msg, 0, sizeof(msg));
+        bool hasmore = false;
+        pos += infmt->put(&msg, buf+pos, len-pos, &hasmore);
+        if (msg.type != CAN_LogNone)
+          {
+          if (filter && msg.type <= CAN_LogFrame_TX_Fail && !filter->IsFiltered(&msg.frame))
+            filtered++;
+          else
+            output(&msg);
+          }
+        if (!hasmore && pos >= len) break;
+        }
+      }
+    delete infmt;
+    }
+
+  result = outfmt->getfooter();
+  fwrite(result.data(), result.length(), 1, out);
+  outsize += result.length();
+
+  long insize = ftell(in);
+  fclose(in);
+  fclose(out);
+  delete outfmt;
+  delete filter;
+
+  writer->printf("Converted %s log '%s' (%ld bytes) to %s '%s' (%ld bytes): %" PRIu32 " messages",
+    compact ? "compact" : "crtd", argv[0], insize, cmd->GetName(), argv[1], (long)outsize, count);
+  if (filtered)
+    writer->printf(", %" PRIu32 " filtered", filtered);
+  if (compact)
+    writer->printf(", %" PRIu32 "/%" PRIu32 " segments skipped", skipped, segments);
+  if (resyncs)
+    writer->printf(", %" PRIu32 " format errors", resyncs);
+  writer->puts("");
+  }
+
+class OvmsCanFormatCompactInit
+  {
+  public: OvmsCanFormatCompactInit();
+} MyOvmsCanFormatCompactInit  __attribute__ ((init_priority (4555)));
+
+OvmsCanFormatCompactInit::OvmsCanFormatCompactInit()
+  {
+  ESP_LOGI(TAG, "Registering CAN Format: COMPACT (4555)");
+
+  MyCanFormatFactory.RegisterCanFormat<canformat_compact>("compact");
+
+  OvmsCommand* cmd_can = MyCommandApp.FindCommand("can");
+  OvmsCommand* cmd_can_log = cmd_can ? cmd_can->FindCommand("log") : NULL;
+  if (cmd_can_log)
+    {
+    OvmsCommand* convert = cmd_can_log->RegisterCommand("convert", "Convert CAN log file (compact or crtd)");
+    MyCanFormatFactory.RegisterCommandSet(convert, "Convert CAN log file to format",
+      can_log_convert,
+      "<infile> <outfile> [filter1] ... [filterN]\n"
+      "Filter: <bus> | <id>[-<id>] | <bus>:<id>[-<id>]\n"
+      "Example: 2:2a0-37f",
+      2, _COMMAND_TOKEN_NMB, true, vfs_file_validate);
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////
+// Compact format
+////////////////////////////////////////////////////////////////////////
+
+canformat_compact::canformat_compact(const char* type)
+  : canformat(type)
+  {
+  m_inlen = 0;
+  m_inpos = 0;
+  }
+
+canformat_compact::~canformat_compact()
+  {
+  }
+
+size_t canformat_compact::getinto(CAN_log_message_t* message, char* buffer, size_t size)
+  {
+  uint8_t bus = (message->origin != NULL) ? message->origin->m_busnumber + 1 : 0;
+  return m_encoder.Encode(message, bus, (uint8_t*)buffer, size);
+  }
+
+std::string canformat_compact::get(CAN_log_message_t* message)
+  {
+  char buf[CANCOMPACT_MAXLEN];
+  size_t len = getinto(message, buf, sizeof(buf));
+  return std::string(buf, len);
+  }
+
+std::string canformat_compact::getheader(struct timeval *time)
+  {
+  struct timeval t;
+  if (time == NULL)
+    {
+    gettimeofday(&t, NULL);
+    time = &t;
+    }
+  uint8_t buf[CANCOMPACT_FILEHDR];
+  size_t len = m_encoder.Header(buf, time);
+  return std::string((char*)buf, len);
+  }
+
+std::string canformat_compact::getfooter()
+  {
+  uint8_t buf[CANCOMPACT_TRAILERMAX];
+  size_t len = m_encoder.Close(buf);
+  return std::string((char*)buf, len);
+  }
+
+size_t canformat_compact::put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc)
+  {
+  // Refill the staging buffer when it may hold less than a complete record:
+  size_t consumed = 0;
+  if (len > 0 && m_inlen - m_inpos < CANCOMPACT_MAXLEN)
+    {
+    memmove(m_in, m_in+m_inpos, m_inlen-m_inpos);
+    m_inlen -= m_inpos;
+    m_inpos = 0;
+    consumed = std::min(len, sizeof(m_in) - m_inlen);
+    memcpy(m_in+m_inlen, buffer, consumed);
+    m_inlen += consumed;
+    }
+
+  bool got;
+  uint8_t bus;
+  m_inpos += m_decoder.Decode(m_in+m_inpos, m_inlen-m_inpos, message, &bus, &got);
+  if (got)
+    {
+    message->origin = (bus > 0) ? MyCan.GetBus(bus-1) : NULL;
+    *hasmore = true;
+    }
+  return consumed;
+  }
+
+bool canformat_compact::seek(FILE* file, const struct timeval* time, bool relative)
+  {
+  cancompact_file cf(file);
+  cancompact_segment_t segment;
+  int64_t target = (int64_t)time->tv_sec * 1000000 + time->tv_usec;
+  if (relative)
+    {
+    if (!cf.FindSegment(0, cf.m_size, &segment))
+      return false;
+    target += segment.start;
+    }
+  if (!cf.Seek(target, &segment))
+    return false;
+  if (fseek(file, segment.offset, SEEK_SET) != 0)
+    return false;
+
+  ESP_LOGD(TAG, "seek: segment #%" PRIu32 " at offset %ld", segment.sequence, segment.offset);
+  m_inlen = m_inpos = 0;
+  m_decoder.Reset();
+  m_decoder.SetSkipUntil(target);
+  return true;
+  }
@@ -0,0 +1,60 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN log compact binary format
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CANFORMAT_COMPACT_H__
+#define __CANFORMAT_COMPACT_H__
+
+#include "canformat.h"
+#include "cancompact.h"
+
+/**
+ * canformat_compact: indexed binary log format, see cancompact.h
+ *  Typically 3-5x smaller than CRTD, supports seeking by time (can play seek)
+ *  and skipping of segments by ID (can log convert with filters).
+ */
+class canformat_compact : public canformat
+  {
+  public:
+    canformat_compact(const char* type);
+    virtual ~canformat_compact();
+
+  public:
+    virtual std::string get(CAN_log_message_t* message);
+    virtual size_t getinto(CAN_log_message_t* message, char* buffer, size_t size);
+    virtual std::string getheader(struct timeval *time);
+    virtual std::string getfooter();
+    virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
+    virtual bool seek(FILE* file, const struct timeval* time, bool relative=false);
+
+  protected:
+    cancompact_encoder  m_encoder;
+    cancompact_decoder  m_decoder;
+    uint8_t             m_in[CANFORMAT_SERVE_BUFFERSIZE];   // put() staging buffer
+    size_t              m_inlen;
+    size_t              m_inpos;
+  };
+
+#endif // __CANFORMAT_COMPACT_H__
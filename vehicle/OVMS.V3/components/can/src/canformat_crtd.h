@@ -39,6 +39,8 @@ class canformat_crtd : public canformat
 
   public:
     virtual std::string get(CAN_log_message_t* message);
+    virtual bool IsStateless() { return true; }
+    virtual size_t getinto(CAN_log_message_t* message, char* buffer, size_t size);
     virtual std::string getheader(struct timeval *time);
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
   };
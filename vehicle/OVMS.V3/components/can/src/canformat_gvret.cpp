@@ -140,8 +140,8 @@ size_t canformat_gvret_ascii::put(CAN_log_message_t* message, uint8_t *buffer, s
     message->type = CAN_LogFrame_RX;
 
     uint32_t timestamp = strtol(b,&b,10);
-    message->timestamp.tv_sec = timestamp % 1000000;
-    message->timestamp.tv_usec = timestamp / 1000000;
+    message->timestamp.tv_sec = timestamp / 1000000;
+    message->timestamp.tv_usec = timestamp % 1000000;
 
     b += 2; // Skip the '-'
 
@@ -37,6 +37,7 @@ class canformat_panda : public canformat
 
   public:
     virtual std::string get(CAN_log_message_t* message);
+    virtual bool IsStateless() { return true; }
     virtual std::string getheader(struct timeval *time);
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
   };
@@ -53,13 +53,15 @@ canformat_pcap::~canformat_pcap()
   {
   }
 
-std::string canformat_pcap::get(CAN_log_message_t* message)
+size_t canformat_pcap::getinto(CAN_log_message_t* message, char* buffer, size_t size)
   {
   pcaprec_can_t m;
 
+  if (size < sizeof(m)) return 0;
+
   if (message->type != CAN_LogFrame_RX)
     {
-    return std::string("");
+    return 0;
     }
 
   memset(&m,0,sizeof(m));
@@ -77,12 +79,20 @@ std::string canformat_pcap::get(CAN_log_message_t* message)
   if (message->frame.FIR.B.DLC > 8)
     {
     ESP_LOGW(TAG, "DLC too long: %d", message->frame.FIR.B.DLC);
-    return std::string("");
+    return 0;
     }
   m.phdr.len = message->frame.FIR.B.DLC;
   memcpy(m.data, message->frame.data.u8, message->frame.FIR.B.DLC);
 
-  return std::string((const char*)&m, sizeof(m));
+  memcpy(buffer, &m, sizeof(m));
+  return sizeof(m);
+  }
+
+std::string canformat_pcap::get(CAN_log_message_t* message)
+  {
+  char buf[sizeof(pcaprec_can_t)];
+  size_t len = getinto(message, buf, sizeof(buf));
+  return std::string(buf, len);
   }
 
 std::string canformat_pcap::getheader(struct timeval *time)
@@ -156,6 +166,8 @@ size_t canformat_pcap::put(CAN_log_message_t* message, uint8_t *buffer, size_t l
     return consumed;
     }
   message->type = CAN_LogFrame_RX;
+  message->timestamp.tv_sec = be32toh(m.record.hdr.ts_sec);
+  message->timestamp.tv_usec = be32toh(m.record.hdr.ts_usec);
   message->frame.FIR.B.RTR = (idf & CANFORMAT_PCAP_FL_RTR)?CAN_RTR:CAN_no_RTR;
   message->frame.FIR.B.FF = (idf & CANFORMAT_PCAP_FL_EXT)?CAN_frame_ext:CAN_frame_std;
   message->frame.MsgID = idf & CANFORMAT_PCAP_FL_MASK;
@@ -53,12 +53,21 @@ canformat_raw::~canformat_raw()
   {
   }
 
-std::string canformat_raw::get(CAN_log_message_t* message)
+size_t canformat_raw::getinto(CAN_log_message_t* message, char* buffer, size_t size)
   {
   CAN_log_message_t raw;
+  if (size < sizeof(raw)) return 0;
   memcpy(&raw,message,sizeof(raw));
   raw.origin = (canbus*)raw.origin->m_busnumber;
-  return std::string((const char*)&raw,sizeof(CAN_log_message_t));
+  memcpy(buffer,&raw,sizeof(raw));  // buffer may be unaligned
+  return sizeof(raw);
+  }
+
+std::string canformat_raw::get(CAN_log_message_t* message)
+  {
+  char buf[sizeof(CAN_log_message_t)];
+  size_t len = getinto(message, buf, sizeof(buf));
+  return std::string(buf,len);
   }
 
 std::string canformat_raw::getheader(struct timeval *time)
@@ -40,6 +40,7 @@ static const char *TAG = "canlog";
 #include "ovms_command.h"
 #include "ovms_events.h"
 #include "ovms_peripherals.h"
+#include "ovms_malloc.h"
 #include "metrics_standard.h"
 
 static const char *CAN_PARAM = "can";
@@ -107,6 +108,7 @@ void can_log_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
           }
         }
       #endif //#ifdef CONFIG_OVMS_SC_GPL_MONGOOSE
+      writer->puts(cl->GetQueueStats().c_str());
       }
     else
       {
@@ -142,6 +144,7 @@ void can_log_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
         }
       #endif //#ifdef CONFIG_OVMS_SC_GPL_MONGOOSE
       }
+    writer->printf("%s", MyCanFormatCache.GetStats().c_str());
     }
   }
 
@@ -234,30 +237,92 @@ void canlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
     return;
     }
 
-#ifdef CONFIG_OVMS_SC_GPL_MONGOOSE
-  // The standard base implemention here is for mongoose network connections
-  auto mglock = MongooseLock();
-  if (m_nc != NULL)
+  // The standard base implemention here is for network connections:
+  // collect the output in the send window, to be sent by Pump()
+  if (m_sendwindow.IsInitialised())
     {
-    if (result.length()>0)
-      {
-      if (m_nc->send_mbuf.len < 32768)
-        {
-        mg_send(m_nc, (const char*)result.c_str(), result.length());
-        }
-      else
-        {
-        m_dropcount++;
-        }
-      }
+    m_sendwindow.Add(result.data(), result.length(), esp_log_timestamp());
     }
   else
-#endif // CONFIG_OVMS_SC_GPL_MONGOOSE
     {
     m_dropcount++;
     }
   }
 
+/**
+ * Flush: commit the output collected, called by the logger task when
+ *  the log queue has been drained
+ */
+void canlogconnection::Flush()
+  {
+  m_sendwindow.Commit();
+  }
+
+/**
+ * InitSendWindow: allocate the send window for a network connection
+ *  Config (can): log[.<type>].window, log[.<type>].mtu, log[.<type>].overflow
+ */
+bool canlogconnection::InitSendWindow()
+  {
+  std::string prefix = std::string("log.") + m_logger->GetType() + ".";
+  int size = MyConfig.GetParamValueInt(CAN_PARAM, prefix + "window",
+    MyConfig.GetParamValueInt(CAN_PARAM, "log.window", CANLOG_SENDWINDOW_SIZE));
+  int mtu = MyConfig.GetParamValueInt(CAN_PARAM, prefix + "mtu",
+    MyConfig.GetParamValueInt(CAN_PARAM, "log.mtu", CANLOG_SENDWINDOW_MTU));
+  std::string overflow = MyConfig.GetParamValue(CAN_PARAM, prefix + "overflow",
+    MyConfig.GetParamValue(CAN_PARAM, "log.overflow", "dropnewest"));
+  if (size < 0) size = CANLOG_SENDWINDOW_SIZE;
+  if (mtu < 0) mtu = CANLOG_SENDWINDOW_MTU;
+
+  if (!m_sendwindow.Init(size, mtu, canlog_sendwindow::GetOverflowType(overflow)))
+    {
+    ESP_LOGE(TAG, "Unable to allocate send window for %s", m_peer.c_str());
+    return false;
+    }
+  return true;
+  }
+
+static bool canlogconnection_write(void* ctx, const char* data, size_t len)
+  {
+  return ((canlogconnection*)ctx)->SendWindowWrite(data, len);
+  }
+
+/**
+ * Pump: send the data waiting in the send window (as far as possible)
+ *  Called by the Mongoose task on MG_EV_POLL & MG_EV_SEND
+ *  Returns false if the connection shall be closed due to a window overflow
+ */
+bool canlogconnection::Pump()
+  {
+  m_sendwindow.Pump(canlogconnection_write, this, esp_log_timestamp());
+  if (m_sendwindow.IsOverflow())
+    {
+    ESP_LOGW(TAG, "Send window overflow on %s, closing connection", m_peer.c_str());
+    return false;
+    }
+  return true;
+  }
+
+/**
+ * SendWindowWrite: hand a chunk from the send window to the network stack
+ *  Returns false if the chunk cannot be taken now
+ */
+bool canlogconnection::SendWindowWrite(const char* data, size_t len)
+  {
+#ifdef CONFIG_OVMS_SC_GPL_MONGOOSE
+  // The standard base implemention here is for mongoose network connections
+  auto mglock = MongooseLock();
+  if (m_nc == NULL)
+    return false;
+  if (m_nc->send_mbuf.len + len > CANLOG_SENDWINDOW_INFLIGHT * m_sendwindow.GetMtu())
+    return false;
+  mg_send(m_nc, data, len);
+  return true;
+#else
+  return false;
+#endif // CONFIG_OVMS_SC_GPL_MONGOOSE
+  }
+
 void canlogconnection::TransmitCallback(uint8_t *buffer, size_t len)
   {
   ESP_LOGD(TAG,"TransmitCallback on %s (%d bytes)",m_peer.c_str(),len);
@@ -331,6 +396,8 @@ std::string canlogconnection::GetStats()
     << " Filtered:" << m_filtercount
     << " Rate:" << std::fixed << std::setprecision(1) << droprate << "%";
 
+  buf << m_sendwindow.GetStats(esp_log_timestamp());
+
   return buf.str();
   }
 
@@ -347,12 +414,20 @@ canlog::canlog(const char* type, std::string format, canformat::canformat_serve_
   m_mode = mode;
   m_formatter = MyCanFormatFactory.NewFormat(format.c_str());
   m_formatter->SetServeMode(mode);
+  MyCanFormatCache.Attach(m_formatter);
   m_filter = NULL;
   m_isopen = false;
 
   m_msgcount = 0;
   m_dropcount = 0;
   m_filtercount = 0;
+  m_waitcount = 0;
+  m_queuehwm = 0;
+  memset(m_fillhist, 0, sizeof(m_fillhist));
+  m_dropburst = 0;
+  memset(m_bursthist, 0, sizeof(m_bursthist));
+  m_queuewait = 0;
+  m_textheap = 0;
 
   using std::placeholders::_1;
   using std::placeholders::_2;
@@ -361,9 +436,38 @@ canlog::canlog(const char* type, std::string format, canformat::canformat_serve_
   MyEvents.RegisterEvent(IDTAG,"config.changed", std::bind(&canlog::UpdatedConfig, this, _1, _2));
   MyMetrics.RegisterListener(IDTAG, "*", std::bind(&canlog::MetricListener, this, _1));
 
-  int queuesize = MyConfig.GetParamValueInt(CAN_PARAM, "log.queuesize",100);
+  // Queue size: per logger type or general
+  std::string typequeuesize = std::string("log.") + type + ".queuesize";
+  m_queuesize = MyConfig.GetParamValueInt(CAN_PARAM, typequeuesize,
+    MyConfig.GetParamValueInt(CAN_PARAM, "log.queuesize", CANLOG_QUEUESIZE));
+  if (m_queuesize < 1) m_queuesize = CANLOG_QUEUESIZE;
+
+  // Text slab for info messages:
+  m_textslots = MyConfig.GetParamValueInt(CAN_PARAM, "log.textslots", CANLOG_TEXTSLOTS);
+  if (m_textslots < 0) m_textslots = 0;
+  if (m_textslots > m_queuesize) m_textslots = m_queuesize;
+  m_textslab = NULL;
+  m_textfree = NULL;
+  if (m_textslots > 0)
+    {
+    m_textslab = (char*) ExternalRamMalloc(m_textslots * CANLOG_TEXTSLOTSIZE);
+    m_textfree = m_textslab ? xQueueCreate(m_textslots, sizeof(char*)) : NULL;
+    if (!m_textfree)
+      {
+      ESP_LOGW(TAG, "Unable to allocate %d text slots, using heap", m_textslots);
+      if (m_textslab) free(m_textslab);
+      m_textslab = NULL;
+      m_textslots = 0;
+      }
+    for (int i = 0; i < m_textslots; i++)
+      {
+      char* slot = m_textslab + i * CANLOG_TEXTSLOTSIZE;
+      xQueueSend(m_textfree, &slot, 0);
+      }
+    }
+
   LoadConfig();
-  m_queue = xQueueCreate(queuesize, sizeof(CAN_log_message_t));
+  m_queue = xQueueCreate(m_queuesize, sizeof(CAN_log_message_t));
   xTaskCreatePinnedToCore(RxTask, "OVMS CanLog", 4096, (void*)this, 10, &m_task, CORE(1));
   }
 
@@ -388,23 +492,26 @@ canlog::~canlog()
     CAN_log_message_t msg;
     while (xQueueReceive(q, &msg, 0) == pdTRUE)
       {
-      switch (msg.type)
-        {
-        case CAN_LogInfo_Comment:
-        case CAN_LogInfo_Config:
-        case CAN_LogInfo_Event:
-        case CAN_LogInfo_Metric:
-          free(msg.text);
-          break;
-        default:
-          break;
-        }
+      if (IsTextMsg(msg.type))
+        TextFree(msg.text);
       }
     vQueueDelete(q);
     }
 
+  if (m_textfree)
+    {
+    vQueueDelete(m_textfree);
+    m_textfree = NULL;
+    }
+  if (m_textslab)
+    {
+    free(m_textslab);
+    m_textslab = NULL;
+    }
+
   if (m_formatter)
     {
+    MyCanFormatCache.Detach(m_formatter);
     delete m_formatter;
     m_formatter = NULL;
     }
@@ -420,23 +527,19 @@ void canlog::RxTask(void *context)
   {
   canlog* me = (canlog*) context;
   CAN_log_message_t msg;
+  TickType_t flushtime = xTaskGetTickCount();
   while (1)
     {
-    if (xQueueReceive(me->m_queue, &msg, (portTickType)portMAX_DELAY) == pdTRUE)
+    if (xQueueReceive(me->m_queue, &msg, pdMS_TO_TICKS(CANLOG_FLUSH_INTERVAL)) == pdTRUE)
       {
-      switch (msg.type)
-        {
-        case CAN_LogInfo_Comment:
-        case CAN_LogInfo_Config:
-        case CAN_LogInfo_Event:
-        case CAN_LogInfo_Metric:
-          me->OutputMsg(msg);
-          free(msg.text);
-          break;
-        default:
-          me->OutputMsg(msg);
-          break;
-        }
+      me->OutputMsg(msg);
+      if (IsTextMsg(msg.type))
+        me->TextFree(msg.text);
+      }
+    if (xTaskGetTickCount() - flushtime >= pdMS_TO_TICKS(CANLOG_FLUSH_INTERVAL))
+      {
+      me->Flush();
+      flushtime = xTaskGetTickCount();
       }
     }
   }
@@ -505,6 +608,15 @@ const char* canlog::GetFormat()
   return m_format.c_str();
   }
 
+/**
+ * Flush: push out output buffered by the logger (if any).
+ *  Called periodically by the RxTask, at least every CANLOG_FLUSH_INTERVAL ms
+ *  while messages are flowing, and once per interval when idle.
+ */
+void canlog::Flush()
+  {
+  }
+
 void canlog::OutputMsg(CAN_log_message_t& msg)
   {
   if (m_formatter == NULL)
@@ -519,23 +631,62 @@ void canlog::OutputMsg(CAN_log_message_t& msg)
     return;
     }
 
-  std::string result = m_formatter->get(&msg);
-  if (result.length()>0)
+  char buffer[CANFORMAT_GET_MAXLEN];
+  if (!m_formatter->IsStateless())
     {
+    // Stateful formats (e.g. compact) encode relative to the output sent
+    // before, so each connection needs its own encoder, started with the
+    // header it got on attach. Filtering needs to be done before encoding.
     OvmsRecMutexLock lock(&m_cmmutex);
     for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
       {
-      if (it->second->m_ispaused)
+      canlogconnection* clc = it->second;
+      if (clc->m_ispaused)
+        {
+        clc->m_msgcount++;
+        clc->m_discardcount++;
+        }
+      else if (clc->m_filters != NULL && !clc->m_filters->IsFiltered(&msg.frame))
         {
-        it->second->m_msgcount++;
-        it->second->m_discardcount++;
+        clc->m_msgcount++;
+        clc->m_filtercount++;
         }
       else
         {
-        it->second->OutputMsg(msg, result);
+        std::string result(buffer, clc->m_formatter->getinto(&msg, buffer, sizeof(buffer)));
+        if (result.length()>0)
+          clc->OutputMsg(msg, result);
         }
       }
     }
+  else
+    {
+    std::string result(buffer, MyCanFormatCache.getinto(m_formatter, &msg, buffer, sizeof(buffer)));
+    if (result.length()>0)
+      {
+      OvmsRecMutexLock lock(&m_cmmutex);
+      for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+        {
+        if (it->second->m_ispaused)
+          {
+          it->second->m_msgcount++;
+          it->second->m_discardcount++;
+          }
+        else
+          {
+          it->second->OutputMsg(msg, result);
+          }
+        }
+      }
+    }
+
+  // Coalesce network output while more messages are waiting:
+  if (uxQueueMessagesWaiting(m_queue) == 0 && m_connmap.size() > 0)
+    {
+    OvmsRecMutexLock lock(&m_cmmutex);
+    for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+      it->second->Flush();
+    }
   }
 
 std::string canlog::GetInfo()
@@ -585,6 +736,34 @@ std::string canlog::GetStats()
   return buf.str();
   }
 
+/**
+ * GetQueueStats: queue & text slab usage details
+ */
+std::string canlog::GetQueueStats()
+  {
+  std::ostringstream buf;
+  uint32_t textfree = m_textfree ? uxQueueMessagesWaiting(m_textfree) : 0;
+
+  buf << "  Queue:" << uxQueueMessagesWaiting(m_queue) << "/" << m_queuesize
+    << " HWM:" << m_queuehwm
+    << " Fill:";
+  for (int i = 0; i < CANLOG_FILL_BUCKETS; i++)
+    buf << (i ? "/" : "") << m_fillhist[i];
+  buf << " (quarters)";
+  if (m_queuewait > 0)
+    buf << " Blocked:" << m_waitcount << " (max " << m_queuewait * portTICK_PERIOD_MS << "ms)";
+  buf << "\n  Drop bursts:";
+  for (int i = 0; i < CANLOG_BURST_BUCKETS; i++)
+    buf << (i ? "/" : "") << m_bursthist[i];
+  buf << " (1/2+/10+/100+/1000+)";
+  if (m_dropburst > 0)
+    buf << " Current:" << m_dropburst;
+  buf << "\n  Text slots:" << (m_textslots - textfree) << "/" << m_textslots
+    << " Heap:" << m_textheap;
+
+  return buf.str();
+  }
+
 void canlog::SetFilter(canfilter* filter)
   {
   if (m_filter)
@@ -611,11 +790,13 @@ void canlog::LogFrame(canbus* bus, CAN_log_type_t type, const CAN_frame_t* frame
     {
     CAN_log_message_t msg;
     msg.type = type;
-    gettimeofday(&msg.timestamp,NULL);
+    if (type == CAN_LogFrame_RX || type == CAN_LogFrame_TX)
+      CAN_timestamp_to_timeval(frame->timestamp_us, &msg.timestamp);
+    else
+      gettimeofday(&msg.timestamp,NULL);
     memcpy(&msg.frame,frame,sizeof(CAN_frame_t));
     msg.frame.origin = bus;
-    m_msgcount++;
-    if (xQueueSend(m_queue, &msg, 0) != pdTRUE) m_dropcount++;
+    QueueMsg(msg);
     }
   else
     {
@@ -634,8 +815,7 @@ void canlog::LogStatus(canbus* bus, CAN_log_type_t type, const CAN_status_t* sta
     gettimeofday(&msg.timestamp,NULL);
     msg.origin = bus;
     memcpy(&msg.status,status,sizeof(CAN_status_t));
-    m_msgcount++;
-    if (xQueueSend(m_queue, &msg, 0) != pdTRUE) m_dropcount++;
+    QueueMsg(msg);
     }
   else
     {
@@ -653,12 +833,16 @@ void canlog::LogInfo(canbus* bus, CAN_log_type_t type, const char* text)
     msg.type = type;
     gettimeofday(&msg.timestamp,NULL);
     msg.origin = bus;
-    msg.text = strdup(text);
-    m_msgcount++;
-    if (xQueueSend(m_queue, &msg, 0) != pdTRUE)
+    msg.text = TextAlloc(text);
+    if (!msg.text)
       {
+      m_msgcount++;
       m_dropcount++;
-      free(msg.text);
+      m_dropburst++;
+      }
+    else if (!QueueMsg(msg))
+      {
+      TextFree(msg.text);
       }
     }
   else
@@ -666,3 +850,82 @@ void canlog::LogInfo(canbus* bus, CAN_log_type_t type, const char* text)
     m_filtercount++;
     }
   }
+
+/**
+ * QueueMsg: send a message to the logger task
+ *  If the queue is full, the message is dropped, or if the logger allows,
+ *  the producer waits up to m_queuewait for the logger to catch up.
+ *  Updates the queue fill & drop burst statistics.
+ */
+bool canlog::QueueMsg(CAN_log_message_t& msg)
+  {
+  m_msgcount++;
+
+  if (xQueueSend(m_queue, &msg, 0) != pdTRUE)
+    {
+    if (m_queuewait == 0 || xTaskGetCurrentTaskHandle() == m_task ||
+        xQueueSend(m_queue, &msg, m_queuewait) != pdTRUE)
+      {
+      m_dropcount++;
+      m_dropburst++;
+      return false;
+      }
+    m_waitcount++;
+    }
+
+  if (m_dropburst > 0)
+    {
+    // drop run ended, add to histogram:
+    int bucket = (m_dropburst >= 1000) ? 4 : (m_dropburst >= 100) ? 3
+               : (m_dropburst >= 10) ? 2 : (m_dropburst >= 2) ? 1 : 0;
+    m_bursthist[bucket]++;
+    m_dropburst = 0;
+    }
+
+  uint32_t fill = uxQueueMessagesWaiting(m_queue);
+  if (fill > m_queuehwm)
+    m_queuehwm = fill;
+  if (fill > 0)
+    m_fillhist[MIN((fill-1) * CANLOG_FILL_BUCKETS / m_queuesize, CANLOG_FILL_BUCKETS-1)]++;
+
+  return true;
+  }
+
+bool canlog::IsTextMsg(CAN_log_type_t type)
+  {
+  switch (type)
+    {
+    case CAN_LogInfo_Comment:
+    case CAN_LogInfo_Config:
+    case CAN_LogInfo_Event:
+    case CAN_LogInfo_Metric:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+/**
+ * TextAlloc: copy an info text into a free slab slot, or to the heap if
+ *  it is too long or all slots are in use.
+ */
+char* canlog::TextAlloc(const char* text)
+  {
+  size_t len = strlen(text) + 1;
+  char* slot;
+  if (len <= CANLOG_TEXTSLOTSIZE && m_textfree && xQueueReceive(m_textfree, &slot, 0) == pdTRUE)
+    {
+    memcpy(slot, text, len);
+    return slot;
+    }
+  m_textheap++;
+  return strdup(text);
+  }
+
+void canlog::TextFree(char* text)
+  {
+  if (text >= m_textslab && text < m_textslab + m_textslots * CANLOG_TEXTSLOTSIZE)
+    xQueueSend(m_textfree, &text, 0);
+  else
+    free(text);
+  }
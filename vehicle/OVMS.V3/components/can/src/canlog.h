@@ -30,6 +30,7 @@
 #include "freertos/semphr.h"
 #include "can.h"
 #include "canformat.h"
+#include "canlog_sendwindow.h"
 #include <sdkconfig.h>
 #ifdef CONFIG_OVMS_SC_GPL_MONGOOSE
 #include "ovms_netmanager.h"
@@ -37,6 +38,14 @@
 #include "ovms_metrics.h"
 #include "id_filter.h"
 
+#define CANLOG_FLUSH_INTERVAL   1000    // ms, max age of buffered log output
+#define CANLOG_QUEUESIZE        100     // default queue size [messages], config can log[.<type>].queuesize
+#define CANLOG_TEXTSLOTS        16      // default number of text slots, config can log.textslots
+#define CANLOG_TEXTSLOTSIZE     256     // text slot size [bytes], longer texts are allocated on the heap
+#define CANLOG_QUEUEWAIT_MAX    100     // ms, max producer block time (config can log.vfs.blockms)
+#define CANLOG_FILL_BUCKETS     4       // queue fill histogram: quarters of the queue size
+#define CANLOG_BURST_BUCKETS    5       // drop burst histogram: 1, 2-9, 10-99, 100-999, 1000+
+
 /**
  * canlog is the general interface and base implementation for all can loggers.
  *  It provides standard methods to open files and configure message filters
@@ -51,7 +60,15 @@
  *  a log can be written/streamed to a slow medium.
  *
  * Log entries can be frames, status or info messages (see CAN_LogEntry_t).
- * The timestamp of the original event is preserved.
+ * The timestamp of the original event is preserved. Info message texts are
+ *  copied into a preallocated slab of fixed size slots, so logging events &
+ *  metrics doesn't cause heap churn. If the queue is full, messages are
+ *  dropped, unless the logger allows blocking the producer (m_queuewait).
+ *
+ * Network connections (canlogconnection) coalesce the formatted messages into
+ *  MTU sized writes and buffer them in a bounded send window per connection
+ *  (see canlog_sendwindow), which is sent by the Mongoose task. So a slow
+ *  client neither blocks the logger task nor affects other clients.
  *
  * Note: loggers get messages for all interfaces, if a log format does not
  *  allow multiple buses within a file, the logger needs to manage a set
@@ -71,6 +88,13 @@ class canlogconnection
 
   public:
     virtual void OutputMsg(CAN_log_message_t& msg, std::string &result);
+    virtual void Flush();
+
+  public:
+    // Send window (network connections):
+    bool InitSendWindow();
+    bool Pump();
+    virtual bool SendWindowWrite(const char* data, size_t len);
 
   public:
     virtual void TransmitCallback(uint8_t *buffer, size_t len);
@@ -99,6 +123,7 @@ class canlogconnection
     uint32_t       m_dropcount;
     uint32_t       m_discardcount;
     uint32_t       m_filtercount;
+    canlog_sendwindow m_sendwindow;
   };
 
 class canlog
@@ -120,6 +145,7 @@ class canlog
     const char* GetType();
     const char* GetFormat();
     virtual std::string GetStats();
+    std::string GetQueueStats();
 
   public:
     // Methods expected to be implemented by sub-classes
@@ -128,6 +154,7 @@ class canlog
     virtual bool IsOpen();
     virtual std::string GetInfo();
     virtual void OutputMsg(CAN_log_message_t& msg);
+    virtual void Flush();
 
   public:
     virtual void SetFilter(canfilter* filter);
@@ -158,14 +185,31 @@ class canlog
   public:
     TaskHandle_t        m_task;
     QueueHandle_t       m_queue;
+    int                 m_queuesize;
+    TickType_t          m_queuewait;              // max producer block time on full queue, 0 = drop
     bool                m_isopen;
     uint32_t            m_msgcount;
     uint32_t            m_dropcount;
     uint32_t            m_filtercount;
+    uint32_t            m_waitcount;              // messages queued after blocking the producer
+    uint32_t            m_queuehwm;               // max queue fill level
+    uint32_t            m_fillhist[CANLOG_FILL_BUCKETS];    // queue fill level after queueing
+    uint32_t            m_dropburst;              // current run of dropped messages
+    uint32_t            m_bursthist[CANLOG_BURST_BUCKETS];  // lengths of drop runs
 
   protected:
     virtual void UpdatedConfig(std::string event, void* data);
     virtual void LoadConfig();
+    bool QueueMsg(CAN_log_message_t& msg);
+    char* TextAlloc(const char* text);
+    void TextFree(char* text);
+    static bool IsTextMsg(CAN_log_type_t type);
+
+  protected:
+    char*               m_textslab;               // m_textslots * CANLOG_TEXTSLOTSIZE bytes
+    int                 m_textslots;
+    QueueHandle_t       m_textfree;               // free text slots
+    uint32_t            m_textheap;               // texts allocated on the heap
 
   protected:
     IdFilter            m_events_filters;
@@ -0,0 +1,264 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN logging framework
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <sstream>
+#include <iomanip>
+#include "canlog_sendwindow.h"
+#include "ovms_malloc.h"
+
+canlog_sendwindow::canlog_sendwindow()
+  {
+  m_chunks = NULL;
+  m_data = NULL;
+  m_count = 0;
+  m_mtu = 0;
+  m_policy = DropNewest;
+  m_head = 0;
+  m_tail = 0;
+  m_used = 0;
+  m_overflow = false;
+
+  m_msgs = 0;
+  m_writes = 0;
+  m_bytes = 0;
+  m_dropped = 0;
+  m_overflows = 0;
+  m_usedhwm = 0;
+  m_lag = 0;
+  m_lagmax = 0;
+  m_ratetime = 0;
+  m_ratebytes = 0;
+  m_rate = 0;
+  }
+
+canlog_sendwindow::~canlog_sendwindow()
+  {
+  if (m_chunks) free(m_chunks);
+  if (m_data) free(m_data);
+  }
+
+canlog_sendwindow::overflow_t canlog_sendwindow::GetOverflowType(const std::string& name)
+  {
+  if (name == "dropoldest") return DropOldest;
+  if (name == "disconnect") return Disconnect;
+  return DropNewest;
+  }
+
+const char* canlog_sendwindow::GetOverflowName(overflow_t overflow)
+  {
+  switch (overflow)
+    {
+    case DropOldest:  return "dropoldest";
+    case Disconnect:  return "disconnect";
+    default:          return "dropnewest";
+    }
+  }
+
+/**
+ * Init: allocate the window
+ *  size: max bytes waiting to be sent, rounded up to full chunks (min 2)
+ *  mtu: max bytes per write, clamped to CANLOG_SENDWINDOW_MINMTU .. 8192
+ */
+bool canlog_sendwindow::Init(size_t size, size_t mtu, overflow_t overflow)
+  {
+  if (m_chunks) return true;
+
+  if (mtu < CANLOG_SENDWINDOW_MINMTU) mtu = CANLOG_SENDWINDOW_MINMTU;
+  if (mtu > 8192) mtu = 8192;
+  size_t count = (size + mtu - 1) / mtu;
+  if (count < 2) count = 2;
+
+  // Add the fill chunk:
+  count++;
+  m_data = (char*) ExternalRamMalloc(count * mtu);
+  m_chunks = (chunk_t*) ExternalRamMalloc(count * sizeof(chunk_t));
+  if (!m_data || !m_chunks)
+    {
+    if (m_data) free(m_data);
+    if (m_chunks) free(m_chunks);
+    m_data = NULL;
+    m_chunks = NULL;
+    return false;
+    }
+  memset(m_chunks, 0, count * sizeof(chunk_t));
+
+  m_count = count;
+  m_mtu = mtu;
+  m_policy = overflow;
+  return true;
+  }
+
+/**
+ * Add: append a message to the fill chunk, commit the chunk if the message
+ *  does not fit. Messages longer than the mtu are dropped.
+ *  Returns false if the message or a chunk has been dropped.
+ */
+bool canlog_sendwindow::Add(const char* data, size_t len, uint32_t now)
+  {
+  if (!m_chunks || len == 0) return true;
+  m_msgs++;
+
+  if (len > m_mtu)
+    {
+    m_dropped++;
+    return false;
+    }
+
+  bool ok = true;
+  chunk_t* fill = &m_chunks[m_tail];
+  if (fill->len + len > m_mtu)
+    {
+    ok = Commit();
+    fill = &m_chunks[m_tail];
+    }
+
+  if (fill->len == 0)
+    fill->time = now;
+  memcpy(m_data + m_tail * m_mtu + fill->len, data, len);
+  fill->len += len;
+  fill->msgs++;
+
+  return ok;
+  }
+
+/**
+ * Commit: move the fill chunk into the window, apply the overflow policy
+ *  if the window is full.
+ *  Returns false if a chunk has been dropped.
+ */
+bool canlog_sendwindow::Commit()
+  {
+  if (!m_chunks) return true;
+  chunk_t* fill = &m_chunks[m_tail];
+  if (fill->len == 0) return true;
+
+  OvmsMutexLock lock(&m_mutex);
+  bool ok = true;
+
+  if (m_used > 0)
+    {
+    // Append to the newest chunk waiting if possible, so small commits
+    // (log queue drained after few messages) don't waste window space:
+    size_t last = (m_tail + m_count - 1) % m_count;
+    chunk_t* chunk = &m_chunks[last];
+    if (chunk->len + fill->len <= m_mtu)
+      {
+      memcpy(m_data + last * m_mtu + chunk->len, m_data + m_tail * m_mtu, fill->len);
+      chunk->len += fill->len;
+      chunk->msgs += fill->msgs;
+      fill->len = 0;
+      fill->msgs = 0;
+      return ok;
+      }
+    }
+
+  if (m_used == m_count - 1)
+    {
+    m_overflows++;
+    ok = false;
+    if (m_policy == DropOldest)
+      {
+      m_dropped += m_chunks[m_head].msgs;
+      m_head = (m_head + 1) % m_count;
+      m_used--;
+      }
+    else
+      {
+      if (m_policy == Disconnect)
+        m_overflow = true;
+      m_dropped += fill->msgs;
+      fill->len = 0;
+      fill->msgs = 0;
+      return ok;
+      }
+    }
+
+  m_tail = (m_tail + 1) % m_count;
+  m_used++;
+  if (m_used > m_usedhwm) m_usedhwm = m_used;
+
+  fill = &m_chunks[m_tail];
+  fill->len = 0;
+  fill->msgs = 0;
+  return ok;
+  }
+
+/**
+ * Pump: send committed chunks, oldest first, until the window is empty or
+ *  the writer returns false (chunk not accepted, try again later).
+ *  Call this periodically from the network task, also to update the rate.
+ *  Returns the number of chunks sent.
+ */
+int canlog_sendwindow::Pump(writer_t writer, void* ctx, uint32_t now)
+  {
+  if (!m_chunks) return 0;
+  OvmsMutexLock lock(&m_mutex);
+  int sent = 0;
+
+  while (m_used > 0)
+    {
+    chunk_t* chunk = &m_chunks[m_head];
+    if (!writer(ctx, m_data + m_head * m_mtu, chunk->len))
+      break;
+    m_writes++;
+    m_bytes += chunk->len;
+    m_lag = now - chunk->time;
+    if (m_lag > m_lagmax) m_lagmax = m_lag;
+    m_head = (m_head + 1) % m_count;
+    m_used--;
+    sent++;
+    }
+
+  if (now - m_ratetime >= 1000)
+    {
+    m_rate = (m_bytes - m_ratebytes) * 1000 / (now - m_ratetime);
+    m_ratetime = now;
+    m_ratebytes = m_bytes;
+    }
+
+  return sent;
+  }
+
+std::string canlog_sendwindow::GetStats(uint32_t now)
+  {
+  std::ostringstream buf;
+  if (!m_chunks) return buf.str();
+
+  OvmsMutexLock lock(&m_mutex);
+  uint32_t lag = (m_used > 0) ? now - m_chunks[m_head].time : 0;
+
+  buf << " Window:" << m_used << "/" << (m_count - 1)
+    << " Peak:" << m_usedhwm
+    << " Writes:" << m_writes
+    << " Sent:" << m_bytes
+    << " Rate:" << std::fixed << std::setprecision(1) << (float) m_rate / 1024 << "kB/s"
+    << " Lag:" << lag << "ms"
+    << " Maxlag:" << m_lagmax << "ms"
+    << " Overflows:" << m_overflows
+    << " Lost:" << m_dropped
+    << " (" << GetOverflowName(m_policy) << ")";
+
+  return buf.str();
+  }
@@ -0,0 +1,137 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN logging framework
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CANLOG_SENDWINDOW_H__
+#define __CANLOG_SENDWINDOW_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include "ovms_mutex.h"
+
+#define CANLOG_SENDWINDOW_SIZE      65536   // default window size [bytes], config can log[.<type>].window
+#define CANLOG_SENDWINDOW_MTU       1460    // default write size [bytes], config can log[.<type>].mtu
+#define CANLOG_SENDWINDOW_MINMTU    512     // min write size (= CANFORMAT_GET_MAXLEN)
+#define CANLOG_SENDWINDOW_INFLIGHT  4       // writes handed to the network stack per connection
+
+/**
+ * canlog_sendwindow: bounded send queue of a network log connection
+ *
+ * The logger task appends formatted messages to a chunk of up to 'mtu' bytes,
+ *  and commits the chunk when it is full or the log queue has been drained.
+ *  The network task takes committed chunks from the window and sends each as
+ *  a single write (TCP) or datagram (UDP). A commit is merged into the newest
+ *  chunk waiting if that has room, so the window also fills up to its byte
+ *  size on small commits. Chunks only contain complete log messages, so
+ *  dropping a chunk does not break the stream format.
+ *
+ * If the client cannot keep up, the window fills up. The overflow policy then
+ *  decides which data gets lost:
+ *    - dropnewest: discard the chunk to be committed (default)
+ *    - dropoldest: discard the oldest chunk not yet sent
+ *    - disconnect: discard the chunk & request closing the connection
+ *
+ * The producer side (Add/Commit) is single threaded, the chunk being filled
+ *  is not visible to the consumer, so only commit & send need the lock.
+ *
+ * Times are given by the caller in milliseconds (monotonic), they are used
+ *  for the lag (age of the oldest message waiting) & throughput statistics.
+ */
+class canlog_sendwindow
+  {
+  public:
+    typedef enum
+      {
+      DropNewest = 0,
+      DropOldest,
+      Disconnect
+      } overflow_t;
+
+    typedef bool (*writer_t)(void* ctx, const char* data, size_t len);
+
+  public:
+    canlog_sendwindow();
+    ~canlog_sendwindow();
+
+  private:
+    canlog_sendwindow(const canlog_sendwindow&) = delete;
+    canlog_sendwindow& operator=(const canlog_sendwindow&) = delete;
+
+  public:
+    static overflow_t GetOverflowType(const std::string& name);
+    static const char* GetOverflowName(overflow_t overflow);
+
+  public:
+    bool Init(size_t size, size_t mtu, overflow_t overflow);
+    bool IsInitialised() const { return m_chunks != NULL; }
+    size_t GetMtu() const { return m_mtu; }
+
+  public:
+    // Producer:
+    bool Add(const char* data, size_t len, uint32_t now);
+    bool Commit();
+
+  public:
+    // Consumer:
+    int Pump(writer_t writer, void* ctx, uint32_t now);
+    bool IsOverflow() const { return m_overflow; }
+
+  public:
+    std::string GetStats(uint32_t now);
+
+  protected:
+    typedef struct
+      {
+      uint32_t          time;           // time of first message
+      uint16_t          len;            // bytes used
+      uint16_t          msgs;           // messages contained
+      } chunk_t;
+
+    chunk_t*            m_chunks;       // m_count chunk descriptors
+    char*               m_data;         // m_count * m_mtu bytes
+    size_t              m_count;        // chunks in ring, one is the fill chunk
+    size_t              m_mtu;
+    overflow_t          m_policy;
+
+    OvmsMutex           m_mutex;
+    size_t              m_head;         // oldest committed chunk
+    size_t              m_tail;         // fill chunk
+    size_t              m_used;         // committed chunks
+    bool                m_overflow;     // disconnect requested
+
+  protected:
+    uint32_t            m_msgs;         // messages added
+    uint32_t            m_writes;       // chunks sent
+    uint64_t            m_bytes;        // bytes sent
+    uint32_t            m_dropped;      // messages dropped on overflow
+    uint32_t            m_overflows;    // overflow events
+    uint32_t            m_usedhwm;      // max committed chunks
+    uint32_t            m_lag;          // lag of last chunk sent [ms]
+    uint32_t            m_lagmax;       // max lag [ms]
+    uint32_t            m_ratetime;     // rate calculation period start
+    uint64_t            m_ratebytes;    // bytes sent at period start
+    uint32_t            m_rate;         // bytes per second in last period
+  };
+
+#endif // __CANLOG_SENDWINDOW_H__
@@ -229,6 +229,7 @@ void canlog_tcpclient::MongooseHandler(struct mg_connection *nc, int ev, void *p
         canlogconnection* clc = new canlogconnection(this, m_format, m_mode);
         clc->m_nc = nc;
         clc->m_peer = m_path;
+        clc->InitSendWindow();
         m_connmap[nc] = clc;
         m_isopen = true;
         std::string result = clc->m_formatter->getheader();
@@ -278,6 +279,18 @@ void canlog_tcpclient::MongooseHandler(struct mg_connection *nc, int ev, void *p
         }
       break;
       }
+    case MG_EV_POLL:
+    case MG_EV_SEND:
+      {
+      // Send the output waiting in the connection's send window
+      OvmsRecMutexLock lock(&m_cmmutex);
+      auto k = m_connmap.find(nc);
+      if (k != m_connmap.end() && !k->second->Pump())
+        {
+        nc->flags |= MG_F_CLOSE_IMMEDIATELY;
+        }
+      break;
+      }
     default:
       break;
     }
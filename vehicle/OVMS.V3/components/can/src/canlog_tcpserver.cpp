@@ -233,6 +233,7 @@ void canlog_tcpserver::MongooseHandler(struct mg_connection *nc, int ev, void *p
       canlogconnection* clc = new canlogconnection(this, m_format, m_mode);
       clc->m_nc = nc;
       clc->m_peer = std::string(addr);
+      clc->InitSendWindow();
       m_connmap[nc] = clc;
       std::string result = clc->m_formatter->getheader();
       if (result.length()>0)
@@ -276,6 +277,19 @@ void canlog_tcpserver::MongooseHandler(struct mg_connection *nc, int ev, void *p
       break;
       }
 
+    case MG_EV_POLL:
+    case MG_EV_SEND:
+      {
+      // Send the output waiting in the connection's send window
+      OvmsRecMutexLock lock(&m_cmmutex);
+      auto k = m_connmap.find(nc);
+      if (k != m_connmap.end() && !k->second->Pump())
+        {
+        nc->flags |= MG_F_CLOSE_IMMEDIATELY;
+        }
+      break;
+      }
+
     default:
       break;
     }
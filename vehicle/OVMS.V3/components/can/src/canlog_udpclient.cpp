@@ -151,6 +151,7 @@ bool canlog_udpclient::Open()
         canlogconnection* clc = new canlogconnection(this, m_format, m_mode);
         clc->m_nc = nc;
         clc->m_peer = m_path;
+        clc->InitSendWindow();
         m_connmap[nc] = clc;
         m_isopen = true;
         return true;
@@ -239,6 +240,18 @@ void canlog_udpclient::MongooseHandler(struct mg_connection *nc, int ev, void *p
         }
       break;
       }
+    case MG_EV_POLL:
+    case MG_EV_SEND:
+      {
+      // Send the output waiting in the connection's send window
+      OvmsRecMutexLock lock(&m_cmmutex);
+      auto k = m_connmap.find(nc);
+      if (k != m_connmap.end() && !k->second->Pump())
+        {
+        nc->flags |= MG_F_CLOSE_IMMEDIATELY;
+        }
+      break;
+      }
     default:
       break;
     }
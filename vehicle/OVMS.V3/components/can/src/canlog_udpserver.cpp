@@ -30,6 +30,7 @@
 #include "ovms_log.h"
 static const char *TAG = "canlog-udpserver";
 
+#include <errno.h>
 #include "can.h"
 #include "canformat.h"
 #include "canlog_udpserver.h"
@@ -51,20 +52,20 @@ udpcanlogconnection::~udpcanlogconnection()
   {
   }
 
-void udpcanlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
+/**
+ * SendWindowWrite: send a chunk from the send window as a datagram
+ *  Returns false if the network stack cannot take it now (retry on next poll),
+ *  other send errors drop the chunk.
+ */
+bool udpcanlogconnection::SendWindowWrite(const char* data, size_t len)
   {
-  m_msgcount++;
-
-  if ((m_filters != NULL) && (! m_filters->IsFiltered(&msg.frame)))
-    {
-    m_filtercount++;
-    return;
-    }
-
-  if (result.length()>0)
+  if (sendto(m_sock, data, len, 0, &m_sa, sizeof(m_sa)) < 0)
     {
-    sendto(m_sock, (const char*)result.c_str(), result.length(), 0, &m_sa, sizeof(m_sa));
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOMEM)
+      return false;
+    m_dropcount++;
     }
+  return true;
   }
 
 void udpcanlogconnection::Tickle()
@@ -263,16 +264,18 @@ void canlog_udpserver::Ticker(std::string event, void* data)
   {
   OvmsRecMutexLock lock(&m_cmmutex);
 
-  for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+  for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); )
     {
     udpcanlogconnection* clc = (udpcanlogconnection*)it->second;
     if (clc->m_timeout < monotonictime)
       {
       // This client has timed out
       ESP_LOGD(TAG,"Timed out connection from %s",clc->m_peer.c_str());
-      m_connmap.erase(it);
+      it = m_connmap.erase(it);
       delete clc;
       }
+    else
+      ++it;
     }
   }
 
@@ -312,6 +315,7 @@ void canlog_udpserver::MongooseHandler(struct mg_connection *nc, int ev, void *p
       clc->m_sock = m_mgconn->sock;
       memcpy(&clc->m_sa,&nc->sa.sin,sizeof(nc->sa.sin));
       clc->m_peer = std::string(addr);
+      clc->InitSendWindow();
       m_connmap[&clc->m_fakenc] = clc;
       std::string result = clc->m_formatter->getheader();
       if (result.length()>0)
@@ -323,6 +327,26 @@ void canlog_udpserver::MongooseHandler(struct mg_connection *nc, int ev, void *p
 
       break;
       }
+    case MG_EV_POLL:
+    case MG_EV_SEND:
+      {
+      // Send the output waiting in the send windows of all clients
+      OvmsRecMutexLock lock(&m_cmmutex);
+      for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); )
+        {
+        udpcanlogconnection* clc = (udpcanlogconnection*)it->second;
+        if (clc->Pump())
+          {
+          ++it;
+          }
+        else
+          {
+          it = m_connmap.erase(it);
+          delete clc;
+          }
+        }
+      break;
+      }
     default:
       break;
     }
@@ -27,14 +27,21 @@
 #include "ovms_log.h"
 static const char *TAG = "canlog-vfs";
 
+#include <string.h>
+#include <sstream>
+#include <algorithm>
+
 #include "can.h"
 #include "canformat.h"
 #include "canlog_vfs.h"
 #include "ovms_utils.h"
+#include "ovms_malloc.h"
 #include "ovms_config.h"
 #include "ovms_peripherals.h"
 #include "ovms_vfs.h"
 
+static const char *CAN_PARAM = "can";
+
 void can_log_vfs_start(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   std::string format(cmd->GetName());
@@ -93,10 +100,27 @@ canlog_vfs_conn::canlog_vfs_conn(canlog* logger, std::string format, canformat::
   : canlogconnection(logger, format, mode), m_file_size(0)
   {
   m_file = NULL;
+  m_ring = NULL;
+  m_blocksize = 0;
+  m_blocks = 0;
+  m_freeq = NULL;
+  m_fullq = NULL;
+  m_writer = NULL;
+  m_writer_done = NULL;
+  m_cur = -1;
+  m_curlen = 0;
+  m_curcap = 0;
+  m_ringdrops = 0;
+  m_blocks_written = 0;
+  m_blocks_hwm = 0;
+  m_write_errors = 0;
+  m_write_time_max = 0;
+  m_write_time_sum = 0;
   }
 
 canlog_vfs_conn::~canlog_vfs_conn()
   {
+  StopWriter();
   if (m_file)
     {
     fclose(m_file);
@@ -104,7 +128,193 @@ canlog_vfs_conn::~canlog_vfs_conn()
     }
   }
 
-void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
+/**
+ * StartWriter: allocate the block ring & start the writer task
+ *  Returns false if the ring could not be set up, the connection then
+ *  falls back to writing each message directly.
+ */
+bool canlog_vfs_conn::StartWriter(size_t blocksize, int blocks)
+  {
+  m_ring = (char*) ExternalRamMalloc(blocksize * blocks);
+  if (!m_ring)
+    return false;
+  m_blocksize = blocksize;
+  m_blocks = blocks;
+  m_freeq = xQueueCreate(blocks, sizeof(int));
+  m_fullq = xQueueCreate(blocks+1, sizeof(canlog_vfs_block_t));
+  m_writer_done = xSemaphoreCreateBinary();
+  if (!m_freeq || !m_fullq || !m_writer_done)
+    {
+    StopWriter();
+    return false;
+    }
+  for (int i = 0; i < blocks; i++)
+    xQueueSend(m_freeq, &i, 0);
+
+  // Write whole blocks, bypass the stdio buffer:
+  setvbuf(m_file, NULL, _IONBF, 0);
+
+  if (xTaskCreatePinnedToCore(WriterTask, "OVMS CanLogVFS", 4096, (void*)this, 5, &m_writer, CORE(1)) != pdPASS)
+    {
+    m_writer = NULL;
+    StopWriter();
+    return false;
+    }
+  return true;
+  }
+
+/**
+ * StopWriter: flush the ring, wait for the writer to finish & free the ring
+ */
+void canlog_vfs_conn::StopWriter()
+  {
+  if (m_writer)
+    {
+    Flush();
+    canlog_vfs_block_t stop = { -1, 0 };
+    xQueueSend(m_fullq, &stop, portMAX_DELAY);
+    if (xSemaphoreTake(m_writer_done, pdMS_TO_TICKS(10000)) != pdTRUE)
+      {
+      ESP_LOGE(TAG, "%s: writer task stalled, aborting", m_peer.c_str());
+      vTaskDelete(m_writer);
+      }
+    m_writer = NULL;
+    }
+  if (m_writer_done)
+    {
+    vSemaphoreDelete(m_writer_done);
+    m_writer_done = NULL;
+    }
+  if (m_fullq)
+    {
+    vQueueDelete(m_fullq);
+    m_fullq = NULL;
+    }
+  if (m_freeq)
+    {
+    vQueueDelete(m_freeq);
+    m_freeq = NULL;
+    }
+  if (m_ring)
+    {
+    free(m_ring);
+    m_ring = NULL;
+    }
+  m_cur = -1;
+  }
+
+void canlog_vfs_conn::WriterTask(void* context)
+  {
+  canlog_vfs_conn* me = (canlog_vfs_conn*) context;
+  canlog_vfs_block_t block;
+  while (xQueueReceive(me->m_fullq, &block, portMAX_DELAY) == pdTRUE)
+    {
+    if (block.index < 0)
+      break;
+    int64_t start = esp_timer_get_time();
+    if (fwrite(me->m_ring + block.index * me->m_blocksize, block.len, 1, me->m_file) != 1)
+      me->m_write_errors++;
+    uint32_t time = esp_timer_get_time() - start;
+    if (time > me->m_write_time_max)
+      me->m_write_time_max = time;
+    me->m_write_time_sum += time;
+    me->m_blocks_written++;
+    xQueueSend(me->m_freeq, &block.index, portMAX_DELAY);
+    }
+  xSemaphoreGive(me->m_writer_done);
+  vTaskDelete(NULL);
+  }
+
+bool canlog_vfs_conn::NextBlock()
+  {
+  int index;
+  if (xQueueReceive(m_freeq, &index, 0) != pdTRUE)
+    return false;
+  m_cur = index;
+  m_curlen = 0;
+  // Keep file writes aligned to the block size after partial flushes:
+  m_curcap = m_blocksize - (m_file_size % m_blocksize);
+  return true;
+  }
+
+void canlog_vfs_conn::SubmitBlock()
+  {
+  if (m_cur < 0 || m_curlen == 0)
+    return;
+  canlog_vfs_block_t block = { m_cur, m_curlen };
+  xQueueSend(m_fullq, &block, portMAX_DELAY);
+  m_cur = -1;
+  uint32_t pending = uxQueueMessagesWaiting(m_fullq);
+  if (pending > m_blocks_hwm)
+    m_blocks_hwm = pending;
+  }
+
+/**
+ * Flush: submit the partially filled block (if any) for writing
+ */
+void canlog_vfs_conn::Flush()
+  {
+  if (m_ring)
+    SubmitBlock();
+  }
+
+/**
+ * FreeSpace: bytes that can be written to the ring without blocking
+ */
+size_t canlog_vfs_conn::FreeSpace()
+  {
+  size_t avail = uxQueueMessagesWaiting(m_freeq) * m_blocksize;
+  if (m_cur >= 0)
+    avail += m_curcap - m_curlen;
+  else if (avail > 0)
+    avail -= m_file_size % m_blocksize;
+  return avail;
+  }
+
+/**
+ * Write: append data to the ring, spanning blocks as necessary
+ *  Data is dropped as a whole if the ring has insufficient free space.
+ */
+void canlog_vfs_conn::Write(const char* data, size_t len)
+  {
+  if (len == 0)
+    return;
+
+  if (!m_ring)
+    {
+    fwrite(data, len, 1, m_file);
+    m_file_size += len;
+    return;
+    }
+
+  if (FreeSpace() < len)
+    {
+    m_ringdrops++;
+    m_dropcount++;
+    return;
+    }
+
+  while (len > 0)
+    {
+    if (m_cur < 0 && !NextBlock())
+      break;
+    size_t cnt = std::min(len, m_curcap - m_curlen);
+    memcpy(m_ring + m_cur * m_blocksize + m_curlen, data, cnt);
+    m_curlen += cnt;
+    m_file_size += cnt;
+    data += cnt;
+    len -= cnt;
+    if (m_curlen == m_curcap)
+      SubmitBlock();
+    }
+  }
+
+/**
+ * OutputMsg: format the message directly into the current ring block
+ *  Only if the block has less than CANFORMAT_GET_MAXLEN bytes left, the
+ *  message is formatted into a scratch buffer and copied across blocks.
+ */
+void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, canformat* formatter)
   {
   m_msgcount++;
 
@@ -114,11 +324,44 @@ void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
     return;
     }
 
-  if (result.length()>0)
+  if (m_ring && m_cur < 0)
+    NextBlock();
+
+  if (m_ring && m_cur >= 0 && m_curcap - m_curlen >= CANFORMAT_GET_MAXLEN)
+    {
+    size_t len = MyCanFormatCache.getinto(formatter, &msg, m_ring + m_cur * m_blocksize + m_curlen, m_curcap - m_curlen);
+    m_curlen += len;
+    m_file_size += len;
+    if (m_curlen == m_curcap)
+      SubmitBlock();
+    }
+  else
+    {
+    // Drop before formatting if the ring is full, so stateful formats
+    // (i.e. delta encoded timestamps) stay consistent:
+    if (m_ring && FreeSpace() < CANFORMAT_GET_MAXLEN)
+      {
+      m_ringdrops++;
+      m_dropcount++;
+      return;
+      }
+    char buffer[CANFORMAT_GET_MAXLEN];
+    size_t len = MyCanFormatCache.getinto(formatter, &msg, buffer, sizeof(buffer));
+    Write(buffer, len);
+    }
+  }
+
+void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
+  {
+  m_msgcount++;
+
+  if ((m_filters != NULL) && (! m_filters->IsFiltered(&msg.frame)))
     {
-    fwrite(result.c_str(),result.length(),1,m_file);
-    m_file_size += result.length();
+    m_filtercount++;
+    return;
     }
+
+  Write(result.data(), result.length());
   }
 
 
@@ -126,6 +369,10 @@ canlog_vfs::canlog_vfs(std::string path, std::string format)
   : canlog("vfs", format)
   {
   m_path = path;
+  // Optionally block producers on a full queue for lossless capture at lower rates:
+  int blockms = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.blockms", 0);
+  if (blockms > CANLOG_QUEUEWAIT_MAX) blockms = CANLOG_QUEUEWAIT_MAX;
+  if (blockms > 0) m_queuewait = std::max<TickType_t>(pdMS_TO_TICKS(blockms), 1);
   using std::placeholders::_1;
   using std::placeholders::_2;
   MyEvents.RegisterEvent(IDTAG, "sd.mounted", std::bind(&canlog_vfs::MountListener, this, _1, _2));
@@ -181,14 +428,20 @@ bool canlog_vfs::Open()
     return false;
     }
 
+  int blocksize = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.blocksize", CANLOG_VFS_BLOCKSIZE);
+  int blocks = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.blocks", CANLOG_VFS_BLOCKS);
+  blocksize = std::max(1024, std::min(32768, blocksize));
+  blocks = std::max(2, std::min(16, blocks));
+  if (!clc->StartWriter(blocksize, blocks))
+    {
+    ESP_LOGW(TAG, "Can't allocate %d x %d bytes write buffer for '%s', writing unbuffered",
+      blocks, blocksize, m_path.c_str());
+    }
+
   ESP_LOGI(TAG, "Now logging CAN messages to '%s'", m_path.c_str());
 
   std::string header = m_formatter->getheader();
-  if (header.length()>0)
-    {
-    fwrite(header.c_str(),header.length(),1,clc->m_file);
-    clc->m_file_size += header.length();
-    }
+  clc->Write(header.data(), header.length());
 
   m_connmap[NULL] = clc;
   m_isopen = true;
@@ -204,8 +457,11 @@ void canlog_vfs::Close()
       m_path.c_str(), GetStats().c_str());
 
     OvmsRecMutexLock lock(&m_cmmutex);
+    std::string footer = m_formatter->getfooter();
     for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
       {
+      if (footer.length() > 0)
+        static_cast<canlog_vfs_conn*>(it->second)->Write(footer.data(), footer.length());
       delete it->second;
       }
     m_connmap.clear();
@@ -214,6 +470,45 @@ void canlog_vfs::Close()
     }
   }
 
+void canlog_vfs::OutputMsg(CAN_log_message_t& msg)
+  {
+  if (m_formatter == NULL)
+    {
+    m_dropcount++;
+    return;
+    }
+
+  if (!m_isopen)
+    {
+    m_dropcount++;
+    return;
+    }
+
+  OvmsRecMutexLock lock(&m_cmmutex);
+  for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+    {
+    canlog_vfs_conn* clc = static_cast<canlog_vfs_conn*>(it->second);
+    if (clc->m_ispaused)
+      {
+      clc->m_msgcount++;
+      clc->m_discardcount++;
+      }
+    else
+      {
+      clc->OutputMsg(msg, m_formatter);
+      }
+    }
+  }
+
+void canlog_vfs::Flush()
+  {
+  OvmsRecMutexLock lock(&m_cmmutex);
+  for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+    {
+    static_cast<canlog_vfs_conn*>(it->second)->Flush();
+    }
+  }
+
 size_t canlog_vfs::GetFileSize()
   {
   size_t result = 0;
@@ -237,10 +532,29 @@ std::string canlog_vfs_conn::GetStats()
   result.append(bufsize);
   result.append(" ");
   result.append(canlogconnection::GetStats());
+  result.append(GetRingStats());
 
   return result;
   }
 
+std::string canlog_vfs_conn::GetRingStats()
+  {
+  if (!m_ring)
+    return std::string("");
+
+  std::ostringstream buf;
+  uint32_t avg = (m_blocks_written > 0) ? m_write_time_sum / m_blocks_written : 0;
+  buf << " Buffer:" << m_blocks << "x" << m_blocksize
+    << " Written:" << m_blocks_written
+    << " Pending:" << uxQueueMessagesWaiting(m_fullq) << "/" << m_blocks_hwm
+    << " Overflows:" << m_ringdrops
+    << " WriteTime:" << avg/1000 << "/" << m_write_time_max/1000 << "ms";
+  if (m_write_errors > 0)
+    buf << " WriteErrors:" << m_write_errors;
+
+  return buf.str();
+  }
+
 std::string canlog_vfs::GetStats()
   {
   char bufsize[15];
@@ -252,6 +566,12 @@ std::string canlog_vfs::GetStats()
   result.append(" ");
   result.append(canlog::GetStats());
 
+  OvmsRecMutexLock lock(&m_cmmutex);
+  for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+    {
+    result.append(static_cast<canlog_vfs_conn*>(it->second)->GetRingStats());
+    }
+
   return result;
   }
 
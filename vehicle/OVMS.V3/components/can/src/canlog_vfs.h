@@ -31,6 +31,24 @@
 #include "canlog.h"
 
 
+/**
+ * canlog_vfs_conn buffers formatted log output in a ring of fixed size blocks
+ *  (in SPIRAM if available). Messages are formatted directly into the current
+ *  block, full blocks are written by a dedicated writer task, so the logger
+ *  task never blocks on slow file I/O. Writes are aligned to the block size
+ *  (config can log.vfs.blocksize) to match the filesystem cluster size.
+ *  If the ring runs full, messages are dropped and counted.
+ */
+
+#define CANLOG_VFS_BLOCKSIZE    8192    // default block size [bytes]
+#define CANLOG_VFS_BLOCKS       4       // default number of blocks
+
+typedef struct
+  {
+  int         index;                    // block index, -1 = stop writer
+  size_t      len;                      // data length
+  } canlog_vfs_block_t;
+
 class canlog_vfs_conn: public canlogconnection
   {
   public:
@@ -38,12 +56,44 @@ class canlog_vfs_conn: public canlogconnection
     virtual ~canlog_vfs_conn();
 
   public:
+    bool StartWriter(size_t blocksize, int blocks);
+    void StopWriter();
     virtual void OutputMsg(CAN_log_message_t& msg, std::string &result);
+    void OutputMsg(CAN_log_message_t& msg, canformat* formatter);
+    void Write(const char* data, size_t len);
+    void Flush();
     virtual std::string GetStats();
+    std::string GetRingStats();
+
+  protected:
+    static void WriterTask(void* context);
+    bool NextBlock();
+    void SubmitBlock();
+    size_t FreeSpace();
 
   public:
     FILE*               m_file;
     size_t              m_file_size;
+
+  protected:
+    char*               m_ring;               // m_blocks * m_blocksize bytes
+    size_t              m_blocksize;
+    int                 m_blocks;
+    QueueHandle_t       m_freeq;              // free block indices
+    QueueHandle_t       m_fullq;              // canlog_vfs_block_t to write
+    TaskHandle_t        m_writer;
+    SemaphoreHandle_t   m_writer_done;
+    int                 m_cur;                // block being filled, -1 = none
+    size_t              m_curlen;             // fill level of current block
+    size_t              m_curcap;             // fill limit of current block
+
+  public:
+    uint32_t            m_ringdrops;          // messages dropped due to full ring
+    uint32_t            m_blocks_written;
+    uint32_t            m_blocks_hwm;         // max blocks pending write
+    uint32_t            m_write_errors;
+    uint32_t            m_write_time_max;     // block write latency [us]
+    uint64_t            m_write_time_sum;
   };
 
 
@@ -58,6 +108,8 @@ class canlog_vfs : public canlog
     virtual void Close();
     virtual std::string GetInfo();
     virtual size_t GetFileSize();
+    virtual void OutputMsg(CAN_log_message_t& msg);
+    virtual void Flush();
 
   public:
     virtual void MountListener(std::string event, void* data);
@@ -160,6 +160,36 @@ void can_play_speed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
     }
   }
 
+void can_play_seek(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (!MyCan.HasPlayer())
+    {
+    writer->puts("CAN playing inactive");
+    return;
+    }
+
+  // <time>: UNIX timestamp, or +<seconds> from the log start
+  const char* arg = argv[0];
+  bool relative = (*arg == '+');
+  if (relative) arg++;
+  double seconds = atof(arg);
+  struct timeval time;
+  time.tv_sec = (time_t) seconds;
+  time.tv_usec = (seconds - time.tv_sec) * 1000000;
+
+  OvmsMutexLock lock(&MyCan.m_playermap_mutex);
+  for (can::canplay_map_t::iterator it=MyCan.m_playermap.begin(); it!=MyCan.m_playermap.end(); ++it)
+    {
+    if (argc==2 && it->first != (uint32_t)atoi(argv[1]))
+      continue;
+    canplay* cl = it->second;
+    if (cl->Seek(&time, relative))
+      writer->printf("CAN player #%" PRId32 ": seeked to %s\n", it->first, argv[0]);
+    else
+      writer->printf("CAN player #%" PRId32 ": seek not supported\n", it->first);
+    }
+  }
+
 ////////////////////////////////////////////////////////////////////////
 // CAN Play System initialisation
 ////////////////////////////////////////////////////////////////////////
@@ -183,6 +213,8 @@ OvmsCanPlayInit::OvmsCanPlayInit()
   OvmsCommand* cmd_canplay = cmd_can->RegisterCommand("play", "CAN play framework");
   cmd_canplay->RegisterCommand("stop", "Stop playing", can_play_stop,"[<id>]",0,1);
   cmd_canplay->RegisterCommand("speed", "Set playback speed", can_play_speed,"<speed> [<id>]",1,2);
+  cmd_canplay->RegisterCommand("seek", "Seek to log time", can_play_seek,"<time>|+<seconds> [<id>]\n"
+    "<time>: UNIX timestamp, +<seconds>: offset from log start",1,2);
   cmd_canplay->RegisterCommand("status", "Playing status", can_play_status,"[<id>]",0,1);
   cmd_canplay->RegisterCommand("list", "Playing list", can_play_list);
   cmd_canplay->RegisterCommand("start", "CAN play start framework");
@@ -200,17 +232,23 @@ canplay::canplay(const char* type, std::string format, canformat::canformat_serv
   m_formatter->SetServeMode(mode);
   m_filter = NULL;
   m_speed = 1;
+  m_pace_logstart = 0;
+  m_pace_loglast = 0;
+  m_pace_start = 0;
 
   m_msgcount = 0;
-  xTaskCreatePinnedToCore(PlayTask, "OVMS CanPlay", 4096, (void*)this, 10, &m_task, CORE(1));
+  m_task = NULL;
+  m_task_done = xSemaphoreCreateBinary();
+  m_stopping = false;
   }
 
 canplay::~canplay()
   {
-  if (m_task)
+  Stop();
+  if (m_task_done)
     {
-    vTaskDelete(m_task);
-    m_task = NULL;
+    vSemaphoreDelete(m_task_done);
+    m_task_done = NULL;
     }
 
   if (m_formatter)
@@ -228,19 +266,116 @@ canplay::~canplay()
 
 void canplay::PlayTask(void *context)
   {
-//  canplay* me = (canplay*) context;
+  canplay* me = (canplay*) context;
+
+  CAN_log_message_t msg;
+  while (!me->m_stopping)
+    {
+    memset(&msg, 0, sizeof(msg));
+    if (me->IsOpen() && me->InputMsg(&msg))
+      me->Play(&msg);
+    else
+      vTaskDelay(pdMS_TO_TICKS(100));
+    }
+  xSemaphoreGive(me->m_task_done);
+  vTaskDelete(NULL);
+  }
 
-//  CAN_log_message_t msg;
-//  while (me->InputMsg(&msg))
-//    {
-//    vTaskDelay(pdMS_TO_TICKS(1000));
-//    }
+/**
+ * Start: start the play task (called by can::AddPlayer when fully constructed)
+ */
+void canplay::Start()
+  {
+  if (m_task == NULL && m_task_done != NULL)
+    {
+    m_stopping = false;
+    if (xTaskCreatePinnedToCore(PlayTask, "OVMS CanPlay", 4096, (void*)this, 10, &m_task, CORE(1)) != pdPASS)
+      {
+      ESP_LOGE(TAG, "Cannot start play task");
+      m_task = NULL;
+      }
+    }
+  }
 
-//  me->Close();
-  while(1)
+/**
+ * Stop: stop the play task & wait for it to exit
+ *  Must be called before a player is torn down, sub-class destructors
+ *  call it before releasing their input.
+ */
+void canplay::Stop()
+  {
+  if (m_task == NULL)
+    return;
+  m_stopping = true;
+  if (xSemaphoreTake(m_task_done, pdMS_TO_TICKS(10000)) != pdTRUE)
     {
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    ESP_LOGE(TAG, "Play task stalled, aborting");
+    vTaskDelete(m_task);
     }
+  m_task = NULL;
+  }
+
+/**
+ * Play: simulate or transmit a frame read from the input, paced by the log timestamps
+ */
+void canplay::Play(CAN_log_message_t* msg)
+  {
+  if (msg->type != CAN_LogFrame_RX && msg->type != CAN_LogFrame_TX)
+    return;
+  if (msg->frame.origin == NULL)
+    return;
+  if (m_filter && !m_filter->IsFiltered(&msg->frame))
+    return;
+
+  Pace(&msg->timestamp);
+  if (m_stopping)
+    return;
+  m_msgcount++;
+
+  msg->frame.timestamp_us = 0;  // new timestamp on injection
+  switch (m_formatter->GetServeMode())
+    {
+    case canformat::Simulate:
+      MyCan.IncomingFrame(&msg->frame);
+      break;
+    case canformat::Transmit:
+      msg->frame.origin->Write(&msg->frame, pdMS_TO_TICKS(500));
+      break;
+    default:
+      break;
+    }
+  }
+
+/**
+ * Pace: delay until the log time of the next frame is due
+ *  Frames are scheduled relative to a reference point (first frame, speed
+ *  change or log time jumping back), so tick granularity and processing
+ *  times do not accumulate. Frames without a timestamp are played immediately.
+ */
+void canplay::Pace(const struct timeval* timestamp)
+  {
+  if (timestamp->tv_sec == 0 && timestamp->tv_usec == 0)
+    return;
+
+  int64_t logtime = (int64_t)timestamp->tv_sec * 1000000 + timestamp->tv_usec;
+  int64_t now = esp_timer_get_time();
+
+  if (m_pace_logstart == 0 || logtime < m_pace_loglast)
+    {
+    m_pace_logstart = logtime;
+    m_pace_start = now;
+    }
+  else
+    {
+    int64_t due = m_pace_start + (logtime - m_pace_logstart) / ((m_speed > 0) ? m_speed : 1);
+    // Wait in slices, so a Stop() does not have to wait for long log gaps:
+    while (!m_stopping && due - now >= portTICK_PERIOD_MS * 1000)
+      {
+      vTaskDelay(pdMS_TO_TICKS(MIN(due - now, 100000) / 1000));
+      now = esp_timer_get_time();
+      }
+    }
+  m_pace_loglast = logtime;
   }
 
 const char* canplay::GetType()
@@ -256,6 +391,7 @@ const char* canplay::GetFormat()
 void canplay::SetSpeed(uint32_t speed)
   {
   m_speed = speed;
+  m_pace_logstart = 0; // resync pacing
   }
 
 bool canplay::InputMsg(CAN_log_message_t* msg)
@@ -263,6 +399,15 @@ bool canplay::InputMsg(CAN_log_message_t* msg)
   return false;
   }
 
+/**
+ * Seek: continue playing at a log time (relative: offset from the log start)
+ *  Returns false if not supported by the player or format.
+ */
+bool canplay::Seek(const struct timeval* time, bool relative)
+  {
+  return false;
+  }
+
 std::string canplay::GetInfo()
   {
   std::ostringstream buf;
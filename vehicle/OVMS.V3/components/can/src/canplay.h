@@ -42,6 +42,8 @@ class canplay : public InternalRamAllocated
 
   public:
     static void PlayTask(void* context);
+    void Start();
+    void Stop();
 
   public:
     const char* GetType();
@@ -56,6 +58,11 @@ class canplay : public InternalRamAllocated
     virtual bool IsOpen() = 0;
     virtual std::string GetInfo();
     virtual bool InputMsg(CAN_log_message_t* msg);
+    virtual bool Seek(const struct timeval* time, bool relative=false);
+
+  protected:
+    void Play(CAN_log_message_t* msg);
+    void Pace(const struct timeval* timestamp);
 
   public:
     virtual void SetFilter(canfilter* filter);
@@ -68,8 +75,15 @@ class canplay : public InternalRamAllocated
     canformat*          m_formatter;
     canfilter*          m_filter;
 
+  protected:
+    int64_t             m_pace_logstart;    // log time of pacing reference [us]
+    int64_t             m_pace_loglast;     // log time of last frame played [us]
+    int64_t             m_pace_start;       // esp_timer time of pacing reference [us]
+
   public:
     TaskHandle_t        m_task;
+    SemaphoreHandle_t   m_task_done;        // given by the play task on exit
+    volatile bool       m_stopping;
     uint32_t            m_msgcount;
   };
 
@@ -91,6 +91,8 @@ canplay_vfs::canplay_vfs(std::string path, std::string format)
   {
   m_file = NULL;
   m_path = path;
+  m_rlen = 0;
+  m_rpos = 0;
   using std::placeholders::_1;
   using std::placeholders::_2;
   MyEvents.RegisterEvent(IDTAG, "sd.mounted", std::bind(&canplay_vfs::MountListener, this, _1, _2));
@@ -99,6 +101,7 @@ canplay_vfs::canplay_vfs(std::string path, std::string format)
 
 canplay_vfs::~canplay_vfs()
   {
+  Stop();
   MyEvents.DeregisterEvent(IDTAG);
 
   if (m_file != NULL)
@@ -109,6 +112,8 @@ canplay_vfs::~canplay_vfs()
 
 bool canplay_vfs::Open()
   {
+  OvmsMutexLock lock(&m_filemutex);
+  m_rlen = m_rpos = 0;
   if (m_file)
     {
     fclose(m_file);
@@ -143,6 +148,7 @@ bool canplay_vfs::Open()
 
 void canplay_vfs::Close()
   {
+  OvmsMutexLock lock(&m_filemutex);
   if (m_file)
     {
     fclose(m_file);
@@ -175,8 +181,44 @@ void canplay_vfs::MountListener(std::string event, void* data)
 
 bool canplay_vfs::InputMsg(CAN_log_message_t* msg)
   {
+  OvmsMutexLock lock(&m_filemutex);
   if (m_file == NULL) return false;
   if (m_formatter == NULL) return false;
 
-  return false;
+  while (true)
+    {
+    memset(msg,0,sizeof(*msg));
+    bool hasmore = false;
+    size_t used = m_formatter->put(msg, m_rbuf+m_rpos, m_rlen-m_rpos, &hasmore);
+    m_rpos += used;
+    if (msg->frame.origin != NULL)
+      return true;
+
+    if (!hasmore && m_rpos >= m_rlen)
+      {
+      m_rpos = 0;
+      m_rlen = fread(m_rbuf, 1, sizeof(m_rbuf), m_file);
+      if (m_rlen == 0)
+        {
+        fclose(m_file);
+        m_file = NULL;
+        ESP_LOGI(TAG, "Finished vfs playback '%s': %s",
+          m_path.c_str(), GetStats().c_str());
+        return false;
+        }
+      }
+    }
+  }
+
+bool canplay_vfs::Seek(const struct timeval* time, bool relative)
+  {
+  OvmsMutexLock lock(&m_filemutex);
+  if (m_file == NULL) return false;
+  if (m_formatter == NULL) return false;
+
+  if (!m_formatter->seek(m_file, time, relative))
+    return false;
+  m_rlen = m_rpos = 0;
+  m_pace_logstart = 0; // resync pacing
+  return true;
   }
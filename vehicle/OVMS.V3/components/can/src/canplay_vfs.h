@@ -44,6 +44,7 @@ class canplay_vfs : public canplay
 
   public:
     virtual bool InputMsg(CAN_log_message_t* msg);
+    virtual bool Seek(const struct timeval* time, bool relative=false);
 
   public:
     virtual void MountListener(std::string event, void* data);
@@ -51,6 +52,12 @@ class canplay_vfs : public canplay
   public:
     std::string         m_path;
     FILE*               m_file;
+    OvmsMutex           m_filemutex;
+
+  protected:
+    uint8_t             m_rbuf[CANFORMAT_SERVE_BUFFERSIZE];
+    size_t              m_rlen;
+    size_t              m_rpos;
   };
 
 #endif // __CANPLAY_VFS_H__
@@ -0,0 +1,57 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN status counters
+;    Date:          17th October 2026
+;
+;    (C) 2011-2026  Mark Webb-Johnson
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CAN_STATUS_H__
+#define __CAN_STATUS_H__
+
+// Included by can.h. Kept free of framework dependencies, so host builds
+// (components/can/tests) use the same definition as the firmware.
+
+#include <stdint.h>
+
+// CAN status
+typedef struct
+  {
+  uint32_t interrupts;              // interrupts
+  uint32_t packets_rx;              // frames reveiced
+  uint32_t packets_tx;              // frames sent successfully
+  uint32_t txbuf_delay;             // frames routed through TX queue
+  uint16_t rxbuf_overflow;          // frames lost due to RX buffers full
+  uint16_t txbuf_overflow;          // TX queue overflows
+  uint32_t tx_fails;                // TX failures/aborts
+  uint32_t error_flags;             // driver specific bitset
+  uint16_t errors_rx;               // RX error counter
+  uint16_t errors_tx;               // TX error counter
+  uint16_t invalid_rx;              // RX invalid frame counter
+  uint16_t watchdog_resets;         // Watchdog reset counter
+  uint16_t error_resets;            // Error resolving reset counter
+  uint32_t error_time;              // monotonictime of last error state detection
+  uint16_t isr_queue_overrun;       // ISR->task service ping dropped (queue full); not a lost
+                                     // frame -- raw data stays latched in the HW RX buffer, the
+                                     // RX-stall watchdog is the backstop that re-arms the line
+  } CAN_status_t;
+
+#endif // __CAN_STATUS_H__
@@ -0,0 +1,165 @@
+// bench_canfilter.cpp — Native laptop benchmark for the compiled canfilter.
+//
+// Compares the compiled canfilter (ID bitmap + sorted ranges per bus) with
+// the former linear walk of the filter list, across filter counts. Results
+// of both forms are checked for equality on every frame.
+//
+// Run:  make bench   (from the tests/ directory)
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Reference: the former list based canfilter::IsFiltered()
+// ---------------------------------------------------------------------------
+
+struct RefFilter {
+    std::list<CAN_filter_t> filters;
+
+    void Add(uint8_t bus, uint32_t from, uint32_t to) {
+        filters.push_back(CAN_filter_t{bus, from, to});
+    }
+
+    bool IsFiltered(const CAN_frame_t* p_frame) const {
+        if (filters.empty()) return true;
+        uint8_t buskey = 0;
+        if (p_frame->origin)
+            buskey = p_frame->origin->m_busnumber + 1;
+        for (const CAN_filter_t& f : filters) {
+            if (f.bus && f.bus != buskey) continue;
+            if (p_frame->MsgID >= f.id_from && p_frame->MsgID <= f.id_to)
+                return true;
+        }
+        return false;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Test data
+// ---------------------------------------------------------------------------
+
+static canbus g_bus[3];
+
+static void make_filters(std::mt19937& rng, int count, canfilter& cf, RefFilter& ref) {
+    std::uniform_int_distribution<int> kind(0, 9), bus(0, 3);
+    std::uniform_int_distribution<uint32_t> stdid(0, 0x7ff), extid(0x18da0000, 0x18dbffff), len(0, 15);
+    for (int i = 0; i < count; i++) {
+        int k = kind(rng);
+        uint8_t b = bus(rng);
+        uint32_t from, to;
+        if (k < 7) {                      // single standard ID
+            from = to = stdid(rng);
+        } else if (k < 9) {               // standard ID range
+            from = stdid(rng);
+            to = std::min<uint32_t>(from + len(rng), 0x7ff);
+        } else {                          // extended ID range
+            from = extid(rng);
+            to = from + len(rng) * 16;
+        }
+        cf.AddFilter(b, from, to);
+        ref.Add(b, from, to);
+    }
+}
+
+static std::vector<CAN_frame_t> make_frames(std::mt19937& rng, int count) {
+    std::uniform_int_distribution<int> kind(0, 9), bus(0, 3);
+    std::uniform_int_distribution<uint32_t> stdid(0, 0x7ff), extid(0x18da0000, 0x18dbffff);
+    std::vector<CAN_frame_t> frames(count);
+    for (CAN_frame_t& f : frames) {
+        memset(&f, 0, sizeof(f));
+        int b = bus(rng);
+        f.origin = (b < 3) ? &g_bus[b] : nullptr;
+        if (kind(rng) < 8) {
+            f.FIR.B.FF = CAN_frame_std;
+            f.MsgID = stdid(rng);
+        } else {
+            f.FIR.B.FF = CAN_frame_ext;
+            f.MsgID = extid(rng);
+        }
+    }
+    return frames;
+}
+
+template <typename F>
+static double time_ns_per_frame(const std::vector<CAN_frame_t>& frames, int loops, F fn, size_t& hits) {
+    auto t0 = std::chrono::steady_clock::now();
+    hits = 0;
+    for (int l = 0; l < loops; l++)
+        for (const CAN_frame_t& f : frames)
+            hits += fn(&f);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)frames.size() * loops);
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+int main() {
+    int failures = 0;
+    for (int i = 0; i < 3; i++) g_bus[i].m_busnumber = i;
+
+    std::mt19937 rng(4711);
+    std::vector<CAN_frame_t> frames = make_frames(rng, 100000);
+    const int loops = 10;
+
+    printf("%8s %12s %12s %8s %10s\n", "filters", "list ns/f", "comp ns/f", "speedup", "hits");
+    for (int count : {1, 2, 5, 10, 20, 50, 100, 200, 500}) {
+        canfilter cf;
+        RefFilter ref;
+        make_filters(rng, count, cf, ref);
+
+        for (const CAN_frame_t& f : frames) {
+            if (cf.IsFiltered(&f) != ref.IsFiltered(&f)) {
+                printf("  FAIL: %d filters, bus %d, id 0x%x\n", count,
+                       f.origin ? f.origin->m_busnumber : -1, f.MsgID);
+                failures++;
+                break;
+            }
+        }
+
+        size_t hits_ref, hits_cf;
+        double t_ref = time_ns_per_frame(frames, loops, [&](const CAN_frame_t* f) { return ref.IsFiltered(f); }, hits_ref);
+        double t_cf = time_ns_per_frame(frames, loops, [&](const CAN_frame_t* f) { return cf.IsFiltered(f); }, hits_cf);
+        if (hits_ref != hits_cf) failures++;
+        printf("%8d %12.1f %12.1f %7.1fx %10zu\n", count, t_ref, t_cf, t_ref / t_cf, hits_cf / loops);
+    }
+
+    // RemoveFilter recompiles, bus filters:
+    canfilter cf;
+    cf.AddFilter(1, 0x100, 0x1ff);
+    cf.AddFilter(0, 0x18daf100, 0x18daf1ff);
+    cf.AddFilter(2, 0x7e8, 0x7e8);
+    CAN_frame_t f{};
+    f.origin = &g_bus[0];
+    f.MsgID = 0x150;
+    if (!cf.IsFiltered(&f)) { printf("  FAIL: 0x150 on can1\n"); failures++; }
+    cf.RemoveFilter(1, 0x100, 0x1ff);
+    if (cf.IsFiltered(&f)) { printf("  FAIL: 0x150 on can1 after remove\n"); failures++; }
+    f.FIR.B.FF = CAN_frame_ext;
+    f.MsgID = 0x18daf1aa;
+    if (!cf.IsFiltered(&f)) { printf("  FAIL: 0x18daf1aa on any bus\n"); failures++; }
+    if (cf.IsFiltered(&g_bus[0]) || !cf.IsFiltered(&g_bus[1])) { printf("  FAIL: bus filter\n"); failures++; }
+    cf.ClearFilters();
+    if (!cf.IsFiltered(&f) || !cf.IsFiltered(&g_bus[0])) { printf("  FAIL: cleared filter\n"); failures++; }
+
+    // ID sets keyed by frame format:
+    canidset ids;
+    ids.Add(0, 0x7df, 0x7df, CAN_frame_std);
+    ids.Add(1, 0x18db33f1, 0x18db33f1, CAN_frame_ext);
+    f.origin = &g_bus[0];
+    f.FIR.B.FF = CAN_frame_std; f.MsgID = 0x7df;
+    if (!ids.Contains(&f)) { printf("  FAIL: idset std 0x7df\n"); failures++; }
+    f.FIR.B.FF = CAN_frame_ext;
+    if (ids.Contains(&f)) { printf("  FAIL: idset ext 0x7df\n"); failures++; }
+    f.MsgID = 0x18db33f1;
+    if (!ids.Contains(&f)) { printf("  FAIL: idset ext 0x18db33f1 on can1\n"); failures++; }
+    f.origin = &g_bus[1];
+    if (ids.Contains(&f)) { printf("  FAIL: idset ext 0x18db33f1 on can2\n"); failures++; }
+
+    printf("\n%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+// mock_can.hpp — Minimal CAN framework types for native laptop builds.
+// Included via -include flag. Defines the can.h include guard, so the
+// component sources pick up these stubs instead of the ESP-IDF based can.h.
+
+#pragma once
+
+#define __CAN_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <sys/time.h>
+
+#define CAN_MAXBUSES 5
+
+typedef enum { CAN_frame_std = 0, CAN_frame_ext = 1 } CAN_frame_format_t;
+typedef enum { CAN_no_RTR = 0, CAN_RTR = 1 } CAN_RTR_t;
+
+typedef union {
+    struct { uint8_t DLC:4; unsigned int unknown_2:2; CAN_RTR_t RTR:1; CAN_frame_format_t FF:1; } B;
+    uint32_t U;
+} CAN_FIR_t;
+
+class canbus {
+public:
+    int m_busnumber = 0;
+};
+
+typedef struct CAN_frame_t CAN_frame_t;
+struct CAN_frame_t {
+    canbus*   origin;
+    void*     callback;
+    CAN_FIR_t FIR;
+    uint32_t  MsgID;
+    union { uint8_t u8[8]; uint32_t u32[2]; uint64_t u64; } data;
+    uint32_t  timestamp_us;
+};
+
+#include "canstatus.h"
+
+typedef enum {
+    CAN_LogNone = 0, CAN_LogFrame_RX, CAN_LogFrame_TX, CAN_LogFrame_TX_Queue, CAN_LogFrame_TX_Fail,
+    CAN_LogStatus_Error, CAN_LogStatus_Statistics,
+    CAN_LogInfo_Comment, CAN_LogInfo_Config, CAN_LogInfo_Event, CAN_LogInfo_Metric,
+} CAN_log_type_t;
+
+typedef struct {
+    CAN_log_type_t type;
+    struct timeval timestamp;
+    union {
+        CAN_frame_t frame;
+        struct { canbus* origin; union { CAN_status_t status; char* text; }; };
+    };
+} CAN_log_message_t;
+
+#include "canfilter.h"
@@ -0,0 +1,30 @@
+// ovms_mutex.h — Minimal OvmsMutex stand-in (std::mutex) for native laptop builds.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+typedef uint32_t TickType_t;
+#define portMAX_DELAY 0xffffffffUL
+
+class OvmsMutex {
+public:
+    bool Lock(TickType_t timeout = portMAX_DELAY) { (void)timeout; m_mutex.lock(); return true; }
+    void Unlock() { m_mutex.unlock(); }
+private:
+    std::mutex m_mutex;
+};
+
+class OvmsMutexLock {
+public:
+    OvmsMutexLock(OvmsMutex* mutex, TickType_t timeout = portMAX_DELAY)
+        : m_mutex(mutex), m_locked(mutex->Lock(timeout)) {}
+    OvmsMutexLock(const OvmsMutexLock&) = delete;
+    OvmsMutexLock& operator=(const OvmsMutexLock&) = delete;
+    ~OvmsMutexLock() { if (m_locked) m_mutex->Unlock(); }
+    bool IsLocked() const { return m_locked; }
+private:
+    OvmsMutex* m_mutex;
+    bool m_locked;
+};
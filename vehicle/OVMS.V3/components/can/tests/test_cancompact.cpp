@@ -0,0 +1,341 @@
+// test_cancompact.cpp — Native laptop tests for the compact binary CAN log codec.
+//
+// Converts the CRTD logs of the corpus into the compact format and checks:
+//   - lossless round trip (decoding in random chunk sizes)
+//   - size reduction vs. CRTD
+//   - seeking by time via the segment index
+//   - segment skipping & frame filtering by ID
+//   - resynchronisation after corrupted & lost data
+//   - status records & the closing trailer
+//
+// Run:  make test   (from the tests/ directory)
+
+#include "cancompact.h"
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; \
+    printf("  FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+// ---------------------------------------------------------------------------
+// Corpus: minimal CRTD reader (frames & info records as written by OVMS)
+// ---------------------------------------------------------------------------
+
+struct Msg {
+    CAN_log_message_t m;
+    uint8_t bus;
+    std::string text;
+};
+
+static int64_t MsgTime(const Msg& msg) {
+    return (int64_t)msg.m.timestamp.tv_sec * 1000000 + msg.m.timestamp.tv_usec;
+}
+
+static bool ParseCRTD(const char* line, Msg* msg) {
+    memset(&msg->m, 0, sizeof(msg->m));
+    char* p;
+    msg->m.timestamp.tv_sec = strtoul(line, &p, 10);
+    if (*p != '.') return false;
+    msg->m.timestamp.tv_usec = strtoul(p+1, &p, 10);
+    if (*p++ != ' ') return false;
+    msg->bus = *p++ - '0';
+    std::string rec(p, 3);
+    p += 3;
+    if (rec == "CEV" || rec == "CMT" || rec == "CXX") {
+        std::string rest(p+1);
+        size_t sp = rest.find(' ');
+        std::string tname = rest.substr(0, sp);
+        msg->text = rest.substr(sp+1);
+        msg->m.type = (rec == "CEV") ? CAN_LogInfo_Event
+                    : (rec == "CMT") ? CAN_LogInfo_Metric
+                    : (tname == "Comment") ? CAN_LogInfo_Comment : CAN_LogInfo_Config;
+        msg->m.text = NULL;
+        return true;
+    }
+    msg->m.type = (rec[0] == 'T') ? CAN_LogFrame_TX : CAN_LogFrame_RX;
+    msg->m.frame.FIR.B.FF = (rec.substr(1) == "29") ? CAN_frame_ext : CAN_frame_std;
+    msg->m.frame.MsgID = strtoul(p, &p, 16);
+    int dlc = 0;
+    while (*p == ' ' && dlc < 8) {
+        msg->m.frame.data.u8[dlc++] = strtoul(p, &p, 16);
+    }
+    msg->m.frame.FIR.B.DLC = dlc;
+    return true;
+}
+
+static std::vector<Msg> LoadCorpus(const char* path, size_t* crtdsize) {
+    std::vector<Msg> msgs;
+    FILE* f = fopen(path, "r");
+    if (!f) { printf("Cannot open %s\n", path); exit(1); }
+    char line[512];
+    *crtdsize = 0;
+    while (fgets(line, sizeof(line), f)) {
+        *crtdsize += strlen(line);
+        line[strcspn(line, "\r\n")] = 0;
+        Msg msg;
+        if (ParseCRTD(line, &msg)) msgs.push_back(msg);
+    }
+    fclose(f);
+    return msgs;
+}
+
+struct Decoded {
+    CAN_log_message_t m;
+    uint8_t bus;
+    std::string text;
+};
+
+static bool SameMsg(const Msg& a, const Decoded& d) {
+    if (a.m.type != d.m.type || a.bus != d.bus) return false;
+    if (a.m.timestamp.tv_sec != d.m.timestamp.tv_sec || a.m.timestamp.tv_usec != d.m.timestamp.tv_usec) return false;
+    if (a.m.type >= CAN_LogInfo_Comment)
+        return a.text == d.text;
+    const CAN_frame_t& x = a.m.frame;
+    const CAN_frame_t& y = d.m.frame;
+    return x.MsgID == y.MsgID && x.FIR.B.FF == y.FIR.B.FF && x.FIR.B.RTR == y.FIR.B.RTR
+        && x.FIR.B.DLC == y.FIR.B.DLC && memcmp(x.data.u8, y.data.u8, x.FIR.B.DLC) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<uint8_t> Encode(std::vector<Msg>& msgs) {
+    std::vector<uint8_t> out;
+    cancompact_encoder enc;
+    uint8_t buf[CANCOMPACT_MAXLEN];
+    size_t n = enc.Header(buf, &msgs[0].m.timestamp);
+    out.insert(out.end(), buf, buf+n);
+    for (Msg& msg : msgs) {
+        msg.m.text = (char*)msg.text.c_str();
+        n = enc.Encode(&msg.m, msg.bus, buf, sizeof(buf));
+        CHECK(n > 0, "encode failed");
+        out.insert(out.end(), buf, buf+n);
+    }
+    n = enc.Close(buf);
+    out.insert(out.end(), buf, buf+n);
+    return out;
+}
+
+// Decode a byte range, feeding it in chunks of random size
+static std::vector<Decoded> Decode(cancompact_decoder& dec, const uint8_t* data, size_t size,
+                                   std::mt19937& rng, size_t maxchunk) {
+    std::vector<Decoded> result;
+    std::vector<uint8_t> buf;
+    size_t fed = 0;
+    while (fed < size || !buf.empty()) {
+        size_t chunk = std::min(size - fed, (size_t)(1 + rng() % maxchunk));
+        buf.insert(buf.end(), data+fed, data+fed+chunk);
+        fed += chunk;
+        size_t pos = 0;
+        bool got;
+        do {
+            Decoded d;
+            pos += dec.Decode(buf.data()+pos, buf.size()-pos, &d.m, &d.bus, &got);
+            if (got) {
+                if (d.m.type >= CAN_LogInfo_Comment) d.text = d.m.text;
+                result.push_back(d);
+            }
+        } while (got);
+        buf.erase(buf.begin(), buf.begin()+pos);
+        if (chunk == 0) break;  // incomplete tail
+    }
+    return result;
+}
+
+static FILE* ToFile(const std::vector<uint8_t>& data) {
+    FILE* f = tmpfile();
+    fwrite(data.data(), 1, data.size(), f);
+    fflush(f);
+    rewind(f);
+    return f;
+}
+
+static std::vector<cancompact_segment_t> Segments(cancompact_file& file) {
+    std::vector<cancompact_segment_t> segs;
+    cancompact_segment_t seg, next;
+    bool valid = file.FindSegment(0, file.m_size, &seg);
+    while (valid) {
+        segs.push_back(seg);
+        valid = file.NextSegment(&seg, &next);
+        seg = next;
+    }
+    return segs;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static void TestCorpus(const char* path) {
+    size_t crtdsize;
+    std::vector<Msg> msgs = LoadCorpus(path, &crtdsize);
+    std::mt19937 rng(42);
+    printf("%s: %zu messages\n", path, msgs.size());
+
+    // Size & round trip:
+    std::vector<uint8_t> data = Encode(msgs);
+    printf("  size: crtd %zu, compact %zu bytes, ratio %.2f\n",
+        crtdsize, data.size(), (double)crtdsize / data.size());
+    CHECK(crtdsize >= 3 * data.size() || msgs.size() < 1000, "compression ratio below 3");
+
+    for (size_t maxchunk : { (size_t)1, (size_t)17, (size_t)1024, (size_t)65536 }) {
+        cancompact_decoder dec;
+        std::vector<Decoded> out = Decode(dec, data.data(), data.size(), rng, maxchunk);
+        CHECK(out.size() == msgs.size(), "round trip (chunk %zu): %zu of %zu messages",
+            maxchunk, out.size(), msgs.size());
+        size_t bad = 0;
+        for (size_t i = 0; i < std::min(out.size(), msgs.size()); i++)
+            if (!SameMsg(msgs[i], out[i])) bad++;
+        CHECK(bad == 0, "round trip (chunk %zu): %zu messages differ", maxchunk, bad);
+        CHECK(dec.m_resyncs == 0, "round trip: %u resyncs", dec.m_resyncs);
+    }
+
+    // Segment index:
+    FILE* f = ToFile(data);
+    cancompact_file file(f);
+    std::vector<cancompact_segment_t> segs = Segments(file);
+    printf("  segments: %zu\n", segs.size());
+    CHECK(!segs.empty(), "no segments found");
+    for (size_t i = 0; i < segs.size(); i++) {
+        CHECK(segs[i].sequence == i, "segment %zu sequence %u", i, segs[i].sequence);
+        cancompact_summary_t sum;
+        long end = (i+1 < segs.size()) ? segs[i+1].offset : file.m_size;
+        CHECK(file.ReadSummary(&segs[i], end, &sum), "segment %zu: no summary", i);
+    }
+
+    // Seek:
+    int64_t first = MsgTime(msgs.front()), last = MsgTime(msgs.back());
+    int seeks = 0, seekfail = 0;
+    for (int k = 0; k < 200; k++) {
+        int64_t target = first + (int64_t)((double)(rng() % 1000000) / 1000000 * (last - first + 1));
+        if (k == 0) target = first;
+        if (k == 1) target = last;
+        cancompact_segment_t seg;
+        if (!file.Seek(target, &seg)) { seekfail++; continue; }
+        cancompact_decoder dec;
+        dec.SetSkipUntil(target);
+        size_t len = std::min((long)(2 * CANCOMPACT_SEGSIZE), file.m_size - seg.offset);
+        std::vector<Decoded> out = Decode(dec, data.data() + seg.offset, len, rng, 4096);
+        size_t expect = 0;
+        while (expect < msgs.size() && MsgTime(msgs[expect]) < target) expect++;
+        if (out.empty() || !SameMsg(msgs[expect], out[0])) seekfail++;
+        seeks++;
+    }
+    CHECK(seekfail == 0, "seek: %d of %d failed", seekfail, seeks);
+
+    // Filter: segment skipping by summary + frame filter:
+    canfilter filter;
+    filter.AddFilter("3:3c0");
+    filter.AddFilter("1:7f0-7ff");
+    size_t expect = 0;
+    for (Msg& msg : msgs) {
+        if (msg.m.type >= CAN_LogStatus_Error) expect++;
+        else if (filter.IsFiltered(msg.bus, msg.m.frame.MsgID)) expect++;
+    }
+    size_t got = 0, skipped = 0;
+    cancompact_decoder dec;
+    dec.SetFilter(&filter);
+    for (size_t i = 0; i < segs.size(); i++) {
+        long end = (i+1 < segs.size()) ? segs[i+1].offset : file.m_size;
+        cancompact_summary_t sum;
+        bool hassum = file.ReadSummary(&segs[i], end, &sum);
+        // verify the summary is conservative: decode the segment anyway
+        dec.Reset();
+        std::vector<Decoded> out = Decode(dec, data.data() + segs[i].offset, end - segs[i].offset, rng, 4096);
+        size_t frames = 0;
+        for (Decoded& d : out) if (d.m.type < CAN_LogStatus_Error) frames++;
+        if (hassum && !(sum.flags & CANCOMPACT_FLAG_INFO) && !cancompact_file::Matches(&sum, &filter)) {
+            skipped++;
+            CHECK(out.empty(), "segment %zu skipped but has %zu matching messages", i, out.size());
+        }
+        got += out.size();
+    }
+    printf("  filter: %zu messages, %zu/%zu segments skipped, %u frames filtered\n",
+        got, skipped, segs.size(), dec.m_filtered);
+    CHECK(got == expect, "filter: %zu of %zu messages", got, expect);
+    fclose(f);
+
+    // Data loss: corrupt one segment, drop bytes in another, check the rest decodes:
+    if (segs.size() >= 6) {
+        std::vector<uint8_t> bad = data;
+        for (long i = segs[2].offset + 30; i < segs[2].offset + 80; i++) bad[i] = 0xA5;
+        bad.erase(bad.begin() + segs[4].offset + 100, bad.begin() + segs[4].offset + 137);
+        cancompact_decoder tail;
+        std::vector<Decoded> ref = Decode(tail, data.data() + segs[5].offset,
+            data.size() - segs[5].offset, rng, 4096);
+        cancompact_decoder dec2;
+        std::vector<Decoded> out = Decode(dec2, bad.data(), bad.size(), rng, 4096);
+        CHECK(out.size() >= ref.size(), "data loss: too few messages decoded");
+        size_t diff = 0;
+        for (size_t i = 0; i < ref.size() && i < out.size(); i++) {
+            const Decoded& a = ref[ref.size()-1-i];
+            const Decoded& b = out[out.size()-1-i];
+            if (memcmp(&a.m.timestamp, &b.m.timestamp, sizeof(a.m.timestamp)) || a.bus != b.bus
+                || (a.m.type < CAN_LogStatus_Error && a.m.frame.MsgID != b.m.frame.MsgID)) diff++;
+        }
+        CHECK(diff == 0, "data loss: %zu messages differ after resync", diff);
+        CHECK(dec2.m_resyncs >= 2, "data loss: %u resyncs", dec2.m_resyncs);
+        printf("  data loss: %u resyncs, %zu of %zu messages decoded\n",
+            dec2.m_resyncs, out.size(), msgs.size());
+    }
+}
+
+static void TestStatus() {
+    printf("status records & closing trailer\n");
+    std::vector<Msg> msgs(3);
+    for (size_t i = 0; i < msgs.size(); i++) {
+        memset(&msgs[i].m, 0, sizeof(msgs[i].m));
+        msgs[i].bus = 1;
+        msgs[i].m.timestamp.tv_sec = 1700000000;
+        msgs[i].m.timestamp.tv_usec = 1000 * i;
+    }
+    msgs[0].m.type = CAN_LogFrame_RX;
+    msgs[0].m.frame.MsgID = 0x123;
+    msgs[0].m.frame.FIR.B.DLC = 2;
+    msgs[2].m.type = CAN_LogFrame_RX;
+    msgs[2].m.frame.MsgID = 0x456;
+    msgs[1].m.type = CAN_LogStatus_Statistics;
+    CAN_status_t& st = msgs[1].m.status;
+    st.packets_rx = 123456;
+    st.rxbuf_overflow = 7;
+    st.errors_rx = 96;
+    st.error_time = 0xdeadbeef;
+    st.isr_queue_overrun = 3;
+
+    std::vector<uint8_t> data = Encode(msgs);
+    cancompact_decoder dec;
+    std::mt19937 rng(7);
+    std::vector<Decoded> out = Decode(dec, data.data(), data.size(), rng, 16);
+    CHECK(out.size() == msgs.size(), "status: %zu of %zu messages", out.size(), msgs.size());
+    if (out.size() == msgs.size()) {
+        CHECK(out[1].m.type == CAN_LogStatus_Statistics && out[1].bus == 1, "status: type/bus differ");
+        CHECK(memcmp(&out[1].m.status, &st, sizeof(st)) == 0, "status: counters differ");
+        CHECK(SameMsg(msgs[2], out[2]), "status: following frame differs");
+    }
+
+    // The closing trailer makes the summary of the last segment available:
+    FILE* f = ToFile(data);
+    cancompact_file file(f);
+    std::vector<cancompact_segment_t> segs = Segments(file);
+    cancompact_summary_t sum;
+    CHECK(segs.size() == 1, "status: %zu segments", segs.size());
+    CHECK(!segs.empty() && file.ReadSummary(&segs.back(), file.m_size, &sum)
+        && sum.records == msgs.size() && (sum.flags & CANCOMPACT_FLAG_INFO),
+        "status: no closing trailer");
+    fclose(f);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: %s <corpus.crtd>...\n", argv[0]);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) TestCorpus(argv[i]);
+    TestStatus();
+    printf("\n%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,419 @@
+// test_sendwindow.cpp — Native laptop test for the canlog network send window.
+//
+// Part 1 checks the window mechanics (coalescing, overflow policies) directly.
+//
+// Part 2 runs a loopback TCP log server, modelled on the firmware: a logger
+// thread formats CRTD style frame lines and adds them to the send window of
+// every client (committing when its simulated log queue drains), a network
+// thread pumps the windows into the sockets on write readiness & poll ticks
+// (MG_EV_SEND / MG_EV_POLL). A fast client reads as fast as it can, a slow
+// client throttles its reads. Both verify every line is complete and the
+// sequence numbers only increase. The fast client must not be affected by
+// the slow one, the slow client's data must stay bounded by its window.
+//
+// Run:  make sendwindow   (from the tests/ directory)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "canlog_sendwindow.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; \
+    printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static uint32_t now_ms()
+{
+    using namespace std::chrono;
+    return (uint32_t) duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int format_frame(char* buf, size_t size, uint32_t seq)
+{
+    // CRTD style: "<time> 1R11 <id> <data...>" with the sequence in the data
+    return snprintf(buf, size, "%u.%06u 1R11 %03X %02X %02X %02X %02X %02X %02X %02X %02X\n",
+        seq / 1000, (seq % 1000) * 1000, 0x100 + (seq % 0x500),
+        (seq >> 24) & 0xff, (seq >> 16) & 0xff, (seq >> 8) & 0xff, seq & 0xff,
+        0x11, 0x22, 0x33, 0x44);
+}
+
+// ---------------------------------------------------------------------------
+// Part 1: window mechanics
+// ---------------------------------------------------------------------------
+
+struct Capture {
+    std::vector<std::string> chunks;
+    size_t accept = SIZE_MAX;     // chunks to accept before refusing
+};
+
+static bool capture_write(void* ctx, const char* data, size_t len)
+{
+    Capture* c = (Capture*) ctx;
+    if (c->chunks.size() >= c->accept) return false;
+    c->chunks.emplace_back(data, len);
+    return true;
+}
+
+static uint32_t first_seq(const std::string& chunk)
+{
+    unsigned a, b, c, d;
+    const char* p = strstr(chunk.c_str(), "1R11 ");
+    if (!p || sscanf(p + 9, "%x %x %x %x", &a, &b, &c, &d) != 4) return UINT32_MAX;
+    return (a << 24) | (b << 16) | (c << 8) | d;
+}
+
+static void test_mechanics()
+{
+    char line[128];
+    int len = format_frame(line, sizeof(line), 0);
+
+    // Coalescing: lines are packed into mtu sized chunks, never split
+    {
+        canlog_sendwindow w;
+        CHECK(w.Init(8192, 512, canlog_sendwindow::DropNewest), "init");
+        for (uint32_t i = 0; i < 100; i++) {
+            len = format_frame(line, sizeof(line), i);
+            CHECK(w.Add(line, len, 0), "add %u", i);
+        }
+        w.Commit();
+        Capture cap;
+        int sent = w.Pump(capture_write, &cap, 0);
+        size_t total = 0;
+        for (auto& c : cap.chunks) {
+            CHECK(c.size() <= 512 && c.back() == '\n', "chunk size %zu / split line", c.size());
+            total += c.size();
+        }
+        CHECK(sent == (int) cap.chunks.size() && total == 100u * len,
+            "sent %d chunks %zu bytes", sent, total);
+        size_t per_chunk = 512 / len;
+        CHECK(cap.chunks.size() == (100 + per_chunk - 1) / per_chunk,
+            "coalescing: %zu chunks", cap.chunks.size());
+    }
+
+    // Small commits are merged into the newest chunk waiting
+    {
+        canlog_sendwindow w;
+        w.Init(8192, 512, canlog_sendwindow::DropNewest);
+        for (uint32_t i = 0; i < 100; i++) {
+            len = format_frame(line, sizeof(line), i);
+            w.Add(line, len, 0);
+            w.Commit();
+        }
+        Capture cap;
+        w.Pump(capture_write, &cap, 0);
+        size_t per_chunk = 512 / len;
+        CHECK(cap.chunks.size() == (100 + per_chunk - 1) / per_chunk,
+            "merging: %zu chunks", cap.chunks.size());
+    }
+
+    // Refused writes keep the chunk for the next pump
+    {
+        canlog_sendwindow w;
+        w.Init(4096, 512, canlog_sendwindow::DropNewest);
+        for (uint32_t i = 0; i < 40; i++) {
+            len = format_frame(line, sizeof(line), i);
+            w.Add(line, len, 0);
+        }
+        w.Commit();
+        Capture cap;
+        cap.accept = 1;
+        CHECK(w.Pump(capture_write, &cap, 0) == 1, "partial pump");
+        cap.accept = SIZE_MAX;
+        w.Pump(capture_write, &cap, 0);
+        uint32_t expect = 0;
+        for (auto& c : cap.chunks) {
+            CHECK(first_seq(c) == expect, "order: chunk starts at %u, expected %u", first_seq(c), expect);
+            expect += c.size() / len;
+        }
+        CHECK(expect == 40, "received %u lines", expect);
+    }
+
+    // Overflow policies: window of 4 chunks, 12 chunks produced, nothing sent
+    for (int policy = 0; policy < 3; policy++) {
+        canlog_sendwindow w;
+        w.Init(4 * 512, 512, (canlog_sendwindow::overflow_t) policy);
+        int per_chunk = 512 / len;
+        for (uint32_t i = 0; i < (uint32_t)(12 * per_chunk); i++) {
+            len = format_frame(line, sizeof(line), i);
+            w.Add(line, len, 0);
+            if ((i + 1) % per_chunk == 0) w.Commit();
+        }
+        Capture cap;
+        w.Pump(capture_write, &cap, 0);
+        CHECK(cap.chunks.size() == 4, "%s: window holds %zu chunks",
+            canlog_sendwindow::GetOverflowName((canlog_sendwindow::overflow_t) policy), cap.chunks.size());
+        uint32_t first = cap.chunks.empty() ? UINT32_MAX : first_seq(cap.chunks.front());
+        if (policy == canlog_sendwindow::DropOldest)
+            CHECK(first == (uint32_t)(8 * per_chunk), "dropoldest: first %u", first);
+        else
+            CHECK(first == 0, "%s: first %u", canlog_sendwindow::GetOverflowName((canlog_sendwindow::overflow_t) policy), first);
+        CHECK(w.IsOverflow() == (policy == canlog_sendwindow::Disconnect), "overflow flag");
+    }
+
+    // Messages longer than the mtu are dropped, the stream continues
+    {
+        canlog_sendwindow w;
+        w.Init(4096, 512, canlog_sendwindow::DropNewest);
+        std::string big(600, 'x');
+        CHECK(!w.Add(big.data(), big.size(), 0), "oversized accepted");
+        CHECK(w.Add(line, len, 0), "add after oversized");
+        w.Commit();
+        Capture cap;
+        w.Pump(capture_write, &cap, 0);
+        CHECK(cap.chunks.size() == 1 && cap.chunks[0].size() == (size_t) len, "after oversized");
+    }
+
+    printf("mechanics: %s\n", failures ? "FAILED" : "ok");
+}
+
+// ---------------------------------------------------------------------------
+// Part 2: loopback TCP server
+// ---------------------------------------------------------------------------
+
+struct ServerConn {
+    int fd = -1;
+    canlog_sendwindow window;
+    std::string mbuf;             // stand-in for the Mongoose send_mbuf
+    bool closed = false;
+};
+
+static bool conn_write(void* ctx, const char* data, size_t len)
+{
+    ServerConn* c = (ServerConn*) ctx;
+    if (c->mbuf.size() + len > CANLOG_SENDWINDOW_INFLIGHT * c->window.GetMtu())
+        return false;
+    c->mbuf.append(data, len);
+    return true;
+}
+
+struct ClientStats {
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    uint64_t gaps = 0;
+    uint64_t bad = 0;
+    bool eof = false;
+};
+
+static void client_thread(int port, bool slow, std::atomic<bool>* stop, ClientStats* st)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (slow) {
+        int rcvbuf = 4096;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(port);
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*) &sa, sizeof(sa)) < 0) { perror("connect"); st->bad++; close(fd); return; }
+    timeval tv = { 0, 100000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    std::vector<char> buf(slow ? 1024 : 65536);
+    std::string line;
+    int64_t last = -1;
+    while (!stop->load()) {
+        ssize_t n = recv(fd, buf.data(), buf.size(), 0);
+        if (n == 0) { st->eof = true; break; }
+        if (n < 0) continue;
+        st->bytes += n;
+        for (ssize_t i = 0; i < n; i++) {
+            line.push_back(buf[i]);
+            if (buf[i] != '\n') continue;
+            uint32_t seq = first_seq(line);
+            if (seq == UINT32_MAX || (int64_t) seq <= last) st->bad++;
+            else if ((int64_t) seq != last + 1) st->gaps++;
+            if (seq != UINT32_MAX) last = seq;
+            st->lines++;
+            line.clear();
+        }
+        if (slow) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // Note: a partial last line is normal here (reader stopped or connection
+    // closed immediately, discarding the data in flight)
+    close(fd);
+}
+
+struct RunResult {
+    uint64_t produced = 0;
+    double secs = 0;
+    ClientStats fast, slow;
+    std::string faststats, slowstats;
+};
+
+// rate: frames per second produced, 0 = as fast as possible
+static RunResult run_server(canlog_sendwindow::overflow_t policy, bool with_slow, double secs, double rate)
+{
+    RunResult res;
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in sa = {};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(lfd, (sockaddr*) &sa, sizeof(sa));
+    socklen_t salen = sizeof(sa);
+    getsockname(lfd, (sockaddr*) &sa, &salen);
+    listen(lfd, 4);
+    int port = ntohs(sa.sin_port);
+
+    std::atomic<bool> stop_clients(false);
+    std::thread fast(client_thread, port, false, &stop_clients, &res.fast);
+    std::thread slow;
+
+    // Accept clients, fast first
+    int nclients = with_slow ? 2 : 1;
+    std::vector<ServerConn*> conns;
+    for (int i = 0; i < nclients; i++) {
+        ServerConn* c = new ServerConn;
+        c->fd = accept(lfd, NULL, NULL);
+        if (i == 0 && with_slow)
+            slow = std::thread(client_thread, port, true, &stop_clients, &res.slow);
+        if (i == 1) {
+            int sndbuf = 4096;
+            setsockopt(c->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        }
+        fcntl(c->fd, F_SETFL, O_NONBLOCK);
+        c->window.Init(CANLOG_SENDWINDOW_SIZE, CANLOG_SENDWINDOW_MTU, policy);
+        conns.push_back(c);
+    }
+    std::mutex connmutex;         // stand-in for canlog::m_cmmutex
+
+    // Network task: poll, write, pump
+    std::atomic<bool> stop_net(false);
+    std::thread net([&]() {
+        while (!stop_net.load()) {
+            std::vector<pollfd> pfds;
+            for (auto c : conns)
+                pfds.push_back(pollfd{ c->fd, (short)((!c->closed && !c->mbuf.empty()) ? POLLOUT : 0), 0 });
+            poll(pfds.data(), pfds.size(), 100);
+            std::lock_guard<std::mutex> lock(connmutex);
+            uint32_t now = now_ms();
+            for (size_t i = 0; i < conns.size(); i++) {
+                ServerConn* c = conns[i];
+                if (c->closed) continue;
+                if ((pfds[i].revents & POLLOUT) && !c->mbuf.empty()) {
+                    ssize_t n = send(c->fd, c->mbuf.data(), c->mbuf.size(), MSG_NOSIGNAL);
+                    if (n > 0) c->mbuf.erase(0, n);
+                }
+                c->window.Pump(conn_write, c, now);
+                if (c->window.IsOverflow()) {
+                    c->closed = true;
+                    shutdown(c->fd, SHUT_RDWR);
+                }
+            }
+        }
+    });
+
+    // Logger task: format & distribute, commit when the "queue" drains
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> burst(1, 64);
+    char line[128];
+    auto start = std::chrono::steady_clock::now();
+    uint32_t seq = 0;
+    double elapsed;
+    while ((elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()) < secs) {
+        if (rate > 0 && seq > elapsed * rate) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        else if (rate == 0) {
+            std::this_thread::yield();
+        }
+        int n = burst(rng);
+        std::lock_guard<std::mutex> lock(connmutex);
+        uint32_t now = now_ms();
+        for (int i = 0; i < n; i++, seq++) {
+            int len = format_frame(line, sizeof(line), seq);
+            for (auto c : conns)
+                if (!c->closed) c->window.Add(line, len, now);
+        }
+        for (auto c : conns)
+            if (!c->closed) c->window.Commit();
+    }
+    res.produced = seq;
+    res.secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Drain, then stop
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop_net = true;
+    net.join();
+    stop_clients = true;
+    fast.join();
+    if (with_slow) slow.join();
+
+    uint32_t now = now_ms();
+    res.faststats = conns[0]->window.GetStats(now);
+    if (with_slow) res.slowstats = conns[1]->window.GetStats(now);
+    for (auto c : conns) { close(c->fd); delete c; }
+    close(lfd);
+    return res;
+}
+
+static void report(const char* name, const RunResult& r, const ClientStats& st, const std::string& stats)
+{
+    printf("  %-5s %9.1f kframes/s %8.1f MB/s  lines %9llu  gaps %6llu  bad %llu%s\n"
+           "        %s\n",
+        name, st.lines / r.secs / 1000, st.bytes / r.secs / 1e6,
+        (unsigned long long) st.lines, (unsigned long long) st.gaps, (unsigned long long) st.bad,
+        st.eof ? "  (disconnected)" : "", stats.c_str());
+}
+
+static void test_loopback()
+{
+    const double secs = 2.0;
+    const double rate = 8000;     // frames/s, ~ a fully loaded 1 Mbit bus
+
+    printf("\nloopback TCP, fast client only, producer unthrottled (server saturated):\n");
+    RunResult sat = run_server(canlog_sendwindow::DropNewest, false, secs, 0);
+    printf("  produced %.1f kframes/s\n", sat.produced / sat.secs / 1000);
+    report("fast", sat, sat.fast, sat.faststats);
+    CHECK(sat.fast.bad == 0, "fast client: %llu bad lines", (unsigned long long) sat.fast.bad);
+
+    for (int policy = 0; policy < 3; policy++) {
+        auto p = (canlog_sendwindow::overflow_t) policy;
+        printf("\nloopback TCP, fast + slow client, %.0f kframes/s, overflow %s:\n",
+            rate / 1000, canlog_sendwindow::GetOverflowName(p));
+        RunResult r = run_server(p, true, secs, rate);
+        report("fast", r, r.fast, r.faststats);
+        report("slow", r, r.slow, r.slowstats);
+
+        CHECK(r.fast.bad == 0 && r.slow.bad == 0, "%llu/%llu bad lines",
+            (unsigned long long) r.fast.bad, (unsigned long long) r.slow.bad);
+        CHECK(!r.fast.eof, "fast client disconnected");
+        CHECK(r.slow.eof == (p == canlog_sendwindow::Disconnect), "slow client eof=%d", r.slow.eof);
+        // The slow client must not affect the fast one…
+        CHECK(r.fast.lines >= r.produced * 0.99, "fast client got %llu of %llu frames",
+            (unsigned long long) r.fast.lines, (unsigned long long) r.produced);
+        // …and only gets a bounded part of the stream
+        CHECK(r.slow.lines < r.produced / 2, "slow client got %llu of %llu frames",
+            (unsigned long long) r.slow.lines, (unsigned long long) r.produced);
+    }
+}
+
+int main()
+{
+    signal(SIGPIPE, SIG_IGN);
+    test_mechanics();
+    test_loopback();
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
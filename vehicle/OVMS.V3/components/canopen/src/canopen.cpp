@@ -142,7 +142,10 @@ CANopenWorker* CANopen::Start(canbus* bus)
     m_rxqueue = xQueueCreate(20, sizeof(CAN_frame_t));
     xTaskCreatePinnedToCore(CANopenRxTask, "OVMS COrx",
       CONFIG_OVMS_COMP_CANOPEN_RX_STACK, (void*)this, 15, &m_rxtask, CORE(0));
-    MyCan.RegisterListener(m_rxqueue);
+    // CANopen only uses 11 bit COB-IDs:
+    canidset* filter = new canidset();
+    filter->Add(0, 0x000, 0x7ff, CAN_frame_std);
+    MyCan.RegisterListener(m_rxqueue, false, filter, TAG);
     }
 
   // start worker:
@@ -34,6 +34,7 @@ static const char *TAG = "dbc";
 #include <algorithm>
 #include <list>
 #include <vector>
+#include <memory>
 #include <sstream>
 #include <string.h>
 #include <stdlib.h>
@@ -105,6 +106,76 @@ dbc_extract_bits_big_endian(const uint8_t *candata, unsigned int bpos, unsigned
   return val;
   }
 
+/**
+ * Word-at-a-time extraction
+ *
+ * dbc_load_le() loads up to 8 payload bytes into a word, the first byte in
+ *  the least significant bits, missing bytes read as zero. A little endian
+ *  (Intel) signal then is (word >> start) & mask. In the byte swapped word,
+ *  the first byte is in the most significant bits, so a big endian (Motorola)
+ *  signal, having its MSB at the start bit, is extracted the same way with
+ *  the LSB position as the shift.
+ *
+ * Signals spanning 9 bytes (unaligned > 56 bits) use the bitwise extraction.
+ */
+static inline uint64_t dbc_load_le(const uint8_t *data, unsigned int len)
+  {
+  uint64_t word = 0;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  if (len >= 8)
+    {
+    memcpy(&word, data, 8);
+    return word;
+    }
+#endif
+  if (len > 8) len = 8;
+  for (int i = len - 1; i >= 0; i--)
+    word = (word << 8) | data[i];
+  return word;
+  }
+
+static inline uint64_t dbc_mask(unsigned int bits)
+  {
+  return (bits >= 64) ? ~((uint64_t)0) : (((uint64_t)1) << bits) - 1;
+  }
+
+/**
+ * dbc_signal_window: get the payload size needed by a signal, the start of
+ *  the 8 byte window to load (0 if the signal lies within the first 8 bytes)
+ *  and the shift to apply to the window word.
+ *  Returns false if the signal does not fit into a window.
+ */
+static bool
+dbc_signal_window(unsigned int start, unsigned int bits, bool bigendian,
+                  unsigned int *end, unsigned int *window, unsigned int *shift)
+  {
+  unsigned int first = start / 8, bytes;
+  if (bigendian)
+    {
+    // Start bit is the MSB, continuing at bit 7 of the following bytes:
+    unsigned int msb = start % 8;
+    bytes = (bits <= msb + 1) ? 1 : 1 + (bits - (msb + 1) + 7) / 8;
+    }
+  else
+    {
+    bytes = ((start % 8) + bits + 7) / 8;
+    if (bytes == 0) bytes = 1;
+    }
+
+  *end = first + bytes;
+  *window = (*end <= 8) ? 0 : first;
+  *shift = 0;
+  if (bytes > 8)
+    return false;
+  if (bits == 0)
+    return true;
+  if (bigendian)
+    *shift = (7 - (first - *window)) * 8 + (start % 8) + 1 - bits;
+  else
+    *shift = start - (*window * 8);
+  return true;
+  }
+
 uint32_t dbcMessageIdFromString(const char* id)
   {
   uint32_t msgid = 0;
@@ -965,7 +1036,7 @@ void dbcSignal::SetUnit(const char* unit)
   SetUnit(std::string(unit));
   }
 
-void dbcSignal::Encode(dbcNumber* source, CAN_frame_t* msg)
+void dbcSignal::Encode(dbcNumber* /*source*/, CAN_frame_t* /*msg*/)
   {
   // TODO: An efficient encoding of the signal
   }
@@ -978,19 +1049,35 @@ dbcNumber dbcSignal::Decode(const uint8_t* msg, uint8_t size) const
   if (size == 0)
     return m_offset;
 
-  if ( ((m_start_bit+m_signal_size+7) / 8) > size)
+  unsigned int start = (m_start_bit > 0) ? m_start_bit : 0;
+  unsigned int bits = (m_signal_size > 0) ? MIN(m_signal_size, 64) : 0;
+  bool bigendian = (m_byte_order == DBC_BYTEORDER_BIG_ENDIAN);
+  unsigned int end, window, shift;
+  bool fits = dbc_signal_window(start, bits, bigendian, &end, &window, &shift);
+
+  if (end > size)
     return result; // empty value.
 
-  if (m_byte_order == DBC_BYTEORDER_BIG_ENDIAN)
-    val = dbc_extract_bits_big_endian(msg,m_start_bit,m_signal_size);
+  if (!fits)
+    {
+    if (bigendian)
+      val = dbc_extract_bits_big_endian(msg,start,bits);
+    else
+      val = dbc_extract_bits_little_endian(msg,start,bits);
+    }
   else
-    val = dbc_extract_bits_little_endian(msg,m_start_bit,m_signal_size);
+    {
+    val = dbc_load_le(msg + window, size - window);
+    if (bigendian)
+      val = __builtin_bswap64(val);
+    val = (val >> shift) & dbc_mask(bits);
+    }
 
-  if (m_value_type == DBC_VALUETYPE_UNSIGNED)
-    result.Cast((uint32_t)val, DBC_NUMBER_INTEGER_UNSIGNED);
+  if (m_value_type == DBC_VALUETYPE_UNSIGNED || bits == 0)
+    result.Cast(val, DBC_NUMBER_INTEGER_UNSIGNED);
   else {
-    int32_t signed_val = sign_extend<uint32_t, int32_t>((uint32_t)val, m_signal_size-1);
-    result.Cast(static_cast<uint32_t>(signed_val), DBC_NUMBER_INTEGER_SIGNED);
+    int64_t signed_val = sign_extend<uint64_t, int64_t>(val, bits-1);
+    result.Cast(static_cast<uint64_t>(signed_val), DBC_NUMBER_INTEGER_SIGNED);
   }
 
   // Apply factor and offset
@@ -1154,142 +1241,308 @@ dbcMessage::dbcMessage()
   {
   m_id = 0;
   m_size = 0;
+  m_plan_slots = 0;
+  m_plan_valid = false;
   }
 
 dbcMessage::dbcMessage(uint32_t id)
   {
   m_size = 0;
   m_id = id;
+  m_plan_slots = 0;
+  m_plan_valid = false;
   }
 
 dbcMessage::~dbcMessage()
   {
   }
 
-void dbcMessage::DecodeSignal(const uint8_t* msg, uint8_t size, bool assignMetrics, OvmsWriter* writer) const
+/**
+ * Compile: translate the signal list into the decode plan.
+ *
+ * Bit positions are resolved into a byte window & shift, the factor/offset
+ *  identity tests are done once, and the multiplexor tree is flattened into
+ *  plan indices, so DecodeSignal() does not need any lookups. Switched
+ *  signals without a (resolvable) multiplexor are never active.
+ */
+void dbcMessage::Compile()
   {
-  // Gets the default multiplexor signal (the first one not also a sink/switch).
-  dbcSignal* mux = GetMultiplexorSignal();
-  // Cache of signal->(signal-activated, value)
-  std::map<dbcSignal *,std::pair<bool, dbcNumber> > mux_vals;
+  dbcSignal* mainmux = GetMultiplexorSignal();
+
+  m_plan.clear();
+  m_plan.reserve(m_signals.size());
+  m_plan_slots = 0;
 
-  // Recursive utility to handle multiple layers of multiplexing.
-  // Changes the value.
-  std::function<std::pair<bool,dbcNumber>(dbcSignal*)> match_mux_signal =
-    [mux, &mux_vals, &match_mux_signal, msg, size, writer]
-    (dbcSignal *sig) -> std::pair<bool,dbcNumber>
+  for (dbcSignal* sig : m_signals)
     {
-    auto found = mux_vals.find(sig);
-    if (found != mux_vals.end())
-      return found->second;
+    dbcDecodeOp_t op;
+    unsigned int start = (sig->m_start_bit > 0) ? sig->m_start_bit : 0;
+    unsigned int bits = (sig->m_signal_size > 0) ? MIN(sig->m_signal_size, 64) : 0;
+    bool bigendian = (sig->m_byte_order == DBC_BYTEORDER_BIG_ENDIAN);
+    unsigned int end, window, shift;
+
+    op.signal = sig;
+    op.size = bits;
+    op.flags = 0;
+    op.slot = -1;
+    op.muxop = -1;
+
+    if (!dbc_signal_window(start, bits, bigendian, &end, &window, &shift))
+      op.flags |= DBC_OP_BITWISE;
+    op.minsize = end;
+    op.byte = window;
+    op.shift = shift;
+
+    if (bigendian)
+      op.flags |= DBC_OP_BIGENDIAN;
+    if (sig->m_value_type != DBC_VALUETYPE_UNSIGNED && bits > 0)
+      op.flags |= DBC_OP_SIGNED;
+    if (!(sig->m_factor == (uint32_t)1))
+      op.flags |= DBC_OP_FACTOR;
+    if (!(sig->m_offset == (uint32_t)0))
+      op.flags |= DBC_OP_OFFSET;
+    if (sig->IsMultiplexSwitch())
+      op.flags |= DBC_OP_SWITCH;
+
+    m_plan.push_back(op);
+    }
 
-    std::pair<bool, dbcNumber> muxval;
-    if (!sig->IsMultiplexSwitch())
-      muxval.first = true;
-    else
+  // Link switched signals to their multiplexor, assign multiplexor slots:
+  for (dbcDecodeOp_t& op : m_plan)
+    {
+    if (!(op.flags & DBC_OP_SWITCH))
+      continue;
+    dbcSignal* muxsrc = op.signal->GetMultiplexSource();
+    if (!muxsrc)
+      muxsrc = mainmux;
+    for (size_t i = 0; i < m_plan.size(); i++)
       {
-      auto muxsrc = sig->GetMultiplexSource();
-      if (!muxsrc)
-        muxsrc = mux;
-      if (!muxsrc)
-        muxval.first = false; // Top-level so activated.
-      else
+      if (m_plan[i].signal == muxsrc)
         {
-        // Get base signal (activated, value)
-        auto val = match_mux_signal(muxsrc);
-        // This signal is activated if the parent is activated and the
-        // value matches the switch for this signal.
-        muxval.first = val.first && sig->IsMultiplexSwitchvalue(val.second.GetUnsignedInteger());
+        op.muxop = i;
+        break;
         }
       }
-    if (muxval.first)
+    }
+
+  // Break multiplexor loops, these have never been decodable:
+  for (dbcDecodeOp_t& op : m_plan)
+    {
+    int muxop = op.muxop;
+    for (size_t depth = 0; muxop >= 0 && depth <= m_plan.size(); depth++)
+      muxop = (m_plan[muxop].flags & DBC_OP_SWITCH) ? m_plan[muxop].muxop : -1;
+    if (muxop >= 0)
+      op.muxop = -1;
+    }
+
+  for (dbcDecodeOp_t& op : m_plan)
+    {
+    if (op.muxop >= 0 && m_plan[op.muxop].slot < 0)
+      m_plan[op.muxop].slot = m_plan_slots++;
+    }
+
+  m_plan.shrink_to_fit();
+  m_plan_valid = true;
+  }
+
+/**
+ * DecodeOp: extract & scale a signal value as dbcSignal::Decode() does
+ *  window: first 8 payload bytes as loaded & byte swapped
+ */
+dbcNumber dbcMessage::DecodeOp(const dbcDecodeOp_t& op, const uint8_t* msg, uint8_t size, const uint64_t* window) const
+  {
+  dbcSignal* sig = op.signal;
+  uint64_t val;
+  dbcNumber result;
+
+  if (size == 0)
+    return sig->m_offset;
+
+  if (op.minsize > size)
+    return result; // empty value.
+
+  if (op.flags & DBC_OP_BITWISE)
+    {
+    if (op.flags & DBC_OP_BIGENDIAN)
+      val = dbc_extract_bits_big_endian(msg, sig->m_start_bit, op.size);
+    else
+      val = dbc_extract_bits_little_endian(msg, sig->m_start_bit, op.size);
+    }
+  else
+    {
+    if (op.byte == 0)
+      val = window[(op.flags & DBC_OP_BIGENDIAN) ? 1 : 0];
+    else
       {
-      // Activated, so decode the signal value.
-      muxval.second = sig->Decode(msg, size);
+      val = dbc_load_le(msg + op.byte, size - op.byte);
+      if (op.flags & DBC_OP_BIGENDIAN)
+        val = __builtin_bswap64(val);
+      }
+    val = (val >> op.shift) & dbc_mask(op.size);
+    }
+
+  if (op.flags & DBC_OP_SIGNED)
+    {
+    int64_t signed_val = sign_extend<uint64_t, int64_t>(val, op.size-1);
+    result.Cast(static_cast<uint64_t>(signed_val), DBC_NUMBER_INTEGER_SIGNED);
+    }
+  else
+    result.Cast(val, DBC_NUMBER_INTEGER_UNSIGNED);
+
+  // Apply factor and offset
+  if (op.flags & DBC_OP_FACTOR)
+    result = (result * sig->m_factor);
+  if (op.flags & DBC_OP_OFFSET)
+    result = (result + sig->m_offset);
+
+  return result;
+  }
+
+/**
+ * DecodeMux: get the activation state of a multiplexor for this frame,
+ *  evaluates (and logs) its parent multiplexors as needed.
+ */
+bool dbcMessage::DecodeMux(int opindex, dbcMuxState_t* state, const uint8_t* msg, uint8_t size, const uint64_t* window, OvmsWriter* writer) const
+  {
+  const dbcDecodeOp_t& op = m_plan[opindex];
+  dbcMuxState_t& mux = state[op.slot];
+  if (mux.active >= 0)
+    return mux.active;
+
+  bool active = true;
+  if (op.flags & DBC_OP_SWITCH)
+    {
+    // Activated if the parent is activated and its value matches our switch:
+    active = (op.muxop >= 0)
+      && DecodeMux(op.muxop, state, msg, size, window, writer)
+      && op.signal->IsMultiplexSwitchvalue(state[m_plan[op.muxop].slot].value.GetUnsignedInteger());
+    }
+  if (active)
+    {
+    mux.value = DecodeOp(op, msg, size, window);
+    if (writer)
+      {
+      std::ostringstream ss;
+      ss << "  dbc/mux/" << op.signal->GetName();
+      ss << ": " << mux.value << " " << op.signal->GetUnit();
+      writer->puts(ss.str().c_str());
+      }
+    }
+  mux.active = active;
+  return active;
+  }
+
+void dbcMessage::DecodeSignal(const uint8_t* msg, uint8_t size, bool assignMetrics, OvmsWriter* writer) const
+  {
+  // Plans of files are compiled on load, messages built or changed by code
+  // need a Compile() before use. Until then, the last plan stays in effect.
+
+  // Multiplexor states of this frame:
+  dbcMuxState_t stackstate[DBC_DECODE_MUXSLOTS];
+  std::unique_ptr<dbcMuxState_t[]> heapstate;
+  dbcMuxState_t* state = stackstate;
+  if (m_plan_slots > DBC_DECODE_MUXSLOTS)
+    {
+    heapstate.reset(new dbcMuxState_t[m_plan_slots]);
+    state = heapstate.get();
+    }
+  for (int i = 0; i < m_plan_slots; i++)
+    state[i].active = -1;
+
+  // Most signals lie within the first 8 bytes, load these once:
+  uint64_t window[2];
+  window[0] = dbc_load_le(msg, size);
+  window[1] = __builtin_bswap64(window[0]);
+
+  for (size_t opindex = 0; opindex < m_plan.size(); opindex++)
+    {
+    const dbcDecodeOp_t& op = m_plan[opindex];
+    dbcSignal* sig = op.signal;
+
+    // Ignore unless there is a metric or we are displaying the output
+    dbcMetric* m = sig->GetMetric();
+    if (!m && !writer)
+      continue;
+
+    dbcNumber value;
+    if (op.slot >= 0 && (op.flags & DBC_OP_SWITCH))
+      {
+      if (!DecodeMux(opindex, state, msg, size, window, writer))
+        continue;
+      value = state[op.slot].value;
+      }
+    else if (op.flags & DBC_OP_SWITCH)
+      {
+      // Switched signal, not a multiplexor itself:
+      if (op.muxop < 0
+          || !DecodeMux(op.muxop, state, msg, size, window, writer)
+          || !sig->IsMultiplexSwitchvalue(state[m_plan[op.muxop].slot].value.GetUnsignedInteger()))
+        continue;
+      value = DecodeOp(op, msg, size, window);
       if (writer)
         {
         std::ostringstream ss;
         ss << "  dbc/mux/" << sig->GetName();
-        ss << ": " << muxval.second << " " << sig->GetUnit();
+        ss << ": " << value << " " << sig->GetUnit();
         writer->puts(ss.str().c_str());
         }
       }
-    // cache.
-    mux_vals[sig] = muxval;
-    return muxval;
-    };
+    else
+      {
+      value = DecodeOp(op, msg, size, window);
+      }
 
-  for (dbcSignal* sig : m_signals)
-    {
-    // Ignore unless there is a metric or we are displaying the output
-    dbcMetric* m = sig->GetMetric();
-    if (m || writer)
+    if (assignMetrics && (m != nullptr))
       {
-      std::pair<bool, dbcNumber> muxval;
-      if (sig->IsMultiplexSwitch())
-        muxval = match_mux_signal(sig);
+      // Store to metric.
+      if (!sig->HasValues())
+        m->SetValue(value, sig->GetMetricUnit());
       else
         {
-        muxval.first = true;
-        muxval.second = sig->Decode(msg, size);
+        // Metric has an 'enum' .. assign the matching value.
+        auto found = sig->m_values.m_entrymap.find(value.GetUnsignedInteger());
+        if (found != sig->m_values.m_entrymap.end())
+          m->SetValue(found->second);
         }
-      if (muxval.first) // Is Active signal
+      }
+    if (writer)
+      {
+      // Log only.
+      std::ostringstream ss;
+      ss << "  dbc/" << sig->GetName();
+      if (m != nullptr)
+        ss << '*';
+      ss << ": ";
+      ss << value;
+      metric_unit_t unit = sig->GetMetricUnit();
+      if (unit != Other)
+        ss << ' ' << OvmsMetricUnitName(unit);
+      else
         {
+        const std::string &unit_name = sig->GetUnit();
+        if (!unit_name.empty())
+          ss << ' ' << unit_name;
 
-        if (assignMetrics && (m != nullptr))
-          {
-          // Store to metric.
-          if (!sig->HasValues())
-            m->SetValue(muxval.second, sig->GetMetricUnit());
-          else
-            {
-            // Metric has an 'enum' .. assign the matching value.
-            uint32_t val = muxval.second.GetUnsignedInteger();
-            if (sig->HasValue(val))
-              m->SetValue(sig->GetValue(val));
-            }
-          }
-        if (writer)
+        if (m)
           {
-          // Log only.
-          std::ostringstream ss;
-          ss << "  dbc/" << sig->GetName();
-          if (m != nullptr)
-            ss << '*';
-          ss << ": ";
-          ss << muxval.second;
-          metric_unit_t unit = sig->GetMetricUnit();
-          if (unit != Other)
-            ss << ' ' << OvmsMetricUnitName(unit);
-          else
-            {
-            const std::string &unit_name = sig->GetUnit();
-            if (!unit_name.empty())
-              ss << ' ' << unit_name;
-
-            if (m)
-              {
-              // This is the unit it will be treated as.
-              metric_unit_t defmetunit = m->DefaultUnit();
-              if (defmetunit != Other)
-                ss << " (" << OvmsMetricUnitName(defmetunit) << ')';
-              }
-            }
-
-          if (sig->HasValues())
-            {
-            ss << " [";
-            uint32_t val = muxval.second.GetUnsignedInteger();
-            if (sig->HasValue(val))
-              ss << sig->GetValue(val);
-            ss << "]";
-            }
-          writer->puts(ss.str().c_str());
+          // This is the unit it will be treated as.
+          metric_unit_t defmetunit = m->DefaultUnit();
+          if (defmetunit != Other)
+            ss << " (" << OvmsMetricUnitName(defmetunit) << ')';
           }
         }
+
+      if (sig->HasValues())
+        {
+        ss << " [";
+        uint32_t val = value.GetUnsignedInteger();
+        if (sig->HasValue(val))
+          ss << sig->GetValue(val);
+        ss << "]";
+        }
+      writer->puts(ss.str().c_str());
       }
     }
-
   }
 
 void dbcMessage::AddComment(const std::string& comment)
@@ -1315,11 +1568,14 @@ bool dbcMessage::HasComment(const std::string& comment) const
 void dbcMessage::AddSignal(dbcSignal* signal)
   {
   m_signals.push_back(signal);
+  m_plan_valid = false;
   }
 
 void dbcMessage::RemoveSignal(dbcSignal* signal, bool free)
   {
   m_signals.remove(signal);
+  m_plan.clear();
+  m_plan_valid = false;
   if (free) delete signal;
   }
 
@@ -1330,6 +1586,8 @@ void dbcMessage::RemoveAllSignals(bool free)
     if (free) delete signal;
     }
   m_signals.clear();
+  m_plan.clear();
+  m_plan_valid = false;
   }
 
 dbcSignal* dbcMessage::FindSignal(std::string name)
@@ -1437,6 +1695,7 @@ dbcSignal* dbcMessage::GetMultiplexorSignal() const
 
 void dbcMessage::SetMultiplexorSignal(dbcSignal* signal)
   {
+  m_plan_valid = false;
   if (signal != NULL)
     {
     signal->SetMultiplexSource();
@@ -1558,6 +1817,14 @@ dbcMessage* dbcMessageTable::FindMessage(CAN_frame_format_t format, uint32_t id)
     return NULL;
   }
 
+void dbcMessageTable::Compile()
+  {
+  for (dbcMessageEntry_t::const_iterator itt = m_entrymap.begin();
+       itt != m_entrymap.end();
+       itt++)
+    itt->second->Compile();
+  }
+
 void dbcMessageTable::Count(int* messages, int* signals, int* bits, int* covered) const
   {
   *messages = 0;
@@ -1690,6 +1957,7 @@ bool dbcfile::LoadFile(const char* name, const char* path, FILE* fd)
     fseek(fd,0,SEEK_SET);
     }
 
+  m_messages.Compile();
   return result;
   }
 
@@ -1705,6 +1973,7 @@ bool dbcfile::LoadString(const char* name, const char* source, size_t length)
   bool result = (yyparse (this) == 0);
   yy_delete_buffer(buffer);
 
+  m_messages.Compile();
   return result;
   }
 
@@ -34,6 +34,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include <functional>
 #include <iostream>
 #include "dbc_number.h"
@@ -323,6 +324,8 @@ class dbcSignal
     dbcNumber GetOffset() const;
     dbcNumber GetMinimum() const;
     dbcNumber GetMaximum() const;
+    // Layout & scaling changes of a signal already added to a message take
+    // effect on decoding by dbcMessage::Compile():
     void SetStartSize(const int startbit, const int size);
     void SetByteOrder(const dbcByteOrder_t order);
     void SetValueType(const dbcValueType_t type);
@@ -360,6 +363,7 @@ class dbcSignal
     dbcValueTable m_values;
 
   protected:
+    friend class dbcMessage;
     std::string m_name;
     dbcMultiplexor_t m_mux;
     int m_start_bit;
@@ -377,6 +381,41 @@ class dbcSignal
   };
 
 typedef std::list<dbcSignal*> dbcSignalList_t;
+
+/**
+ * dbcDecodeOp_t: compiled decode step for one signal of a message.
+ *
+ * dbcMessage::Compile() translates the signal list into a flat array of these,
+ *  so decoding a frame is a linear walk without lookups or heap allocations.
+ *  The signal bits are fetched by loading the 8 payload bytes starting at
+ *  'byte' into a 64 bit word (in signal byte order) and shifting right by
+ *  'shift'. Signals within the first 8 bytes use window 0, which is loaded
+ *  once per frame. Multiplexor signals get a 'slot' for their per frame
+ *  state, switched signals refer to their multiplexor by plan index ('muxop').
+ */
+#define DBC_OP_BIGENDIAN      0x01    // Motorola byte order
+#define DBC_OP_SIGNED         0x02    // Sign extend the raw value
+#define DBC_OP_FACTOR         0x04    // Apply factor (not 1)
+#define DBC_OP_OFFSET         0x08    // Apply offset (not 0)
+#define DBC_OP_SWITCH         0x10    // Multiplexed signal, check muxop
+#define DBC_OP_BITWISE        0x20    // Spans 9 bytes, extract bitwise
+
+#define DBC_DECODE_MUXSLOTS   8       // Multiplexor states kept on the stack
+
+struct dbcDecodeOp_t
+  {
+  dbcSignal* signal;
+  uint16_t minsize;     // Payload bytes needed to decode
+  uint16_t byte;        // First payload byte of the 8 byte window
+  uint8_t shift;        // Right shift to align the window word
+  uint8_t size;         // Signal size [bits], max 64
+  uint8_t flags;        // DBC_OP_*
+  int16_t slot;         // Multiplexor state slot, -1 = not a multiplexor
+  int16_t muxop;        // Switch: index of the multiplexor op, -1 = never active
+  };
+
+typedef std::vector<dbcDecodeOp_t> dbcDecodePlan_t;
+
 class dbcMessage
   {
   public:
@@ -391,8 +430,21 @@ class dbcMessage
     dbcSignal* FindSignal(std::string name);
     void Count(int* signals, int* bits, int* covered) const;
 
+    // Rebuild the decode plan; needed after adding or removing signals or
+    // changing their layout, scaling or multiplexing. Not thread safe, the
+    // message must not be decoded concurrently:
+    void Compile();
     void DecodeSignal(const uint8_t* msg, uint8_t size, bool assignMetrics = true, OvmsWriter* writer = nullptr) const;
 
+  protected:
+    struct dbcMuxState_t
+      {
+      int8_t active;    // -1 = not evaluated yet
+      dbcNumber value;
+      };
+    dbcNumber DecodeOp(const dbcDecodeOp_t& op, const uint8_t* msg, uint8_t size, const uint64_t* window) const;
+    bool DecodeMux(int opindex, dbcMuxState_t* state, const uint8_t* msg, uint8_t size, const uint64_t* window, OvmsWriter* writer) const;
+
   public:
     void AddComment(const std::string& comment);
     void AddComment(const char* comment);
@@ -430,6 +482,11 @@ class dbcMessage
     std::string m_name;
     int m_size;
     std::string m_transmitter_node;
+
+  protected:
+    dbcDecodePlan_t m_plan;
+    int m_plan_slots;
+    bool m_plan_valid;
   };
 
 typedef std::map<uint32_t, dbcMessage*> dbcMessageEntry_t;
@@ -445,6 +502,7 @@ class dbcMessageTable
     dbcMessage* FindMessage(uint32_t id) const;
     dbcMessage* FindMessage(CAN_frame_format_t format, uint32_t id) const;
     void Count(int* messages, int* signals, int* bits, int* covered) const;
+    void Compile();
 
   public:
     void EmptyContent();
@@ -499,6 +499,7 @@ void dbc_message_set_mux(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, in
   if (argc == 1)
     {
     msg->SetMultiplexorSignal(NULL);
+    msg->Compile();
     writer->printf("DBC: Cleared mux for %s\n",argv[0]);
     return;
     }
@@ -511,6 +512,7 @@ void dbc_message_set_mux(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, in
     }
 
   msg->SetMultiplexorSignal(signal);
+  msg->Compile();
   writer->printf("DBC: Set mux for message %s to %s\n",argv[0],argv[1]);
   }
 
@@ -533,6 +535,7 @@ void dbc_signal_clear(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
     {
     msg->RemoveAllSignals(true);
     msg->SetMultiplexorSignal(NULL);
+    msg->Compile();
     writer->printf("DBC: Cleared all signals for %s\n",argv[0]);
     }
   }
@@ -572,6 +575,7 @@ void dbc_signal_add(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
   signal->SetUnit(argv[10]);
   signal->AddReceiver(argv[11]);
   msg->AddSignal(signal);
+  msg->Compile();
   writer->printf("DBC: Added signal %s on message %s\n",argv[1],argv[0]);
   }
 
@@ -600,6 +604,7 @@ void dbc_signal_remove(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int
   else
     {
     msg->RemoveSignal(signal, true);
+    msg->Compile();
     writer->printf("DBC: Removed signal %s on message %s\n",argv[1],argv[0]);
     }
   }
@@ -637,6 +642,7 @@ void dbc_signal_set_mux(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int
     signal->ClearMultiplexed();
     writer->printf("DBC: Cleared mux for signal %s on message %s\n",argv[1],argv[0]);
     }
+  msg->Compile();
   }
 
 void dbc_signal_set_mux_ext(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
@@ -702,6 +708,7 @@ void dbc_signal_set_mux_ext(int verbosity, OvmsWriter* writer, OvmsCommand* cmd,
     signal->ClearMultiplexed();
     writer->printf("DBC: Cleared mux for signal %s on message %s\n",argv[1],argv[0]);
     }
+  msg->Compile();
   }
 
 dbc::dbc()
@@ -50,6 +50,16 @@ dbcNumber::dbcNumber(uint32_t value)
   Set(value);
   }
 
+dbcNumber::dbcNumber(int64_t value)
+  {
+  Set(value);
+  }
+
+dbcNumber::dbcNumber(uint64_t value)
+  {
+  Set(value);
+  }
+
 dbcNumber::dbcNumber(double value)
   {
   Set(value);
@@ -96,19 +106,32 @@ void dbcNumber::Set(uint32_t value)
   m_value.uintval = value;
   }
 
+void dbcNumber::Set(int64_t value)
+  {
+  m_type = DBC_NUMBER_INTEGER_SIGNED;
+  m_value.sintval = value;
+  }
+
+void dbcNumber::Set(uint64_t value)
+  {
+  m_type = DBC_NUMBER_INTEGER_UNSIGNED;
+  m_value.uintval = value;
+  }
+
 void dbcNumber::Set(double value)
   {
-  if (ceil(value)==value)
+  // Integral values within the 64 bit range are stored as integers:
+  if (ceil(value)==value && value >= -9223372036854775808.0 && value < 18446744073709551616.0)
     {
     if (value<0)
       {
       m_type = DBC_NUMBER_INTEGER_SIGNED;
-      m_value.sintval = (int32_t)value;
+      m_value.sintval = (int64_t)value;
       }
     else
       {
       m_type = DBC_NUMBER_INTEGER_UNSIGNED;
-      m_value.uintval = (uint32_t)value;
+      m_value.uintval = (uint64_t)value;
       }
     }
   else
@@ -119,6 +142,23 @@ void dbcNumber::Set(double value)
   }
 
 void dbcNumber::Cast(uint32_t value, dbcNumberType_t type)
+  {
+  switch(type)
+    {
+    case DBC_NUMBER_INTEGER_SIGNED:
+      m_value.sintval = (int32_t)value;
+      m_type = type;
+      break;
+    case DBC_NUMBER_INTEGER_UNSIGNED:
+      m_value.uintval = value;
+      m_type = type;
+      break;
+    default:
+      break;
+    }
+  }
+
+void dbcNumber::Cast(uint64_t value, dbcNumberType_t type)
   {
   switch(type)
     {
@@ -137,7 +177,7 @@ int32_t dbcNumber::GetSignedInteger() const
   switch (m_type)
     {
     case DBC_NUMBER_INTEGER_SIGNED:
-      return m_value.sintval;
+      return (int32_t)m_value.sintval;
       break;
     case DBC_NUMBER_INTEGER_UNSIGNED:
       return (int32_t)m_value.uintval;
@@ -159,7 +199,7 @@ uint32_t dbcNumber::GetUnsignedInteger() const
       return (uint32_t)m_value.sintval;
       break;
     case DBC_NUMBER_INTEGER_UNSIGNED:
-      return m_value.uintval;
+      return (uint32_t)m_value.uintval;
       break;
     case DBC_NUMBER_DOUBLE:
       return (uint32_t)m_value.doubleval;
@@ -170,6 +210,44 @@ uint32_t dbcNumber::GetUnsignedInteger() const
     }
   }
 
+int64_t dbcNumber::GetSignedInteger64() const
+  {
+  switch (m_type)
+    {
+    case DBC_NUMBER_INTEGER_SIGNED:
+      return m_value.sintval;
+      break;
+    case DBC_NUMBER_INTEGER_UNSIGNED:
+      return (int64_t)m_value.uintval;
+      break;
+    case DBC_NUMBER_DOUBLE:
+      return (int64_t)m_value.doubleval;
+      break;
+    default:
+      return 0;
+      break;
+    }
+  }
+
+uint64_t dbcNumber::GetUnsignedInteger64() const
+  {
+  switch (m_type)
+    {
+    case DBC_NUMBER_INTEGER_SIGNED:
+      return (uint64_t)m_value.sintval;
+      break;
+    case DBC_NUMBER_INTEGER_UNSIGNED:
+      return m_value.uintval;
+      break;
+    case DBC_NUMBER_DOUBLE:
+      return (uint64_t)m_value.doubleval;
+      break;
+    default:
+      return 0;
+      break;
+    }
+  }
+
 double dbcNumber::GetDouble() const
   {
   switch (m_type)
@@ -224,6 +302,20 @@ dbcNumber& dbcNumber::operator=(const uint32_t value)
   return *this;
   }
 
+dbcNumber& dbcNumber::operator=(const int64_t value)
+  {
+  m_type = DBC_NUMBER_INTEGER_SIGNED;
+  m_value.sintval = value;
+  return *this;
+  }
+
+dbcNumber& dbcNumber::operator=(const uint64_t value)
+  {
+  m_type = DBC_NUMBER_INTEGER_UNSIGNED;
+  m_value.uintval = value;
+  return *this;
+  }
+
 dbcNumber& dbcNumber::operator=(const double value)
   {
   m_type = DBC_NUMBER_DOUBLE;
@@ -252,7 +344,7 @@ dbcNumber dbcNumber::operator*(const dbcNumber& value)
           return dbcNumber(m_value.sintval * value.m_value.sintval);
           break;
         case DBC_NUMBER_INTEGER_UNSIGNED:
-          return dbcNumber((int32_t)m_value.uintval * value.m_value.sintval);
+          return dbcNumber((int64_t)m_value.uintval * value.m_value.sintval);
           break;
         case DBC_NUMBER_DOUBLE:
           return dbcNumber(m_value.doubleval * value.m_value.sintval);
@@ -265,7 +357,7 @@ dbcNumber dbcNumber::operator*(const dbcNumber& value)
       switch (m_type)
         {
         case DBC_NUMBER_INTEGER_SIGNED:
-          return dbcNumber(m_value.sintval * value.m_value.uintval);
+          return dbcNumber(m_value.sintval * (int64_t)value.m_value.uintval);
           break;
         case DBC_NUMBER_INTEGER_UNSIGNED:
           return dbcNumber(m_value.uintval * value.m_value.uintval);
@@ -310,7 +402,7 @@ dbcNumber dbcNumber::operator+(const dbcNumber& value)
           return dbcNumber(m_value.sintval + value.m_value.sintval);
           break;
         case DBC_NUMBER_INTEGER_UNSIGNED:
-          return dbcNumber((int32_t)m_value.uintval + value.m_value.sintval);
+          return dbcNumber((int64_t)m_value.uintval + value.m_value.sintval);
           break;
         case DBC_NUMBER_DOUBLE:
           return dbcNumber(m_value.doubleval + value.m_value.sintval);
@@ -323,7 +415,7 @@ dbcNumber dbcNumber::operator+(const dbcNumber& value)
       switch (m_type)
         {
         case DBC_NUMBER_INTEGER_SIGNED:
-          return dbcNumber(m_value.sintval + value.m_value.uintval);
+          return dbcNumber(m_value.sintval + (int64_t)value.m_value.uintval);
           break;
         case DBC_NUMBER_INTEGER_UNSIGNED:
           return dbcNumber(m_value.uintval + value.m_value.uintval);
@@ -377,7 +469,7 @@ bool dbcNumber::operator==(const uint32_t value) const
   switch (m_type)
     {
     case DBC_NUMBER_INTEGER_SIGNED:
-      return (m_value.sintval >= 0) && (value == uint32_t(m_value.sintval));
+      return (m_value.sintval >= 0) && (value == uint64_t(m_value.sintval));
     case DBC_NUMBER_INTEGER_UNSIGNED:
       return m_value.uintval == value;
     case DBC_NUMBER_DOUBLE:
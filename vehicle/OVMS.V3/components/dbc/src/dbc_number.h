@@ -49,7 +49,10 @@ class dbcNumber
     dbcNumber();
     dbcNumber(int32_t value);
     dbcNumber(uint32_t value);
+    dbcNumber(int64_t value);
+    dbcNumber(uint64_t value);
     dbcNumber(double value);
+    dbcNumber(const dbcNumber& value) = default;
     ~dbcNumber();
 
   public:
@@ -60,14 +63,21 @@ class dbcNumber
     bool IsDouble() const;
     void Set(int32_t value);
     void Set(uint32_t value);
+    void Set(int64_t value);
+    void Set(uint64_t value);
     void Set(double value);
     void Cast(uint32_t value, dbcNumberType_t type);
+    void Cast(uint64_t value, dbcNumberType_t type);
     int32_t GetSignedInteger() const;
     uint32_t GetUnsignedInteger() const;
+    int64_t GetSignedInteger64() const;
+    uint64_t GetUnsignedInteger64() const;
     double GetDouble() const;
     friend std::ostream& operator<<(std::ostream& os, const dbcNumber& me);
     dbcNumber& operator=(const int32_t value);
     dbcNumber& operator=(const uint32_t value);
+    dbcNumber& operator=(const int64_t value);
+    dbcNumber& operator=(const uint64_t value);
     dbcNumber& operator=(const double value);
     dbcNumber& operator=(const dbcNumber& value);
     dbcNumber operator*(const dbcNumber& value);
@@ -80,8 +90,8 @@ class dbcNumber
     dbcNumberType_t m_type;
     union
       {
-      uint32_t uintval;
-      int32_t sintval;
+      uint64_t uintval;
+      int64_t sintval;
       double doubleval;
       } m_value;
   };
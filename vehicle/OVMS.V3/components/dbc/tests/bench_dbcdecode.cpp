@@ -0,0 +1,496 @@
+// bench_dbcdecode.cpp — Native laptop benchmark for compiled DBC decode plans.
+//
+// Loads a DBC (a real file given on the command line, e.g. the Tesla Model 3
+// CAN DBC from opendbc, or a generated one of the same shape by default) and
+// decodes random frames with dbcMessage::DecodeSignal() and with the former
+// implementation walking the signal list with a mux cache map & recursive
+// lambda. Metric assignments and the log output of both must be identical.
+// The compiled decode must not allocate from the heap when assigning metrics.
+//
+// Run:  make bench   (from the tests/ directory)
+//       ./bench path/to/file.dbc
+
+#include "dbc.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Heap allocation counter
+// ---------------------------------------------------------------------------
+
+static uint64_t g_allocs = 0;
+
+void* operator new(size_t size) {
+    g_allocs++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+// Not inlined, so GCC doesn't pair new expressions with the free() calls:
+__attribute__((noinline)) static void heap_free(void* p) { free(p); }
+void operator delete(void* p) noexcept { heap_free(p); }
+void operator delete[](void* p) noexcept { heap_free(p); }
+void operator delete(void* p, size_t) noexcept { heap_free(p); }
+void operator delete[](void* p, size_t) noexcept { heap_free(p); }
+
+// ---------------------------------------------------------------------------
+// Former dbcMessage::DecodeSignal()
+// ---------------------------------------------------------------------------
+
+static void LegacyDecodeSignal(const dbcMessage* self, const uint8_t* msg, uint8_t size, bool assignMetrics, OvmsWriter* writer) {
+    dbcSignal* mux = self->GetMultiplexorSignal();
+    std::map<dbcSignal *,std::pair<bool, dbcNumber> > mux_vals;
+
+    std::function<std::pair<bool,dbcNumber>(dbcSignal*)> match_mux_signal =
+        [mux, &mux_vals, &match_mux_signal, msg, size, writer]
+        (dbcSignal *sig) -> std::pair<bool,dbcNumber> {
+        auto found = mux_vals.find(sig);
+        if (found != mux_vals.end())
+            return found->second;
+
+        std::pair<bool, dbcNumber> muxval;
+        if (!sig->IsMultiplexSwitch())
+            muxval.first = true;
+        else {
+            auto muxsrc = sig->GetMultiplexSource();
+            if (!muxsrc)
+                muxsrc = mux;
+            if (!muxsrc)
+                muxval.first = false;
+            else {
+                auto val = match_mux_signal(muxsrc);
+                muxval.first = val.first && sig->IsMultiplexSwitchvalue(val.second.GetUnsignedInteger());
+            }
+        }
+        if (muxval.first) {
+            muxval.second = sig->Decode(msg, size);
+            if (writer) {
+                std::ostringstream ss;
+                ss << "  dbc/mux/" << sig->GetName();
+                ss << ": " << muxval.second << " " << sig->GetUnit();
+                writer->puts(ss.str().c_str());
+            }
+        }
+        mux_vals[sig] = muxval;
+        return muxval;
+    };
+
+    for (dbcSignal* sig : self->m_signals) {
+        dbcMetric* m = sig->GetMetric();
+        if (m || writer) {
+            std::pair<bool, dbcNumber> muxval;
+            if (sig->IsMultiplexSwitch())
+                muxval = match_mux_signal(sig);
+            else {
+                muxval.first = true;
+                muxval.second = sig->Decode(msg, size);
+            }
+            if (muxval.first) {
+                if (assignMetrics && (m != nullptr)) {
+                    if (!sig->HasValues())
+                        m->SetValue(muxval.second, sig->GetMetricUnit());
+                    else {
+                        uint32_t val = muxval.second.GetUnsignedInteger();
+                        if (sig->HasValue(val))
+                            m->SetValue(sig->GetValue(val));
+                    }
+                }
+                if (writer) {
+                    std::ostringstream ss;
+                    ss << "  dbc/" << sig->GetName();
+                    if (m != nullptr)
+                        ss << '*';
+                    ss << ": ";
+                    ss << muxval.second;
+                    metric_unit_t unit = sig->GetMetricUnit();
+                    if (unit != Other)
+                        ss << ' ' << OvmsMetricUnitName(unit);
+                    else {
+                        const std::string &unit_name = sig->GetUnit();
+                        if (!unit_name.empty())
+                            ss << ' ' << unit_name;
+                        if (m) {
+                            metric_unit_t defmetunit = m->DefaultUnit();
+                            if (defmetunit != Other)
+                                ss << " (" << OvmsMetricUnitName(defmetunit) << ')';
+                        }
+                    }
+                    if (sig->HasValues()) {
+                        ss << " [";
+                        uint32_t val = muxval.second.GetUnsignedInteger();
+                        if (sig->HasValue(val))
+                            ss << sig->GetValue(val);
+                        ss << "]";
+                    }
+                    writer->puts(ss.str().c_str());
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Metric & writer recorders
+// ---------------------------------------------------------------------------
+
+struct Assignment {
+    uint32_t signal;
+    uint32_t type;      // 0-3 = dbcNumber type, 4 = string
+    uint64_t bits;      // value bits, string hash
+    bool operator==(const Assignment& o) const { return signal == o.signal && type == o.type && bits == o.bits; }
+};
+
+struct Recorder {
+    std::vector<Assignment> log;
+    size_t count = 0;
+    void Reset() { count = 0; }
+    void Add(const Assignment& a) {
+        if (count < log.size())
+            log[count++] = a;
+    }
+};
+
+static Recorder* g_rec = nullptr;
+
+class RecordMetric : public dbcMetric {
+  public:
+    RecordMetric(uint32_t id) : m_id(id) {}
+    void SetValue(dbcNumber value, metric_unit_t) override {
+        Assignment a{m_id, 0, 0};
+        if (value.IsSignedInteger()) { a.type = 1; a.bits = (uint32_t)value.GetSignedInteger(); }
+        else if (value.IsUnsignedInteger()) { a.type = 2; a.bits = value.GetUnsignedInteger(); }
+        else if (value.IsDouble()) { double d = value.GetDouble(); a.type = 3; memcpy(&a.bits, &d, sizeof(d)); }
+        g_rec->Add(a);
+    }
+    void SetValue(const std::string& value) override {
+        uint64_t h = 1469598103934665603ULL;
+        for (unsigned char c : value) h = (h ^ c) * 1099511628211ULL;
+        g_rec->Add(Assignment{m_id, 4, h});
+    }
+    metric_unit_t DefaultUnit() const override { return Other; }
+  private:
+    uint32_t m_id;
+};
+
+class StringWriter : public OvmsWriter {
+  public:
+    int puts(const char* s) override { out.append(s); out.push_back('\n'); return 0; }
+    std::string out;
+};
+
+// ---------------------------------------------------------------------------
+// DBC reader (BO_, SG_, SG_MUL_VAL_ & VAL_ lines), as the bison parser does
+// ---------------------------------------------------------------------------
+
+static bool LoadDbc(std::istream& in, dbcfile& dbc) {
+    std::string line;
+    dbcMessage* msg = nullptr;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        std::string kw;
+        ls >> kw;
+        if (kw == "BO_") {
+            uint32_t id;
+            std::string name, node;
+            int size;
+            ls >> id >> name >> size >> node;
+            if (!name.empty() && name.back() == ':') name.pop_back();
+            msg = new dbcMessage(id);
+            msg->SetName(name);
+            msg->SetSize(size);
+            dbc.m_messages.AddMessage(id, msg);
+        } else if (kw == "SG_" && msg) {
+            std::string name, tok;
+            ls >> name >> tok;
+            dbcSignal* sig = new dbcSignal(name);
+            if (tok != ":") {
+                if (tok[0] == 'M')
+                    sig->SetMultiplexSource();
+                else if (tok[0] == 'm') {
+                    if (tok.size() > 2 && tok.back() == 'M')
+                        sig->SetMultiplexSource();
+                    sig->SetMultiplexed((uint32_t)strtoul(tok.c_str() + 1, NULL, 10));
+                }
+                ls >> tok;
+            }
+            std::string rest;
+            std::getline(ls, rest);
+            int start, len, order;
+            char sign;
+            double factor, offset, min, max;
+            char unit[64] = "";
+            if (sscanf(rest.c_str(), " %d|%d@%d%c (%lf,%lf) [%lf|%lf] \"%63[^\"]\"",
+                       &start, &len, &order, &sign, &factor, &offset, &min, &max, unit) < 8) {
+                delete sig;
+                continue;
+            }
+            sig->SetStartSize(start, len);
+            sig->SetByteOrder((dbcByteOrder_t)order);
+            sig->SetValueType((sign == '+') ? DBC_VALUETYPE_UNSIGNED : DBC_VALUETYPE_SIGNED);
+            sig->SetFactorOffset(factor, offset);
+            sig->SetMinMax(min, max);
+            sig->SetUnit(unit);
+            msg->AddSignal(sig);
+        } else if (kw == "SG_MUL_VAL_") {
+            uint32_t id;
+            std::string name, src, ranges;
+            ls >> id >> name >> src;
+            std::getline(ls, ranges, ';');
+            dbcMessage* m = dbc.m_messages.FindMessage(id);
+            dbcSignal* sig = m ? m->FindSignal(name) : nullptr;
+            dbcSignal* s = m ? m->FindSignal(src) : nullptr;
+            if (!sig || !s || !sig->IsMultiplexSwitch()) continue;
+            sig->SetMultiplexSource(s);
+            std::istringstream rs(ranges);
+            std::string r;
+            while (std::getline(rs, r, ',')) {
+                dbcSwitchRange_t range;
+                if (sscanf(r.c_str(), " %u-%u", &range.min_val, &range.max_val) == 2)
+                    sig->AddMultiplexRange(range);
+            }
+        } else if (kw == "VAL_") {
+            uint32_t id;
+            std::string name, rest;
+            ls >> id >> name;
+            std::getline(ls, rest, ';');
+            dbcMessage* m = dbc.m_messages.FindMessage(id);
+            dbcSignal* sig = m ? m->FindSignal(name) : nullptr;
+            if (!sig) continue;
+            const char* p = rest.c_str();
+            unsigned v;
+            char text[128];
+            int n;
+            while (sscanf(p, " %u \"%127[^\"]\"%n", &v, text, &n) == 2) {
+                sig->AddValue(v, text);
+                p += n;
+            }
+        }
+    }
+    // as dbcfile::LoadFile():
+    dbc.m_messages.Compile();
+    return !dbc.m_messages.m_entrymap.empty();
+}
+
+// ---------------------------------------------------------------------------
+// Generated DBC: shape of the Tesla Model 3 vehicle bus DBC
+// (~150 messages, some thousand signals, mostly Intel byte order, multiplexed
+// battery/thermal pages, some nested mux & value tables)
+// ---------------------------------------------------------------------------
+
+static std::string GenerateDbc(std::mt19937& rng) {
+    std::ostringstream out;
+    std::uniform_int_distribution<int> pct(0, 99);
+    const double factors[] = { 1, 1, 1, 0.1, 0.01, 0.5, 0.25, 0.125, 2, 0.001, 0.0625 };
+    const double offsets[] = { 0, 0, 0, 0, -40, -128, -1638.35, 0.5, 100 };
+    const char* units[] = { "", "", "V", "A", "C", "kph", "%", "Nm" };
+    uint32_t id = 0x100;
+    int n = 0;
+
+    auto signal = [&](const std::string& name, const char* mux, int start, int len, bool be) {
+        bool sgn = pct(rng) < 30;
+        double f = factors[rng() % (sizeof(factors) / sizeof(factors[0]))];
+        double o = offsets[rng() % (sizeof(offsets) / sizeof(offsets[0]))];
+        out << " SG_ " << name << ' ' << mux << (mux[0] ? " " : "") << ": " << start << '|' << len
+            << '@' << (be ? 0 : 1) << (sgn ? '-' : '+') << " (" << f << ',' << o << ") [0|0] \""
+            << units[rng() % (sizeof(units) / sizeof(units[0]))] << "\" X\n";
+    };
+    // Pack signals into bits [from, 64), returns the number added
+    auto pack = [&](const std::string& prefix, const char* mux, int from) {
+        int bit = from, count = 0;
+        std::uniform_int_distribution<int> size(1, 20);
+        while (true) {
+            int len = (pct(rng) < 15) ? 1 : size(rng);
+            if (bit + len > 64) break;
+            bool be = pct(rng) < 10;
+            if (be) {
+                // Motorola: start bit is the MSB, continuing at bit 7 of the
+                // following bytes; use whole bytes to keep the packing simple
+                int first = (bit + 7) / 8, bytes = 1 + rng() % 3;
+                if (first + bytes > 8) break;
+                int msb = rng() % 8;
+                len = msb + 1 + 8 * (bytes - 1) - (int)(rng() % (bytes > 1 ? 8 : msb + 1));
+                signal(prefix + std::to_string(count++), mux, first * 8 + msb, len, true);
+                bit = (first + bytes) * 8;
+                continue;
+            }
+            signal(prefix + std::to_string(count++), mux, bit, len, false);
+            bit += len;
+            if (pct(rng) < 20) bit += 1 + pct(rng) % 4;   // unused bits
+        }
+        return count;
+    };
+
+    // Plain messages
+    for (int i = 0; i < 110; i++, id += 3) {
+        std::string name = "MSG_" + std::to_string(id);
+        out << "BO_ " << id << ' ' << name << ": 8 X\n";
+        n += pack(name + "_s", "", 0);
+        if (pct(rng) < 30) {
+            out << " SG_ " << name << "_state : 60|4@1+ (1,0) [0|0] \"\" X\n";
+            out << "VAL_ " << id << ' ' << name << "_state 0 \"OFF\" 1 \"STANDBY\" 2 \"ON\" 3 \"FAULT\" ;\n";
+        }
+        out << "\n";
+    }
+    // Multiplexed pages (cell voltages, temperatures, ...)
+    for (int i = 0; i < 32; i++, id += 3) {
+        std::string name = "MUX_" + std::to_string(id);
+        int pages = 2 + rng() % 24;
+        out << "BO_ " << id << ' ' << name << ": 8 X\n";
+        out << " SG_ " << name << "_index M : 0|5@1+ (1,0) [0|0] \"\" X\n";
+        for (int p = 0; p < pages; p++) {
+            std::string m = "m" + std::to_string(p);
+            n += pack(name + "_p" + std::to_string(p) + "_", m.c_str(), 5);
+        }
+        out << "\n";
+    }
+    // Nested mux: page 0 has a sub index selecting groups of signals
+    for (int i = 0; i < 8; i++, id += 3) {
+        std::string name = "NEST_" + std::to_string(id);
+        out << "BO_ " << id << ' ' << name << ": 8 X\n";
+        out << " SG_ " << name << "_index M : 0|3@1+ (1,0) [0|0] \"\" X\n";
+        out << " SG_ " << name << "_sub m0M : 3|4@1+ (1,0) [0|0] \"\" X\n";
+        std::ostringstream ext;
+        for (int g = 0; g < 4; g++) {
+            std::string prefix = name + "_g" + std::to_string(g) + "_";
+            int count = pack(prefix, "m0", 7);
+            for (int s = 0; s < count; s++)
+                ext << "SG_MUL_VAL_ " << id << ' ' << prefix << s << ' ' << name << "_sub "
+                    << g * 4 << '-' << g * 4 + 2 << ";\n";
+            n += count;
+        }
+        for (int p = 1; p < 4; p++) {
+            std::string m = "m" + std::to_string(p);
+            n += pack(name + "_p" + std::to_string(p) + "_", m.c_str(), 3);
+        }
+        out << "\n" << ext.str() << "\n";
+    }
+    return out.str();
+}
+
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+    std::mt19937 rng(2026);
+    dbcfile dbc;
+    std::string source;
+
+    if (argc > 1) {
+        std::ifstream in(argv[1]);
+        if (!in || !LoadDbc(in, dbc)) {
+            fprintf(stderr, "Could not load %s\n", argv[1]);
+            return 1;
+        }
+        source = argv[1];
+    } else {
+        std::istringstream in(GenerateDbc(rng));
+        LoadDbc(in, dbc);
+        source = "generated (Model 3 shape)";
+    }
+
+    // Attach a recording metric to every signal
+    Recorder rec_old, rec_new;
+    std::vector<dbcMessage*> msgs;
+    uint32_t nsignals = 0;
+    for (auto& e : dbc.m_messages.m_entrymap) {
+        msgs.push_back(e.second);
+        for (dbcSignal* sig : e.second->m_signals)
+            sig->AttachDbcMetric(new RecordMetric(nsignals++));
+    }
+    rec_old.log.resize(nsignals + 1);
+    rec_new.log.resize(nsignals + 1);
+
+    printf("DBC decode: %s, %zu messages, %u signals\n\n", source.c_str(), msgs.size(), nsignals);
+
+    // Random traffic: 8 byte frames (some short) of random messages
+    const size_t frames = 200000;
+    std::vector<std::pair<dbcMessage*, std::vector<uint8_t>>> traffic;
+    std::uniform_int_distribution<size_t> pick(0, msgs.size() - 1);
+    std::uniform_int_distribution<int> byte(0, 255), pct(0, 99);
+    for (size_t i = 0; i < frames; i++) {
+        std::vector<uint8_t> data(64);
+        for (auto& b : data) b = byte(rng);
+        dbcMessage* m = msgs[pick(rng)];
+        int size = m->GetSize() > 0 ? m->GetSize() : 8;
+        if (pct(rng) < 2) size = pct(rng) % size;
+        data.resize(size);
+        traffic.emplace_back(m, std::move(data));
+    }
+
+    int failures = 0;
+
+    // 1. Metric assignments must match
+    size_t mismatches = 0, assigned = 0;
+    for (size_t i = 0; i < frames; i++) {
+        auto& t = traffic[i];
+        g_rec = &rec_old;
+        rec_old.Reset();
+        LegacyDecodeSignal(t.first, t.second.data(), t.second.size(), true, nullptr);
+        g_rec = &rec_new;
+        rec_new.Reset();
+        t.first->DecodeSignal(t.second.data(), t.second.size(), true, nullptr);
+        assigned += rec_new.count;
+        if (rec_old.count != rec_new.count ||
+            !std::equal(rec_old.log.begin(), rec_old.log.begin() + rec_old.count, rec_new.log.begin()))
+            mismatches++;
+        if (i == 20000) break;
+    }
+    printf("Metric check:  %zu assignments, %zu frames differ\n", assigned, mismatches);
+    if (mismatches) failures++;
+
+    // 2. Log output (reverse engineering) must match
+    mismatches = 0;
+    for (size_t i = 0; i < 20000; i++) {
+        auto& t = traffic[i];
+        StringWriter w_old, w_new;
+        LegacyDecodeSignal(t.first, t.second.data(), t.second.size(), false, &w_old);
+        t.first->DecodeSignal(t.second.data(), t.second.size(), false, &w_new);
+        if (w_old.out != w_new.out) {
+            if (!mismatches)
+                printf("First log mismatch (%s):\n--- former\n%s--- compiled\n%s",
+                       t.first->GetName().c_str(), w_old.out.c_str(), w_new.out.c_str());
+            mismatches++;
+        }
+    }
+    printf("Log check:     %zu frames differ\n\n", mismatches);
+    if (mismatches) failures++;
+
+    // 3. Throughput with metrics on all signals
+    g_rec = &rec_new;
+    printf("%-10s %12s %12s %14s %14s\n", "decode", "ns/frame", "allocs/frame", "frames/s", "load@5k fps");
+    double ns[2];
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t allocs = g_allocs;
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto& t : traffic) {
+            rec_new.Reset();
+            if (impl == 0)
+                LegacyDecodeSignal(t.first, t.second.data(), t.second.size(), true, nullptr);
+            else
+                t.first->DecodeSignal(t.second.data(), t.second.size(), true, nullptr);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        allocs = g_allocs - allocs;
+        ns[impl] = std::chrono::duration<double, std::nano>(t1 - t0).count() / frames;
+        printf("%-10s %12.0f %12.2f %14.0f %13.3f%%\n", impl ? "compiled" : "former",
+               ns[impl], (double)allocs / frames, 1e9 / ns[impl], ns[impl] * 5000 / 1e7);
+        if (impl == 1 && allocs) {
+            printf("  compiled decode allocated from the heap\n");
+            failures++;
+        }
+    }
+    printf("speedup    %11.1fx\n", ns[0] / ns[1]);
+
+    printf("\n%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+// can.h — Frame types used by the dbc module, for native laptop builds.
+
+#pragma once
+
+#include <stdint.h>
+#include "ovms_command.h"
+
+typedef enum
+  {
+  CAN_frame_std = 0,
+  CAN_frame_ext = 1
+  } CAN_frame_format_t;
+
+typedef struct
+  {
+  struct
+    {
+    uint8_t DLC;
+    CAN_frame_format_t FF;
+    } FIR;
+  uint32_t MsgID;
+  union
+    {
+    uint8_t u8[8];
+    uint64_t u64;
+    } data;
+  } CAN_frame_t;
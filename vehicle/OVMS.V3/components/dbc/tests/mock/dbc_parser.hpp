@@ -0,0 +1,3 @@
+// dbc_parser.hpp — Empty stand-in for the bison output (not built natively).
+
+#pragma once
@@ -0,0 +1,13 @@
+// ovms_command.h — Minimal OvmsWriter for native laptop builds of the dbc module.
+
+#pragma once
+
+#include <sys/types.h>
+
+class OvmsWriter
+  {
+  public:
+    virtual ~OvmsWriter() {}
+    virtual int puts(const char*) { return 0; }
+    virtual int printf(const char*, ...) { return 0; }
+  };
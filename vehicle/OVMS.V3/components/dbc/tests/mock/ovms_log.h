@@ -0,0 +1,23 @@
+// ovms_log.h — Logging stubs for native laptop builds of the dbc module.
+
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+#include <inttypes.h>
+#include <sys/param.h>
+
+static inline void mock_log(char level, const char* tag, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "%c %s: ", level, tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+#define ESP_LOGE(tag, fmt, ...) mock_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) mock_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) mock_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) do { if (0) mock_log('D', tag, fmt, ##__VA_ARGS__); } while (0)
+#define ESP_LOGV(tag, fmt, ...) do { if (0) mock_log('V', tag, fmt, ##__VA_ARGS__); } while (0)
@@ -0,0 +1,74 @@
+// ovms_metrics.h — Metric stand-ins for native laptop builds of the dbc module.
+// Decoded values are delivered through dbcMetric, so OvmsMetric is not used.
+
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include "dbc_number.h"
+#include "ovms_command.h"
+#include "ovms_log.h"
+
+typedef enum : uint8_t
+  {
+  Other = 0,
+  Native = Other,
+  Kph,
+  Volts,
+  Amps,
+  Celcius
+  } metric_unit_t;
+
+static inline const char* OvmsMetricUnitName(metric_unit_t units)
+  {
+  switch (units)
+    {
+    case Kph:     return "kph";
+    case Volts:   return "V";
+    case Amps:    return "A";
+    case Celcius: return "°C";
+    default:      return "";
+    }
+  }
+
+static inline metric_unit_t OvmsMetricUnitFromName(const char* unit, bool /*allowUniquePrefix*/ = false)
+  {
+  std::string name(unit);
+  if (name == "kph") return Kph;
+  if (name == "V") return Volts;
+  if (name == "A") return Amps;
+  if (name == "C") return Celcius;
+  return Other;
+  }
+
+static inline metric_unit_t OvmsMetricUnitFromLabel(const char*)
+  {
+  return Other;
+  }
+
+class OvmsMetric
+  {
+  public:
+    void SetValue(const dbcNumber&, metric_unit_t) {}
+    void SetValue(const std::string&) {}
+    metric_unit_t GetUnits() { return Other; }
+  };
+
+class OvmsMetrics
+  {
+  public:
+    OvmsMetric* Find(const char*) { return nullptr; }
+  };
+
+inline OvmsMetrics MyMetrics;
+
+template<typename UINT, typename INT>
+INT sign_extend( UINT uvalue, uint8_t signbit)
+  {
+  typedef typename std::make_unsigned<INT>::type uint_t;
+  uint_t newuvalue = uvalue;
+  UINT signmask = UINT(1U) << signbit;
+  if ( newuvalue & signmask)
+    newuvalue |= ~ (static_cast<uint_t>(signmask) - 1);
+  return reinterpret_cast<INT &>(newuvalue);
+  }
@@ -0,0 +1,280 @@
+// test_dbcdecode.cpp — Native laptop test for the 64 bit DBC signal decode.
+//
+// Exhaustively compares the word-at-a-time extraction of dbcSignal::Decode()
+// and of compiled message plans (dbcMessage::DecodeSignal()) with the former
+// bitwise extraction: every start bit & size 1..64, both byte orders, signed
+// & unsigned, on classic CAN (8 byte) and CAN FD (64 byte) payloads and on
+// short payloads (signal beyond the payload must decode as empty).
+// Also checks scaling of values wider than 32 bits.
+//
+// Run:  make test   (from the tests/ directory)
+
+#include "dbc.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+static int reported = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; if (reported++ < 20) { \
+    printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+// ---------------------------------------------------------------------------
+// Reference: former bitwise extraction (dbc.cpp)
+// ---------------------------------------------------------------------------
+
+static inline uint64_t
+ref_extract_bits(const uint8_t *candata, unsigned int bpos, unsigned int align, unsigned int shifter, unsigned int pos)
+  {
+  uint64_t val = (uint64_t)candata[bpos/8];
+  unsigned int mask = (1 << shifter) - 1;
+  return ((val >> align) & mask) << pos;
+  }
+
+static uint64_t
+ref_extract_bits_little_endian(const uint8_t *candata, unsigned int bpos, unsigned int bits, unsigned int* maxbyte)
+  {
+  unsigned int pos, aligner, shifter;
+  uint64_t val = 0;
+
+  pos = 0;
+  while (bits > 0)
+    {
+    aligner = bpos % 8;
+    shifter = 8 - aligner;
+    shifter = MIN(shifter, bits);
+
+    *maxbyte = MAX(*maxbyte, bpos/8);
+    val |= ref_extract_bits(candata, bpos, aligner, shifter, pos);
+    pos += shifter;
+
+    bpos += shifter;
+    bits -= shifter;
+    }
+
+  return val;
+  }
+
+static uint64_t
+ref_extract_bits_big_endian(const uint8_t *candata, unsigned int bpos, unsigned int bits, unsigned int* maxbyte)
+  {
+  unsigned int pos, aligner, slicer;
+  uint64_t val = 0;
+
+  pos = bits;
+  while (bits > 0)
+    {
+    slicer = (bpos % 8) + 1;
+    slicer = MIN(slicer, bits);
+    aligner = ((bpos % 8) + 1) - slicer;
+
+    pos -= slicer;
+    *maxbyte = MAX(*maxbyte, bpos/8);
+    val |= ref_extract_bits(candata, bpos, aligner, slicer, pos);
+
+    bpos = ((bpos / 8) + 1) * 8 + 7;
+    bits -= slicer;
+    }
+
+  return val;
+  }
+
+// Reference decode: raw value, sign extended to 64 bit.
+// Returns false if the signal needs bytes beyond the payload.
+static bool ref_decode(const uint8_t* data, unsigned int size, unsigned int start, unsigned int bits,
+                       bool bigendian, bool sign, uint64_t* value)
+  {
+  // the bitwise functions index the payload, so give them a padded copy
+  std::vector<uint8_t> buf(data, data + size);
+  buf.resize(size + 16, 0);
+  unsigned int maxbyte = 0;
+  uint64_t raw = bigendian
+    ? ref_extract_bits_big_endian(buf.data(), start, bits, &maxbyte)
+    : ref_extract_bits_little_endian(buf.data(), start, bits, &maxbyte);
+  if (maxbyte >= size)
+    return false;
+  if (sign && bits < 64 && (raw & (1ULL << (bits - 1))))
+    raw |= ~((1ULL << bits) - 1);
+  *value = raw;
+  return true;
+  }
+
+// ---------------------------------------------------------------------------
+// Plan check helpers
+// ---------------------------------------------------------------------------
+
+class CaptureMetric : public dbcMetric {
+  public:
+    void SetValue(dbcNumber value, metric_unit_t) override { last = value; count++; }
+    void SetValue(const std::string&) override {}
+    metric_unit_t DefaultUnit() const override { return Other; }
+    dbcNumber last;
+    int count = 0;
+};
+
+static bool same_integer(const dbcNumber& n, bool sign, uint64_t value)
+  {
+  if (sign)
+    return n.IsSignedInteger() && (uint64_t)n.GetSignedInteger64() == value;
+  else
+    return n.IsUnsignedInteger() && n.GetUnsignedInteger64() == value;
+  }
+
+// ---------------------------------------------------------------------------
+// Exhaustive extraction check
+// ---------------------------------------------------------------------------
+
+static void test_extraction(unsigned int size, const std::vector<std::vector<uint8_t>>& payloads)
+  {
+  uint64_t checked = 0, empty = 0;
+  dbcMessage msg(0x123);
+  dbcSignal* sig = new dbcSignal("s");
+  sig->SetFactorOffset(1.0, 0.0);
+  CaptureMetric* metric = new CaptureMetric();
+  sig->AttachDbcMetric(metric);
+  msg.AddSignal(sig);
+
+  // Signals may start beyond the payload (short frames), so cover 8 bytes min:
+  unsigned int maxstart = MAX(size, 8u) * 8;
+  for (unsigned int start = 0; start < maxstart; start++)
+    {
+    for (unsigned int bits = 1; bits <= 64; bits++)
+      {
+      for (int order = 0; order < 2; order++)
+        {
+        bool bigendian = (order == 0);
+        for (int sign = 0; sign < 2; sign++)
+          {
+          sig->SetStartSize(start, bits);
+          sig->SetByteOrder(bigendian ? DBC_BYTEORDER_BIG_ENDIAN : DBC_BYTEORDER_LITTLE_ENDIAN);
+          sig->SetValueType(sign ? DBC_VALUETYPE_SIGNED : DBC_VALUETYPE_UNSIGNED);
+          msg.Compile();
+
+          for (const auto& p : payloads)
+            {
+            uint64_t expect = 0;
+            bool valid = ref_decode(p.data(), size, start, bits, bigendian, sign, &expect);
+            dbcNumber n = sig->Decode(p.data(), size);
+            metric->count = 0;
+            metric->last.Clear();
+            msg.DecodeSignal(p.data(), size);
+            checked++;
+            if (!valid)
+              {
+              empty++;
+              CHECK(!n.IsDefined(), "size %u start %u bits %u %s%s: expected empty",
+                    size, start, bits, bigendian ? "BE" : "LE", sign ? " signed" : "");
+              CHECK(metric->count == 1 && !metric->last.IsDefined(), "plan size %u start %u bits %u %s%s: expected empty",
+                    size, start, bits, bigendian ? "BE" : "LE", sign ? " signed" : "");
+              continue;
+              }
+            CHECK(same_integer(n, sign, expect), "size %u start %u bits %u %s%s: %llx != %llx",
+                  size, start, bits, bigendian ? "BE" : "LE", sign ? " signed" : "",
+                  (unsigned long long)n.GetUnsignedInteger64(), (unsigned long long)expect);
+            CHECK(metric->count == 1 && same_integer(metric->last, sign, expect),
+                  "plan size %u start %u bits %u %s%s: %llx != %llx",
+                  size, start, bits, bigendian ? "BE" : "LE", sign ? " signed" : "",
+                  (unsigned long long)metric->last.GetUnsignedInteger64(), (unsigned long long)expect);
+            }
+          }
+        }
+      }
+    }
+  printf("Payload %2u bytes: %llu decodes checked, %llu beyond payload\n",
+         size, (unsigned long long)checked, (unsigned long long)empty);
+  }
+
+// ---------------------------------------------------------------------------
+// Wide values & scaling
+// ---------------------------------------------------------------------------
+
+static dbcNumber decode(const uint8_t* data, uint8_t size, int start, int bits, dbcByteOrder_t order,
+                        dbcValueType_t type, double factor, double offset)
+  {
+  dbcSignal sig("s");
+  sig.SetStartSize(start, bits);
+  sig.SetByteOrder(order);
+  sig.SetValueType(type);
+  sig.SetFactorOffset(factor, offset);
+  return sig.Decode(data, size);
+  }
+
+static void test_scaling()
+  {
+  const uint8_t ones[8] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+  // 40 bit energy counter [Wh] at bytes 0..4: 0x123456789A
+  const uint8_t energy[8] = { 0x9a, 0x78, 0x56, 0x34, 0x12, 0x00, 0x00, 0x00 };
+  // 64 bit Motorola timestamp
+  const uint8_t stamp[8] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef };
+
+  dbcNumber n = decode(energy, 8, 0, 40, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_UNSIGNED, 1, 0);
+  CHECK(n.IsUnsignedInteger() && n.GetUnsignedInteger64() == 0x123456789AULL, "40 bit raw");
+
+  n = decode(energy, 8, 0, 40, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_UNSIGNED, 0.001, 0);
+  CHECK(n.IsDouble() && fabs(n.GetDouble() - 78187493.530) < 1e-6, "40 bit scaled: %f", n.GetDouble());
+
+  n = decode(energy, 8, 0, 40, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_UNSIGNED, 1000, 0);
+  CHECK(n.IsUnsignedInteger() && n.GetUnsignedInteger64() == 0x123456789AULL * 1000, "40 bit integer factor");
+
+  n = decode(stamp, 8, 7, 64, DBC_BYTEORDER_BIG_ENDIAN, DBC_VALUETYPE_UNSIGNED, 1, 0);
+  CHECK(n.IsUnsignedInteger() && n.GetUnsignedInteger64() == 0x0123456789abcdefULL, "64 bit Motorola");
+
+  n = decode(ones, 8, 0, 64, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_UNSIGNED, 1, 0);
+  CHECK(n.IsUnsignedInteger() && n.GetUnsignedInteger64() == ~0ULL, "64 bit unsigned max");
+
+  n = decode(ones, 8, 0, 64, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_SIGNED, 1, 0);
+  CHECK(n.IsSignedInteger() && n.GetSignedInteger64() == -1, "64 bit signed -1");
+
+  n = decode(ones, 8, 4, 36, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_SIGNED, 2, 0);
+  CHECK(n.IsSignedInteger() && n.GetSignedInteger64() == -2, "signed * integer factor: %lld",
+        (long long)n.GetSignedInteger64());
+
+  // Positive integral results are normalised to unsigned:
+  n = decode(ones, 8, 0, 8, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_SIGNED, 1, 40);
+  CHECK(n.IsUnsignedInteger() && n.GetSignedInteger64() == 39, "signed + integer offset");
+
+  n = decode(ones, 8, 0, 8, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_SIGNED, 10, -40);
+  CHECK(n.IsSignedInteger() && n.GetSignedInteger64() == -50, "signed scaled to negative");
+
+  // 32 bit accessors keep their former truncating behaviour:
+  n = decode(energy, 8, 0, 40, DBC_BYTEORDER_LITTLE_ENDIAN, DBC_VALUETYPE_UNSIGNED, 1, 0);
+  CHECK(n.GetUnsignedInteger() == 0x3456789AU, "32 bit accessor");
+
+  // Integral doubles beyond 32 bit stay exact:
+  dbcNumber d(1099511627776.0);
+  CHECK(d.IsUnsignedInteger() && d.GetUnsignedInteger64() == (1ULL << 40), "integral double");
+  dbcNumber big(1e30);
+  CHECK(big.IsDouble(), "huge double");
+
+  printf("Scaling: done\n");
+  }
+
+// ---------------------------------------------------------------------------
+
+int main()
+  {
+  std::mt19937_64 rng(22);
+  std::vector<std::vector<uint8_t>> payloads;
+  for (int i = 0; i < 4; i++)
+    {
+    std::vector<uint8_t> p(64);
+    for (auto& b : p) b = rng();
+    payloads.push_back(p);
+    }
+  payloads.push_back(std::vector<uint8_t>(64, 0xff));
+  payloads.push_back(std::vector<uint8_t>(64, 0x55));
+
+  test_extraction(8, payloads);
+  test_extraction(64, payloads);
+  for (unsigned int size = 1; size < 8; size++)
+    test_extraction(size, payloads);
+  test_scaling();
+
+  printf("\n%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+  return failures ? 1 : 0;
+  }
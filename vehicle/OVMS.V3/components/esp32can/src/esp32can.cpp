@@ -129,6 +129,7 @@ static inline uint32_t ESP32CAN_rxframe(esp32can *me, BaseType_t* task_woken)
       memset(&msg,0,sizeof(msg));
       msg.type = CAN_frame;
       msg.body.frame.origin = me;
+      msg.body.frame.timestamp_us = CAN_timestamp();
 
       // get FIR
       msg.body.frame.FIR.U = MODULE_ESP32CAN->MBX_CTRL.FCTRL.FIR.U;
@@ -272,6 +273,7 @@ static IRAM_ATTR void ESP32CAN_isr(void *pvParameters)
         msg.type = CAN_txcallback;
         }
       msg.body.frame = me->m_tx_frame;
+      msg.body.frame.timestamp_us = CAN_timestamp();
       msg.body.bus = me;
       xQueueSendFromISR(MyCan.m_rxqueue, &msg, &task_woken);
       }
@@ -76,6 +76,8 @@ static IRAM_ATTR void MCP2515_isr(void *pvParameters)
   CAN_queue_msg_t msg = {};
   msg.type = CAN_asyncinterrupthandler;
   msg.body.bus = me;
+  // Record the interrupt time, used as the RX timestamp of the first frame read:
+  msg.body.frame.timestamp_us = CAN_timestamp();
 
   //send callback request to main CAN processor task
   if (xQueueSendFromISR(MyCan.m_rxqueue, &msg, &task_woken) != pdTRUE)
@@ -810,8 +812,11 @@ bool mcp2515::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesR
   if (intflag <= 2)
     {
     // The indicated RX buffer has a message to be read
+    // (use the ISR timestamp if this is the first frame of the interrupt)
+    uint32_t timestamp_us = frame->timestamp_us;
     memset(frame,0,sizeof(*frame));
     frame->origin = this;
+    frame->timestamp_us = timestamp_us ? timestamp_us : CAN_timestamp();
 
     // read RX buffer and clear interrupt flag:
     uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 13, 1, CMD_READ_RXBUF + ((intflag==1) ? 0 : 4));
@@ -836,6 +841,7 @@ bool mcp2515::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesR
     memcpy(&frame->data,p+5,8);
     *framesReceived = *framesReceived + 1;
     MyCan.IncomingFrame(frame);
+    frame->timestamp_us = 0;
     }
 
   // handle other interrupts that came in at the same time:
@@ -196,7 +196,13 @@ obd2ecu::obd2ecu(const char* name, canbus* can)
 
   xTaskCreatePinnedToCore(OBD2ECU_task, "OVMS OBDII ECU", 6144, (void*)this, 5, &m_task, CORE(1));
 
-  MyCan.RegisterCallback(GetName(), std::bind(&obd2ecu::ECURxCallback, this, _1, _2));
+  canidset* filter = new canidset();
+  uint8_t bus = m_can->m_busnumber+1;
+  filter->Add(bus, REQUEST_PID, REQUEST_PID, CAN_frame_std);
+  filter->Add(bus, FLOWCONTROL_PID, FLOWCONTROL_PID, CAN_frame_std);
+  filter->Add(bus, REQUEST_EXT_PID, REQUEST_EXT_PID, CAN_frame_ext);
+  filter->Add(bus, FLOWCONTROL_EXT_PID, FLOWCONTROL_EXT_PID, CAN_frame_ext);
+  MyCan.RegisterCallback(GetName(), std::bind(&obd2ecu::ECURxCallback, this, _1, _2), false, filter);
   }
 
 obd2ecu::~obd2ecu()
@@ -43,6 +43,7 @@ OvmsBuffer::OvmsBuffer(size_t size, void* userdata)
   m_tail = 0;
   m_size = size;
   m_used = 0;
+  m_scan = 0;
   m_userdata = userdata;
   }
 
@@ -71,6 +72,7 @@ void OvmsBuffer::EmptyAll()
   m_head = 0;
   m_tail = 0;
   m_used = 0;
+  m_scan = 0;
   }
 
 bool OvmsBuffer::Push(uint8_t byte)
@@ -79,7 +81,7 @@ bool OvmsBuffer::Push(uint8_t byte)
 
   m_used++;
   m_buffer[m_head++] = byte;
-  if (m_head >= m_size) m_head=0;
+  if ((size_t)m_head >= m_size) m_head=0;
 
   return true;
   }
@@ -88,13 +90,18 @@ bool OvmsBuffer::Push(uint8_t *byte, size_t count)
   {
   if ((m_size-m_used)<count) return false;
 
-  m_used += count;
-  for (size_t k=0;k<count;k++)
+  // copy in up to two blocks (up to the buffer end, then from the start):
+  size_t done = 0;
+  while (done < count)
     {
-    // ESP_LOGI(TAG, "Push() %02x at %d",byte[k],m_head);
-    m_buffer[m_head++] = byte[k];
-    if (m_head >= m_size) m_head=0;
+    size_t n = m_size - m_head;
+    if (n > count - done) n = count - done;
+    memcpy(m_buffer + m_head, byte + done, n);
+    done += n;
+    m_head += n;
+    if ((size_t)m_head >= m_size) m_head=0;
     }
+  m_used += count;
 
   return true;
   }
@@ -103,24 +110,16 @@ uint8_t OvmsBuffer::Pop()
   {
   if (m_used==0) return 0;
 
-  m_used--;
-  uint8_t result = m_buffer[m_tail++];
-  if (m_tail >= m_size) m_tail=0;
+  uint8_t result = m_buffer[m_tail];
+  Consume(1);
 
   return result;
   }
 
 size_t OvmsBuffer::Pop(size_t count, uint8_t *dest)
   {
-  size_t done = 0;
-
-  while ((m_used>0)&&(done < count))
-    {
-    m_used--;
-    dest[done++] = m_buffer[m_tail++];
-    if (m_tail >= m_size) m_tail=0;
-    }
-
+  size_t done = Peek(count, dest);
+  Consume(done);
   return done;
   }
 
@@ -133,13 +132,17 @@ uint8_t OvmsBuffer::Peek()
 
 size_t OvmsBuffer::Peek(size_t count, uint8_t *dest)
   {
-  size_t done = 0;
+  if (count > m_used) count = m_used;
 
+  size_t done = 0;
   size_t tail = m_tail;
-  while ((done<m_used)&&(done<count))
+  while (done < count)
     {
-    dest[done++] = m_buffer[tail++];
-    if (tail >= m_size) tail=0;
+    size_t n = m_size - tail;
+    if (n > count - done) n = count - done;
+    memcpy(dest + done, m_buffer + tail, n);
+    done += n;
+    tail = 0;
     }
 
   return done;
@@ -152,41 +155,59 @@ void OvmsBuffer::Diagnostics()
     m_used,m_size,m_head,m_tail,hl);
   }
 
+/**
+ * HasLine: find the first CR or LF
+ *  Returns the length of the line (bytes before the CR/LF) or -1 if there is none yet.
+ *  The scan continues where the last call stopped, so polling a buffer while a long
+ *  line trickles in only scans the new bytes.
+ */
 int OvmsBuffer::HasLine()
   {
-  size_t tail = m_tail;
-
   if (m_used==0) return -1;
 
-  // ESP_LOGI(TAG, "HasLine() with tail at %d (%d used)",m_tail,m_used);
-  for (size_t done=0;done<m_used;done++)
+  size_t done = m_scan;
+  size_t tail = m_tail + done;
+  if (tail >= m_size) tail -= m_size;
+  while (done < m_used)
     {
-    // ESP_LOGI(TAG, "HasLine() at tail %d is %02x (%d done)",tail,m_buffer[tail],done);
-    if ((m_buffer[tail]=='\r')||(m_buffer[tail]=='\n'))
+    size_t n = m_size - tail;
+    if (n > m_used - done) n = m_used - done;
+    const uint8_t *start = m_buffer + tail, *end = start + n;
+    for (const uint8_t *p = start; p < end; p++)
       {
-      // ESP_LOGI(TAG, "HasLine() found a CR/LF at tail %d (done=%d)",tail,done);
-      return done;
+      if ((*p=='\r')||(*p=='\n'))
+        {
+        m_scan = done + (p - start);
+        return m_scan;
+        }
       }
-    tail++;
-    if (tail >= m_size) tail=0;
+    done += n;
+    tail = 0;
     }
 
-  // ESP_LOGI(TAG, "HasLine() didnt find a CR/LF");
+  m_scan = m_used;
   return -1;
   }
 
 std::string OvmsBuffer::ReadLine()
   {
-  int hl = HasLine();
+  const char* data;
+  int hl = PeekLine(&data);
   if (hl<0) return std::string("");
 
-  uint8_t result[hl+1];
-  Pop(hl, result);
-
-  if (Peek() == '\r') Pop();
-  if (Peek() == '\n') Pop();
+  std::string result;
+  if (data)
+    {
+    result.assign(data, hl);
+    }
+  else
+    {
+    result.resize(hl);
+    Peek(hl, (uint8_t*)&result[0]);
+    }
+  ConsumeLine(hl);
 
-  return std::string((char*)result,hl);
+  return result;
   }
 
 std::string OvmsBuffer::ReadAll()
@@ -196,6 +217,68 @@ std::string OvmsBuffer::ReadAll()
   return result;
   }
 
+/**
+ * PeekContiguous: get the data at the tail without copying
+ *  Sets *data to the tail and returns the number of bytes readable from there
+ *  up to the buffer end (0 = empty). If the data wraps, the rest follows after
+ *  a Consume() of the first block.
+ */
+size_t OvmsBuffer::PeekContiguous(const uint8_t** data)
+  {
+  *data = m_buffer + m_tail;
+  size_t n = m_size - m_tail;
+  return (n < m_used) ? n : m_used;
+  }
+
+/**
+ * PeekLine: HasLine() with a zero-copy view of the line
+ *  Sets *data to the line if it is stored contiguously, else to NULL
+ *  (use Peek() or ReadLine() then). Consume the line by ConsumeLine().
+ */
+int OvmsBuffer::PeekLine(const char** data)
+  {
+  int hl = HasLine();
+  if (hl >= 0 && (size_t)(m_tail + hl) <= m_size)
+    *data = (const char*)m_buffer + m_tail;
+  else
+    *data = NULL;
+  return hl;
+  }
+
+/**
+ * Consume: drop up to count bytes from the tail
+ */
+size_t OvmsBuffer::Consume(size_t count)
+  {
+  if (count > m_used) count = m_used;
+
+  m_used -= count;
+  m_tail += count;
+  if ((size_t)m_tail >= m_size) m_tail -= m_size;
+  m_scan = (m_scan > count) ? m_scan - count : 0;
+
+  if (m_used == 0)
+    {
+    // restart at the buffer start to keep data contiguous:
+    m_head = 0;
+    m_tail = 0;
+    }
+
+  return count;
+  }
+
+/**
+ * ConsumeLine: drop a line of the length returned by HasLine()/PeekLine()
+ *  and its terminator, same as ReadLine() (one CR and/or one LF)
+ */
+void OvmsBuffer::ConsumeLine(int length)
+  {
+  if (length > 0) Consume(length);
+
+  if (Peek() == '\r') Pop();
+  if (Peek() == '\n') Pop();
+  }
+
 ssize_t OvmsBuffer::PollSocket(int sock, long timeoutms)
   {
   fd_set fds;
@@ -60,6 +60,13 @@ class OvmsBuffer
     std::string ReadLine();
     std::string ReadAll();
 
+  public:
+    // Zero-copy access, pointers are valid until the next buffer modification:
+    size_t PeekContiguous(const uint8_t** data);
+    int PeekLine(const char** data);
+    size_t Consume(size_t count);
+    void ConsumeLine(int length);
+
   public:
     ssize_t PollSocket(int sock, long timeoutms);
 
@@ -72,6 +79,7 @@ class OvmsBuffer
     int m_tail;
     size_t m_size;
     size_t m_used;
+    size_t m_scan;      // Bytes from tail already scanned by HasLine() without a CR/LF
   };
 
 #endif //#ifndef __OVMS_BUFFER_H__
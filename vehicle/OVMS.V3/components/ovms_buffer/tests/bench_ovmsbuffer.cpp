@@ -0,0 +1,209 @@
+// bench_ovmsbuffer.cpp — Native laptop benchmark for OvmsBuffer line reading.
+//
+// Feeds synthetic modem traffic (AT responses, URCs, NMEA sentences and long
+// operator/cell list lines) in small chunks, as received via UART & MUX
+// frames, and reads all complete lines after each chunk the way
+// modem::StandardIncomingHandler() does. Compares the incremental line scan
+// with the former full rescan implementation; the lines read must match.
+//
+// Run:  make bench   (from the tests/ directory)
+
+#include "ovms_buffer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Reference: the former OvmsBuffer line scan & read
+// ---------------------------------------------------------------------------
+
+class RefBuffer {
+public:
+    explicit RefBuffer(size_t size) : m_buffer(size), m_size(size) {}
+
+    bool Push(const uint8_t* data, size_t count) {
+        if (m_size - m_used < count) return false;
+        m_used += count;
+        for (size_t k = 0; k < count; k++) {
+            m_buffer[m_head++] = data[k];
+            if (m_head >= m_size) m_head = 0;
+        }
+        return true;
+    }
+
+    uint8_t Peek() const { return m_used ? m_buffer[m_tail] : 0; }
+
+    uint8_t Pop() {
+        if (m_used == 0) return 0;
+        m_used--;
+        uint8_t result = m_buffer[m_tail++];
+        if (m_tail >= m_size) m_tail = 0;
+        return result;
+    }
+
+    int HasLine() const {
+        size_t tail = m_tail;
+        if (m_used == 0) return -1;
+        for (size_t done = 0; done < m_used; done++) {
+            if (m_buffer[tail] == '\r' || m_buffer[tail] == '\n') return done;
+            if (++tail >= m_size) tail = 0;
+        }
+        return -1;
+    }
+
+    std::string ReadLine() {
+        int hl = HasLine();
+        if (hl < 0) return std::string("");
+        std::vector<uint8_t> result(hl + 1);
+        for (int i = 0; i < hl; i++) result[i] = Pop();
+        if (Peek() == '\r') Pop();
+        if (Peek() == '\n') Pop();
+        return std::string((char*)result.data(), hl);
+    }
+
+    size_t FreeSpace() const { return m_size - m_used; }
+
+private:
+    std::vector<uint8_t> m_buffer;
+    size_t m_size, m_head = 0, m_tail = 0, m_used = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Test data
+// ---------------------------------------------------------------------------
+
+static std::string nmea(std::mt19937& rng, const char* type) {
+    char body[120];
+    std::uniform_int_distribution<int> d(0, 9999);
+    snprintf(body, sizeof(body), "%s,%06d.00,51%02d.%04d,N,006%02d.%04d,E,1,%02d,0.%d,%d.%d,M,47.0,M,,",
+             type, d(rng) * 10, d(rng) % 60, d(rng), d(rng) % 60, d(rng), d(rng) % 13, d(rng) % 10,
+             d(rng) % 500, d(rng) % 10);
+    uint8_t cs = 0;
+    for (const char* p = body + 1; *p; p++) cs ^= *p;
+    char line[140];
+    snprintf(line, sizeof(line), "%s*%02X\r\n", body, cs);
+    return line;
+}
+
+static std::string traffic(std::mt19937& rng, size_t size) {
+    std::string out;
+    std::uniform_int_distribution<int> kind(0, 99), val(0, 31);
+    while (out.size() < size) {
+        int k = kind(rng);
+        if (k < 40) {
+            out += nmea(rng, (k & 1) ? "$GPGGA" : "$GNRMC");
+        } else if (k < 60) {
+            out += "\r\n+CSQ: " + std::to_string(val(rng)) + ",99\r\n\r\nOK\r\n";
+        } else if (k < 75) {
+            out += "\r\n+CREG: 1,5,\"7A2B\",\"01C3F" + std::to_string(val(rng)) + "\",7\r\n";
+        } else if (k < 85) {
+            out += "\r\n+CPSI: LTE,Online,262-02,0x7A2B,27437579,300,EUTRAN-BAND20,6300,3,3,-112,-1046,-775,12\r\n";
+        } else if (k < 95) {
+            out += "\r\nOK\r\n";
+        } else {
+            // long operator list (AT+COPS=?), arrives slowly over many frames
+            out += "\r\n+COPS: ";
+            for (int i = 0; i < 10; i++)
+                out += "(2,\"Operator " + std::to_string(i) + "\",\"OP" + std::to_string(i) + "\",\"2620" +
+                       std::to_string(i) + "\",7),(3,\"Roaming " + std::to_string(i) + "\",\"RM\",\"2621" +
+                       std::to_string(i) + "\",0),";
+            out += ",(0,1,2,3,4),(0,1,2)\r\n\r\nOK\r\n";
+        }
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Runs
+// ---------------------------------------------------------------------------
+
+struct Result {
+    size_t lines = 0, bytes = 0, polls = 0;
+    uint64_t hash = 1469598103934665603ull;
+    double ms = 0;
+
+    void Add(const std::string& line) {
+        lines++;
+        bytes += line.size();
+        for (unsigned char c : line) hash = (hash ^ c) * 1099511628211ull;
+        hash = (hash ^ 0xff) * 1099511628211ull;
+    }
+};
+
+template <typename BUF, typename READ>
+static Result run(BUF& buf, const std::string& data, const std::vector<size_t>& chunks, READ read) {
+    Result r;
+    auto t0 = std::chrono::steady_clock::now();
+    size_t pos = 0;
+    for (size_t c : chunks) {
+        if (pos >= data.size()) break;
+        if (c > data.size() - pos) c = data.size() - pos;
+        if (!buf.Push((uint8_t*)data.data() + pos, c)) {
+            fprintf(stderr, "buffer overflow at %zu\n", pos);
+            break;
+        }
+        pos += c;
+        r.polls++;
+        read(buf, r);
+    }
+    r.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+int main() {
+    std::mt19937 rng(4711);
+    const size_t volume = 4 * 1024 * 1024;
+    std::string data = traffic(rng, volume);
+
+    printf("OvmsBuffer line reading: %zu bytes modem traffic, 1024 byte buffer\n\n", data.size());
+    printf("%-10s %8s %8s | %10s %10s %10s | %7s\n",
+           "chunks", "polls", "lines", "ref ms", "ReadLine", "PeekLine", "speedup");
+
+    int failures = 0;
+    for (size_t maxchunk : {1, 4, 16, 64}) {
+        std::uniform_int_distribution<size_t> len(1, maxchunk);
+        std::vector<size_t> chunks;
+        for (size_t total = 0; total < data.size(); ) {
+            chunks.push_back(len(rng));
+            total += chunks.back();
+        }
+
+        RefBuffer ref(1024);
+        Result rr = run(ref, data, chunks, [](RefBuffer& b, Result& r) {
+            while (b.HasLine() >= 0) r.Add(b.ReadLine());
+        });
+
+        OvmsBuffer buf(1024);
+        Result rn = run(buf, data, chunks, [](OvmsBuffer& b, Result& r) {
+            while (b.HasLine() >= 0) r.Add(b.ReadLine());
+        });
+
+        OvmsBuffer view(1024);
+        Result rv = run(view, data, chunks, [](OvmsBuffer& b, Result& r) {
+            const char* line;
+            int len;
+            while ((len = b.PeekLine(&line)) >= 0) {
+                if (line) {
+                    r.Add(std::string(line, len));
+                    b.ConsumeLine(len);
+                } else {
+                    r.Add(b.ReadLine());
+                }
+            }
+        });
+
+        bool ok = rr.lines == rn.lines && rr.hash == rn.hash && rr.lines == rv.lines && rr.hash == rv.hash;
+        if (!ok) failures++;
+        char label[16];
+        snprintf(label, sizeof(label), "1..%zu", maxchunk);
+        printf("%-10s %8zu %8zu | %10.1f %10.1f %10.1f | %6.1fx%s\n",
+               label, rr.polls, rr.lines, rr.ms, rn.ms, rv.ms, rr.ms / rn.ms, ok ? "" : "  MISMATCH");
+    }
+
+    printf("\n%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,3 @@
+// ovms_command.h — Empty stand-in for native laptop builds of ovms_buffer.
+
+#pragma once
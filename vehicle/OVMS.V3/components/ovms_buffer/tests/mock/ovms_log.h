@@ -0,0 +1,22 @@
+// ovms_log.h — Logging stubs for native laptop builds of ovms_buffer.
+// Not format checked: the firmware formats assume 32 bit size_t.
+
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+
+static inline void mock_log(char level, const char* tag, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "%c %s: ", level, tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+#define ESP_LOGE(tag, fmt, ...) mock_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) mock_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) mock_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) do {} while (0)
+#define ESP_LOGV(tag, fmt, ...) do {} while (0)
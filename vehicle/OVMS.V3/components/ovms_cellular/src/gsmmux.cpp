@@ -115,7 +115,7 @@ static inline uint8_t gsm_fcs_add(uint8_t fcs, uint8_t c)
   return gsm_fcs8[fcs ^ c];
   }
 
-static inline uint8_t gsm_fcs_add_block(uint8_t fcs, uint8_t *c, size_t len)
+static inline uint8_t gsm_fcs_add_block(uint8_t fcs, const uint8_t *c, size_t len)
   {
   while (len--) fcs = gsm_fcs8[fcs ^ *c++];
   return fcs;
@@ -133,7 +133,7 @@ GsmMuxChannel::~GsmMuxChannel()
   {
   }
 
-void GsmMuxChannel::ProcessFrame(uint8_t* frame, size_t length, size_t iframepos)
+void GsmMuxChannel::ProcessFrame(const uint8_t* frame, size_t length, size_t iframepos)
   {
   // Note the <length> provided excludes the start byte, stop byte, and checksum
   // The <frame> pointer itself points to the byte after the start byte
@@ -158,9 +158,14 @@ void GsmMuxChannel::ProcessFrame(uint8_t* frame, size_t length, size_t iframepos
       // GSM_UIH alone set for CGNSSINFO response
       if (frame[1] == (GSM_UIH + GSM_PF) || frame[1] == GSM_UIH )  
         {
-        for (size_t k=iframepos;k<length;k++)
-          m_buffer.Push(frame[k]);
-        m_mux->m_modem->IncomingMuxData(this);
+        // Pass the payload on directly if possible, else buffer as much as fits:
+        size_t size = (length > iframepos) ? length-iframepos : 0;
+        if (size == 0 || !m_mux->m_modem->IncomingMuxPayload(this, frame+iframepos, size))
+          {
+          if (size > m_buffer.FreeSpace()) size = m_buffer.FreeSpace();
+          if (size > 0) m_buffer.Push((uint8_t*)frame+iframepos, size);
+          m_mux->m_modem->IncomingMuxData(this);
+          }
         }
       break;
     case ChanClosing:
@@ -180,7 +185,6 @@ GsmMux::GsmMux(modem* m, int channelcount, size_t maxframesize)
   m_framepos = 0;
   m_frameipos = 0;
   m_framelen = 0;
-  m_framemorelen = false;
   m_openchannels = 0;
   m_framingerrors = 0;
   m_lastgoodrxframe = 0;
@@ -216,7 +220,7 @@ void GsmMux::Shutdown()
   if (m_channels.size() > 0)
     {
     ESP_LOGI(TAG, "Stop MUX");
-    for (int k=0; k<m_channels.size(); k++)
+    for (size_t k=0; k<m_channels.size(); k++)
       {
       GsmMuxChannel* chan = m_channels[k];
       if (chan) delete chan;
@@ -224,10 +228,7 @@ void GsmMux::Shutdown()
     m_channels.clear();
     }
   m_state = DlciClosed;
-  m_framepos = 0;
-  m_frameipos = 0;
-  m_framelen = 0;
-  m_framemorelen = false;
+  ResetFrame();
   m_openchannels = 0;
   m_framingerrors = 0;
   m_lastgoodrxframe = 0;
@@ -273,112 +274,153 @@ uint32_t GsmMux::GoodFrameAge()
   return (m_lastgoodrxframe > 0) ? (monotonictime-m_lastgoodrxframe) : 0;
   }
 
+void GsmMux::ResetFrame()
+  {
+  m_framepos = 0;
+  m_frameipos = 0;
+  m_framelen = 0;
+  }
+
+/**
+ * FrameLength: get the total frame length (including both flags) from the
+ *  header at <frame> (starting with the flag), 0 if the header is incomplete.
+ *  <ipos> is set to the position of the information field.
+ */
+size_t GsmMux::FrameLength(const uint8_t* frame, size_t size, size_t* ipos)
+  {
+  if (size < 4) return 0;
+  size_t len = frame[3] >> 1;
+  if (frame[3] & GSM_EA)
+    {
+    *ipos = 4;
+    return len + 6;
+    }
+  if (size < 5) return 0;
+  *ipos = 5;
+  return len + (frame[4] << 7) + 7;
+  }
+
+/**
+ * Process: demultiplex the data received
+ *
+ *  Scans the contiguous spans of the buffer for the start flag, frames
+ *  contained completely in a span are processed in place. Only frames
+ *  split by the ring buffer wrap or across reads are collected in m_frame.
+ */
 void GsmMux::Process(OvmsBuffer* buf)
   {
-  while (buf->UsedSpace()>0)
+  const uint8_t* data;
+  size_t n, len, ipos;
+
+  while ((n = buf->PeekContiguous(&data)) > 0)
     {
+    if (m_framepos == 0)
+      {
+      // Skip to start of frame, and past repeated flags (end of previous frame):
+      const uint8_t* sof = (const uint8_t*)memchr(data, GSM0_SOF, n);
+      if (sof == NULL)
+        {
+        buf->Consume(n);
+        continue;
+        }
+      size_t skip = sof - data;
+      while ((skip+1 < n)&&(data[skip+1] == GSM0_SOF)) skip++;
+      buf->Consume(skip);
+      data += skip;
+      n -= skip;
+
+      len = FrameLength(data, n, &ipos);
+      if ((len > 0)&&(len <= n)&&(len <= m_framesize))
+        {
+        // We have a complete frame in the span...
+        ProcessFrame(data, len, ipos);
+        buf->Consume(len);
+        continue;
+        }
+
+      // Collect the frame:
+      m_frame[m_framepos++] = GSM0_SOF;
+      buf->Consume(1);
+      continue;
+      }
+
     if (m_framepos == m_framesize)
       {
       // Overflow frame
       ESP_LOGW(TAG, "Frame overflow (%d bytes)",m_framesize);
       MyCommandApp.HexDump(TAG, "Frame head", (const char*)m_frame, 8*16);
-      m_framepos = 0;
-      m_framelen = 0;
-      m_framemorelen = false;
+      ResetFrame();
       m_framingerrors++;
       continue;
       }
-    uint8_t b = buf->Pop();
-    if ((m_framepos == 0)&&(b != GSM0_SOF))
-      {
-      continue; // Skip to start of frame
-      }
-    if ((m_framepos == 1)&&(b == GSM0_SOF)) continue; // We found end of previous frame, so just skip it
-    // ESP_LOGI(TAG, "Got %02x at %d (length sofar = %d)",b,m_framepos,m_framelen);
-    m_frame[m_framepos++] = b;
-    if (m_framepos == 4)
-      {
-      // First byte of length field
-      m_framemorelen = !(b & GSM_EA);
-      m_framelen = (b>>1);
-      if (!m_framemorelen)
-        {
-        m_framelen += (m_framepos+2);
-        m_frameipos = m_framepos;
-        }
-      else
-        {
-        m_framelen += (m_framepos+3);
-        m_frameipos = m_framepos+1;
-        }
-      // ESP_LOGI(TAG, "Frame length (first byte) = %d",m_framelen);
-      }
-    if ((m_framepos == 5)&&(m_framemorelen))
+
+    if (m_framelen == 0)
       {
-      // Second byte of length field
-      m_framelen += (b<<7);
-      m_framemorelen = false;
-      // ESP_LOGI(TAG, "Frame length (second byte) = %d",m_framelen);
+      // Header: address, control & length field
+      uint8_t b = data[0];
+      buf->Consume(1);
+      if ((m_framepos == 1)&&(b == GSM0_SOF)) continue; // We found end of previous frame, so just skip it
+      m_frame[m_framepos++] = b;
+      m_framelen = FrameLength(m_frame, m_framepos, &m_frameipos);
+      continue;
       }
+
+    // Information field, FCS & end flag:
+    len = m_framelen - m_framepos;
+    if (len > n) len = n;
+    if (len > m_framesize - m_framepos) len = m_framesize - m_framepos;
+    memcpy(m_frame+m_framepos, data, len);
+    buf->Consume(len);
+    m_framepos += len;
     if (m_framepos == m_framelen)
       {
-      if (b == GSM0_SOF)
-        {
-        // We have a complete frame...
-        ProcessFrame();
-        }
-      else
-        {
-        // Frame error:
-        int channel = m_frame[1] >> 2;
-        ESP_LOGW(TAG, "Frame error: EOF mismatch (CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%d)",
-          channel, m_frame[1], m_frame[2], m_frame[m_framelen-2], m_framelen);
-        MyCommandApp.HexDump(TAG, "Frame dump", (const char*)m_frame, m_framelen);
-        // find next frame:
-        m_framepos = 0;
-        m_framelen = 0;
-        m_framemorelen = false;
-        m_framingerrors++;
-        }
+      ProcessFrame(m_frame, m_framelen, m_frameipos);
+      ResetFrame();
       }
     }
   }
 
-void GsmMux::ProcessFrame()
+/**
+ * ProcessFrame: check & dispatch a received frame
+ *  <frame> points to the start flag, <length> includes both flags,
+ *  <ipos> is the position of the information field.
+ */
+void GsmMux::ProcessFrame(const uint8_t* frame, size_t length, size_t ipos)
   {
-  int channel = m_frame[1] >>2;
+  int channel = frame[1] >>2;
+
+  if (frame[length-1] != GSM0_SOF)
+    {
+    // Frame error:
+    ESP_LOGW(TAG, "Frame error: EOF mismatch (CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%d)",
+      channel, frame[1], frame[2], frame[length-2], length);
+    MyCommandApp.HexDump(TAG, "Frame dump", (const char*)frame, length);
+    m_framingerrors++;
+    return;
+    }
 
   ESP_LOGV(TAG, "ProcessFrame(CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%d)",
-    channel, m_frame[1], m_frame[2], m_frame[m_framelen-2], m_framelen);
+    channel, frame[1], frame[2], frame[length-2], length);
 
-  uint8_t fcs = 0xFF - gsm_fcs_add_block(FCS_INIT, m_frame+1, m_frameipos-1);
-  if (fcs != m_frame[m_framelen-2])
+  uint8_t fcs = 0xFF - gsm_fcs_add_block(FCS_INIT, frame+1, ipos-1);
+  if (fcs != frame[length-2])
     {
-    ESP_LOGW(TAG, "FCS mismatch (%02x != %02x)",fcs,m_frame[m_framelen-2]);
-    m_framepos = 0;
-    m_frameipos = 0;
-    m_framelen = 0;
+    ESP_LOGW(TAG, "FCS mismatch (%02x != %02x)",fcs,frame[length-2]);
     m_framingerrors++;
-    m_framemorelen = false;
     return;
     }
 
-  GsmMuxChannel* chan = m_channels[channel];
+  GsmMuxChannel* chan = (channel < (int)m_channels.size()) ? m_channels[channel] : NULL;
   if (chan)
     {
     m_lastgoodrxframe = monotonictime;
     m_rxframecount++;
-    chan->ProcessFrame(m_frame+1,m_framelen-3,m_frameipos-1);
+    chan->ProcessFrame(frame+1,length-3,ipos-1);
     }
   else
     {
     ESP_LOGW(TAG, "Incoming message for unrecognised channel #%d",channel);
     }
-
-  m_framepos = 0;
-  m_frameipos = 0;
-  m_framelen = 0;
-  m_framemorelen = false;
   }
 
 void GsmMux::txfcs(uint8_t* data, size_t size, size_t ipos)
@@ -412,7 +454,7 @@ size_t GsmMux::tx(int channel, uint8_t* data, ssize_t size)
     buf[4] = (uint8_t)len; // Length: upper 7 bits
     ipos = 5;
     }
-  for (size_t k=0; k<size; k++)
+  for (ssize_t k=0; k<size; k++)
     {
     buf[ipos+k] = data[k];
     }
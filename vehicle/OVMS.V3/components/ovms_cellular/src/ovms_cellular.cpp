@@ -1816,6 +1816,23 @@ void modem::ConfigChanged(std::string event, void* data)
     }
   }
 
+bool modem::IncomingMuxPayload(GsmMuxChannel* channel, const uint8_t* data, size_t size)
+  {
+  // The MUX offers a frame payload before buffering it in the channel:
+  // pass PPP data in network mode directly to the PPPoS input, as long as
+  // nothing is left buffered (keeping the order).
+
+  if ((channel->m_channel == m_mux_channel_DATA) &&
+      (m_state1 == NetMode) &&
+      (m_ppp != NULL) &&
+      (channel->m_buffer.UsedSpace() == 0))
+    {
+    m_ppp->IncomingData((uint8_t*)data, size);
+    return true;
+    }
+  return false;
+  }
+
 void modem::IncomingMuxData(GsmMuxChannel* channel)
   {
   // The MUX has indicated there is data on the specified channel
@@ -1835,11 +1852,12 @@ void modem::IncomingMuxData(GsmMuxChannel* channel)
     {
     if (m_state1 == NetMode)
       {
-      uint8_t buf[32];
+      const uint8_t* data;
       size_t n;
-      while ((m_ppp != NULL)&&(n = channel->m_buffer.Pop(sizeof(buf),buf)) > 0)
+      while ((m_ppp != NULL)&&(n = channel->m_buffer.PeekContiguous(&data)) > 0)
         {
-        m_ppp->IncomingData(buf,n);
+        m_ppp->IncomingData((uint8_t*)data,n);
+        channel->m_buffer.Consume(n);
         }
       }
     else
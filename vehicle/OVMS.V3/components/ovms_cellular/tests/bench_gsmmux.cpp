@@ -0,0 +1,308 @@
+// bench_gsmmux.cpp — Native laptop benchmark for the GSM 07.10 mux demultiplexer.
+//
+// Replays modem traffic through the former byte by byte GsmMux::Process()
+// and the block scanning one, feeding it in UART reads of up to 128 bytes
+// into the 1024 byte modem buffer as modem::Task() does. The data received
+// per channel, the frame count and the framing error count of both must be
+// identical.
+//
+// Without arguments a capture is simulated: channel setup, PPP data (ch 2),
+// NMEA (ch 1), AT responses (ch 4) and MSC (ch 0), with FCS errors, truncated
+// frames, line noise and an oversized frame. Raw captures of the modem UART
+// (mux mode) can be given as arguments instead.
+//
+// Run:  make bench   (from the tests/ directory)
+
+#include "gsmmux.h"
+#include "ovms_cellular.h"
+#include "ovms_command.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+uint32_t monotonictime = 1;
+OvmsCommandApp MyCommandApp;
+
+void modem::IncomingMuxData(GsmMuxChannel* channel)
+  {
+  const uint8_t* data;
+  size_t n;
+  while ((n = channel->m_buffer.PeekContiguous(&data)) > 0)
+    {
+    m_out[channel->m_channel].append((const char*)data, n);
+    channel->m_buffer.Consume(n);
+    }
+  }
+
+bool modem::IncomingMuxPayload(GsmMuxChannel* channel, const uint8_t* data, size_t size)
+  {
+  if (!m_direct || channel->m_channel != MOCK_MUX_DATA || channel->m_buffer.UsedSpace() > 0)
+    return false;
+  m_out[channel->m_channel].append((const char*)data, size);
+  return true;
+  }
+
+// ---------------------------------------------------------------------------
+// Former demultiplexer (byte by byte), as in gsmmux.cpp before
+// ---------------------------------------------------------------------------
+
+#define GSM_EA    0x01
+#define GSM_CR    0x02
+#define GSM_PF    0x10
+#define GSM_UA    0x63
+#define GSM_UIH   0xEF
+#define GSM0_SOF  0xF9
+
+static uint8_t fcs8[256];
+
+static void InitFcs() {
+    for (int i = 0; i < 256; i++) {
+        uint8_t crc = i;
+        for (int k = 0; k < 8; k++) crc = (crc & 1) ? (crc >> 1) ^ 0xE0 : (crc >> 1);
+        fcs8[i] = crc;
+    }
+}
+
+static uint8_t Fcs(const uint8_t* data, size_t len) {
+    uint8_t fcs = 0xFF;
+    while (len--) fcs = fcs8[fcs ^ *data++];
+    return 0xFF - fcs;
+}
+
+struct LegacyMux {
+    modem* m_modem;
+    std::vector<GsmMuxChannel*> m_channels;
+    uint8_t m_frame[2048];
+    size_t m_framesize = sizeof(m_frame);
+    size_t m_framepos = 0, m_frameipos = 0, m_framelen = 0;
+    bool m_framemorelen = false;
+    uint32_t m_framingerrors = 0, m_rxframecount = 0;
+
+    LegacyMux(modem* m) : m_modem(m) {
+        for (int k = 0; k < MOCK_MUX_CHANNELS; k++) {
+            m_channels.push_back(new GsmMuxChannel(NULL, k, k ? CONFIG_OVMS_HW_CELLULAR_MODEM_MUXCHANNEL_SIZE : 8));
+            m_channels[k]->m_state = GsmMuxChannel::ChanOpen;
+        }
+    }
+    ~LegacyMux() { for (auto c : m_channels) delete c; }
+
+    void Reset() { m_framepos = 0; m_frameipos = 0; m_framelen = 0; m_framemorelen = false; }
+
+    void Process(OvmsBuffer* buf) {
+        while (buf->UsedSpace() > 0) {
+            if (m_framepos == m_framesize) {
+                Reset();
+                m_framingerrors++;
+                continue;
+            }
+            uint8_t b = buf->Pop();
+            if ((m_framepos == 0) && (b != GSM0_SOF)) continue;
+            if ((m_framepos == 1) && (b == GSM0_SOF)) continue;
+            m_frame[m_framepos++] = b;
+            if (m_framepos == 4) {
+                m_framemorelen = !(b & GSM_EA);
+                m_framelen = (b >> 1);
+                if (!m_framemorelen) { m_framelen += (m_framepos + 2); m_frameipos = m_framepos; }
+                else { m_framelen += (m_framepos + 3); m_frameipos = m_framepos + 1; }
+            }
+            if ((m_framepos == 5) && (m_framemorelen)) {
+                m_framelen += (b << 7);
+                m_framemorelen = false;
+            }
+            if (m_framepos == m_framelen) {
+                if (b == GSM0_SOF)
+                    ProcessFrame();
+                else {
+                    m_framepos = 0; m_framelen = 0; m_framemorelen = false;
+                    m_framingerrors++;
+                }
+            }
+        }
+    }
+
+    void ProcessFrame() {
+        int channel = m_frame[1] >> 2;
+        uint8_t fcs = Fcs(m_frame + 1, m_frameipos - 1);
+        if (fcs != m_frame[m_framelen - 2]) {
+            Reset();
+            m_framingerrors++;
+            return;
+        }
+        if (channel < (int)m_channels.size()) {
+            m_rxframecount++;
+            const uint8_t* frame = m_frame + 1;
+            size_t length = m_framelen - 3, iframepos = m_frameipos - 1;
+            GsmMuxChannel* chan = m_channels[channel];
+            if (frame[1] == (GSM_UIH + GSM_PF) || frame[1] == GSM_UIH) {
+                for (size_t k = iframepos; k < length; k++)
+                    chan->m_buffer.Push(frame[k]);
+                m_modem->IncomingMuxData(chan);
+            }
+        }
+        Reset();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Capture simulation
+// ---------------------------------------------------------------------------
+
+static void AddFrame(std::string& out, int channel, uint8_t ctrl, const std::string& payload, bool cr = false) {
+    std::string f;
+    f += (char)GSM0_SOF;
+    f += (char)((channel << 2) | GSM_EA | (cr ? GSM_CR : 0));
+    f += (char)ctrl;
+    size_t len = payload.size();
+    if (len < 128)
+        f += (char)((len << 1) | GSM_EA);
+    else {
+        f += (char)((len % 128) << 1);
+        f += (char)(len / 128);
+    }
+    uint8_t fcs = Fcs((const uint8_t*)f.data() + 1, f.size() - 1);
+    f += payload;
+    f += (char)fcs;
+    f += (char)GSM0_SOF;
+    out += f;
+}
+
+static std::string Capture(size_t size, std::mt19937& rng) {
+    std::string out;
+    for (int k = 0; k < MOCK_MUX_CHANNELS; k++)
+        AddFrame(out, k, GSM_UA + GSM_PF, "", true);
+    static const char* nmea[] = {
+        "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n",
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n",
+    };
+    bool oversized = false;
+    while (out.size() < size) {
+        uint32_t r = rng() % 100;
+        std::string frame;
+        if (r < 70) {
+            // PPP frame, payload bytes may contain flags:
+            size_t len = (rng() % 4) ? 40 + rng() % 120 : 200 + rng() % 1300;
+            std::string p(len, 0);
+            p[0] = 0x7e;
+            for (size_t i = 1; i < len; i++) p[i] = (char)rng();
+            p[len - 1] = 0x7e;
+            AddFrame(frame, 2, (rng() % 2) ? GSM_UIH : GSM_UIH + GSM_PF, p);
+        } else if (r < 85) {
+            AddFrame(frame, 1, GSM_UIH, nmea[rng() % 2]);
+        } else if (r < 95) {
+            AddFrame(frame, 4, GSM_UIH, "\r\n+CSQ: 21,99\r\n\r\nOK\r\n");
+        } else {
+            AddFrame(frame, 0, GSM_UIH, std::string("\xe3\x05\x0b\x0d", 4), true);
+        }
+
+        // Errors:
+        uint32_t e = rng() % 1000;
+        if (e < 5) {
+            frame[frame.size() - 2] ^= 0x55;                       // FCS error
+        } else if (e < 8 && frame.size() > 20) {
+            frame.resize(frame.size() - 5);                        // truncated, EOF mismatch
+        } else if (e < 20) {
+            out += std::string(1 + rng() % 16, (char)(rng() | 1)); // line noise
+        } else if (e < 30) {
+            out += std::string(1 + rng() % 3, (char)GSM0_SOF);     // repeated flags
+        } else if (e < 31 && !oversized) {
+            std::string p(3000, 'x');                              // exceeds the frame buffer
+            frame.clear();
+            AddFrame(frame, 2, GSM_UIH, p);
+            oversized = true;
+        }
+        out += frame;
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+
+struct Result {
+    std::string out[MOCK_MUX_CHANNELS];
+    uint32_t frames, errors;
+    double ns;
+};
+
+template <typename M> static Result Replay(const std::string& capture, M& mux, modem& m, unsigned seed) {
+    std::mt19937 rng(seed);
+    OvmsBuffer buf(1024);
+    const uint8_t* data = (const uint8_t*)capture.data();
+    size_t pos = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    while (pos < capture.size()) {
+        size_t n = 1 + rng() % 128;
+        if (n > capture.size() - pos) n = capture.size() - pos;
+        buf.Push((uint8_t*)data + pos, n);
+        pos += n;
+        mux.Process(&buf);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    Result res;
+    for (int k = 0; k < MOCK_MUX_CHANNELS; k++) res.out[k] = m.m_out[k];
+    res.frames = mux.m_rxframecount;
+    res.errors = mux.m_framingerrors;
+    res.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / capture.size();
+    return res;
+}
+
+static int Compare(const char* name, const std::string& capture, bool direct) {
+    int failures = 0;
+    modem ml, mn;
+    mn.m_direct = direct;
+    LegacyMux legacy(&ml);
+    GsmMux mux(&mn, MOCK_MUX_CHANNELS - 1);
+    mux.Startup();
+    Result rl = Replay(capture, legacy, ml, 42);
+    Result rn = Replay(capture, mux, mn, 42);
+
+    for (int k = 0; k < MOCK_MUX_CHANNELS; k++) {
+        if (rl.out[k] != rn.out[k]) {
+            failures++;
+            printf("FAIL: %s channel %d data differs (%zu / %zu bytes)\n",
+                   name, k, rl.out[k].size(), rn.out[k].size());
+        }
+    }
+    if (rl.frames != rn.frames || rl.errors != rn.errors) {
+        failures++;
+        printf("FAIL: %s frames %u / %u, framing errors %u / %u\n",
+               name, rl.frames, rn.frames, rl.errors, rn.errors);
+    }
+    printf("%-24s %9zu %8u %6u %10.2f %10.2f %7.1fx\n", name, capture.size(), rn.frames, rn.errors,
+           rl.ns, rn.ns, rl.ns / rn.ns);
+    mux.Shutdown();
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    InitFcs();
+    int failures = 0;
+
+    printf("%-24s %9s %8s %6s %10s %10s %8s\n", "capture", "bytes", "frames", "errors",
+           "former ns", "block ns", "speedup");
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            std::ifstream f(argv[i], std::ios::binary);
+            std::string capture((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            failures += Compare(argv[i], capture, true);
+        }
+    } else {
+        for (unsigned seed : { 1u, 2u, 3u }) {
+            std::mt19937 rng(seed);
+            std::string capture = Capture(4 << 20, rng);
+            char name[32];
+            snprintf(name, sizeof(name), "simulated #%u", seed);
+            failures += Compare(name, capture, true);
+            snprintf(name, sizeof(name), "simulated #%u buffered", seed);
+            failures += Compare(name, capture, false);
+        }
+    }
+
+    printf("\n%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,12 @@
+// ovms.h — Framework stand-ins for native laptop builds of gsmmux.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define CONFIG_OVMS_HW_CELLULAR_MODEM_MUXCHANNEL_SIZE 2048
+
+class InternalRamAllocated {};
+
+extern uint32_t monotonictime;
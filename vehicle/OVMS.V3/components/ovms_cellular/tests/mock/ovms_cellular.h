@@ -0,0 +1,31 @@
+// ovms_cellular.h — Modem stand-in for native laptop builds of gsmmux.
+//
+// Collects the data demultiplexed per channel; the data channel is taken
+// to be in network mode (PPP), so payloads may be passed on unbuffered.
+
+// Uses the guard of the framework header: gsmmux.o is built with this mock
+// included first, so gsmmux.cpp's own #include "ovms_cellular.h" (which
+// resolves to the header next to it) is skipped.
+#ifndef __OVMS_CELLULAR_H__
+#define __OVMS_CELLULAR_H__
+
+#include <string>
+#include "gsmmux.h"
+#include "ovms_command.h"
+
+#define MOCK_MUX_CHANNELS 5
+#define MOCK_MUX_DATA     2
+
+class modem
+  {
+  public:
+    void IncomingMuxData(GsmMuxChannel* channel);
+    bool IncomingMuxPayload(GsmMuxChannel* channel, const uint8_t* data, size_t size);
+    void tx(uint8_t* data, size_t size) {}
+
+  public:
+    bool m_direct = true;
+    std::string m_out[MOCK_MUX_CHANNELS];
+  };
+
+#endif //#ifndef __OVMS_CELLULAR_H__
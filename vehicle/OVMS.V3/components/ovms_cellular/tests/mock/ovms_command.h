@@ -0,0 +1,13 @@
+// ovms_command.h — Command framework stand-in for native laptop builds of gsmmux.
+
+#pragma once
+
+#include <cstddef>
+
+class OvmsCommandApp
+  {
+  public:
+    void HexDump(const char* tag, const char* prefix, const char* data, size_t length) {}
+  };
+
+extern OvmsCommandApp MyCommandApp;
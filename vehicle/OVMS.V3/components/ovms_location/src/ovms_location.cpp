@@ -514,6 +514,8 @@ void location_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int ar
   n = MyLocations.m_locations.size();
   writer->printf("There %s %d location%s defined\n",
     n == 1 ? "is" : "are", n, n == 1 ? "" : "s");
+  if (verbosity > COMMAND_RESULT_MINIMAL)
+    MyLocations.GridStatus(writer);
 
   bool found = false;
   for (LocationMap::iterator it=MyLocations.m_locations.begin(); it!=MyLocations.m_locations.end(); ++it)
@@ -706,6 +708,7 @@ OvmsLocations::OvmsLocations()
   m_valet_distance = 0;
   m_valet_invalid = true;
   m_valet_last_alarm = 0;
+  m_location_checked = 0;
 
   // Register our commands
   OvmsCommand* cmd_location = MyCommandApp.RegisterCommand("location","LOCATION framework", location_status, "", 0, 0, false);
@@ -910,17 +913,57 @@ void OvmsLocations::ReloadMap()
       }
     }
 
+  ReloadGrid();
+
   if (m_gpsgood) UpdateLocations();
   }
 
+/**
+ * ReloadGrid: rebuild the location list & spatial index after changes to m_locations
+ */
+void OvmsLocations::ReloadGrid()
+  {
+  m_location_list.clear();
+  m_location_list.reserve(m_locations.size());
+  m_location_inside.clear();
+  m_grid.Clear();
+  for (LocationMap::iterator it=m_locations.begin(); it!=m_locations.end(); ++it)
+    {
+    OvmsLocation* loc = it->second;
+    uint32_t index = m_location_list.size();
+    m_location_list.push_back(loc);
+    m_grid.Add(index, loc->m_latitude, loc->m_longitude, loc->m_radius);
+    if (loc->m_inlocation)
+      m_location_inside.push_back(index);
+    }
+  m_grid.Build();
+  }
+
+void OvmsLocations::GridStatus(OvmsWriter* writer)
+  {
+  writer->printf("Location index: %u cell entries, %u always checked, %u checked on last update\n",
+    (unsigned)m_grid.Cells(), (unsigned)m_grid.Wide(), (unsigned)m_location_checked);
+  }
+
 void OvmsLocations::UpdateLocations()
   {
   if ((m_latitude == 0) && (m_longitude == 0)) return;
 
-  for (LocationMap::iterator it=m_locations.begin(); it!=m_locations.end(); ++it)
+  // Check the locations near the position and those we are in (to detect leaving),
+  // in map order like a full scan, so enter/leave events & actions keep their order.
+  // Locations not checked can neither be entered nor left.
+  m_location_check = m_location_inside;
+  m_grid.Find(m_latitude, m_longitude, m_location_check);
+  std::sort(m_location_check.begin(), m_location_check.end());
+  m_location_check.erase(std::unique(m_location_check.begin(), m_location_check.end()), m_location_check.end());
+
+  m_location_inside.clear();
+  for (uint32_t index : m_location_check)
     {
-    it->second->IsInLocation(m_latitude,m_longitude);
+    if (m_location_list[index]->IsInLocation(m_latitude,m_longitude))
+      m_location_inside.push_back(index);
     }
+  m_location_checked = m_location_check.size();
   }
 
 void OvmsLocations::CheckTheft()
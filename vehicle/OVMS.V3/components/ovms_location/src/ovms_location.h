@@ -34,6 +34,7 @@
 #include "ovms_metrics.h"
 #include "ovms_utils.h"
 #include "ovms_command.h"
+#include "ovms_location_grid.h"
 
 enum LocationAction {
   INVALID = 0,
@@ -119,8 +120,17 @@ class OvmsLocations
 
     LocationMap m_locations;
 
+  protected:
+    std::vector<OvmsLocation*> m_location_list;   // m_locations in map order, indexed by m_grid
+    OvmsLocationGrid m_grid;
+    std::vector<uint32_t> m_location_inside;      // List indices of locations we are in
+    std::vector<uint32_t> m_location_check;       // List indices to check (temporary)
+    uint32_t m_location_checked;                  // Locations checked by last update
+
   public:
     void ReloadMap();
+    void ReloadGrid();
+    void GridStatus(OvmsWriter* writer);
     void UpdateLocations();
     void UpdateParkPosition();
     void CheckTheft();
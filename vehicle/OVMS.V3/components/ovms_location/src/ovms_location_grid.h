@@ -0,0 +1,170 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+#ifndef __LOCATION_GRID_H__
+#define __LOCATION_GRID_H__
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Spatial index of the geofence locations (circles: center & radius in meters).
+ *
+ * Each location is registered in the grid cells (LOCATION_GRID_CELL degrees) its
+ * bounding box overlaps. A position lookup only checks the locations of the cell
+ * containing it, and those only if the position is within their bounding box, so
+ * the exact (haversine) distance only needs to be computed for close locations.
+ *
+ * Bounding boxes are conservative (superset of the circle), so the lookup never
+ * misses a location the exact test would match. Locations covering too many
+ * cells (very large radius, near the poles or across the date line) are kept in
+ * a separate list checked on every lookup.
+ *
+ * Locations are referenced by their index in the caller's list. Independent of
+ * the framework, so it can be tested on the host.
+ */
+
+#define LOCATION_GRID_CELL      0.05      // Cell size in degrees (~5.5 km latitude)
+#define LOCATION_GRID_MAXCELLS  16        // Max cells per location, else checked always
+#define LOCATION_GRID_EARTH_R   6371000.0 // Earth radius in meters, as in OvmsLocationDistance()
+
+class OvmsLocationGrid
+  {
+  public:
+    OvmsLocationGrid() {}
+
+    void Clear()
+      {
+      m_boxes.clear();
+      m_cells.clear();
+      m_wide.clear();
+      }
+
+    /// Add location index with center & radius; call Build() after adding all.
+    void Add(uint32_t index, float latitude, float longitude, int radius)
+      {
+      if (index >= m_boxes.size())
+        m_boxes.resize(index + 1, box_t{1, -1, 1, -1});
+      if (radius < 0)
+        return;  // never inside
+
+      // Conservative extent: 1% + 1e-6° margin for float rounding
+      double delta = (double)radius / LOCATION_GRID_EARTH_R;
+      double dlat = delta * (180 / M_PI) * 1.01 + 1e-6;
+      double clat = cos((double)latitude * (M_PI / 180));
+      double slon = (clat > 0) ? sin(delta) / clat : 2;
+      double dlon = (slon < 1) ? asin(slon) * (180 / M_PI) * 1.01 + 1e-6 : 360;
+      box_t& box = m_boxes[index];
+      box.lat_min = latitude - dlat;
+      box.lat_max = latitude + dlat;
+      box.lon_min = longitude - dlon;
+      box.lon_max = longitude + dlon;
+
+      if (box.lon_min < -180 || box.lon_max > 180)
+        {
+        // wraps around the date line / pole:
+        box.lon_min = -1000;
+        box.lon_max = 1000;
+        m_wide.push_back(index);
+        return;
+        }
+      int32_t y0 = Cell(box.lat_min), y1 = Cell(box.lat_max);
+      int32_t x0 = Cell(box.lon_min), x1 = Cell(box.lon_max);
+      if ((y1 - y0 + 1) * (x1 - x0 + 1) > LOCATION_GRID_MAXCELLS)
+        {
+        m_wide.push_back(index);
+        return;
+        }
+      for (int32_t y = y0; y <= y1; y++)
+        for (int32_t x = x0; x <= x1; x++)
+          m_cells.push_back(cell_entry_t{Key(y, x), index});
+      }
+
+    /// Sort the cell entries for lookup.
+    void Build()
+      {
+      std::sort(m_cells.begin(), m_cells.end(),
+        [](const cell_entry_t& a, const cell_entry_t& b) { return a.key < b.key; });
+      m_cells.shrink_to_fit();
+      m_wide.shrink_to_fit();
+      }
+
+    /**
+     * Find: append the indices of the locations possibly containing the position.
+     *  Each index is appended at most once, order is unspecified.
+     */
+    void Find(float latitude, float longitude, std::vector<uint32_t>& result) const
+      {
+      for (uint32_t index : m_wide)
+        {
+        if (m_boxes[index].Contains(latitude, longitude))
+          result.push_back(index);
+        }
+      uint32_t key = Key(Cell(latitude), Cell(longitude));
+      auto it = std::lower_bound(m_cells.begin(), m_cells.end(), key,
+        [](const cell_entry_t& e, uint32_t k) { return e.key < k; });
+      for (; it != m_cells.end() && it->key == key; ++it)
+        {
+        if (m_boxes[it->index].Contains(latitude, longitude))
+          result.push_back(it->index);
+        }
+      }
+
+    size_t Cells() const { return m_cells.size(); }
+    size_t Wide() const { return m_wide.size(); }
+
+  private:
+    typedef struct
+      {
+      float lat_min, lat_max;
+      float lon_min, lon_max;
+      bool Contains(float latitude, float longitude) const
+        {
+        return latitude >= lat_min && latitude <= lat_max &&
+               longitude >= lon_min && longitude <= lon_max;
+        }
+      } box_t;
+
+    typedef struct
+      {
+      uint32_t key;
+      uint32_t index;
+      } cell_entry_t;
+
+    static int32_t Cell(double degrees)
+      {
+      return (int32_t)floor(degrees / LOCATION_GRID_CELL);
+      }
+    static uint32_t Key(int32_t y, int32_t x)
+      {
+      // 0.05° cells: latitude -1800…1800, longitude -3600…3600
+      return ((uint32_t)(y + 2048) << 16) | (uint32_t)(x + 4096);
+      }
+
+    std::vector<box_t>        m_boxes;    // Bounding boxes by location index
+    std::vector<cell_entry_t> m_cells;    // Cell entries sorted by key
+    std::vector<uint32_t>     m_wide;     // Locations checked on every lookup
+  };
+
+#endif // __LOCATION_GRID_H__
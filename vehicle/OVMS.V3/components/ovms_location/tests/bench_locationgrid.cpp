@@ -0,0 +1,221 @@
+// bench_locationgrid.cpp — Native laptop benchmark for the location grid index.
+//
+// Simulates fleet units with many depot/charger geofences driving between
+// them at 1 Hz, and compares OvmsLocations::UpdateLocations() using the
+// grid index (checking nearby & entered locations in list order) with the
+// former full scan computing the distance to every location. The enter/leave
+// event sequences of both must be identical.
+//
+// Run:  make bench   (from the tests/ directory)
+
+#include "ovms_location_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Framework parts: distance & location state as in ovms_location.cpp
+// ---------------------------------------------------------------------------
+
+#define LOCATION_R 6371
+#define LOCATION_TO_RAD (3.1415926536 / 180)
+
+static double OvmsLocationDistance(double th1, double ph1, double th2, double ph2) {
+    double dx, dy, dz;
+    ph1 -= ph2;
+    ph1 *= LOCATION_TO_RAD, th1 *= LOCATION_TO_RAD, th2 *= LOCATION_TO_RAD;
+    dz = sin(th1) - sin(th2);
+    dx = cos(ph1) * cos(th1) - cos(th2);
+    dy = sin(ph1) * cos(th1);
+    return (asin(sqrt(dx * dx + dy * dy + dz * dz) / 2) * 2 * LOCATION_R) * 1000.0;
+}
+
+struct Location {
+    float lat, lon;
+    int radius;
+    bool inside = false;
+};
+
+struct Event {
+    uint32_t tick, index;
+    bool enter;
+    bool operator==(const Event& o) const { return tick == o.tick && index == o.index && enter == o.enter; }
+};
+
+struct Fleet {
+    std::vector<Location> locs;
+    std::vector<Event> events;
+    uint64_t distances = 0;
+
+    bool IsInLocation(uint32_t tick, uint32_t index, float lat, float lon) {
+        Location& l = locs[index];
+        distances++;
+        double dist = OvmsLocationDistance(lat, lon, l.lat, l.lon);
+        bool in = fabs(dist) <= l.radius;
+        if (in != l.inside) {
+            l.inside = in;
+            events.push_back(Event{tick, index, in});
+        }
+        return l.inside;
+    }
+};
+
+// Former UpdateLocations(): check all locations
+struct FullScan : Fleet {
+    void Update(uint32_t tick, float lat, float lon) {
+        for (uint32_t i = 0; i < locs.size(); i++)
+            IsInLocation(tick, i, lat, lon);
+    }
+};
+
+// New UpdateLocations(): grid candidates + entered locations, in list order
+struct GridScan : Fleet {
+    OvmsLocationGrid grid;
+    std::vector<uint32_t> inside, check;
+
+    void Build() {
+        grid.Clear();
+        for (uint32_t i = 0; i < locs.size(); i++)
+            grid.Add(i, locs[i].lat, locs[i].lon, locs[i].radius);
+        grid.Build();
+    }
+
+    void Update(uint32_t tick, float lat, float lon) {
+        check = inside;
+        grid.Find(lat, lon, check);
+        std::sort(check.begin(), check.end());
+        check.erase(std::unique(check.begin(), check.end()), check.end());
+        inside.clear();
+        for (uint32_t i : check)
+            if (IsInLocation(tick, i, lat, lon))
+                inside.push_back(i);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Test data
+// ---------------------------------------------------------------------------
+
+struct Site { double lat, lon; };
+
+static std::vector<Location> make_locations(std::mt19937& rng, const std::vector<Site>& sites, int count) {
+    std::vector<Location> locs;
+    std::uniform_int_distribution<size_t> site(0, sites.size() - 1);
+    std::normal_distribution<double> spread(0, 0.15);
+    std::uniform_int_distribution<int> kind(0, 99), radius(30, 500), large(5000, 60000);
+    for (int i = 0; i < count; i++) {
+        const Site& s = sites[site(rng)];
+        int k = kind(rng);
+        Location l;
+        l.lat = s.lat + spread(rng);
+        l.lon = s.lon + spread(rng);
+        l.radius = (k < 2) ? large(rng) : (k < 3) ? 0 : radius(rng);
+        locs.push_back(l);
+    }
+    // special cases: date line, polar, exact site centers
+    locs.push_back(Location{-16.5f, 179.99f, 3000});
+    locs.push_back(Location{89.9f, 10.0f, 20000});
+    for (const Site& s : sites)
+        locs.push_back(Location{(float)s.lat, (float)s.lon, 100});
+    return locs;
+}
+
+int main() {
+    std::mt19937 rng(1900);
+    const std::vector<Site> sites = {
+        {51.5072, -0.1276}, {52.5200, 13.4050}, {48.8566, 2.3522}, {59.9139, 10.7522},
+        {1.3521, 103.8198}, {-33.8688, 151.2093}, {37.7749, -122.4194}, {-16.5, 179.98},
+    };
+    const uint32_t ticks = 36000;    // GPS updates (1 Hz: 10 hours driving)
+
+    printf("Location update: %u GPS updates\n\n", ticks);
+    printf("%-9s %10s %10s | %10s %10s | %12s %7s\n",
+           "locations", "cells", "wide", "full ms", "grid ms", "dist/update", "speedup");
+
+    int failures = 0;
+    for (int count : {100, 1000, 5000}) {
+        FullScan full;
+        GridScan grid;
+        full.locs = grid.locs = make_locations(rng, sites, count);
+        grid.Build();
+
+        // vehicle track: drive between random locations at up to ~40 m/s
+        std::vector<std::pair<float, float>> track;
+        std::uniform_int_distribution<size_t> pick(0, full.locs.size() - 1);
+        double lat = sites[0].lat, lon = sites[0].lon;
+        while (track.size() < ticks) {
+            const Location& dest = full.locs[pick(rng)];
+            if (fabs(dest.lat) > 80) continue;
+            double dlat = dest.lat - lat, dlon = dest.lon - lon;
+            if (fabs(dlat) > 1 || fabs(dlon) > 1) {
+                // long trip: jump (e.g. ferry or GPS loss)
+                lat = dest.lat + 0.02;
+                lon = dest.lon;
+                continue;
+            }
+            int steps = std::max(1, (int)(sqrt(dlat * dlat + dlon * dlon) / 0.0003));
+            for (int i = 1; i <= steps && track.size() < ticks; i++)
+                track.emplace_back(lat + dlat * i / steps, lon + dlon * i / steps);
+            lat = dest.lat;
+            lon = dest.lon;
+            for (int i = 0; i < 30 && track.size() < ticks; i++)
+                track.emplace_back(lat, lon);   // parked
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < ticks; t++)
+            full.Update(t, track[t].first, track[t].second);
+        auto t1 = std::chrono::steady_clock::now();
+        for (uint32_t t = 0; t < ticks; t++)
+            grid.Update(t, track[t].first, track[t].second);
+        auto t2 = std::chrono::steady_clock::now();
+
+        double full_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double grid_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        bool ok = full.events == grid.events;
+        if (!ok) failures++;
+        printf("%-9zu %10zu %10zu | %10.1f %10.1f | %12.2f %6.1fx  %zu events%s\n",
+               full.locs.size(), grid.grid.Cells(), grid.grid.Wide(), full_ms, grid_ms,
+               (double)grid.distances / ticks, full_ms / grid_ms, full.events.size(),
+               ok ? "" : "  MISMATCH");
+    }
+
+    // Bounding boxes must be conservative: random points close to the radius
+    uint64_t checked = 0, misses = 0;
+    std::uniform_real_distribution<double> ulat(-85, 85), ulon(-180, 180), ang(0, 2 * M_PI), rel(0.98, 1.0);
+    std::uniform_int_distribution<int> radius(0, 50000);
+    for (int i = 0; i < 20000; i++) {
+        Location l{(float)ulat(rng), (float)ulon(rng), radius(rng)};
+        if (i % 10 == 0) l.radius = i % 7;
+        OvmsLocationGrid g;
+        g.Add(0, l.lat, l.lon, l.radius);
+        g.Build();
+        for (int j = 0; j < 20; j++) {
+            double a = ang(rng), d = l.radius * rel(rng) / 6371000.0;
+            double plat = l.lat + d * cos(a) * 180 / M_PI;
+            double plon = l.lon + d * sin(a) * 180 / M_PI / cos(l.lat * M_PI / 180);
+            if (plon > 180 || plon < -180 || fabs(plat) > 90) continue;
+            float fl = plat, fo = plon;
+            if (OvmsLocationDistance(fl, fo, l.lat, l.lon) > l.radius) continue;
+            std::vector<uint32_t> found;
+            g.Find(fl, fo, found);
+            checked++;
+            if (found.empty()) misses++;
+        }
+        // center point
+        std::vector<uint32_t> found;
+        g.Find(l.lat, l.lon, found);
+        checked++;
+        if (found.empty()) misses++;
+    }
+    printf("\nBoundary check: %llu points inside, %llu missed by the index\n",
+           (unsigned long long)checked, (unsigned long long)misses);
+    if (misses) failures++;
+
+    printf("\n%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -25,6 +25,26 @@ function hasKeys(obj)
   return false;
   }
 
+function syncTopics()
+  {
+  // report topics with subscribers to the native event forwarder,
+  // so events nobody listens to are not queued to the script task
+  var topics = [],
+      m;
+  if ( typeof PubSubSync !== 'function' )
+    {
+    return;
+    }
+  for (m in messages)
+    {
+    if ( Object.prototype.hasOwnProperty.call(messages, m) && hasKeys(messages[m]) )
+      {
+      topics.push(m);
+      }
+    }
+  PubSubSync(topics);
+  }
+
 function callSubscriberWithImmediateExceptions( subscriber, message, data )
   {
   subscriber( message, data );
@@ -139,6 +159,7 @@ exports.subscribe = function( message, func )
   // and allow for easy use as key names for the 'messages' object
   var token = 'uid_' + String(++lastUid);
   messages[message][token] = func;
+  syncTopics();
 
   // return token for unsubscribing
   return token;
@@ -153,6 +174,7 @@ exports.subscribe = function( message, func )
 exports.clearAllSubscriptions = function clearAllSubscriptions()
   {
   messages = {};
+  syncTopics();
   };
 
 /**
@@ -171,6 +193,7 @@ exports.clearSubscriptions = function clearSubscriptions(topic)
       delete messages[m];
       }
     }
+  syncTopics();
   };
 
 /**
@@ -249,6 +272,10 @@ exports.unsubscribe = function(value)
       }
     }
 
+  if (result)
+    {
+    syncTopics();
+    }
   return result;
   };
 
@@ -263,3 +290,5 @@ exports.data = function ()
   {
   return messages;
   };
+
+syncTopics();
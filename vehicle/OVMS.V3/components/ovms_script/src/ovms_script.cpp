@@ -57,6 +57,7 @@ static const char *TAG = "script";
 static void script_reload(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   writer->puts("Reloading javascript engine");
+  MyScripts.EventScriptsInvalidate();
   MyDuktape.DuktapeReload();
   }
 
@@ -76,28 +77,45 @@ static void script_meminfo(int verbosity, OvmsWriter* writer, OvmsCommand* cmd,
   MyDuktape.DuktapeEvalNoResult("JSON.print(meminfo())", writer);
   }
 
+#else // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+
+static void script_reload(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  writer->puts("Reloading event scripts");
+  MyScripts.EventScriptsInvalidate();
+  }
+
 #endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
 
 OvmsScripts MyScripts __attribute__ ((init_priority (1600)));
 
-static void script_ovms(int verbosity, OvmsWriter* writer,
-  const char* spath, FILE* sf, bool secure=false)
+// Event script text cache limits:
+#define SCRIPT_CACHE_ITEM_MAX     2048      // Max script size to cache
+#define SCRIPT_CACHE_TOTAL_MAX    16384     // Max total cache size
+#define SCRIPT_CACHE_HOT_RUNS     2         // Runs before a script is cached
+
+static void script_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
-  char *ext = rindex(spath, '.');
+  MyScripts.EventScriptsStatus(writer);
+#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  MyDuktape.EventStatus(writer);
+#endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  }
+
+/**
+ * script_ovms_text: execute a script from memory
+ */
+static void script_ovms_text(int verbosity, OvmsWriter* writer,
+  const char* spath, const char* text, size_t len, bool secure=false)
+  {
+  const char *ext = rindex(spath, '.');
   if ((ext != NULL)&&(strcmp(ext,".js")==0))
     {
     // Javascript script
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
-    fseek(sf,0,SEEK_END);
-    long slen = ftell(sf);
-    fseek(sf,0,SEEK_SET);
-    char *script = new char[slen+1];
-    memset(script,0,slen+1);
-    fread(script,1,slen,sf);
     MyDuktape.NotifyDuktapeModuleLoad(spath);
-    MyDuktape.DuktapeEvalNoResult(script, writer, spath);
+    MyDuktape.DuktapeEvalNoResult(text, writer, spath);
     MyDuktape.NotifyDuktapeModuleUnload(spath);
-    delete [] script;
 #else // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
     if (writer)
       {
@@ -108,21 +126,26 @@ static void script_ovms(int verbosity, OvmsWriter* writer,
       ESP_LOGE(TAG, "Error: No javascript engine available");
       }
 #endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
-    fclose(sf);
     }
   else
     {
     // Default: OVMS command script
     BufferedShell* bs = new BufferedShell(false, verbosity);
     if (secure) bs->SetSecure(true);
-    char* cmdline = new char[_COMMAND_LINE_LEN];
-    while(fgets(cmdline, _COMMAND_LINE_LEN, sf) != NULL )
+    // feed in the same line chunks as read by fgets(…, _COMMAND_LINE_LEN, …):
+    const char *cp = text, *end = text + len;
+    while (cp < end)
       {
-      bs->ProcessChars(cmdline, strlen(cmdline));
-      if (strlen(cmdline) > 0 && cmdline[strlen(cmdline)-1] != '\n')
+      size_t n = 0;
+      while (cp+n < end && n < _COMMAND_LINE_LEN-1 && cp[n] != '\n')
+        n++;
+      if (cp+n < end && n < _COMMAND_LINE_LEN-1)
+        n++; // include newline
+      bs->ProcessChars(cp, n);
+      if (cp[n-1] != '\n')
         bs->ProcessChar('\n');
+      cp += n;
       }
-    fclose(sf);
     if (writer)
       {
       bs->Output(writer);
@@ -134,10 +157,34 @@ static void script_ovms(int verbosity, OvmsWriter* writer,
       ESP_LOGI(TAG, "%s", output.c_str());
       }
     delete bs;
-    delete [] cmdline;
     }
   }
 
+/**
+ * script_load: read a script file into memory
+ */
+static bool script_load(FILE* sf, extram::string &text)
+  {
+  fseek(sf,0,SEEK_END);
+  long slen = ftell(sf);
+  fseek(sf,0,SEEK_SET);
+  if (slen < 0)
+    return false;
+  text.resize(slen);
+  text.resize(fread(&text[0],1,slen,sf));
+  return true;
+  }
+
+static void script_ovms(int verbosity, OvmsWriter* writer,
+  const char* spath, FILE* sf, bool secure=false)
+  {
+  extram::string text;
+  bool loaded = script_load(sf, text);
+  fclose(sf);
+  if (loaded)
+    script_ovms_text(verbosity, writer, spath, text.c_str(), text.size(), secure);
+  }
+
 static void script_run(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   FILE *sf = NULL;
@@ -205,42 +252,238 @@ void OvmsScripts::AllScripts(std::string path)
     }
   }
 
+/**
+ * EventScript: run the scripts in /sd/events/<event> (if enabled) & /store/events/<event>
+ *
+ *  The event directories are looked up in an index of the directories containing scripts,
+ *  built on first use, so events without scripts don't need to access the file system.
+ *  The index is invalidated on system.vfs.file.changed for the paths concerned,
+ *  on sd.mounted / sd.unmounting and by "script reload".
+ *
+ *  Scripts run frequently (e.g. on ticker events) are kept in memory.
+ */
 void OvmsScripts::EventScript(std::string event, void* data)
   {
-  std::string path;
-
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   MyDuktape.EventScript(event, data);
 #endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
 
-#ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
-  // run event scripts on external storage:
-  path=std::string("/sd/events/");
-  path.append(event);
-  AllScripts(path);
-#endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+  for (int i = 0; i < m_index_count; i++)
+    IndexRun(m_index[i], event);
+  }
+
+void OvmsScripts::EventScriptsInvalidate(const char* path)
+  {
+  OvmsMutexLock lock(&m_index_mutex);
+  for (int i = 0; i < m_index_count; i++)
+    {
+    event_index_t &index = m_index[i];
+    if (path && strncmp(path, index.root, strlen(index.root)) != 0
+             && strncmp(index.root, path, strlen(path)) != 0)
+      continue;
+    if (index.valid)
+      ESP_LOGD(TAG, "EventScriptsInvalidate: %s", index.root);
+    index.valid = false;
+    for (auto &ev : index.events)
+      {
+      for (auto &script : ev.second)
+        {
+        if (script.text)
+          m_cache_size -= script.text->size();
+        }
+      }
+    index.events.clear();
+    }
+  m_index_gen++;
+  }
+
+void OvmsScripts::EventListener(std::string event, void* data)
+  {
+  if (event == "system.vfs.file.changed")
+    {
+    if (data)
+      EventScriptsInvalidate((const char*)data);
+    }
+  else if (event == "sd.mounted" || event == "sd.unmounting")
+    {
+    EventScriptsInvalidate("/sd");
+    }
+  }
+
+/**
+ * IndexBuild: scan the event directories of the index root (index mutex locked)
+ */
+void OvmsScripts::IndexBuild(event_index_t &index)
+  {
+  DIR *dir, *evdir;
+  struct dirent *dp;
+
+  index.events.clear();
+  index.valid = true;
+  m_index_builds++;
+
+  if ((dir = opendir(index.root)) == NULL)
+    return;
+  while ((dp = readdir(dir)) != NULL)
+    {
+    if (strcmp(dp->d_name, ".") == 0 || strcmp(dp->d_name, "..") == 0)
+      continue;
+    std::string event = dp->d_name;
+    std::string path = index.root;
+    path.append("/");
+    path.append(event);
+    if ((evdir = opendir(path.c_str())) == NULL)
+      continue;
+    // sort scripts by name:
+    std::set<std::string> files;
+    while ((dp = readdir(evdir)) != NULL)
+      {
+      std::string fpath = path;
+      fpath.append("/");
+      fpath.append(dp->d_name);
+      files.insert(fpath);
+      }
+    closedir(evdir);
+    if (files.empty())
+      continue;
+    event_scripts_t &scripts = index.events[event];
+    scripts.reserve(files.size());
+    for (auto &fpath : files)
+      scripts.push_back(event_script_t{fpath, 0, nullptr});
+    }
+  closedir(dir);
+  ESP_LOGD(TAG, "IndexBuild: %s: %u event(s) with scripts", index.root, (unsigned)index.events.size());
+  }
+
+/**
+ * IndexRun: run the scripts for an event from an index root
+ */
+void OvmsScripts::IndexRun(event_index_t &index, const std::string &event)
+  {
+  std::vector<event_script_t> run;
+  uint32_t gen;
+
+  // Collect the scripts, so the index isn't locked while they run:
+    {
+    OvmsMutexLock lock(&m_index_mutex);
+    if (!index.valid)
+      IndexBuild(index);
+    m_index_lookups++;
+    auto it = index.events.find(event);
+    if (it == index.events.end())
+      return;
+    for (auto &script : it->second)
+      script.runs++;
+    run = it->second;
+    gen = m_index_gen;
+    }
+
+  for (auto &script : run)
+    {
+    script_text_t text = script.text;
+    if (text)
+      {
+      m_cache_hits++;
+      }
+    else
+      {
+      FILE* sf = fopen(script.path.c_str(), "r");
+      if (!sf)
+        continue;
+      text = std::make_shared<extram::string>();
+      bool loaded = script_load(sf, *text);
+      fclose(sf);
+      if (!loaded)
+        continue;
+
+      // Keep hot scripts:
+      if (script.runs >= SCRIPT_CACHE_HOT_RUNS && text->size() <= SCRIPT_CACHE_ITEM_MAX)
+        {
+        OvmsMutexLock lock(&m_index_mutex);
+        if (gen == m_index_gen && m_cache_size + text->size() <= SCRIPT_CACHE_TOTAL_MAX)
+          {
+          for (auto &cached : index.events[event])
+            {
+            if (cached.path == script.path && !cached.text)
+              {
+              cached.text = text;
+              m_cache_size += text->size();
+              }
+            }
+          }
+        }
+      }
 
-  // run event scripts on internal storage:
-  path=std::string("/store/events/");
-  path.append(event);
-  AllScripts(path);
+    ESP_LOGI(TAG, "Running script %s", script.path.c_str());
+    m_index_runs++;
+    script_ovms_text(COMMAND_RESULT_MINIMAL, NULL, script.path.c_str(), text->c_str(), text->size(), true);
+    }
+  }
+
+void OvmsScripts::EventScriptsStatus(OvmsWriter* writer)
+  {
+  OvmsMutexLock lock(&m_index_mutex);
+  writer->puts("Event scripts:");
+  for (int i = 0; i < m_index_count; i++)
+    {
+    event_index_t &index = m_index[i];
+    if (!index.valid)
+      {
+      writer->printf("  %s: not indexed\n", index.root);
+      continue;
+      }
+    writer->printf("  %s: %u event(s)\n", index.root, (unsigned)index.events.size());
+    for (auto &ev : index.events)
+      {
+      for (auto &script : ev.second)
+        writer->printf("    %s: %" PRIu32 " runs%s\n", script.path.c_str(), script.runs, script.text ? ", cached" : "");
+      }
+    }
+  writer->printf("  Index: %" PRIu32 " builds, %" PRIu32 " lookups, %" PRIu32 " scripts run\n",
+    m_index_builds, m_index_lookups, m_index_runs);
+  writer->printf("  Cache: %u bytes, %" PRIu32 " hits\n", (unsigned)m_cache_size, m_cache_hits);
   }
 
 OvmsScripts::OvmsScripts()
   {
   ESP_LOGI(TAG, "Initialising SCRIPTS (1600)");
 
+  m_index_count = 0;
+#ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+  // event scripts on external storage run first:
+  m_index[m_index_count++].root = "/sd/events";
+#endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+  m_index[m_index_count++].root = "/store/events";
+  for (int i = 0; i < m_index_count; i++)
+    m_index[i].valid = false;
+  m_index_gen = 0;
+  m_cache_size = 0;
+  m_index_builds = 0;
+  m_index_lookups = 0;
+  m_index_runs = 0;
+  m_cache_hits = 0;
+
+  #undef bind  // Kludgy, but works
+  using std::placeholders::_1;
+  using std::placeholders::_2;
+  MyEvents.RegisterEvent(TAG, "system.vfs.file.changed", std::bind(&OvmsScripts::EventListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "sd.mounted", std::bind(&OvmsScripts::EventListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "sd.unmounting", std::bind(&OvmsScripts::EventListener, this, _1, _2));
+
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_NONE
   ESP_LOGI(TAG, "No javascript engines enabled (command scripting only)");
 #endif //#ifdef CONFIG_OVMS_SC_JAVASCRIPT_NONE
 
   OvmsCommand* cmd_script = MyCommandApp.RegisterCommand("script","SCRIPT framework");
   cmd_script->RegisterCommand("run","Run a script",script_run,"<path>",1,1,true, vfs_file_validate);
+  cmd_script->RegisterCommand("status","Show event script & javascript event status",script_status);
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   cmd_script->RegisterCommand("reload","Reload javascript framework",script_reload);
   cmd_script->RegisterCommand("eval","Eval some javascript code",script_eval,"<code>",1,1);
   cmd_script->RegisterCommand("compact","Compact javascript heap",script_compact);
   cmd_script->RegisterCommand("meminfo","Show heap memory status",script_meminfo);
+#else // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  cmd_script->RegisterCommand("reload","Reload event scripts",script_reload);
 #endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   MyCommandApp.RegisterCommand(".","Run a script",script_run,"<path>",1,1, true, vfs_file_validate);
   }
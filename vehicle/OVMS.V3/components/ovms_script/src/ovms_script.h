@@ -31,7 +31,12 @@
 #ifndef __SCRIPT_H__
 #define __SCRIPT_H__
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "ovms.h"
 #include "ovms_command.h"
+#include "ovms_mutex.h"
 #include "ovms_utils.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -51,6 +56,42 @@ class OvmsScripts
   public:
     void EventScript(std::string event, void* data);
     void AllScripts(std::string path);
+
+  public:
+    // Event script index, see EventScript():
+    void EventScriptsInvalidate(const char* path = NULL);
+    void EventScriptsStatus(OvmsWriter* writer);
+
+  protected:
+    void EventListener(std::string event, void* data);
+
+    typedef std::shared_ptr<extram::string> script_text_t;
+    typedef struct
+      {
+      std::string path;
+      uint32_t runs;
+      script_text_t text;                     // Cached script text (hot scripts only)
+      } event_script_t;
+    typedef std::vector<event_script_t> event_scripts_t;
+    typedef struct
+      {
+      const char* root;                       // e.g. "/store/events"
+      bool valid;
+      std::unordered_map<std::string, event_scripts_t> events; // Event → scripts sorted by name
+      } event_index_t;
+
+    void IndexBuild(event_index_t &index);
+    void IndexRun(event_index_t &index, const std::string &event);
+
+    OvmsMutex         m_index_mutex;
+    event_index_t     m_index[2];
+    int               m_index_count;
+    uint32_t          m_index_gen;            // Incremented on invalidation
+    size_t            m_cache_size;           // Bytes of script text cached
+    uint32_t          m_index_builds;
+    uint32_t          m_index_lookups;
+    uint32_t          m_index_runs;           // Event scripts executed
+    uint32_t          m_cache_hits;
   };
 
 extern OvmsScripts MyScripts;
@@ -507,6 +507,7 @@ void DuktapeVFSSave::Save()
   m_file.write(&m_data[0], m_data.size());
   bool wfail = m_file.fail();
   m_file.close();
+  MyEvents.SignalEvent("system.vfs.file.changed", (void*)m_path.c_str(), m_path.size()+1);
 
   // free buffer:
   m_data.clear();
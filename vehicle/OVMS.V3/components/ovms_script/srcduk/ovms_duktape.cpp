@@ -982,6 +982,26 @@ void DuktapeConsoleCommand::BeforeDecouple(duk_context *ctx)
 //
 // This is the main OVMS Duktape registry and singleton utiltiy object
 
+static duk_ret_t DukOvmsPubSubSync(duk_context *ctx)
+  {
+  // Called by PubSub with the array of topics currently having subscribers
+  std::vector<std::string> topics;
+  if (duk_is_array(ctx, 0))
+    {
+    duk_size_t len = duk_get_length(ctx, 0);
+    topics.reserve(len);
+    for (duk_size_t i = 0; i < len; i++)
+      {
+      duk_get_prop_index(ctx, 0, i);
+      if (duk_is_string(ctx, -1))
+        topics.push_back(duk_get_string(ctx, -1));
+      duk_pop(ctx);
+      }
+    }
+  MyDuktape.SetEventSubscriptions(topics);
+  return 0;
+  }
+
 OvmsDuktape::OvmsDuktape()
   {
   ESP_LOGI(TAG, "Initialising DUKTAPE Registry (1000)");
@@ -989,6 +1009,13 @@ OvmsDuktape::OvmsDuktape()
   m_dukctx = NULL;
   m_duktaskid = NULL;
   m_duktaskqueue = NULL;
+  m_event_topics_valid = false;
+  m_event_forwarded = 0;
+  m_event_skipped = 0;
+  m_event_dropped = 0;
+
+  // Register standard functions...
+  RegisterDuktapeFunction(DukOvmsPubSubSync, 1, "PubSubSync");
 
   // Register standard modules...
   extern const char mod_pubsub_js_start[]     asm("_binary_pubsub_js_start");
@@ -1083,31 +1110,74 @@ void OvmsDuktape::AutoInitDuktape()
     }
   }
 
+void OvmsDuktape::SetEventSubscriptions(std::vector<std::string>& topics)
+  {
+  OvmsMutexLock lock(&m_event_mutex);
+  m_event_topics.swap(topics);
+  m_event_topics_valid = true;
+  }
+
+void OvmsDuktape::ResetEventSubscriptions()
+  {
+  OvmsMutexLock lock(&m_event_mutex);
+  m_event_topics.clear();
+  m_event_topics_valid = false;
+  }
+
+/**
+ * EventSubscribed: check if PubSub would deliver the event to any subscriber,
+ *  i.e. if a topic matches the event name or one of its dot separated parents
+ *  (same hierarchy as in PubSub.publish).
+ */
+bool OvmsDuktape::EventSubscribed(const std::string& event)
+  {
+  OvmsMutexLock lock(&m_event_mutex);
+  if (!m_event_topics_valid)
+    return true;
+  for (const std::string& topic : m_event_topics)
+    {
+    size_t len = topic.size();
+    if (len <= event.size() && event.compare(0, len, topic) == 0 &&
+        (len == event.size() || event[len] == '.'))
+      return true;
+    }
+  return false;
+  }
+
 void OvmsDuktape::EventScript(std::string event, void* data)
   {
   if (!m_dukctx) return;
 
-  // dispatch event to PubSub component:
-  duktape_queue_t dmsg;
-  memset(&dmsg, 0, sizeof(dmsg));
-  dmsg.type = DUKTAPE_event;
-  dmsg.body.dt_event.name = strdup(event.c_str());
-  dmsg.body.dt_event.data = NULL; // data unused, may also be invalid in async script execution
-  if (!DuktapeDispatch(&dmsg, 0))
+  if (!EventSubscribed(event))
     {
-    ESP_LOGE(TAG, "EventScript: event '%s' lost (queue overflow)", event.c_str());
-    free((void*)dmsg.body.dt_event.name);
+    m_event_skipped++;
     }
   else
-   {
-   // event processing delayed?
-   int qwait = uxQueueMessagesWaiting(m_duktaskqueue);
-   if (qwait > 10)
-     {
-     ESP_LOGW(TAG, "EventScript: event '%s' delayed, queued at position %d/%d", event.c_str(),
-       qwait, CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE_QUEUE_SIZE);
-     }
-   }
+    {
+    // dispatch event to PubSub component:
+    duktape_queue_t dmsg;
+    memset(&dmsg, 0, sizeof(dmsg));
+    dmsg.type = DUKTAPE_event;
+    dmsg.body.dt_event.name = strdup(event.c_str());
+    dmsg.body.dt_event.data = NULL; // data unused, may also be invalid in async script execution
+    if (!DuktapeDispatch(&dmsg, 0))
+      {
+      m_event_dropped++;
+      ESP_LOGE(TAG, "EventScript: event '%s' lost (queue overflow)", event.c_str());
+      free((void*)dmsg.body.dt_event.name);
+      }
+    else
+      {
+      m_event_forwarded++;
+      // event processing delayed?
+      int qwait = uxQueueMessagesWaiting(m_duktaskqueue);
+      if (qwait > 10)
+        {
+        ESP_LOGW(TAG, "EventScript: event '%s' delayed, queued at position %d/%d", event.c_str(),
+          qwait, CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE_QUEUE_SIZE);
+        }
+      }
+    }
 
   if (event == "ticker.60")
     {
@@ -1116,6 +1186,29 @@ void OvmsDuktape::EventScript(std::string event, void* data)
     }
   }
 
+void OvmsDuktape::EventStatus(OvmsWriter* writer)
+  {
+  OvmsMutexLock lock(&m_event_mutex);
+  writer->puts("Javascript events:");
+  if (!m_dukctx)
+    writer->puts("  Engine: not running");
+  if (m_event_topics_valid)
+    {
+    writer->printf("  Subscriptions: %u topic(s)\n", (unsigned)m_event_topics.size());
+    for (const std::string& topic : m_event_topics)
+      writer->printf("    %s\n", topic.c_str());
+    }
+  else
+    {
+    writer->puts("  Subscriptions: not synced, forwarding all events");
+    }
+  writer->printf("  Events: %" PRIu32 " forwarded, %" PRIu32 " skipped, %" PRIu32 " dropped\n",
+    m_event_forwarded, m_event_skipped, m_event_dropped);
+  writer->printf("  Queue: %u/%d\n",
+    m_duktaskqueue ? (unsigned)uxQueueMessagesWaiting(m_duktaskqueue) : 0u,
+    CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE_QUEUE_SIZE);
+  }
+
 bool OvmsDuktape::DuktapeDispatch(duktape_queue_t* msg, TickType_t queuewait /*=portMAX_DELAY*/)
   {
   msg->waitcompletion = NULL;
@@ -1500,6 +1593,7 @@ void OvmsDuktape::DukTapeUnload(bool unload_modules)
   {
   if (m_dukctx != NULL)
     {
+    ResetEventSubscriptions();
     if (unload_modules)
       NotifyDuktapeModuleUnloadAll(m_dukctx);
     ESP_LOGI(TAG,"Duktape: Clearing existing context");
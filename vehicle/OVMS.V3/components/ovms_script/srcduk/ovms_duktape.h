@@ -33,6 +33,7 @@
 
 #include "ovms_command.h"
 #include "ovms_utils.h"
+#include "ovms_mutex.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -40,6 +41,7 @@
 
 #include "duktape.h"
 #include <list>
+#include <vector>
 #include <utility>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -372,6 +374,14 @@ class OvmsDuktape
     bool InDukTapeTask() { return xTaskGetCurrentTaskHandle() == m_duktaskid; }
     duk_context* DukTapeContext() { return m_dukctx; }
     void EventScript(std::string event, void* data);
+    void EventStatus(OvmsWriter* writer);
+
+  public:
+    // PubSub subscription mirror, see PubSubSync in pubsub.js:
+    void SetEventSubscriptions(std::vector<std::string>& topics);
+    void ResetEventSubscriptions();
+  protected:
+    bool EventSubscribed(const std::string& event);
 
   protected:
     duk_context* m_dukctx;
@@ -381,6 +391,13 @@ class OvmsDuktape
     DuktapeModuleMap m_modmap;
     DuktapeObjectMap m_obmap;
 
+    OvmsMutex m_event_mutex;
+    std::vector<std::string> m_event_topics;    // PubSub topics with subscribers
+    bool m_event_topics_valid;                  // false = not synced yet, forward all
+    uint32_t m_event_forwarded;
+    uint32_t m_event_skipped;
+    uint32_t m_event_dropped;
+
   public:
     typedef std::map<OvmsCommand*, DuktapeConsoleCommand*> DuktapeCommandMap;
     DuktapeCommandMap m_cmdmap;
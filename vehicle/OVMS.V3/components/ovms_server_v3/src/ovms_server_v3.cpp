@@ -241,6 +241,7 @@ OvmsServerV3::OvmsServerV3(const char* name)
     {
     MyOvmsServerV3Modifier = MyMetrics.RegisterModifier();
     ESP_LOGI(TAG, "OVMS Server V3 registered metric modifier is #%d",MyOvmsServerV3Modifier);
+    MyMetrics.EnableModifiedQueue(MyOvmsServerV3Modifier);
     }
 
   SetStatus("Server has been started", false, WaitNetwork);
@@ -420,6 +421,27 @@ void OvmsServerV3::TransmitModifiedMetrics()
   if (!StandardMetrics.ms_s_v3_connected->AsBool()) return;
   CountClients();
 
+  int sent = 0;
+
+  // Normally we only need to drain the modified metrics queue. A full scan
+  // is needed after a queue overflow, it may take multiple calls to complete:
+  if (s_mod_next_index == 0 && !MyMetrics.ModifiedQueueOverflow(MyOvmsServerV3Modifier))
+    {
+    OvmsMetric* cur;
+    while (sent < m_max_per_call_modified &&
+           (cur = MyMetrics.NextModified(MyOvmsServerV3Modifier)) != NULL)
+      {
+      if (cur->IsDefined())
+        {
+        TransmitMetric(cur);
+        sent++;
+        }
+      }
+    if (sent >= m_max_per_call_modified)
+      m_lasttx = 0;
+    return;
+    }
+
   // Locate starting point:
   OvmsMetric* m = MyMetrics.m_first;
   size_t pos = 0;
@@ -437,7 +459,6 @@ void OvmsServerV3::TransmitModifiedMetrics()
     pos = 0;
     }
 
-  int sent = 0;
   while (m)
     {
     OvmsMetric* cur = m;
@@ -437,6 +437,7 @@ class WebSocketHandler : public MgHandler, public OvmsWriter
     int                       m_sent = 0;
     int                       m_ack = 0;
     int                       m_last = 0;             // last entry sent up
+    bool                      m_scan = false;         // metrics update: full scan mode
     std::set<std::string>     m_subscriptions;
     bool                      m_units_subscribed;
     bool                      m_units_prefs_subscribed;
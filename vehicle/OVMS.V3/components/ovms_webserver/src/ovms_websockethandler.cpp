@@ -125,7 +125,9 @@ void WebSocketHandler::ProcessTxJob()
     case WSTX_MetricsAll:
     case WSTX_MetricsUpdate:
     {
-      // Note: this loops over the metrics by index, keeping the last checked position
+      // Updates are normally taken from our modified metrics queue. A full scan
+      //  is done for MetricsAll and after a queue overflow.
+      // Note: the scan loops over the metrics by index, keeping the last checked position
       //  in m_last. It will not detect new metrics added between polls if they are
       //  inserted before m_last, so new metrics may not be sent until first changed.
       //  The Metrics set normally is static, so this should be no problem.
@@ -133,16 +135,21 @@ void WebSocketHandler::ProcessTxJob()
       // find start:
       int i;
       OvmsMetric* m;
-      for (i=0, m=MyMetrics.m_first; i < m_last && m != NULL; m=m->m_next, i++);
+      if (m_last == 0 && m_sent == 0)
+        m_scan = (m_job.type == WSTX_MetricsAll || MyMetrics.ModifiedQueueOverflow(m_modifier));
+      if (m_scan)
+        for (i=0, m=MyMetrics.m_first; i < m_last && m != NULL; m=m->m_next, i++);
+      else
+        m = MyMetrics.NextModified(m_modifier);
       
       // build msg:
       if (m) {
         std::string msg;
         msg.reserve(2*XFER_CHUNK_SIZE+128);
         msg = "{\"metrics\":{";
-        for (i=0; m && msg.size() < XFER_CHUNK_SIZE; m=m->m_next) {
+        for (i=0; m; ) {
           ++m_last;
-          if (m->IsModifiedAndClear(m_modifier) || m_job.type == WSTX_MetricsAll) {
+          if (!m_scan || m->IsModifiedAndClear(m_modifier) || m_job.type == WSTX_MetricsAll) {
             if (i) msg += ',';
             msg += '\"';
             msg += m->m_name;
@@ -150,6 +157,12 @@ void WebSocketHandler::ProcessTxJob()
             msg += m->AsJSON();
             i++;
           }
+          if (m_scan)
+            m = m->m_next;
+          if (msg.size() >= XFER_CHUNK_SIZE)
+            break; // queue mode: m != NULL = not done
+          if (!m_scan)
+            m = MyMetrics.NextModified(m_modifier);
         }
 
         // send msg:
@@ -582,6 +595,7 @@ WebSocketHandler* OvmsWebServer::CreateWebSocketHandler(mg_connection* nc)
     WebSocketSlot slot;
     slot.handler = NULL;
     slot.modifier = MyMetrics.RegisterModifier();
+    MyMetrics.EnableModifiedQueue(slot.modifier);
     slot.reader = MyNotify.RegisterReader("ovmsweb", COMMAND_RESULT_VERBOSE,
                                           std::bind(&OvmsWebServer::IncomingNotification, i, _1, _2), true,
                                           std::bind(&OvmsWebServer::NotificationFilter, i, _1, _2));
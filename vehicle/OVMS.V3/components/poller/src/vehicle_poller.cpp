@@ -34,6 +34,7 @@ static const char *TAG_DK = "duktape-poll";
 
 #include <stdio.h>
 #include <algorithm>
+#include <new>
 #include <ovms_command.h>
 #include <ovms_script.h>
 #include <ovms_metrics.h>
@@ -44,6 +45,7 @@ static const char *TAG_DK = "duktape-poll";
 #endif // #ifdef CONFIG_OVMS_COMP_WEBSERVER
 #include <ovms_peripherals.h>
 #include <string_writer.h>
+#include <ovms_malloc.h>
 #include "vehicle_poller.h"
 #include "can.h"
 #include "ovms_boot.h"
@@ -134,6 +136,17 @@ OvmsPoller::OvmsPoller(canbus* can, uint8_t can_number, OvmsPollers *parent,
   m_poll_repeat_count = 0;
   m_poll_sent_last = 0;
   m_poll_between_success = 0;
+  m_poll_batch_max = 0;
+
+  m_pipe_queue = nullptr;
+  m_pipe_task = nullptr;
+  m_pipe_done = nullptr;
+  m_sim = nullptr;
+  m_resp_buf = nullptr;
+  m_resp_size = 0;
+  m_resp_len = 0;
+  m_resp_valid = false;
+  RoundStatsReset();
   }
 
 /** Handle incoming frame.
@@ -205,6 +218,107 @@ bool OvmsPoller::Incoming(CAN_frame_t &frame, bool success)
 
 OvmsPoller::~OvmsPoller()
   {
+  SimStop();
+  StopPipeline();
+  auto queue = Atomic_GetAndNull(m_pipe_queue);
+  if (queue)
+    vQueueDelete(queue);
+  if (m_pipe_done)
+    vSemaphoreDelete(m_pipe_done);
+  if (m_resp_buf)
+    free(m_resp_buf);
+  }
+
+/**
+ * IncomingPollData: deliver response payload of the current poll to the series
+ *  Series wanting complete responses get the fragments collected in the pooled
+ *  buffer of this bus and a single IncomingResponse() call when mlremain reaches 0.
+ *  Single frame responses are passed through without copying.
+ *  Responses that can't be completed are reported by IncomingPollError() with
+ *  POLL_ERR_INCOMPLETE, see DropPollResponse().
+ *  Called by the protocol receivers with m_poll_mutex held.
+ */
+void OvmsPoller::IncomingPollData(uint8_t* data, uint8_t length)
+  {
+  if (!m_polls.WantsResponse())
+    {
+    m_polls.IncomingPacket(m_poll, data, length);
+    return;
+    }
+
+  if (m_poll.mlframe == 0)
+    {
+    if (m_poll.mlremain == 0)
+      {
+      m_polls.IncomingResponse(m_poll, data, length);
+      return;
+      }
+    // First frame: make sure the pooled buffer can take the complete response
+    // (ISO-TP & VWTP lengths are 12 bit, so this is bounded to 4095 bytes):
+    uint32_t total = length + m_poll.mlremain;
+    m_resp_len = 0;
+    m_resp_valid = true;
+    if (total > 4096)
+      {
+      DropPollResponse("too long");
+      return;
+      }
+    if (total > m_resp_size)
+      {
+      uint32_t size = std::min<uint32_t>((total + 255) & ~255, 4096);
+      uint8_t* buf = (uint8_t*) ExternalRamRealloc(m_resp_buf, size);
+      if (buf)
+        {
+        m_resp_buf = buf;
+        m_resp_size = size;
+        }
+      else
+        {
+        DropPollResponse("no memory");
+        return;
+        }
+      }
+    }
+
+  if (m_resp_valid)
+    {
+    if (m_poll.mloffset != m_resp_len || m_resp_len + length > m_resp_size)
+      {
+      DropPollResponse("fragment missing");
+      }
+    else
+      {
+      memcpy(m_resp_buf + m_resp_len, data, length);
+      m_resp_len += length;
+      }
+    }
+
+  if (m_poll.mlremain == 0 && m_resp_valid)
+    {
+    m_resp_valid = false;
+    m_polls.IncomingResponse(m_poll, m_resp_buf, m_resp_len);
+    }
+  }
+
+/**
+ * DropPollResponse: abort collecting the current complete response
+ *  The series is informed by IncomingPollError() with POLL_ERR_INCOMPLETE, so it
+ *  doesn't need to wait for the poll timeout. Remaining fragments are ignored.
+ *  Called with m_poll_mutex held, by IncomingPollData() and by the protocol
+ *  receivers on a lost frame (reason NULL: already logged by the receiver).
+ */
+void OvmsPoller::DropPollResponse(const char* reason)
+  {
+  if (!m_resp_valid)
+    return;
+  m_resp_valid = false;
+  if (reason)
+    {
+    ESP_LOGW(TAG, "[%" PRIu8 "]IncomingPollData: %s at off=%u (have %u of %u) => dropping response %02X(%X)",
+             m_poll.bus_no, reason, m_poll.mloffset, m_resp_len, m_poll.mloffset + m_poll.mlremain,
+             m_poll.type, m_poll.pid);
+    }
+  IncomingPollError(m_poll, POLL_ERR_INCOMPLETE);
   }
 
 
@@ -223,9 +337,16 @@ OvmsPoller::~OvmsPoller()
  */
 void OvmsPoller::IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success)
   {
+  OvmsPollers::SignalLock lock(m_parent);
   m_polls.IncomingTxReply(job, success);
   }
 
+void OvmsPoller::IncomingPollError(const OvmsPoller::poll_job_t &job, int32_t code)
+  {
+  OvmsPollers::SignalLock lock(m_parent);
+  m_polls.IncomingError(job, code);
+  }
+
 bool OvmsPoller::Ready() const
   {
   return m_parent->Ready();
@@ -250,6 +371,7 @@ void OvmsPoller::PollSetPidList(uint8_t defaultbus, const OvmsPoller::poll_pid_t
     if (!plist) // Don't add if not necessary.
       return;
     m_poll_series = std::shared_ptr<StandardPollSeries>(new StandardVehiclePollSeries(this, signal));
+    m_poll_series->SetBatching(m_poll_batch_max);
     m_polls.SetEntry("!v.standard", m_poll_series);
     }
 
@@ -332,6 +454,24 @@ void OvmsPoller::PollSetTimeBetweenSuccess(uint16_t time_between_ms)
   m_poll_between_success = pdMS_TO_TICKS(time_between_ms);
   }
 
+/**
+ * PollSetBatching: configure UDS multi-DID requests for the vehicle poll list
+ *  Due ReadDataByIdentifier (0x22) entries for the same ECU are combined into one
+ *  request, see StandardPollSeries::SetBatching().
+ *
+ *  @param max_dids
+ *    DIDs per request (2…4), 0 = off (default)
+ *
+ *  The configuration is kept unchanged over calls to PollSetPidList() or PollSetState().
+ */
+void OvmsPoller::PollSetBatching(uint8_t max_dids)
+  {
+  OvmsRecMutexLock lock(&m_poll_mutex);
+  m_poll_batch_max = max_dids;
+  if (m_poll_series)
+    m_poll_series->SetBatching(max_dids);
+  }
+
 void OvmsPoller::ResetThrottle()
   {
   // Main Timer reset throttling counter,
@@ -492,6 +632,12 @@ void OvmsPoller::PollerSend(poller_source_t source)
     return;
     }
 
+  if (!m_polls.has_blocking() && !m_parent->CanPollBudget(m_poll.bus_no))
+    {
+    IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]PollerSend: Budget exhausted", m_poll.bus_no);
+    return;
+    }
+
   PollEntryStyle found_style;
   OvmsPoller::OvmsNextPollResult res;
   bool reach_repeat;
@@ -553,6 +699,7 @@ void OvmsPoller::PollerSend(poller_source_t source)
       {
       IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]PollerSend: Poller Reached End", m_poll.bus_no);
       m_poll_run_finished = true;
+      RoundFinished();
       break;
       }
     case OvmsNextPollResult::StillAtEnd:
@@ -561,6 +708,7 @@ void OvmsPoller::PollerSend(poller_source_t source)
         IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "Poller Reached End(!)", m_poll.bus_no);
         m_poll_run_finished = true;
         }
+      RoundFinished();
       break;
     case OvmsNextPollResult::FoundEntry:
       {
@@ -583,6 +731,11 @@ void OvmsPoller::PollerSend(poller_source_t source)
         PollerISOTPStart(fromPrimaryOrOnceOffTicker);
 
       m_poll_sequence_limiter.MarkPolled(found_style);
+      if (found_style == PollEntryStyle::Standard)
+        {
+        m_parent->MarkPollBudget(m_poll.bus_no);
+        RoundStarted();
+        }
       break;
       }
     }
@@ -608,9 +761,10 @@ void OvmsPoller::Outgoing(const CAN_frame_t &frame, bool success)
   if (!success)
     {
     ResetPollWaiting();
+    OvmsPollers::SignalLock signal(m_parent);
     OvmsRecMutexLock lock(&m_poll_mutex, pdMS_TO_TICKS(10));
     if (lock.IsLocked())
-      m_polls.IncomingError(m_poll, POLLSINGLE_TXFAILURE);
+      IncomingPollError(m_poll, POLLSINGLE_TXFAILURE);
     }
 
   // Forward to application:
@@ -686,7 +840,7 @@ int OvmsPoller::PollSingleRequest(uint32_t txid, uint32_t rxid,
     return POLLSINGLE_TIMEOUT;
     }
 
-  if (Atomic_Get(m_parent->m_polltask) == xTaskGetCurrentTaskHandle())
+  if (m_parent->IsPollerTask())
     {
     // NB: PollerStateTicker is called from the poller task.
     ESP_LOGE(TAG, "PollSingleRequest: Unable to call from poller task");
@@ -882,8 +1036,176 @@ void OvmsPoller::PollerStatus(int verbosity, OvmsWriter* writer)
     }
   writer->printf("  Ticker: %" PRIu32 "\n", m_poll.ticker);
   writer->printf("  State:  %" PRIu8 "\n", m_poll_state);
+  if (m_pipe_task)
+    writer->printf("  Pipeline: %s\n", m_parent->IsParallel() ? "active" : "idle");
+  RoundStatus(writer);
+  if (m_poll_series)
+    m_poll_series->BatchStatus(writer);
   m_polls.Status(verbosity, writer);
   }
+
+/**
+ * RoundStarted / RoundFinished: time the full rounds through the poll list,
+ *  from the first standard request to reaching the end of the list.
+ */
+void OvmsPoller::RoundStarted()
+  {
+  if (m_round_start == 0)
+    m_round_start = esp_timer_get_time();
+  }
+
+void OvmsPoller::RoundFinished()
+  {
+  if (m_round_start == 0)
+    return;
+  uint32_t ms = (esp_timer_get_time() - m_round_start) / 1000;
+  m_round_start = 0;
+  m_round_last_ms = ms;
+  if (m_round_count == 0 || ms < m_round_min_ms)
+    m_round_min_ms = ms;
+  if (ms > m_round_max_ms)
+    m_round_max_ms = ms;
+  m_round_sum_ms += ms;
+  ++m_round_count;
+  }
+
+void OvmsPoller::RoundStatsReset()
+  {
+  m_round_start = 0;
+  m_round_count = 0;
+  m_round_last_ms = 0;
+  m_round_min_ms = 0;
+  m_round_max_ms = 0;
+  m_round_sum_ms = 0;
+  }
+
+void OvmsPoller::RoundStatus(OvmsWriter* writer, bool header)
+  {
+  if (header)
+    writer->printf("Poller on Can%" PRIu8 "\n", m_poll.bus_no);
+  uint32_t count = m_round_count;
+  if (count == 0)
+    {
+    writer->puts("  Rounds: none completed");
+    return;
+    }
+  writer->printf("  Rounds: %" PRIu32 ", last %" PRIu32 "ms, avg %.1fms, min %" PRIu32 "ms, max %" PRIu32 "ms\n",
+    count, m_round_last_ms, (float)m_round_sum_ms / count, m_round_min_ms, m_round_max_ms);
+  }
+
+/**
+ * Per bus pipeline: while the pollers run in parallel mode, the frames and
+ *  poll requests of this bus are processed by a task of its own.
+ */
+void OvmsPoller::OvmsPollerPipelineTask(void *pvParameters)
+  {
+  OvmsPoller *me = (OvmsPoller*)pvParameters;
+  me->PipelineTask();
+  }
+
+void OvmsPoller::PipelineTask()
+  {
+  QueueHandle_t queue = m_pipe_queue;
+  poll_queue_entry_t entry;
+  while (true)
+    {
+    if (xQueueReceive(queue, &entry, (portTickType)portMAX_DELAY)!=pdTRUE)
+      continue;
+    if (entry.entry_type == OvmsPollEntryType::Command)
+      {
+      if (entry.entry_Command.cmd == OvmsPollCommand::Shutdown)
+        break;
+      continue;
+      }
+    if (m_parent->m_shut_down)
+      continue;
+
+    std::unique_ptr<timer_util_t> timer;
+    m_parent->TimeEntry(entry, timer);
+
+    m_parent->m_poll_last = monotonictime;
+    switch (entry.entry_type)
+      {
+      case OvmsPollEntryType::FrameRx:
+        m_parent->ProcessFrameRx(entry);
+        break;
+      case OvmsPollEntryType::FrameTx:
+        m_parent->ProcessFrameTx(entry);
+        break;
+      case OvmsPollEntryType::Poll:
+        if (!m_parent->m_user_paused && !m_parent->m_paused)
+          {
+          if ((entry.entry_Poll.poll_ticker == 0) || (m_poll.ticker == entry.entry_Poll.poll_ticker))
+            PollerSend(entry.entry_Poll.source);
+          }
+        break;
+      case OvmsPollEntryType::PollState:
+        Do_PollSetState(entry.entry_PollState.new_state);
+        break;
+      default:
+        break;
+      }
+    }
+
+  // Stop forwarding, then let StopPipeline() know we're done with this poller:
+  Atomic_GetAndNull(m_pipe_task);
+  ESP_LOGD(TAG, "[%" PRIu8 "]Pipeline: Shutdown", m_poll.bus_no);
+  xSemaphoreGive(m_pipe_done);
+  vTaskDelete(NULL);
+  }
+
+bool OvmsPoller::StartPipeline()
+  {
+  if (Atomic_Get(m_pipe_task))
+    return true;
+  if (!m_pipe_queue)
+    {
+    m_pipe_queue = xQueueCreate(CONFIG_OVMS_VEHICLE_CAN_RX_QUEUE_SIZE, sizeof(poll_queue_entry_t));
+    if (!m_pipe_queue)
+      {
+      ESP_LOGE(TAG, "[%" PRIu8 "]Pipeline: Failed to create queue", m_poll.bus_no);
+      return false;
+      }
+    }
+  if (!m_pipe_done)
+    {
+    m_pipe_done = xSemaphoreCreateBinary();
+    if (!m_pipe_done)
+      {
+      ESP_LOGE(TAG, "[%" PRIu8 "]Pipeline: Failed to create semaphore", m_poll.bus_no);
+      return false;
+      }
+    }
+  char name[configMAX_TASK_NAME_LEN];
+  snprintf(name, sizeof(name), "OVMS Poll Can%" PRIu8, m_poll.bus_no);
+  TaskHandle_t task;
+  if (xTaskCreatePinnedToCore(OvmsPollerPipelineTask, name,
+      CONFIG_OVMS_VEHICLE_RXTASK_STACK, (void*)this, 10, &task, CORE(1)) != pdPASS)
+    {
+    ESP_LOGE(TAG, "[%" PRIu8 "]Pipeline: Failed to create task", m_poll.bus_no);
+    return false;
+    }
+  // Vehicle callbacks need serialising from now on. Entries are only
+  // forwarded to the pipeline once m_pipe_task is set:
+  Atomic_Increment(m_parent->m_pipelines, (uint8_t)1);
+  Atomic_Swap(m_pipe_task, task);
+  ESP_LOGD(TAG, "[%" PRIu8 "]Pipeline: Started", m_poll.bus_no);
+  return true;
+  }
+
+void OvmsPoller::StopPipeline()
+  {
+  if (!Atomic_Get(m_pipe_task))
+    return;
+  poll_queue_entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.entry_type = OvmsPollEntryType::Command;
+  entry.entry_Command.cmd = OvmsPollCommand::Shutdown;
+  xQueueSendToFront(m_pipe_queue, &entry, portMAX_DELAY);
+  // Wait for the pipeline to finish the current entry & exit:
+  while (xSemaphoreTake(m_pipe_done, pdMS_TO_TICKS(10000)) != pdTRUE)
+    ESP_LOGW(TAG, "[%" PRIu8 "]Pipeline: Waiting for shutdown", m_poll.bus_no);
+  }
 /**
  * PollResultCodeName: get text representation of result code
  */
@@ -939,6 +1261,7 @@ const char *OvmsPoller::PollerCommand(OvmsPollCommand src, bool brief)
     case OvmsPollCommand::SuccessSep:  return brief ? "SucSp" : "SuccSep";
     case OvmsPollCommand::Shutdown:    return brief ? "Shtdn" : "Shutdown";
     case OvmsPollCommand::ResetTimer:  return brief ? "RstTm" : "ResetTimer";
+    case OvmsPollCommand::Batching:    return brief ? "Batch" : "Batching";
     }
   return "??";
   }
@@ -949,6 +1272,7 @@ OvmsPollers::OvmsPollers()
     m_poll_fc_septime(25),
     m_poll_ch_keepalive(60),
     m_poll_between_success(0),
+    m_poll_batch_max(0),
     m_poll_last(0),
     m_pollqueue(nullptr), m_polltask(nullptr),
     m_timer_poller(nullptr),
@@ -960,7 +1284,14 @@ OvmsPollers::OvmsPollers()
     m_paused(false),
     m_user_paused(false),
     m_trace(trace_Off),
-    m_filtered(false)
+    m_filtered(false),
+    m_poll_time_stats(nullptr),
+    m_poll_time_dropped(0),
+    m_parallel(false),
+    m_pipelines(0),
+    m_budget_max(0),
+    m_budget_total(0),
+    m_bench_busses(0)
 
   {
   ESP_LOGI(TAG, "Initialising Poller (7000)");
@@ -973,6 +1304,8 @@ OvmsPollers::OvmsPollers()
 
   m_overflow_count[0] = 0;
   m_overflow_count[1] = 0;
+  for (int idx = 0; idx < VEHICLE_MAXBUSSES; ++idx)
+    m_budget_used[idx] = 0;
 
   m_poll_txcallback = std::bind(&OvmsPollers::PollerTxCallback, this, _1, _2);
 
@@ -1001,7 +1334,16 @@ OvmsPollers::OvmsPollers()
   cmd_times->RegisterCommand("on","Turn on Poll-Time Tracing",poller_times);
   cmd_times->RegisterCommand("off","Turn off Poll-Time Tracing",poller_times);
   cmd_times->RegisterCommand("status","Show timing status",poller_times);
+  cmd_times->RegisterCommand("percentiles","Show timing percentiles",poller_times);
+  cmd_times->RegisterCommand("json","Show timing status as JSON",poller_times);
   cmd_times->RegisterCommand("reset","Reset Poll-Time Tracing",poller_times);
+  OvmsCommand* cmd_bench = cmd_poller->RegisterCommand("bench","OBD poll round benchmark on simulated ECUs");
+  cmd_bench->RegisterCommand("start","Start benchmark",poller_bench_start,
+    "<bus>[,<bus>...] [<pids> [<delay_ms> [<length>]]]\n"
+    "Polls <pids> (default 20) PIDs per round on each bus, answered by a simulated ECU\n"
+    "after <delay_ms> (default 10) with <length> (default 4) bytes of data.", 1, 4);
+  cmd_bench->RegisterCommand("stop","Stop benchmark",poller_bench_stop);
+  cmd_bench->RegisterCommand("status","Show benchmark results",poller_bench_status);
 
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   DuktapeObjectRegistration* dto = new DuktapeObjectRegistration("OvmsPoller");
@@ -1044,7 +1386,10 @@ OvmsPollers::OvmsPollers()
 #endif
 
   if (MyConfig.ismounted())
+    {
     LoadPollerTimerConfig();
+    LoadPollerParallelConfig();
+    }
   }
 
 OvmsPollers::~OvmsPollers()
@@ -1070,7 +1415,9 @@ OvmsPollers::~OvmsPollers()
       m_pollers[i] = nullptr;
       }
     }
-
+  auto stats = Atomic_GetAndNull(m_poll_time_stats);
+  if (stats)
+    free(stats);
   }
 
 void OvmsPollers::StartingUp()
@@ -1092,10 +1439,14 @@ void OvmsPollers::ShuttingDown()
     m_timer_poller = NULL;
     }
 
+  BenchStop();
   for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
     {
     if (m_pollers[i])
+      {
+      m_pollers[i]->StopPipeline();
       m_pollers[i]->ClearPollList();
+      }
     }
 
   bool autoOff = MyConfig.GetParamValueBool("vehicle", "can.autooff", true);
@@ -1210,6 +1561,7 @@ void OvmsPollers::PowerDownCanBus(int busno)
 void OvmsPollers::Ticker1(std::string event, void* data)
   {
   PollerResetThrottle();
+  ResetPollBudget();
   }
 
 void OvmsPollers::EventSystemShuttingDown(std::string event, void* data)
@@ -1289,6 +1641,8 @@ void OvmsPollers::ConfigChanged(std::string event, void* data)
   OvmsConfigParam* param = (OvmsConfigParam*) data;
   if (!param || param->GetName() == "log")
     LoadPollerTimerConfig();
+  if (!param || param->GetName() == "vehicle")
+    LoadPollerParallelConfig();
   }
 
 void OvmsPollers::LoadPollerTimerConfig()
@@ -1299,6 +1653,140 @@ void OvmsPollers::LoadPollerTimerConfig()
     MyPollers.m_trace &= ~trace_Times;
   }
 
+void OvmsPollers::LoadPollerParallelConfig()
+  {
+  int budget = MyConfig.GetParamValueInt("vehicle", "poller.budget", 0);
+  m_budget_max = (budget < 0) ? 0 : std::min(budget, 0xffff);
+  SetParallel(MyConfig.GetParamValueBool("vehicle", "poller.parallel", false));
+  }
+
+/**
+ * SetParallel: process the busses in pipelines of their own.
+ *  Pipelines are started on demand and kept idle when switching back,
+ *  so entries still queued for them will not get lost.
+ */
+void OvmsPollers::SetParallel(bool parallel)
+  {
+  if (parallel == m_parallel)
+    return;
+  ESP_LOGI(TAG, "Pollers: %s bus pipelines", parallel ? "Parallel" : "Serial");
+  OvmsRecMutexLock lock(&m_poller_mutex);
+  if (parallel)
+    {
+    for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+      {
+      if (m_pollers[i])
+        m_pollers[i]->StartPipeline();
+      }
+    }
+  m_parallel = parallel;
+  }
+
+bool OvmsPollers::IsPollerTask() const
+  {
+  TaskHandle_t cur = xTaskGetCurrentTaskHandle();
+  if (Atomic_Get(m_polltask) == cur)
+    return true;
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    {
+    auto poller = m_pollers[i];
+    if (poller && Atomic_Get(poller->m_pipe_task) == cur)
+      return true;
+    }
+  return false;
+  }
+
+/**
+ * PipelineQueue: get the pipeline queue for a bus in parallel mode, if any.
+ *  Pollers are never removed while running, so this needs no lock.
+ */
+QueueHandle_t OvmsPollers::PipelineQueue(uint8_t busno) const
+  {
+  if (!m_parallel || busno == 0)
+    return nullptr;
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    {
+    auto poller = m_pollers[i];
+    if (poller && poller->m_poll.bus_no == busno)
+      return Atomic_Get(poller->m_pipe_task) ? poller->m_pipe_queue : nullptr;
+    }
+  return nullptr;
+  }
+
+/**
+ * ForwardPipeline: pass a bus specific copy of an entry to the poller pipeline.
+ * @return false if the poller has no active pipeline.
+ */
+bool OvmsPollers::ForwardPipeline(OvmsPoller *poller, OvmsPoller::poll_queue_entry_t &entry)
+  {
+  QueueHandle_t queue = PipelineQueue(poller->m_poll.bus_no);
+  if (!queue)
+    return false;
+  OvmsPoller::poll_queue_entry_t fwd = entry;
+  if (fwd.entry_type == OvmsPoller::OvmsPollEntryType::Poll)
+    fwd.entry_Poll.busno = poller->m_poll.bus_no;
+  else if (fwd.entry_type == OvmsPoller::OvmsPollEntryType::PollState)
+    fwd.entry_PollState.bus = poller->m_poll.bus;
+  if (xQueueSend(queue, &fwd, 0) != pdPASS)
+    ESP_LOGI(TAG, "Pollers[%" PRIu8 "]: Pipeline Queue Overflow", poller->m_poll.bus_no);
+  return true;
+  }
+
+/**
+ * Global poll budget: limits the standard poll requests of all busses per second.
+ *  Each bus is guaranteed its fair share, it may use more as long as the
+ *  remaining budget still covers the unused shares of the other busses.
+ */
+bool OvmsPollers::CanPollBudget(uint8_t busno)
+  {
+  if (m_budget_max == 0 || busno < 1 || busno > VEHICLE_MAXBUSSES)
+    return true;
+  bool active[VEHICLE_MAXBUSSES] = {};
+  int active_count = 0;
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    {
+    auto poller = m_pollers[i];
+    if (poller && poller->m_poll.bus_no >= 1 && poller->m_poll.bus_no <= VEHICLE_MAXBUSSES && poller->HasPollList())
+      {
+      active[poller->m_poll.bus_no-1] = true;
+      ++active_count;
+      }
+    }
+  uint16_t share = std::max(1, m_budget_max / std::max(1, active_count));
+
+  OvmsMutexLock lock(&m_budget_mutex);
+  if (m_budget_total >= m_budget_max)
+    return false;
+  if (m_budget_used[busno-1] < share)
+    return true;
+  uint32_t reserved = 0;
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    {
+    if (i != busno-1 && active[i] && m_budget_used[i] < share)
+      reserved += share - m_budget_used[i];
+    }
+  return (uint32_t)(m_budget_max - m_budget_total) > reserved;
+  }
+
+void OvmsPollers::MarkPollBudget(uint8_t busno)
+  {
+  if (m_budget_max == 0 || busno < 1 || busno > VEHICLE_MAXBUSSES)
+    return;
+  OvmsMutexLock lock(&m_budget_mutex);
+  if (m_budget_used[busno-1] < 0xffff)
+    ++m_budget_used[busno-1];
+  if (m_budget_total < 0xffff)
+    ++m_budget_total;
+  }
+
+void OvmsPollers::ResetPollBudget()
+  {
+  OvmsMutexLock lock(&m_budget_mutex);
+  m_budget_total = 0;
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    m_budget_used[i] = 0;
+  }
+
 /**
  * PollerTxCallback: internal: process poll request callbacks
  */
@@ -1477,32 +1965,218 @@ void OvmsPollers::average_value_t::add_time(uint32_t time_spent, uint64_t time_a
     max_time = timesum;
   }
 
-bool OvmsPollers::poller_key_less_t::operator()(const poller_key_t &lhs, const poller_key_t &rhs) const
+bool OvmsPollers::poller_key_st::operator==(const poller_key_st &rhs) const
+  {
+  if (entry_type != rhs.entry_type)
+    return false;
+  switch (entry_type)
+    {
+    case OvmsPoller::OvmsPollEntryType::FrameRx:
+    case OvmsPoller::OvmsPollEntryType::FrameTx:
+      return busnumber == rhs.busnumber && Frame_MsgId == rhs.Frame_MsgId;
+    case OvmsPoller::OvmsPollEntryType::Poll:
+      return busnumber == rhs.busnumber && Poll_src == rhs.Poll_src;
+    case OvmsPoller::OvmsPollEntryType::Command:
+      return Command_cmd == rhs.Command_cmd;
+    default:
+      return true;
+    }
+  }
+
+uint32_t OvmsPollers::poller_key_st::hash() const
+  {
+  uint32_t val;
+  switch (entry_type)
+    {
+    case OvmsPoller::OvmsPollEntryType::FrameRx:
+    case OvmsPoller::OvmsPollEntryType::FrameTx:
+      val = Frame_MsgId;
+      break;
+    case OvmsPoller::OvmsPollEntryType::Poll:
+      val = static_cast<uint32_t>(Poll_src);
+      break;
+    case OvmsPoller::OvmsPollEntryType::Command:
+      val = static_cast<uint32_t>(Command_cmd);
+      break;
+    default:
+      val = 0;
+    }
+  val ^= (static_cast<uint32_t>(entry_type) << 29) ^ (static_cast<uint32_t>(busnumber) << 26);
+  // Fibonacci hashing: spreads sequential CAN IDs over the table.
+  return val * 2654435761u;
+  }
+
+/**
+ * FindTimesEntry: find the stats entry for a key.
+ * Only the poller task may create entries.
+ */
+OvmsPollers::poller_times_entry_t *OvmsPollers::FindTimesEntry(const poller_key_t &key, bool create)
+  {
+  poller_times_entry_t *table = Atomic_Get(m_poll_time_stats);
+  if (!table)
+    {
+    if (!create)
+      return nullptr;
+    table = (poller_times_entry_t *)ExternalRamCalloc(times_table_size, sizeof(poller_times_entry_t));
+    if (!table)
+      return nullptr;
+    for (int i = 0; i < times_table_size; ++i)
+      new (&table[i]) poller_times_entry_t();
+    Atomic_Swap(m_poll_time_stats, table);
+    }
+  uint32_t idx = key.hash() >> (32 - floorlog2(times_table_size));
+  for (int probe = 0; probe < times_table_size; ++probe)
+    {
+    poller_times_entry_t &entry = table[idx];
+    if (!Atomic_Get(entry.used))
+      {
+      if (!create)
+        return nullptr;
+      entry.key = key;
+      Atomic_Swap(entry.used, true);
+      return &entry;
+      }
+    if (entry.key == key)
+      return &entry;
+    idx = (idx + 1) & (times_table_size - 1);
+    }
+  return nullptr;
+  }
+
+/**
+ * PipelineLock: lock a mutex only if it's needed because bus pipelines are running.
+ */
+class PipelineLock
+  {
+  private:
+    OvmsMutex *m_mutex;
+  public:
+    PipelineLock(OvmsMutex *mutex, bool need)
+      : m_mutex(need ? mutex : nullptr)
+      {
+      if (m_mutex)
+        m_mutex->Lock();
+      }
+    ~PipelineLock()
+      {
+      if (m_mutex)
+        m_mutex->Unlock();
+      }
+  };
+
+void OvmsPollers::AddTimesEntry(const poller_key_t &key, uint32_t time_spent, uint64_t time_added)
+  {
+  PipelineLock lock(&m_times_mutex, m_pipelines != 0);
+  poller_times_entry_t *entry = FindTimesEntry(key, true);
+  if (!entry)
+    {
+    Atomic_Increment(m_poll_time_dropped, (uint32_t)1);
+    return;
+    }
+  Atomic_Increment(entry->seq, (uint32_t)1);
+  entry->avg.add_time(time_spent, time_added);
+  Atomic_Increment(entry->seq, (uint32_t)1);
+
+  uint8_t bucket = (time_spent < 2) ? 0 : (31 - __builtin_clz(time_spent));
+  if (bucket >= times_hist_buckets)
+    bucket = times_hist_buckets-1;
+  Atomic_Increment(entry->hist[bucket], (uint32_t)1);
+  Atomic_Increment(entry->count, (uint32_t)1);
+  }
+
+void OvmsPollers::ResetTimesEntries(bool paused_only)
+  {
+  PipelineLock lock(&m_times_mutex, m_pipelines != 0);
+  poller_times_entry_t *table = Atomic_Get(m_poll_time_stats);
+  if (!table)
+    return;
+  for (int i = 0; i < times_table_size; ++i)
+    {
+    poller_times_entry_t &entry = table[i];
+    if (!Atomic_Get(entry.used))
+      continue;
+    Atomic_Increment(entry.seq, (uint32_t)1);
+    if (paused_only)
+      entry.avg.paused();
+    else
+      entry.avg.reset();
+    Atomic_Increment(entry.seq, (uint32_t)1);
+    if (!paused_only)
+      {
+      for (int b = 0; b < times_hist_buckets; ++b)
+        Atomic_Swap(entry.hist[b], (uint32_t)0);
+      Atomic_Swap(entry.count, (uint32_t)0);
+      }
+    }
+  if (!paused_only)
+    Atomic_Swap(m_poll_time_dropped, (uint32_t)0);
+  }
+
+void OvmsPollers::CatchupTimesEntries(uint64_t time_added)
+  {
+  PipelineLock lock(&m_times_mutex, m_pipelines != 0);
+  poller_times_entry_t *table = Atomic_Get(m_poll_time_stats);
+  if (!table)
+    return;
+  for (int i = 0; i < times_table_size; ++i)
+    {
+    poller_times_entry_t &entry = table[i];
+    if (!Atomic_Get(entry.used))
+      continue;
+    Atomic_Increment(entry.seq, (uint32_t)1);
+    entry.avg.catchup(time_added);
+    Atomic_Increment(entry.seq, (uint32_t)1);
+    }
+  }
+
+/**
+ * CopyTimesEntry: get a consistent copy of the averages without blocking the poller.
+ * @return false if the entry kept changing (very unlikely).
+ */
+bool OvmsPollers::CopyTimesEntry(const poller_times_entry_t &entry, average_value_t &avg)
   {
-  if (lhs.entry_type != rhs.entry_type)
-    return lhs.entry_type < rhs.entry_type;
-  switch (lhs.entry_type)
+  for (int retry = 0; retry < 10; ++retry)
     {
-    case OvmsPoller::OvmsPollEntryType::FrameRx:
-    case OvmsPoller::OvmsPollEntryType::FrameTx:
+    uint32_t seq = Atomic_Get(entry.seq);
+    if (seq & 1)
       {
-      if (lhs.busnumber != rhs.busnumber)
-        return lhs.busnumber < rhs.busnumber;
-      return lhs.Frame_MsgId < rhs.Frame_MsgId;
+      taskYIELD();
+      continue;
       }
-    case OvmsPoller::OvmsPollEntryType::Poll:
+    avg = entry.avg;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (Atomic_Get(entry.seq) == seq)
+      return true;
+    }
+  return false;
+  }
+
+/**
+ * TimesPercentile: interpolate a percentile from the log2 histogram.
+ * @return time in us
+ */
+float OvmsPollers::TimesPercentile(const uint32_t *hist, uint32_t total, float fraction, uint32_t max_val)
+  {
+  if (total == 0)
+    return 0;
+  float target = fraction * total;
+  uint32_t cum = 0;
+  for (int b = 0; b < times_hist_buckets; ++b)
+    {
+    if (hist[b] == 0 || cum + hist[b] < target)
       {
-      if (lhs.busnumber != rhs.busnumber)
-        return lhs.busnumber < rhs.busnumber;
-      return lhs.Poll_src < rhs.Poll_src;
+      cum += hist[b];
+      continue;
       }
-    case OvmsPoller::OvmsPollEntryType::Command:
-      return lhs.Command_cmd < rhs.Command_cmd;
-    case OvmsPoller::OvmsPollEntryType::PollState:
-      return false;
-    default:
-      return false;
+    float lo = (b == 0) ? 0 : (1 << b);
+    float hi = 1 << (b+1);
+    float res = lo + (hi - lo) * (target - cum) / hist[b];
+    // The peak is exact, the buckets aren't.
+    if (max_val >= lo && res > max_val)
+      res = max_val;
+    return res;
     }
+  return max_val;
   }
 
 OvmsPollers::poller_key_st::poller_key_st( const OvmsPoller::poll_queue_entry_t &entry)
@@ -1528,6 +2202,100 @@ OvmsPollers::poller_key_st::poller_key_st( const OvmsPoller::poll_queue_entry_t
     }
   }
 
+void OvmsPollers::TimeEntry(OvmsPoller::poll_queue_entry_t &entry, std::unique_ptr<timer_util_t> &timer)
+  {
+  IFTRACE(Times)
+    timer = std::unique_ptr<timer_util_t>(new timer_util_t(
+      [&entry,this](uint64_t start, uint64_t finish)
+        {
+          {
+          int32_t diff = finish-start;
+          AddTimesEntry(poller_key_t(entry), diff, finish);
+          }
+        }
+      ));
+  }
+
+void OvmsPollers::ProcessFrameRx(OvmsPoller::poll_queue_entry_t &entry)
+  {
+  bool processed = false;
+  canbus* bus = entry.entry_FrameRxTx.frame.origin;
+  auto poller = GetPoller(bus);
+  IFTRACE(Poller) ESP_LOGV(TAG, "Pollers: FrameRx(bus=%d)", GetBusNo(entry.entry_FrameRxTx.frame.origin));
+  if (poller)
+    processed = poller->Incoming(entry.entry_FrameRxTx.frame, entry.entry_FrameRxTx.success);
+  PollerFrameRx(entry.entry_FrameRxTx.frame);
+
+  if (!processed) // Not processed by poller.
+    {
+    dbcfile* dbc = bus->GetDBC();
+    if (dbc != nullptr)
+      {
+      SignalLock lock(this);
+      CAN_frame_t &frame = entry.entry_FrameRxTx.frame;
+      dbc->DecodeSignal(frame.FIR.B.FF, frame.MsgID, frame.data.u8, 8);
+      }
+    }
+  }
+
+void OvmsPollers::ProcessFrameTx(OvmsPoller::poll_queue_entry_t &entry)
+  {
+  auto poller = GetPoller(entry.entry_FrameRxTx.frame.origin);
+  IFTRACE(Poller) ESP_LOGV(TAG, "Pollers: FrameTx(bus=%d) %s",
+      GetBusNo(entry.entry_FrameRxTx.frame.origin),
+      (poller == nullptr) ? "not found" : "poller found");
+  if (poller)
+    poller->Outgoing(entry.entry_FrameRxTx.frame, entry.entry_FrameRxTx.success);
+  }
+
+void OvmsPollers::ProcessPoll(OvmsPoller::poll_queue_entry_t &entry)
+  {
+  if (m_user_paused || m_paused)
+    return;
+  // Must not lock mutex while calling.
+  IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]Poller: Send(%s)", entry.entry_Poll.busno, OvmsPoller::PollerSource(entry.entry_Poll.source));
+  if (entry.entry_Poll.busno != 0)
+    {
+    auto bus = GetBus(entry.entry_Poll.busno);
+    auto poller = GetPoller(bus);
+    if (poller)
+      {
+      if ((entry.entry_Poll.poll_ticker == 0) || (poller->m_poll.ticker == entry.entry_Poll.poll_ticker))
+        poller->PollerSend(entry.entry_Poll.source);
+      }
+    }
+  else
+    {
+    for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+      {
+      OvmsPoller *poller;
+        {
+        OvmsRecMutexLock lock(&m_poller_mutex);
+        poller = m_pollers[i];
+        }
+      if (poller && !ForwardPipeline(poller, entry))
+        poller->PollerSend(entry.entry_Poll.source);
+      }
+    }
+  }
+
+void OvmsPollers::ProcessPollState(OvmsPoller::poll_queue_entry_t &entry)
+  {
+  if (entry.entry_PollState.bus)
+    ESP_LOGD(TAG, "Pollers: PollState(%" PRIu8 ",%" PRIu8 ")", entry.entry_PollState.new_state, GetBusNo(entry.entry_PollState.bus));
+  else
+    ESP_LOGD(TAG, "Pollers: PollState(%" PRIu8 ")", entry.entry_PollState.new_state);
+  OvmsRecMutexLock lock(&m_poller_mutex);
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    {
+    auto cur = m_pollers[i];
+    if (!cur || (entry.entry_PollState.bus && !cur->HasBus(entry.entry_PollState.bus)))
+      continue;
+    if (!ForwardPipeline(cur, entry))
+      cur->Do_PollSetState(entry.entry_PollState.new_state);
+    }
+  }
+
 void OvmsPollers::PollerTask()
   {
   OvmsPoller::poll_queue_entry_t entry;
@@ -1546,10 +2314,7 @@ void OvmsPollers::PollerTask()
       if (entry.entry_type == OvmsPoller::OvmsPollEntryType::PollState)
         {
         // Make sure the every second (ish), we have caught up on averages-by-period measurements.
-        uint64_t curtime = esp_timer_get_time();
-        OvmsMutexLock lock(&m_stats_mutex);
-        for (auto it = m_poll_time_stats.begin(); it != m_poll_time_stats.end(); ++it)
-          it->second.catchup(curtime);
+        CatchupTimesEntries(esp_timer_get_time());
         }
       }
     // A couple of special cases.
@@ -1562,16 +2327,13 @@ void OvmsPollers::PollerTask()
         }
       if (entry.entry_Command.cmd == OvmsPoller::OvmsPollCommand::ResetTimer)
         {
-        OvmsMutexLock lock(&m_stats_mutex);
         if (entry.entry_Command.parameter == 2)
           {
-          for (auto it = m_poll_time_stats.begin(); it != m_poll_time_stats.end(); ++it)
-            it->second.paused();
+          ResetTimesEntries(true);
           }
         else
           {
-          for (auto it = m_poll_time_stats.begin(); it != m_poll_time_stats.end(); ++it)
-            it->second.reset();
+          ResetTimesEntries(false);
           if (entry.entry_Command.parameter == 1)
             {
             // Tracing back on.
@@ -1588,53 +2350,16 @@ void OvmsPollers::PollerTask()
       }
 
     std::unique_ptr<timer_util_t> timer;
-
-    IFTRACE(Times)
-      timer = std::unique_ptr<timer_util_t>(new timer_util_t(
-        [&entry,this](uint64_t start, uint64_t finish)
-          {
-            {
-            int32_t diff = finish-start;
-            poller_key_t key(entry);
-            OvmsMutexLock lock(&m_stats_mutex);
-            m_poll_time_stats[key].add_time(diff, finish);
-            }
-          }
-        ));
+    TimeEntry(entry, timer);
 
     m_poll_last = monotonictime;
     switch (entry.entry_type)
       {
       case OvmsPoller::OvmsPollEntryType::FrameRx:
-        {
-        bool processed = false;
-        canbus* bus = entry.entry_FrameRxTx.frame.origin;
-        auto poller = GetPoller(bus);
-        IFTRACE(Poller) ESP_LOGV(TAG, "Pollers: FrameRx(bus=%d)", GetBusNo(entry.entry_FrameRxTx.frame.origin));
-        if (poller)
-          processed = poller->Incoming(entry.entry_FrameRxTx.frame, entry.entry_FrameRxTx.success);
-        PollerFrameRx(entry.entry_FrameRxTx.frame);
-
-        if (!processed) // Not processed by poller.
-          {
-          dbcfile* dbc = bus->GetDBC();
-          if (dbc != nullptr)
-            {
-            CAN_frame_t &frame = entry.entry_FrameRxTx.frame;
-            dbc->DecodeSignal(frame.FIR.B.FF, frame.MsgID, frame.data.u8, 8);
-            }
-          }
-        }
+        ProcessFrameRx(entry);
         break;
       case OvmsPoller::OvmsPollEntryType::FrameTx:
-        {
-        auto poller = GetPoller(entry.entry_FrameRxTx.frame.origin);
-        IFTRACE(Poller) ESP_LOGV(TAG, "Pollers: FrameTx(bus=%d) %s",
-            GetBusNo(entry.entry_FrameRxTx.frame.origin),
-            (poller == nullptr) ? "not found" : "poller found");
-        if (poller)
-          poller->Outgoing(entry.entry_FrameRxTx.frame, entry.entry_FrameRxTx.success);
-        }
+        ProcessFrameTx(entry);
         break;
       case OvmsPoller::OvmsPollEntryType::Poll:
         {
@@ -1647,34 +2372,7 @@ void OvmsPollers::PollerTask()
             Atomic_Subtract( m_overflow_count[istx], ovf_count);
             }
           }
-        if (!m_user_paused && !m_paused)
-          {
-          // Must not lock mutex while calling.
-          IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]Poller: Send(%s)", entry.entry_Poll.busno, OvmsPoller::PollerSource(entry.entry_Poll.source));
-          if (entry.entry_Poll.busno != 0)
-            {
-            auto bus = GetBus(entry.entry_Poll.busno);
-            auto poller = GetPoller(bus);
-            if (poller)
-              {
-              if ((entry.entry_Poll.poll_ticker == 0) || (poller->m_poll.ticker == entry.entry_Poll.poll_ticker))
-                poller->PollerSend(entry.entry_Poll.source);
-              }
-            }
-          else
-            {
-            for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
-              {
-              OvmsPoller *poller;
-                {
-                OvmsRecMutexLock lock(&m_poller_mutex);
-                poller = m_pollers[i];
-                }
-              if (poller)
-                poller->PollerSend(entry.entry_Poll.source);
-              }
-            }
-          }
+        ProcessPoll(entry);
         }
         break;
       case OvmsPoller::OvmsPollEntryType::Command:
@@ -1770,35 +2468,24 @@ void OvmsPollers::PollerTask()
                 }
               }
             break;
+          case OvmsPoller::OvmsPollCommand::Batching:
+            if (entry.entry_Command.parameter != m_poll_batch_max)
+              {
+              m_poll_batch_max = entry.entry_Command.parameter;
+              OvmsRecMutexLock lock(&m_poller_mutex);
+              for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+                {
+                if (m_pollers[i])
+                  m_pollers[i]->PollSetBatching(m_poll_batch_max);
+                }
+              }
+            break;
           case OvmsPoller::OvmsPollCommand::ResetTimer:
             break;//triggered above
           }
         break;
       case OvmsPoller::OvmsPollEntryType::PollState:
-        {
-        if (entry.entry_PollState.bus)
-          {
-          ESP_LOGD(TAG, "Pollers: PollState(%" PRIu8 ",%" PRIu8 ")", entry.entry_PollState.new_state, GetBusNo(entry.entry_PollState.bus));
-          OvmsRecMutexLock lock(&m_poller_mutex);
-          for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
-            {
-            auto cur = m_pollers[i];
-            if (cur && cur->HasBus(entry.entry_PollState.bus) )
-              cur->Do_PollSetState(entry.entry_PollState.new_state);
-            }
-          }
-        else
-          {
-          ESP_LOGD(TAG, "Pollers: PollState(%" PRIu8 ")", entry.entry_PollState.new_state);
-          OvmsRecMutexLock lock(&m_poller_mutex);
-          for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
-            {
-            auto cur = m_pollers[i];
-            if (cur)
-              cur->Do_PollSetState(entry.entry_PollState.new_state);
-            }
-          }
-        }
+        ProcessPollState(entry);
         break;
       }
     }
@@ -1854,6 +2541,9 @@ OvmsPoller *OvmsPollers::GetPoller(canbus *can, bool force)
 
     newpoller->m_poll_fc_septime = m_poll_fc_septime;
     newpoller->m_poll_ch_keepalive = m_poll_ch_keepalive;
+    newpoller->m_poll_batch_max = m_poll_batch_max;
+    if (m_parallel)
+      newpoller->StartPipeline();
     m_pollers[gap] = newpoller;
     }
 
@@ -1880,7 +2570,8 @@ void OvmsPollers::QueuePollerSend(OvmsPoller::poller_source_t src, uint8_t busno
   entry.entry_Poll.poll_ticker = pollticker;
 
   IFTRACE(TXRX) ESP_LOGV(TAG, "Pollers: Queue PollerSend(%s, %" PRIu8 ")", OvmsPoller::PollerSource(src), busno);
-  if (xQueueSend(m_pollqueue, &entry, pdMS_TO_TICKS(50)) != pdPASS)
+  QueueHandle_t queue = PipelineQueue(busno);
+  if (xQueueSend(queue ? queue : m_pollqueue, &entry, pdMS_TO_TICKS(50)) != pdPASS)
     ESP_LOGI(TAG, "Pollers[Send]: Task Queue Overflow");
   }
 
@@ -2043,7 +2734,8 @@ void OvmsPollers::Queue_PollerFrame(const CAN_frame_t &frame, bool success, bool
   entry.entry_FrameRxTx.success = success;
 
   IFTRACE(TXRX) ESP_LOGV(TAG, "Poller: Queue PollerFrame(%s, %s)", (success ? "OK" : "Fail"), ( istx ? "TX" : "RX") );
-  if (xQueueSend(m_pollqueue, &entry, 0) != pdPASS)
+  QueueHandle_t queue = frame.origin ? PipelineQueue(frame.origin->m_busnumber+1) : nullptr;
+  if (xQueueSend(queue ? queue : m_pollqueue, &entry, 0) != pdPASS)
     {
     volatile uint32_t &count = m_overflow_count[istx ? 1 : 0];
     Atomic_Increment(count, (uint32_t)1);
@@ -2130,6 +2822,9 @@ void OvmsPollers::PollerStatus(int verbosity, OvmsWriter* writer)
   writer->printf("Time between polling ticks: %" PRIu16 "ms\n", m_poll_tick_ms);
  if (m_poll_tick_secondary > 0)
    writer->printf("Secondary ticks: %" PRIu8 ".\n",  m_poll_tick_secondary);
+  writer->printf("Bus processing: %s\n", m_parallel ? "parallel" : "serial");
+  if (m_budget_max)
+    writer->printf("Poll budget: %" PRIu16 "/s, used %" PRIu16 "\n", m_budget_max, m_budget_total);
   auto last = LastPollCmdReceived();
   writer->printf("Last Poll Received: ");
   if (last == 0)
@@ -2217,6 +2912,16 @@ void OvmsPollers::poller_times(int verbosity, OvmsWriter* writer, OvmsCommand* c
       (MyPollers.m_trace & trace_Times) ? "on" : "off");
     MyPollers.PollerTimesTrace(writer);
     }
+  else if (strcmp(cmd->GetName(), "percentiles") == 0)
+    {
+    writer->printf("Poller timing is: %s\n",
+      (MyPollers.m_trace & trace_Times) ? "on" : "off");
+    MyPollers.PollerTimesPercentiles(writer);
+    }
+  else if (strcmp(cmd->GetName(), "json") == 0)
+    {
+    MyPollers.PollerTimesJson(writer);
+    }
   else if (strcmp(cmd->GetName(), "reset") == 0)
     {
     MyPollers.PollerTimesReset();
@@ -2485,6 +3190,15 @@ duk_ret_t OvmsPollers::DukOvmsPollerTimesGetStatus(duk_context *ctx)
     duk_push_number(ctx, it->max_val);
     duk_put_prop_string(ctx, -2, "peak_time_ms");
 
+    duk_push_number(ctx, it->p50);
+    duk_put_prop_string(ctx, -2, "p50_ms");
+
+    duk_push_number(ctx, it->p95);
+    duk_put_prop_string(ctx, -2, "p95_ms");
+
+    duk_push_number(ctx, it->p99);
+    duk_put_prop_string(ctx, -2, "p99_ms");
+
     // Add the object with the desc as the key
     duk_put_prop_string(ctx, -2, it->desc.c_str());
     }
@@ -3317,6 +4031,8 @@ duk_ret_t OvmsPollers::DukOvmsPollerPollAdd(duk_context *ctx)
               }
             duk_pop(ctx);
             // -- {poll_item} {decode_obj}
+            // Compile the decode plan before the message is shared with the poller:
+            msg->Compile();
             message_id_t id;
             id.rxid = poll.rxmoduleid;
             id.pid = poll.pid;
@@ -3699,19 +4415,30 @@ bool OvmsPollers::LoadTimesTrace( metric_unit_t ratio_unit, times_trace_t &trace
   uint32_t avg_time_sum_us = 0;
   uint32_t avg_utlzn_sum_us = 0;
   uint32_t avg_count_sum = 0;
-  std::list<std::pair<poller_key_t, average_value_t> > copy;
-  // Lock for the shortest time possible... copy the current values.
-  m_stats_mutex.Lock();
-  for (const auto &val : m_poll_time_stats)
-    copy.push_back(val);
-  m_stats_mutex.Unlock();
+  trace.dropped = Atomic_Get(m_poll_time_dropped);
+
+  const poller_times_entry_t *table = Atomic_Get(m_poll_time_stats);
+  if (!table)
+    return false;
 
-  for (auto it = copy.begin(); it != copy.end(); ++it)
+  for (int idx = 0; idx < times_table_size; ++idx)
     {
-    average_value_t &cur = it->second;
+    const poller_times_entry_t &entry = table[idx];
+    if (!Atomic_Get(entry.used))
+      continue;
+    average_value_t cur;
+    if (!CopyTimesEntry(entry, cur))
+      continue;
     uint16_t max_val = cur.max_val;
     if (max_val == 0)
       continue;
+    uint32_t hist[times_hist_buckets];
+    uint32_t hist_total = 0;
+    for (int b = 0; b < times_hist_buckets; ++b)
+      {
+      hist[b] = Atomic_Get(entry.hist[b]);
+      hist_total += hist[b];
+      }
     uint16_t avg_100n = cur.avg_n.get();
     uint32_t avg_utlzn_us = cur.avg_utlzn.get();
     uint32_t avg_time = cur.avg_time.get();
@@ -3720,22 +4447,23 @@ bool OvmsPollers::LoadTimesTrace( metric_unit_t ratio_unit, times_trace_t &trace
     avg_utlzn_sum_us += avg_utlzn_us;
     avg_count_sum += avg_100n;
 
+    const poller_key_t &key = entry.key;
     times_trace_elt_t item;
-    switch (it->first.entry_type)
+    switch (key.entry_type)
       {
       case OvmsPoller::OvmsPollEntryType::FrameRx:
         item.desc = string_format("RxCan%" PRIu8 "[%03" PRIx32 "]",
-            it->first.busnumber, it->first.Frame_MsgId);
+            key.busnumber, key.Frame_MsgId);
         break;
       case OvmsPoller::OvmsPollEntryType::FrameTx:
         item.desc = string_format("TxCan%" PRIu8 "[%03" PRIx32 "]",
-            it->first.busnumber, it->first.Frame_MsgId);
+            key.busnumber, key.Frame_MsgId);
         break;
       case OvmsPoller::OvmsPollEntryType::Poll:
-        item.desc = string_format("Poll:%s", OvmsPoller::PollerSource(it->first.Poll_src));
+        item.desc = string_format("Poll:%s", OvmsPoller::PollerSource(key.Poll_src));
         break;
       case OvmsPoller::OvmsPollEntryType::Command:
-        item.desc = string_format("Cmd:%s", OvmsPoller::PollerCommand(it->first.Command_cmd, true));
+        item.desc = string_format("Cmd:%s", OvmsPoller::PollerCommand(key.Command_cmd, true));
         break;
       case OvmsPoller::OvmsPollEntryType::PollState:
         item.desc = "Cmd:State";
@@ -3750,10 +4478,19 @@ bool OvmsPollers::LoadTimesTrace( metric_unit_t ratio_unit, times_trace_t &trace
     item.max_time = UnitConvert(Permille, ratio_unit, max_time / (average_sep_s * 1000.0F));
     item.avg_time = avg_time / 10000.0;
     item.max_val  = max_val  / 1000.0;
+    item.count = Atomic_Get(entry.count);
+    item.p50 = TimesPercentile(hist, hist_total, 0.50, max_val) / 1000.0;
+    item.p95 = TimesPercentile(hist, hist_total, 0.95, max_val) / 1000.0;
+    item.p99 = TimesPercentile(hist, hist_total, 0.99, max_val) / 1000.0;
     trace.items.push_back(item);
     }
   if (trace.items.size() == 0)
     return false;
+  // Table order is by hash, list by type / bus / id.
+  trace.items.sort([](const times_trace_elt_t &a, const times_trace_elt_t &b)
+    {
+    return a.desc < b.desc;
+    });
   // uses 100 as base for precision. cvt from 10s to 1s (ie permille)
   trace.tot_n = avg_count_sum  / (average_sep_s * 100.0);
   // Convert to micro-s per 10s to ms per s
@@ -3785,6 +4522,56 @@ bool OvmsPollers::PollerTimesTrace( OvmsWriter* writer)
   return true;
   }
 
+bool OvmsPollers::PollerTimesPercentiles( OvmsWriter* writer)
+  {
+  times_trace_t trace;
+  if (!LoadTimesTrace( Permille, trace))
+    return false;
+  writer->puts(  "Type           |    count |    p50 |    p95 |    p99 |   Peak");
+  writer->puts(  "               |          |   [ms] |   [ms] |   [ms] |   [ms]");
+  writer->puts(  "---------------+----------+--------+--------+--------+--------");
+  for (auto it = trace.items.begin(); it != trace.items.end(); ++it)
+    {
+    writer->printf("%-15s|%10" PRIu32 "|%8.3f|%8.3f|%8.3f|%8.3f\n",
+        it->desc.c_str(), it->count, it->p50, it->p95, it->p99, it->max_val);
+    }
+  if (trace.dropped)
+    writer->printf("(%" PRIu32 " packets not timed: table full)\n", trace.dropped);
+  return true;
+  }
+
+bool OvmsPollers::PollerTimesJson( OvmsWriter* writer)
+  {
+  times_trace_t trace;
+  bool have = LoadTimesTrace( Permille, trace);
+  std::string out;
+  out.reserve(128 + trace.items.size() * 192);
+  out = string_format("{\"started\":%s,\"items\":{",
+      MyConfig.GetParamValueBool("log", "poller.timers", false) ? "true" : "false");
+  bool first = true;
+  for (auto it = trace.items.begin(); it != trace.items.end(); ++it)
+    {
+    if (!first)
+      out += ',';
+    first = false;
+    out += string_format("\"%s\":{\"count\":%" PRIu32 ",\"count_hz\":%.2f"
+        ",\"avg_util_pm\":%.3f,\"peak_util_pm\":%.3f,\"avg_time_ms\":%.3f,\"peak_time_ms\":%.3f"
+        ",\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f}",
+        json_encode(it->desc).c_str(), it->count, it->avg_n,
+        it->avg_utlzn_ms, it->max_time, it->avg_time, it->max_val,
+        it->p50, it->p95, it->p99);
+    }
+  out += '}';
+  if (have)
+    {
+    out += string_format(",\"tot_count_hz\":%.2f,\"tot_util_pm\":%.3f,\"tot_time_ms\":%.3f,\"dropped\":%" PRIu32,
+        trace.tot_n, trace.tot_utlzn_ms, trace.tot_time, trace.dropped);
+    }
+  out += '}';
+  writer->puts(out.c_str());
+  return have;
+  }
+
 static const char *PollResStr( OvmsPoller::OvmsNextPollResult res)
   {
   switch(res)
@@ -3976,6 +4763,24 @@ void OvmsPoller::PollSeriesList::IncomingPacket(const OvmsPoller::poll_job_t& jo
     }
   }
 
+// Current series wants complete responses.
+bool OvmsPoller::PollSeriesList::WantsResponse()
+  {
+  return (m_iter != nullptr) && (m_iter->series != nullptr) && !m_iter_changed
+    && m_iter->series->WantsResponse();
+  }
+
+// Process a complete response.
+void OvmsPoller::PollSeriesList::IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length)
+  {
+  if ((m_iter != nullptr) && (m_iter->series != nullptr) && !m_iter_changed)
+    {
+    IFTRACE(Poller) ESP_LOGD(TAG, "Poll List:[%s] IncomingResponse TYPE:%x PID: %03x LEN: %d", m_iter->name.c_str(), job.type, job.pid, length);
+
+    m_iter->series->IncomingResponse(job, data, length);
+    }
+  }
+
 // Process An Error
 void OvmsPoller::PollSeriesList::IncomingError(const OvmsPoller::poll_job_t& job, int32_t code)
   {
@@ -4206,6 +5011,16 @@ bool OvmsPoller::PollSeriesEntry::Ready() const
   {
   return true;
   }
+
+bool OvmsPoller::PollSeriesEntry::WantsResponse() const
+  {
+  return false;
+  }
+
+void OvmsPoller::PollSeriesEntry::IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length)
+  {
+  // ignore
+  }
 // Standard Poll Series - Replaces the original functionality
 
 // Standard Poll Series class
@@ -4225,6 +5040,8 @@ void OvmsPoller::StandardPollSeries::PollSetPidList(uint8_t defaultbus, const po
   m_poll_plcur = nullptr;
   m_poll_plist = plist;
   m_defaultbus = defaultbus;
+  m_schedule.Invalidate();
+  m_batch.Clear();
   }
 
 void OvmsPoller::StandardPollSeries::ResetList(OvmsPoller::ResetMode mode)
@@ -4254,37 +5071,36 @@ OvmsPoller::OvmsNextPollResult OvmsPoller::StandardPollSeries::NextPollEntry(pol
   if (pollstate >= VEHICLE_POLL_NSTATES)
     return OvmsNextPollResult::StillAtEnd;
 
+  // Previous batched request not answered?
+  if (BatchPending())
+    BatchLost();
+  m_batch.Cancel();
+
   // Restart poll list cursor:
+  int after;
   if (m_poll_plcur == NULL)
-    m_poll_plcur = m_poll_plist;
+    after = -1;
   else if (m_poll_plcur->txmoduleid == 0)
     return OvmsNextPollResult::StillAtEnd;
   else
-    ++m_poll_plcur;
+    after = m_poll_plcur - m_poll_plist;
 
-  while (m_poll_plcur->txmoduleid != 0)
+  // Only visit the entries due for this ticker, see PollSchedule.
+  // Note: poll shifts reset at max_ticker (3600 seconds) cycle reset,
+  //  shifts with interval 0 are quasi single shot (poll once per max_ticker cycle).
+  m_schedule.Prepare(m_poll_plist, mybus, m_defaultbus, pollstate);
+  int next = m_schedule.Next(pollticker, after);
+  if (next < 0)
     {
-    uint8_t bus = m_poll_plcur->pollbus;
-    if (bus == 0)
-      bus = m_defaultbus;
-    if (mybus == bus)
-      {
-      uint16_t polltime = m_poll_plcur->polltime[pollstate];
-      uint8_t pollshift = m_poll_plcur->ts.shift[pollstate];
-      // Note: poll shifts reset at max_ticker (3600 seconds) cycle reset
-      if ( ((polltime > 0) && (pollticker >= pollshift) && (((pollticker - pollshift) % polltime) == 0))
-        // Treat shifts with interval 0 as quasi single shot (poll once per max_ticker cycle):
-        || ((polltime == 0) && (pollshift > 0) && (pollticker == pollshift)) )
-        {
-        entry = *m_poll_plcur;
-        IFTRACE(Poller) ESP_LOGD(TAG, "Found Poll Entry for Standard Poll");
-        return OvmsNextPollResult::FoundEntry;
-        }
-      }
-    // Poll entry is not due, check next
-    ++m_poll_plcur;
+    m_poll_plcur = m_poll_plist + m_schedule.Size();
+    return OvmsNextPollResult::ReachedEnd;
     }
-  return OvmsNextPollResult::ReachedEnd;
+  m_poll_plcur = m_poll_plist + next;
+  entry = *m_poll_plcur;
+  if (m_batch.Max() > 1)
+    CollectBatch(entry, pollticker);
+  IFTRACE(Poller) ESP_LOGD(TAG, "Found Poll Entry for Standard Poll");
+  return OvmsNextPollResult::FoundEntry;
   }
 
 void OvmsPoller::StandardPollSeries::IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length)
@@ -4293,6 +5109,168 @@ void OvmsPoller::StandardPollSeries::IncomingPacket(const OvmsPoller::poll_job_t
 
 void OvmsPoller::StandardPollSeries::IncomingError(const OvmsPoller::poll_job_t& job, int32_t code)
   {
+  BatchError(job, code);
+  }
+
+bool OvmsPoller::StandardPollSeries::WantsResponse() const
+  {
+  return BatchPending();
+  }
+
+void OvmsPoller::StandardPollSeries::IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length)
+  {
+  if (BatchPending())
+    BatchSplit(job, data, length);
+  }
+
+/**
+ * UDS multi-DID batching
+ *
+ *  ReadDataByIdentifier accepts a list of DIDs, the response then is the concatenation of
+ *  the DIDs with their data, without length information. So we learn the data lengths
+ *  from the single responses, and only combine entries with a known length that came as
+ *  a single frame, so the vehicle gets exactly the same IncomingPollReply() calls as
+ *  without batching.
+ *
+ *  ECU support is probed with a two DID request on first use. A negative response, no
+ *  response or a response not matching the expected layout marks the ECU unsupported
+ *  (until the poll list is set again), it then continues with single requests. The DIDs
+ *  of a failed batch are polled again when next due. See PollBatch for the details.
+ */
+void OvmsPoller::StandardPollSeries::SetBatching(uint8_t max_dids)
+  {
+  m_batch.SetMax(max_dids);
+  }
+
+// Entry can be combined with a request for the first entry?
+bool OvmsPoller::StandardPollSeries::BatchCompatible(const poll_pid_t &entry, const poll_pid_t &first)
+  {
+  return entry.type == VEHICLE_POLL_TYPE_READDATA
+    && entry.args.datalen == 0
+    && entry.protocol != VWTP_20
+    && entry.rxmoduleid != 0
+    && entry.txmoduleid == first.txmoduleid
+    && entry.rxmoduleid == first.rxmoduleid
+    && entry.protocol == first.protocol;
+  }
+
+// Extend the entry found by the DIDs due next for the same ECU.
+void OvmsPoller::StandardPollSeries::CollectBatch(poll_pid_t &entry, uint32_t pollticker)
+  {
+  int last = m_batch.Collect(entry, m_poll_plist, m_schedule.Size(), m_poll_plcur - m_poll_plist,
+    [this, pollticker](int index) { return m_schedule.Next(pollticker, index); },
+    BatchCompatible);
+  if (last < 0)
+    return;
+  const PollBatch<poll_pid_t>::ecu_t *ecu = m_batch.Ecu();
+  if (ecu && ecu->support == PollBatch<poll_pid_t>::Probing)
+    {
+    ESP_LOGD(TAG, "Standard Poll Series: probing multi-DID support of %03" PRIx32 "/%03" PRIx32,
+             ecu->txid, ecu->rxid);
+    }
+  m_poll_plcur = m_poll_plist + last;
+  }
+
+// The batched request in flight got no (usable) response.
+void OvmsPoller::StandardPollSeries::BatchLost()
+  {
+  if (m_batch.Lost())
+    {
+    const PollBatch<poll_pid_t>::ecu_t *ecu = m_batch.Ecu();
+    ESP_LOGI(TAG, "Standard Poll Series: %03" PRIx32 "/%03" PRIx32 " does not support multi-DID requests",
+             ecu->txid, ecu->rxid);
+    }
+  }
+
+// Learn the data length from a single DID response (length = first fragment incl. mlremain).
+void OvmsPoller::StandardPollSeries::BatchLearn(const OvmsPoller::poll_job_t& job, uint16_t length)
+  {
+  if (m_batch.Max() < 2 || BatchPending() || !m_poll_plist || !m_poll_plcur)
+    return;
+  int index = m_poll_plcur - m_poll_plist;
+  if (index < 0 || index >= (int)m_schedule.Size())
+    return;
+  const poll_pid_t &entry = m_poll_plist[index];
+  if (entry.type != job.type || entry.pid != job.pid || entry.txmoduleid != job.entry.txmoduleid)
+    return;
+  m_batch.Learn(m_schedule.Size(), index, length, job.mlremain == 0);
+  }
+
+// Negative response to a batched request?
+bool OvmsPoller::StandardPollSeries::BatchError(const OvmsPoller::poll_job_t& job, int32_t code)
+  {
+  if (!BatchPending())
+    return false;
+  ESP_LOGD(TAG, "Standard Poll Series: multi-DID request to %03" PRIx32 " failed, code=%02" PRIx32,
+           job.moduleid_sent, code);
+  if (m_batch.Error())
+    {
+    const PollBatch<poll_pid_t>::ecu_t *ecu = m_batch.Ecu();
+    ESP_LOGI(TAG, "Standard Poll Series: %03" PRIx32 "/%03" PRIx32 " does not support multi-DID requests",
+             ecu->txid, ecu->rxid);
+    }
+  return true;
+  }
+
+// Split a batched response into the DIDs requested.
+//  The whole layout is checked first, on a mismatch nothing is delivered.
+void OvmsPoller::StandardPollSeries::BatchSplit(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length)
+  {
+  const PollBatch<poll_pid_t>::ecu_t *ecu = m_batch.Ecu();
+  bool probing = ecu && ecu->support == PollBatch<poll_pid_t>::Probing;
+  uint8_t count = m_batch.Count();
+  PollBatch<poll_pid_t>::item_t items[PollBatch<poll_pid_t>::dids_max];
+  uint8_t item;
+  uint16_t pos;
+  if (m_batch.Split(m_poll_plist, data, length, items, item, pos) == 0)
+    {
+    ESP_LOGW(TAG, "Standard Poll Series: multi-DID response from %03" PRIx32 " does not match at DID %u/%u (%u/%u bytes)",
+             job.moduleid_rec, item+1, count, pos, length);
+    if (probing)
+      {
+      ESP_LOGI(TAG, "Standard Poll Series: %03" PRIx32 "/%03" PRIx32 " does not support multi-DID requests",
+               ecu->txid, ecu->rxid);
+      }
+    return;
+    }
+  if (probing)
+    {
+    ESP_LOGI(TAG, "Standard Poll Series: %03" PRIx32 "/%03" PRIx32 " supports multi-DID requests",
+             ecu->txid, ecu->rxid);
+    }
+
+  for (uint8_t i = 0; i < count; ++i)
+    {
+    const poll_pid_t &entry = m_poll_plist[items[i].index];
+    uint8_t* itemdata = const_cast<uint8_t*>(data + items[i].offset);
+    OvmsPoller::poll_job_t itemjob = job;
+    itemjob.entry = entry;
+    itemjob.pid = entry.pid;
+    itemjob.mlframe = 0;
+    itemjob.mloffset = 0;
+    itemjob.mlremain = 0;
+    itemjob.raw_data = itemdata;
+    itemjob.raw_data_len = items[i].length;
+    IncomingBatchItem(itemjob, itemdata, items[i].length);
+    }
+  }
+
+void OvmsPoller::StandardPollSeries::IncomingBatchItem(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length)
+  {
+  IncomingPacket(job, data, length);
+  }
+
+void OvmsPoller::StandardPollSeries::BatchStatus(OvmsWriter* writer)
+  {
+  if (m_batch.Max() < 2)
+    return;
+  static const char* support[] = { "unknown", "probing", "supported", "unsupported" };
+  writer->printf("  Multi-DID: max %" PRIu8 " per request\n", m_batch.Max());
+  for (auto &ecu : m_batch.Ecus())
+    {
+    writer->printf("    %03" PRIx32 "/%03" PRIx32 ": %s, %" PRIu32 " requests\n",
+                   ecu.txid, ecu.rxid, support[ecu.support], ecu.requests);
+    }
   }
 
 OvmsPoller::SeriesStatus OvmsPoller::StandardPollSeries::FinishRun()
@@ -4327,13 +5305,48 @@ OvmsPoller::StandardVehiclePollSeries::StandardVehiclePollSeries(OvmsPoller *pol
 // Process an incoming packet.
 void OvmsPoller::StandardVehiclePollSeries::IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length)
  {
+ if (job.mlframe == 0)
+   BatchLearn(job, length + job.mlremain);
  if (m_signal)
    m_signal->IncomingPollReply(job, data, length);
  }
 
+// Vehicle opted in to complete responses? (or batched request in flight)
+bool OvmsPoller::StandardVehiclePollSeries::WantsResponse() const
+  {
+  return BatchPending() || (m_signal && m_signal->WantsPollResponse());
+  }
+
+// Process a complete response.
+void OvmsPoller::StandardVehiclePollSeries::IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length)
+  {
+  if (BatchPending())
+    {
+    BatchSplit(job, data, length);
+    return;
+    }
+  if (job.mlframe == 0)
+    BatchLearn(job, length);
+  if (m_signal)
+    m_signal->IncomingPollResponse(job, data, length);
+  }
+
+// Deliver a DID of a batched response.
+void OvmsPoller::StandardVehiclePollSeries::IncomingBatchItem(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length)
+  {
+  if (!m_signal)
+    return;
+  if (m_signal->WantsPollResponse())
+    m_signal->IncomingPollResponse(job, data, length);
+  else
+    m_signal->IncomingPollReply(job, data, length);
+  }
+
 // Process An Error.
 void OvmsPoller::StandardVehiclePollSeries::IncomingError(const OvmsPoller::poll_job_t& job, int32_t code)
  {
+ if (BatchError(job, code))
+   return;
  if (m_signal)
    m_signal->IncomingPollError(job, code);
  }
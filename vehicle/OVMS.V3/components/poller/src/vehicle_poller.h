@@ -26,6 +26,8 @@
 
 #include "vehicle_common.h"
 #include "ovms_utils.h"
+#include "vehicle_poller_schedule.h"
+#include "vehicle_poller_batch.h"
 
 #include <cstdint>
 #include <memory>
@@ -36,6 +38,9 @@
 #define POLLSINGLE_TXFAILURE            -2
 #define POLLSINGLE_NORESPONSE           -3
 
+// Poll error code passed to IncomingPollError() in addition to the OBD/UDS NRCs:
+#define POLL_ERR_INCOMPLETE             -4    // Complete response lost (missing frame / too long)
+
 #define VEHICLE_POLL_TYPE_NONE          0x00
 
 // Number of polling states supported
@@ -217,6 +222,10 @@ class OvmsPoller : public InternalRamAllocated {
         virtual void IncomingPollError(const OvmsPoller::poll_job_t &job, int32_t code);
         virtual void IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success);
         virtual bool Ready() const = 0;
+        // Complete response delivery (opt-in, replaces IncomingPollReply)
+        //  Responses that can't be completed are reported as POLL_ERR_INCOMPLETE.
+        virtual bool WantsPollResponse() const { return false; }
+        virtual void IncomingPollResponse(const OvmsPoller::poll_job_t &job, const uint8_t* data, uint16_t length) { }
       };
     enum class OvmsNextPollResult
       {
@@ -264,6 +273,15 @@ class OvmsPoller : public InternalRamAllocated {
         /// Process An Error
         virtual void IncomingError(const OvmsPoller::poll_job_t& job, int32_t code) = 0;
 
+        /** Return true to receive complete (reassembled) responses via IncomingResponse()
+          * instead of the fragments via IncomingPacket().
+          */
+        virtual bool WantsResponse() const;
+        /** Process a complete response.
+          * @arg data Response payload, only valid for the duration of the call.
+          */
+        virtual void IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length);
+
         /// Send on an imcoming TX reply
         virtual void IncomingTxReply(const OvmsPoller::poll_job_t& job, bool success);
 
@@ -347,6 +365,11 @@ class OvmsPoller : public InternalRamAllocated {
         /// Process an incoming packet.
         void IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length);
 
+        /// Current series wants complete responses.
+        bool WantsResponse();
+        /// Process a complete response.
+        void IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length);
+
         /// Process An Error
         void IncomingError(const OvmsPoller::poll_job_t& job, int32_t code);
 
@@ -394,6 +417,19 @@ class OvmsPoller : public InternalRamAllocated {
 
         const poll_pid_t* m_poll_plist; // Head of poll list
         const poll_pid_t* m_poll_plcur; // Poll list loop cursor
+        PollSchedule<poll_pid_t> m_schedule; // Due entries per ticker for bus & state
+
+        PollBatch<poll_pid_t> m_batch;       // UDS multi-DID batching (see SetBatching)
+
+        static bool BatchCompatible(const poll_pid_t &entry, const poll_pid_t &first);
+        void CollectBatch(poll_pid_t &entry, uint32_t pollticker);
+        void BatchLost();
+        void BatchLearn(const OvmsPoller::poll_job_t& job, uint16_t length);
+        bool BatchPending() const { return m_batch.Pending(); }
+        bool BatchError(const OvmsPoller::poll_job_t& job, int32_t code);
+        void BatchSplit(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length);
+        /// Deliver a DID of a batched response (single frame semantics).
+        virtual void IncomingBatchItem(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length);
 
       public:
         StandardPollSeries(OvmsPoller *poller, uint16_t stateoffset = 0);
@@ -403,6 +439,12 @@ class OvmsPoller : public InternalRamAllocated {
         /// Set the PID list and default bus.
         void PollSetPidList(uint8_t defaultbus, const poll_pid_t* plist);
 
+        /** Combine due ReadDataByIdentifier entries for the same ECU into one request.
+          * @arg max_dids DIDs per request (2…4), 0 = off
+          */
+        void SetBatching(uint8_t max_dids);
+        void BatchStatus(OvmsWriter* writer);
+
         // Move list to start.
         void ResetList(ResetMode mode) override;
 
@@ -415,6 +457,10 @@ class OvmsPoller : public InternalRamAllocated {
         // Process An Error. (pass through to m_poller)
         void IncomingError(const OvmsPoller::poll_job_t& job, int32_t code) override;
 
+        // Batched responses are split into the DIDs.
+        bool WantsResponse() const override;
+        void IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length) override;
+
         // Called when run is finished to determine what happens next.
         SeriesStatus FinishRun() override;
 
@@ -436,6 +482,10 @@ class OvmsPoller : public InternalRamAllocated {
         // Process an incoming packet.
         void IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length) override;
 
+        // Complete responses if the vehicle wants them.
+        bool WantsResponse() const override;
+        void IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length) override;
+
         // Process An Error
         void IncomingError(const OvmsPoller::poll_job_t& job, int32_t code) override;
 
@@ -444,6 +494,9 @@ class OvmsPoller : public InternalRamAllocated {
 
         // Return true if this series is ok to run.
         bool Ready() const override;
+
+      protected:
+        void IncomingBatchItem(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length) override;
       };
 
     typedef std::function<void(uint16_t type, uint32_t module_sent, uint32_t module_rec, uint16_t pid, CAN_frame_format_t format, const std::string &data)> poll_success_func;
@@ -662,12 +715,71 @@ class OvmsPoller : public InternalRamAllocated {
     uint8_t           m_poll_fc_septime;      // Flow control separation time for multi frame responses
     uint16_t          m_poll_ch_keepalive;    // Seconds to keep an inactive channel (e.g. VWTP) alive (default: 60)
     uint16_t          m_poll_between_success;
+    uint8_t           m_poll_batch_max;       // UDS multi-DID batching for the vehicle poll list, 0 = off
     bool              m_poll_ticked;
     bool              m_poll_run_finished;
 
   private:
     mutable OvmsRecMutex m_poll_single_mutex;    // PollSingleRequest() concurrency protection
 
+    // Response reassembly for series wanting complete responses (see IncomingPollData)
+    uint8_t*          m_resp_buf;             // Pooled buffer, grows up to the largest response seen
+    uint16_t          m_resp_size;            // Buffer capacity
+    uint16_t          m_resp_len;             // Bytes collected for the current response
+    bool              m_resp_valid;           // True while a response is collected
+    void IncomingPollData(uint8_t* data, uint8_t length);
+    void DropPollResponse(const char* reason);
+
+    // Per bus pipeline (see OvmsPollers::SetParallel)
+    QueueHandle_t     m_pipe_queue;           // Entries for this bus while pipelined
+    TaskHandle_t      m_pipe_task;            // Set while the pipeline task runs
+    SemaphoreHandle_t m_pipe_done;            // Given by the pipeline task on exit
+    static void OvmsPollerPipelineTask(void *pvParameters);
+    void PipelineTask();
+    bool StartPipeline();
+    void StopPipeline();
+
+    // Poll round timing
+    uint64_t          m_round_start;          // First poll of the current round [us], 0 = none
+    uint32_t          m_round_count;          // Rounds completed since reset
+    uint32_t          m_round_last_ms;
+    uint32_t          m_round_min_ms;
+    uint32_t          m_round_max_ms;
+    uint64_t          m_round_sum_ms;
+    void RoundStarted();
+    void RoundFinished();
+
+    // Simulated ECU for "poller bench", answers ISO-TP requests instead of the bus
+    typedef struct
+      {
+      TimerHandle_t timer;
+      OvmsMutex mutex;
+      uint16_t delay_ms;                      // Response delay
+      uint16_t length;                        // Response payload length (after service & PID)
+      uint32_t rxid;                          // Response CAN ID
+      uint8_t  service;                       // Positive response service
+      uint16_t pid;
+      uint8_t  pidlen;                        // 0…2
+      uint16_t total;                         // Response length incl. service & PID
+      uint16_t offset;                        // Response bytes sent
+      uint8_t  septime;                       // Consecutive frame separation [ms]
+      uint8_t  seqno;                         // Next consecutive frame number
+      bool     awaiting_fc;                   // First frame sent, waiting for flow control
+      uint32_t responses;
+      } poll_sim_t;
+    poll_sim_t*       m_sim;
+    OvmsMutex         m_sim_mutex;            // Keeps m_sim alive while in use (see SimStop)
+    static void SimTimer(TimerHandle_t timer);
+    void SimSendNext();
+    void PollerTransmit(CAN_frame_t &frame);
+
+  public:
+    void SimStart(uint16_t delay_ms, uint16_t length);
+    void SimStop();
+    bool HasSim() const { return m_sim != nullptr; }
+    void RoundStatsReset();
+    void RoundStatus(OvmsWriter* writer, bool header = false);
+
   protected:
     vwtp_channel_t    m_poll_vwtp;            // VWTP channel state
 
@@ -676,10 +788,7 @@ class OvmsPoller : public InternalRamAllocated {
     // Signals for vehicle
     void PollRunFinished();
 
-    void IncomingPollError(const OvmsPoller::poll_job_t &job, int32_t code)
-      {
-      m_polls.IncomingError(job, code);
-      }
+    void IncomingPollError(const OvmsPoller::poll_job_t &job, int32_t code);
     void IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success);
 
     bool Ready() const;
@@ -736,7 +845,8 @@ class OvmsPoller : public InternalRamAllocated {
       Keepalive,
       SuccessSep,
       Shutdown,
-      ResetTimer
+      ResetTimer,
+      Batching
       };
     typedef struct {
         CAN_frame_t frame;
@@ -790,6 +900,7 @@ class OvmsPoller : public InternalRamAllocated {
     void PollSetResponseSeparationTime(uint8_t septime);
     void PollSetChannelKeepalive(uint16_t keepalive_seconds);
     void PollSetTimeBetweenSuccess(uint16_t time_between_ms);
+    void PollSetBatching(uint8_t max_dids);
 
     // TODO - Work out how to make sure these are protected. Reduce/eliminate mutex time.
     void PollSetPidList(uint8_t defaultbus, const poll_pid_t* plist, VehicleSignal *signal);
@@ -834,6 +945,7 @@ class OvmsPollers : public InternalRamAllocated {
     uint8_t           m_poll_fc_septime;      // Flow control separation time for multi frame responses
     uint16_t          m_poll_ch_keepalive;    // Seconds to keep an inactive channel (e.g. VWTP) alive (default: 60)
     uint16_t          m_poll_between_success;
+    uint8_t           m_poll_batch_max;
     uint32_t          m_poll_last;
 
     _Alignas(32 / CHAR_BIT)
@@ -858,6 +970,55 @@ class OvmsPollers : public InternalRamAllocated {
     canfilter         m_filter;
     bool              m_filtered;
 
+    // Per bus pipelines
+    bool              m_parallel;             // Route bus entries to the bus pipelines
+    uint8_t           m_pipelines;            // Pipeline tasks started (never decreases)
+    OvmsRecMutex      m_signal_mutex;         // Serialises calls into vehicle code between pipelines
+    OvmsMutex         m_times_mutex;          // Serialises timing writers between pipelines
+
+    // Global poll budget shared by all busses per second (fair share per bus)
+    OvmsMutex         m_budget_mutex;
+    uint16_t          m_budget_max;           // 0 = unlimited
+    uint16_t          m_budget_total;
+    uint16_t          m_budget_used[VEHICLE_MAXBUSSES];
+
+    bool CanPollBudget(uint8_t busno);
+    void MarkPollBudget(uint8_t busno);
+    void ResetPollBudget();
+
+    void LoadPollerParallelConfig();
+    void SetParallel(bool parallel);
+    void ProcessFrameRx(OvmsPoller::poll_queue_entry_t &entry);
+    void ProcessFrameTx(OvmsPoller::poll_queue_entry_t &entry);
+    void ProcessPoll(OvmsPoller::poll_queue_entry_t &entry);
+    void ProcessPollState(OvmsPoller::poll_queue_entry_t &entry);
+    void TimeEntry(OvmsPoller::poll_queue_entry_t &entry, std::unique_ptr<timer_util_t> &timer);
+    QueueHandle_t PipelineQueue(uint8_t busno) const;
+    bool ForwardPipeline(OvmsPoller *poller, OvmsPoller::poll_queue_entry_t &entry);
+
+  public:
+    // Serialises calls into vehicle & script code while the bus pipelines run in parallel.
+    class SignalLock
+      {
+      private:
+        OvmsRecMutex *m_mutex;
+      public:
+        SignalLock(OvmsPollers *pollers)
+          : m_mutex(pollers->m_pipelines ? &pollers->m_signal_mutex : nullptr)
+          {
+          if (m_mutex)
+            m_mutex->Lock();
+          }
+        ~SignalLock()
+          {
+          if (m_mutex)
+            m_mutex->Unlock();
+          }
+      };
+    bool IsPollerTask() const;
+    bool IsParallel() const { return m_parallel; }
+  private:
+
     void PollerTxCallback(const CAN_frame_t* frame, bool success);
     void PollerRxCallback(const CAN_frame_t* frame, bool success);
 
@@ -872,6 +1033,11 @@ class OvmsPollers : public InternalRamAllocated {
     static void vehicle_pause_off(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void vehicle_poller_trace(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void poller_times(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_bench_start(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_bench_stop(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_bench_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    void BenchStop();
+    uint8_t           m_bench_busses;         // Bit mask of busses running the bench
 
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
     // OvmsPoller Object
@@ -932,10 +1098,13 @@ class OvmsPollers : public InternalRamAllocated {
     typedef struct {
       std::string desc;
       float avg_n, avg_utlzn_ms, max_time, avg_time, max_val;
+      uint32_t count;
+      float p50, p95, p99;
     } times_trace_elt_t;
     typedef struct {
       std::list<times_trace_elt_t> items;
       float tot_n, tot_utlzn_ms, tot_time;
+      uint32_t dropped;
     } times_trace_t;
 
     void PollerTimesReset();
@@ -944,6 +1113,8 @@ class OvmsPollers : public InternalRamAllocated {
     bool LoadTimesTrace( metric_unit_t ratio_unit, times_trace_t &trace);
   public:
     bool PollerTimesTrace( OvmsWriter* writer);
+    bool PollerTimesPercentiles( OvmsWriter* writer);
+    bool PollerTimesJson( OvmsWriter* writer);
     bool IsTracingTimes() const { return (m_trace & trace_Times) != 0; }
     typedef std::function<void(canbus*, void *)> PollCallback;
     typedef std::function<void(const CAN_frame_t &)> FrameCallback;
@@ -966,8 +1137,14 @@ class OvmsPollers : public InternalRamAllocated {
         OvmsPoller::OvmsPollCommand Command_cmd;
       };
       uint8_t busnumber;
+      poller_key_st()
+        : entry_type(OvmsPoller::OvmsPollEntryType::Poll), Frame_MsgId(0), busnumber(0)
+        {
+        }
       // Constructor to convert from the queue entry to the key.
       poller_key_st( const OvmsPoller::poll_queue_entry_t &entry);
+      bool operator==(const poller_key_st &rhs) const;
+      uint32_t hash() const;
     } poller_key_t;
     static const uint32_t average_sep_s = 10;
     static const uint32_t average_sep_mic_s = average_sep_s * 1000000;//10s
@@ -999,12 +1176,33 @@ class OvmsPollers : public InternalRamAllocated {
       void catchup(uint64_t time_added);
     } average_value_t;
 
-    struct poller_key_less_t {
-      bool operator()(const poller_key_t &lhs, const poller_key_t &rhs) const;
-    };
-    // Store for timing for different packet types.
-    std::map<poller_key_t, average_value_t, poller_key_less_t> m_poll_time_stats;
-    OvmsMutex m_stats_mutex;
+    // Latency histogram: bucket 0 is < 2us, bucket n is [2^n, 2^(n+1)) us,
+    // the last bucket also collects everything above.
+    static const uint8_t times_hist_buckets = 20;
+    // Number of distinct keys that can be timed (power of 2).
+    static const uint16_t times_table_size = 128;
+
+    // Timing for one packet type. Only the poller task writes to the table,
+    // readers use the sequence count to get a consistent copy of 'avg'.
+    typedef struct poller_times_entry_st {
+      volatile bool used;               // Set after key; entries are never removed
+      poller_key_t key;
+      volatile uint32_t seq;            // Odd while 'avg' is being updated
+      average_value_t avg;
+      volatile uint32_t count;          // Packets since reset
+      volatile uint32_t hist[times_hist_buckets];
+    } poller_times_entry_t;
+
+    // Store for timing for different packet types (open addressed, linear probing).
+    poller_times_entry_t* volatile m_poll_time_stats;
+    volatile uint32_t m_poll_time_dropped;   // Packets not timed: table full
+
+    poller_times_entry_t *FindTimesEntry(const poller_key_t &key, bool create);
+    void AddTimesEntry(const poller_key_t &key, uint32_t time_spent, uint64_t time_added);
+    void ResetTimesEntries(bool paused_only);
+    void CatchupTimesEntries(uint64_t time_added);
+    static bool CopyTimesEntry(const poller_times_entry_t &entry, average_value_t &avg);
+    static float TimesPercentile(const uint32_t *hist, uint32_t total, float fraction, uint32_t max_val);
 
   public:
     void RegisterRunFinished(const std::string &name, PollCallback fn) { m_runfinished_callback.Register(name, fn);}
@@ -1020,6 +1218,7 @@ class OvmsPollers : public InternalRamAllocated {
   private:
     void PollRunFinished(canbus *bus)
       {
+      SignalLock lock(this);
       m_runfinished_callback.Call(
         [bus](const std::string &name, const PollCallback &cb)
           {
@@ -1028,6 +1227,7 @@ class OvmsPollers : public InternalRamAllocated {
       }
     void PollerStateTicker(canbus *bus)
       {
+      SignalLock lock(this);
       m_pollstateticker_callback.Call(
         [bus](const std::string &name, const PollCallback &cb)
           {
@@ -1036,6 +1236,7 @@ class OvmsPollers : public InternalRamAllocated {
       }
     void PollerFrameRx(CAN_frame_t &frame)
       {
+      SignalLock lock(this);
       m_framerx_callback.Call(
         [frame](const std::string &name, FrameCallback cb)
           {
@@ -1097,6 +1298,10 @@ class OvmsPollers : public InternalRamAllocated {
       {
       Queue_Command(OvmsPoller::OvmsPollCommand::SuccessSep, time_between_ms);
       }
+    void PollSetBatching(uint8_t max_dids)
+      {
+      Queue_Command(OvmsPoller::OvmsPollCommand::Batching, max_dids);
+      }
     // signal poller
     void PollerResetThrottle();
 
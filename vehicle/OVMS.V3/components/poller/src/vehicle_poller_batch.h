@@ -0,0 +1,302 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+#ifndef __VEHICLE_POLLER_BATCH_H__
+#define __VEHICLE_POLLER_BATCH_H__
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * UDS multi-DID batching state of a poll list (poll_pid_t array).
+ *
+ * ReadDataByIdentifier accepts a list of DIDs, the response then is the concatenation
+ * of the DIDs with their data, without length information. So the data lengths are
+ * learned from the single responses, and only entries with a known length that came
+ * as a single frame are combined.
+ *
+ * ECU support is probed with a two DID request on first use. A negative response, no
+ * response or a response not matching the expected layout marks the ECU unsupported
+ * (until the list is cleared). A supported ECU stays supported on a layout mismatch
+ * (e.g. a DID changed its length), the lengths of the DIDs involved are relearned.
+ *
+ * A response is checked completely before any DID is delivered, so a mismatch never
+ * passes misframed data on.
+ *
+ * Templated on the poll entry type, so it can be tested on the host. The caller
+ * does the logging & delivery (see StandardPollSeries).
+ */
+template <typename PID> class PollBatch
+  {
+  public:
+    typedef enum : uint8_t { Unknown, Probing, Supported, Unsupported } support_t;
+    typedef struct
+      {
+      uint32_t txid;
+      uint32_t rxid;
+      support_t support;
+      uint32_t requests;                        // Batched requests answered
+      } ecu_t;
+    typedef struct
+      {
+      uint16_t index;                           // List index
+      uint16_t offset;                          // Data offset in the response
+      uint16_t length;                          // Data length
+      } item_t;
+
+    static const uint8_t dids_max = 4;          // First DID as pid + 3 in args.data
+    static const uint16_t len_single = 0xffff;  // Learned: not a single frame response
+
+  public:
+    PollBatch()
+      : m_max(0), m_count(0), m_ecu(0)
+      {
+      }
+
+    /// Set the max DIDs per request, < 2 = off.
+    void SetMax(uint8_t max)
+      {
+      m_max = (max > dids_max) ? dids_max : max;
+      if (m_max < 2)
+        m_count = 0;
+      }
+    uint8_t Max() const { return m_max; }
+
+    /// Forget lengths, ECU support & the request in flight (new list).
+    void Clear()
+      {
+      m_len.clear();
+      m_ecus.clear();
+      m_count = 0;
+      }
+
+    /// Batched request in flight?
+    bool Pending() const { return m_count > 1; }
+    uint8_t Count() const { return m_count; }
+    void Cancel() { m_count = 0; }
+
+    const std::vector<ecu_t>& Ecus() const { return m_ecus; }
+
+    /// ECU of the request in flight (or last sent).
+    const ecu_t* Ecu() const
+      {
+      return (m_ecu < m_ecus.size()) ? &m_ecus[m_ecu] : nullptr;
+      }
+
+    /// Learned length of a list entry, 0 = unknown.
+    uint16_t Length(int index) const
+      {
+      return (index >= 0 && index < (int)m_len.size()) ? m_len[index] : 0;
+      }
+
+    /**
+     * Learn: record the data length of a single DID response.
+     *  single = the response came in a single frame.
+     */
+    void Learn(uint16_t size, int index, uint16_t length, bool single)
+      {
+      if (m_max < 2 || Pending())
+        return;
+      if (m_len.size() != size)
+        m_len.assign(size, 0);
+      if (index < 0 || index >= (int)m_len.size())
+        return;
+      m_len[index] = (single && length < len_single) ? length : len_single;
+      }
+
+    /**
+     * Collect: extend the request for list entry 'first' (copied to 'entry') by the
+     *  DIDs due next for the same ECU.
+     *  next(index) returns the list index due after index (-1 = none),
+     *  compatible(entry, first) checks the entry can join a request of first.
+     * @return list index of the last DID added, -1 if not batched.
+     */
+    template <typename NEXT, typename COMPAT>
+    int Collect(PID &entry, const PID* plist, uint16_t size, int first, NEXT next, COMPAT compatible)
+      {
+      m_count = 0;
+      if (m_max < 2)
+        return -1;
+      if (m_len.size() != size)
+        m_len.assign(size, 0);
+      if (!Batchable(plist, first, entry, compatible))
+        return -1;
+      ecu_t *ecu = GetEcu(entry);
+      uint8_t max;
+      switch (ecu->support)
+        {
+        case Supported:
+          max = m_max;
+          break;
+        case Unknown:
+          max = 2;
+          break;
+        default:
+          return -1;
+        }
+      uint8_t count = 0;
+      int cur = first;
+      m_index[count++] = cur;
+      while (count < max)
+        {
+        int nxt = next(cur);
+        if (!Batchable(plist, nxt, entry, compatible))
+          break;
+        cur = nxt;
+        m_index[count++] = cur;
+        }
+      if (count < 2)
+        return -1;
+
+      for (uint8_t i = 1; i < count; ++i)
+        {
+        uint16_t did = plist[m_index[i]].pid;
+        entry.args.data[2*(i-1)] = did >> 8;
+        entry.args.data[2*(i-1)+1] = did & 0xff;
+        }
+      entry.args.datalen = 2 * (count-1);
+      if (ecu->support == Unknown)
+        ecu->support = Probing;
+      m_ecu = ecu - m_ecus.data();
+      m_count = count;
+      return cur;
+      }
+
+    /**
+     * Lost: the request in flight got no (usable) response.
+     * @return true if the ECU has been marked unsupported by this.
+     */
+    bool Lost()
+      {
+      bool marked = false;
+      if (Pending() && m_ecu < m_ecus.size())
+        {
+        ecu_t &ecu = m_ecus[m_ecu];
+        if (ecu.support != Unsupported && (ecu.support != Supported || ecu.requests == 0))
+          {
+          ecu.support = Unsupported;
+          marked = true;
+          }
+        }
+      m_count = 0;
+      return marked;
+      }
+
+    /**
+     * Error: negative response to the request in flight, the ECU is marked
+     *  unsupported.
+     * @return true if the ECU has been marked unsupported by this.
+     */
+    bool Error()
+      {
+      if (Pending() && m_ecu < m_ecus.size())
+        m_ecus[m_ecu].requests = 0;
+      return Lost();
+      }
+
+    /**
+     * Split: check a response to the request in flight against the learned layout.
+     *  data starts after the first DID (the PID of the request).
+     *  On success, items[] is filled with the layout of all DIDs requested, on a
+     *  mismatch the lengths of the DIDs requested are relearned, a probed ECU is
+     *  marked unsupported.
+     * @return number of items, 0 on a mismatch ('item' then is the DID index
+     *  & 'pos' the offset where the layout failed).
+     */
+    uint8_t Split(const PID* plist, const uint8_t* data, uint16_t length,
+                  item_t* items, uint8_t &item, uint16_t &pos)
+      {
+      uint8_t count = m_count;
+      uint16_t p = 0;
+      uint8_t i;
+      for (i = 0; i < count; ++i)
+        {
+        uint16_t index = m_index[i];
+        if (i > 0)
+          {
+          if (p + 2 > length || (data[p] << 8 | data[p+1]) != plist[index].pid)
+            break;
+          p += 2;
+          }
+        uint16_t len = Length(index);
+        if (len == 0 || len == len_single || p + len > length)
+          break;
+        items[i] = item_t{index, p, len};
+        p += len;
+        }
+      item = i;
+      pos = p;
+
+      if (i == count && p == length)
+        {
+        m_count = 0;
+        if (m_ecu < m_ecus.size())
+          {
+          ecu_t &ecu = m_ecus[m_ecu];
+          if (ecu.support == Probing)
+            ecu.support = Supported;
+          ++ecu.requests;
+          }
+        return count;
+        }
+
+      for (i = 0; i < count; ++i)
+        {
+        if (m_index[i] < m_len.size())
+          m_len[m_index[i]] = 0;
+        }
+      if (m_ecu < m_ecus.size() && m_ecus[m_ecu].support == Probing)
+        Lost();
+      m_count = 0;
+      return 0;
+      }
+
+  private:
+    template <typename COMPAT>
+    bool Batchable(const PID* plist, int index, const PID &first, COMPAT compatible) const
+      {
+      uint16_t len = Length(index);
+      if (len == 0 || len == len_single)
+        return false;
+      return compatible(plist[index], first);
+      }
+
+    ecu_t* GetEcu(const PID &entry)
+      {
+      for (auto &ecu : m_ecus)
+        {
+        if (ecu.txid == entry.txmoduleid && ecu.rxid == entry.rxmoduleid)
+          return &ecu;
+        }
+      m_ecus.push_back(ecu_t{entry.txmoduleid, entry.rxmoduleid, Unknown, 0});
+      return &m_ecus.back();
+      }
+
+    uint8_t               m_max;                // Max DIDs per request, < 2 = off
+    std::vector<uint16_t> m_len;                // Learned DID data length by list index, 0 = unknown
+    std::vector<ecu_t>    m_ecus;
+    uint16_t              m_index[dids_max];    // List indices of the request in flight
+    uint8_t               m_count;              // DIDs in flight, > 1 = batched request
+    uint8_t               m_ecu;                // m_ecus index of the request in flight
+  };
+
+#endif // __VEHICLE_POLLER_BATCH_H__
@@ -167,7 +167,7 @@ void OvmsPoller::PollerISOTPStart(bool fromTicker)
   m_poll.mlremain = 0;
   SetPollWaiting(1000);
 
-  m_poll.bus->Write(&txframe);
+  PollerTransmit(txframe);
   }
 
 
@@ -340,7 +340,7 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
         memcpy(&tx_data[1], m_poll_tx_data+m_poll_tx_offset, tx_datasent);
         if (tx_datasent < tx_datalen)
           memset(&tx_data[1+tx_datasent], 0x55, tx_datalen-tx_datasent);
-        tx_frame.Write();
+        PollerTransmit(tx_frame);
         m_poll_tx_offset += tx_datasent;
         m_poll_tx_remain -= tx_datasent;
 
@@ -378,6 +378,11 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
               msgid, tp_frameindex, m_poll.mlframe & 0x0f, m_poll.type, m_poll.pid,
               hexdump ? hexdump : "-");
       if (hexdump) free(hexdump);
+        {
+        OvmsPollers::SignalLock signal(m_parent);
+        OvmsRecMutexLock lock(&m_poll_mutex);
+        DropPollResponse(NULL);
+        }
       m_poll.moduleid_low = m_poll.moduleid_high = 0; // ignore further frames
       SetPollWaiting(1000); // give the bus time to let remaining frames pass
       return true;
@@ -455,6 +460,7 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
                m_poll.bus_no, msgid, m_poll.type, m_poll.pid, error_code);
       // Running single poll?
       {
+      OvmsPollers::SignalLock signal(m_parent);
       OvmsRecMutexLock lock(&m_poll_mutex);
       m_poll.moduleid_rec = msgid;
       m_poll.mlframe = 0;
@@ -475,9 +481,10 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
              m_poll.mlframe, response_datalen, m_poll.mloffset, m_poll.mlremain);
 
       {
+      OvmsPollers::SignalLock signal(m_parent);
       OvmsRecMutexLock lock(&m_poll_mutex);
       m_poll.moduleid_rec = msgid;
-      m_polls.IncomingPacket(m_poll, response_data, response_datalen);
+      IncomingPollData(response_data, response_datalen);
       }
     }
   else
@@ -536,7 +543,7 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
       txdata[0] = 0x30;                // flow control frame type
       txdata[1] = 0x00;                // request all frames available
       txdata[2] = m_poll_fc_septime;   // with configured separation timing (default 25 ms)
-      txframe.Write();
+      PollerTransmit(txframe);
       m_poll.mlframe = 1;
       }
     else
@@ -0,0 +1,188 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          9th April 2023
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+#ifndef __VEHICLE_POLLER_SCHEDULE_H__
+#define __VEHICLE_POLLER_SCHEDULE_H__
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Precomputed schedule of a poll list (poll_pid_t array) for one bus & poll state.
+ *
+ * The entries are grouped by their timing class (cycle & shift of the state), so a
+ * ticker only needs to check the classes instead of every entry. Each class has a
+ * bitmap of its entries by list index, the bitmaps of the classes due are combined
+ * once per ticker, and the result is walked in list order.
+ *
+ * Timing semantics are those of the list walk in StandardPollSeries:
+ *  - cycle > 0: due if ticker >= shift and (ticker - shift) is a multiple of cycle
+ *  - cycle = 0, shift > 0: due once per max_ticker cycle, at ticker == shift
+ *  - cycle = 0, shift = 0: never due
+ *
+ * Templated on the poll entry type, so it can be tested on the host.
+ */
+template <typename PID> class PollSchedule
+  {
+  public:
+    PollSchedule()
+      : m_plist(nullptr), m_mybus(0), m_defaultbus(0), m_state(0), m_count(0), m_words(0),
+        m_built(false), m_due_valid(false), m_due_ticker(0)
+      {
+      }
+
+    /// Force a rebuild on next use (list contents may have changed).
+    void Invalidate()
+      {
+      m_built = false;
+      m_due_valid = false;
+      }
+
+    /// Build for list, bus & state unless already done.
+    void Prepare(const PID* plist, uint8_t mybus, uint8_t defaultbus, uint8_t state)
+      {
+      if (m_built && plist == m_plist && mybus == m_mybus && defaultbus == m_defaultbus && state == m_state)
+        return;
+      Build(plist, mybus, defaultbus, state);
+      }
+
+    /// Number of list entries (= index of the list terminator).
+    uint16_t Size() const { return m_count; }
+
+    /// Number of timing classes for the current bus & state.
+    size_t Classes() const { return m_classes.size(); }
+
+    /**
+     * Next: find the next entry due at ticker after list index 'after' (-1 = from start).
+     * @return list index or -1 if none is due.
+     */
+    int Next(uint32_t ticker, int after)
+      {
+      if (!m_due_valid || ticker != m_due_ticker)
+        CollectDue(ticker);
+      int index = after + 1;
+      if (index < 0)
+        index = 0;
+      size_t word = index >> 5;
+      if (word >= m_due.size())
+        return -1;
+      uint32_t bits = m_due[word] & (~0u << (index & 31));
+      while (!bits)
+        {
+        if (++word >= m_due.size())
+          return -1;
+        bits = m_due[word];
+        }
+      return (word << 5) + __builtin_ctz(bits);
+      }
+
+    static bool IsDue(uint32_t ticker, uint16_t cycle, uint8_t shift)
+      {
+      if (cycle > 0)
+        return (ticker >= shift) && (((ticker - shift) % cycle) == 0);
+      return (shift > 0) && (ticker == shift);
+      }
+
+  private:
+    typedef struct
+      {
+      uint16_t cycle;
+      uint8_t shift;
+      } timing_class_t;
+
+    void Build(const PID* plist, uint8_t mybus, uint8_t defaultbus, uint8_t state)
+      {
+      m_plist = plist;
+      m_mybus = mybus;
+      m_defaultbus = defaultbus;
+      m_state = state;
+      m_classes.clear();
+      m_class_bits.clear();
+      m_due.clear();
+      m_due_valid = false;
+      m_count = 0;
+      m_built = true;
+      if (!plist)
+        return;
+      for (const PID* cur = plist; cur->txmoduleid != 0; ++cur)
+        ++m_count;
+      m_words = (m_count + 31) >> 5;
+      m_due.assign(m_words, 0);
+      uint16_t index = 0;
+      for (const PID* cur = plist; cur->txmoduleid != 0; ++cur, ++index)
+        {
+        uint8_t bus = cur->pollbus;
+        if (bus == 0)
+          bus = defaultbus;
+        if (bus != mybus)
+          continue;
+        uint16_t cycle = cur->polltime[state];
+        uint8_t shift = cur->ts.shift[state];
+        if (cycle == 0 && shift == 0)
+          continue;
+        size_t cls = 0;
+        while (cls < m_classes.size() && (m_classes[cls].cycle != cycle || m_classes[cls].shift != shift))
+          ++cls;
+        if (cls == m_classes.size())
+          {
+          m_classes.push_back(timing_class_t{cycle, shift});
+          m_class_bits.resize(m_class_bits.size() + m_words, 0);
+          }
+        m_class_bits[cls * m_words + (index >> 5)] |= 1u << (index & 31);
+        }
+      m_classes.shrink_to_fit();
+      m_class_bits.shrink_to_fit();
+      }
+
+    void CollectDue(uint32_t ticker)
+      {
+      std::fill(m_due.begin(), m_due.end(), 0);
+      const uint32_t *bits = m_class_bits.data();
+      for (const auto &cls : m_classes)
+        {
+        if (IsDue(ticker, cls.cycle, cls.shift))
+          {
+          for (uint16_t word = 0; word < m_words; ++word)
+            m_due[word] |= bits[word];
+          }
+        bits += m_words;
+        }
+      m_due_ticker = ticker;
+      m_due_valid = true;
+      }
+
+    const PID*                  m_plist;
+    uint8_t                     m_mybus;
+    uint8_t                     m_defaultbus;
+    uint8_t                     m_state;
+    uint16_t                    m_count;
+    uint16_t                    m_words;          // Bitmap size
+    bool                        m_built;
+    bool                        m_due_valid;
+    uint32_t                    m_due_ticker;
+    std::vector<timing_class_t> m_classes;
+    std::vector<uint32_t>       m_class_bits;     // Entry bitmaps of the classes
+    std::vector<uint32_t>       m_due;            // Due entries bitmap by list index
+  };
+
+#endif // __VEHICLE_POLLER_SCHEDULE_H__
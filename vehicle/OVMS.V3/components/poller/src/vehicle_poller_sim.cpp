@@ -0,0 +1,437 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          14th March 2017
+;
+;    Changes:
+;    1.0  Initial release
+;
+;    (C) 2011       Michael Stegen / Stegen Electronics
+;    (C) 2011-2017  Mark Webb-Johnson
+;    (C) 2011        Sonny Chen @ EPRO/DX
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "vehicle-pollsim";
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <ovms_command.h>
+#include <ovms_peripherals.h>
+#include "vehicle_poller.h"
+#include "can.h"
+
+/**
+ * Simulated ECU for the poller benchmark.
+ *  Takes the ISO-TP requests of the poller instead of the bus and answers
+ *  them after the configured delay, using (standard addressing) single frame
+ *  or first + consecutive frame responses as the response length requires.
+ *  Frames are fed to the poller queue like real bus traffic, so the timing
+ *  covers the complete poller path except the CAN driver.
+ *  Timing resolution is one FreeRTOS tick.
+ */
+
+static TickType_t SimTicks(uint16_t ms)
+  {
+  TickType_t ticks = pdMS_TO_TICKS(ms);
+  return (ticks < 1) ? 1 : ticks;
+  }
+
+void OvmsPoller::SimStart(uint16_t delay_ms, uint16_t length)
+  {
+  if (length > 4000)
+    length = 4000;
+  OvmsMutexLock simlock(&m_sim_mutex);
+  poll_sim_t *sim = m_sim;
+  if (sim)
+    {
+    OvmsMutexLock lock(&sim->mutex);
+    sim->delay_ms = delay_ms;
+    sim->length = length;
+    return;
+    }
+  sim = new poll_sim_t();
+  sim->delay_ms = delay_ms;
+  sim->length = length;
+  sim->timer = xTimerCreate("Poll Sim", SimTicks(delay_ms), pdFALSE, this, SimTimer);
+  if (!sim->timer)
+    {
+    ESP_LOGE(TAG, "[%" PRIu8 "]SimStart: failed to create timer", m_poll.bus_no);
+    delete sim;
+    return;
+    }
+  Atomic_Swap(m_sim, sim);
+  ESP_LOGI(TAG, "[%" PRIu8 "]Simulated ECU started: delay=%" PRIu16 "ms length=%" PRIu16,
+    m_poll.bus_no, delay_ms, length);
+  }
+
+static void SimTimerSync(void *done, uint32_t)
+  {
+  xSemaphoreGive((SemaphoreHandle_t)done);
+  }
+
+void OvmsPoller::SimStop()
+  {
+  poll_sim_t *sim;
+    {
+    OvmsMutexLock lock(&m_sim_mutex);
+    sim = Atomic_GetAndNull(m_sim);
+    }
+  if (!sim)
+    return;
+  xTimerStop(sim->timer, portMAX_DELAY);
+  xTimerDelete(sim->timer, portMAX_DELAY);
+  // The sim is no longer reachable. The timer task handles its commands in
+  // order, so when a call queued behind the delete has run, no SimTimer()
+  // callback can still be using this poller:
+  SemaphoreHandle_t done = xSemaphoreCreateBinary();
+  if (done && xTimerPendFunctionCall(SimTimerSync, done, 0, portMAX_DELAY) == pdPASS)
+    xSemaphoreTake(done, portMAX_DELAY);
+  else
+    vTaskDelay(pdMS_TO_TICKS(100));
+  if (done)
+    vSemaphoreDelete(done);
+  delete sim;
+  ESP_LOGI(TAG, "[%" PRIu8 "]Simulated ECU stopped", m_poll.bus_no);
+  }
+
+/**
+ * PollerTransmit: send a poller request frame, to the simulated ECU if active.
+ */
+void OvmsPoller::PollerTransmit(CAN_frame_t &frame)
+  {
+  if (!Atomic_Get(m_sim))
+    {
+    frame.Write();
+    return;
+    }
+  OvmsMutexLock simlock(&m_sim_mutex);
+  poll_sim_t *sim = m_sim;
+  if (!sim)
+    {
+    frame.Write();
+    return;
+    }
+
+  // Simulate the driver TX callback:
+  if (frame.callback)
+    (*frame.callback)(&frame, true);
+
+  if (frame.FIR.B.FF != CAN_frame_std)
+    return;
+  uint8_t frametype = frame.data.u8[0] >> 4;
+  OvmsMutexLock lock(&sim->mutex);
+  if (frametype == ISOTP_FT_SINGLE)
+    {
+    uint8_t len = frame.data.u8[0] & 0x0f;
+    if (len < 1 || len > 7)
+      return;
+    xTimerStop(sim->timer, 0);
+    sim->service = frame.data.u8[1];
+    if (POLL_TYPE_HAS_16BIT_PID(sim->service) && len >= 3)
+      {
+      sim->pid = (frame.data.u8[2] << 8) | frame.data.u8[3];
+      sim->pidlen = 2;
+      }
+    else if (POLL_TYPE_HAS_8BIT_PID(sim->service) && len >= 2)
+      {
+      sim->pid = frame.data.u8[2];
+      sim->pidlen = 1;
+      }
+    else
+      {
+      sim->pid = 0;
+      sim->pidlen = 0;
+      }
+    sim->rxid = (frame.MsgID == 0x7df) ? 0x7e8 : frame.MsgID + 8;
+    sim->total = 1 + sim->pidlen + sim->length;
+    sim->offset = 0;
+    sim->seqno = 1;
+    sim->awaiting_fc = false;
+    xTimerChangePeriod(sim->timer, SimTicks(sim->delay_ms), 0);
+    }
+  else if (frametype == ISOTP_FT_FLOWCTRL && sim->awaiting_fc)
+    {
+    uint8_t septime = frame.data.u8[2];
+    sim->septime = (septime <= 127) ? septime : 1;
+    sim->awaiting_fc = false;
+    xTimerChangePeriod(sim->timer, SimTicks(sim->septime), 0);
+    }
+  }
+
+void OvmsPoller::SimTimer(TimerHandle_t timer)
+  {
+  OvmsPoller *poller = (OvmsPoller*)pvTimerGetTimerID(timer);
+  if (poller)
+    poller->SimSendNext();
+  }
+
+/**
+ * SimSendNext: send the next response frame of the simulated ECU.
+ */
+void OvmsPoller::SimSendNext()
+  {
+  CAN_frame_t frame = {};
+  frame.origin = m_poll.bus;
+  frame.FIR.B.FF = CAN_frame_std;
+  frame.FIR.B.DLC = 8;
+  std::fill_n(frame.data.u8, sizeof_array(frame.data.u8), 0x55);
+    {
+    OvmsMutexLock simlock(&m_sim_mutex);
+    poll_sim_t *sim = m_sim;
+    if (!sim)
+      return;
+    OvmsMutexLock lock(&sim->mutex);
+    if (sim->awaiting_fc || sim->offset >= sim->total)
+      return;
+    frame.MsgID = sim->rxid;
+
+    uint8_t *data;
+    uint8_t datalen;
+    if (sim->offset == 0 && sim->total <= 7)
+      {
+      frame.data.u8[0] = (ISOTP_FT_SINGLE << 4) + sim->total;
+      data = &frame.data.u8[1];
+      datalen = sim->total;
+      }
+    else if (sim->offset == 0)
+      {
+      frame.data.u8[0] = (ISOTP_FT_FIRST << 4) + ((sim->total & 0x0f00) >> 8);
+      frame.data.u8[1] = sim->total & 0xff;
+      data = &frame.data.u8[2];
+      datalen = 6;
+      sim->awaiting_fc = true;
+      }
+    else
+      {
+      frame.data.u8[0] = (ISOTP_FT_CONSECUTIVE << 4) + (sim->seqno++ & 0x0f);
+      data = &frame.data.u8[1];
+      datalen = std::min<uint16_t>(7, sim->total - sim->offset);
+      }
+
+    for (uint8_t i = 0; i < datalen; ++i, ++sim->offset)
+      {
+      uint16_t pos = sim->offset;
+      if (pos == 0)
+        data[i] = 0x40 + sim->service;
+      else if (pos <= sim->pidlen)
+        data[i] = (sim->pidlen == 2 && pos == 1) ? (sim->pid >> 8) : (sim->pid & 0xff);
+      else
+        data[i] = pos & 0xff;
+      }
+
+    if (sim->offset >= sim->total)
+      ++sim->responses;
+    else if (!sim->awaiting_fc)
+      xTimerChangePeriod(sim->timer, SimTicks(sim->septime), 0);
+    }
+
+  m_parent->Queue_PollerFrame(frame, true, false);
+  }
+
+/**
+ * Benchmark poll series: polls a generated PID list on every tick
+ *  and counts the responses.
+ */
+class BenchPollSeries : public OvmsPoller::StandardPollSeries
+  {
+  private:
+    std::vector<OvmsPoller::poll_pid_t> m_list;
+  public:
+    uint32_t m_responses = 0;
+    uint32_t m_errors = 0;
+
+    BenchPollSeries(OvmsPoller *poller, uint8_t busno, uint16_t pids)
+      : StandardPollSeries(poller)
+      {
+      m_list.reserve(pids + 1);
+      for (uint16_t i = 0; i < pids; ++i)
+        {
+        OvmsPoller::poll_pid_t entry = POLL_LIST_END;
+        entry.txmoduleid = 0x7e0;
+        entry.rxmoduleid = 0x7e8;
+        entry.type = VEHICLE_POLL_TYPE_READDATA;
+        entry.pid = 0x1000 + i;
+        for (int state = 0; state < VEHICLE_POLL_NSTATES; ++state)
+          entry.polltime[state] = 1;
+        entry.pollbus = busno;
+        entry.protocol = ISOTP_STD;
+        m_list.push_back(entry);
+        }
+      m_list.push_back(POLL_LIST_END);
+      PollSetPidList(busno, m_list.data());
+      }
+
+    // Responses are taken reassembled, so the bench includes the reassembly path:
+    bool WantsResponse() const override
+      {
+      return true;
+      }
+
+    void IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length) override
+      {
+      }
+
+    void IncomingResponse(const OvmsPoller::poll_job_t& job, const uint8_t* data, uint16_t length) override
+      {
+      ++m_responses;
+      }
+
+    void IncomingError(const OvmsPoller::poll_job_t& job, int32_t code) override
+      {
+      ++m_errors;
+      }
+  };
+
+static std::shared_ptr<BenchPollSeries> s_bench_series[VEHICLE_MAXBUSSES];
+
+void OvmsPollers::BenchStop()
+  {
+  uint8_t busses = m_bench_busses;
+  m_bench_busses = 0;
+  for (uint8_t busno = 1; busno <= VEHICLE_MAXBUSSES; ++busno)
+    {
+    if (!(busses & (1 << (busno-1))))
+      continue;
+    auto poller = GetPoller(GetBus(busno), false);
+    if (poller)
+      {
+      poller->RemovePollRequest("!bench");
+      poller->SimStop();
+      poller->PollSetThrottling(m_poll_sequence_max[static_cast<uint8_t>(PollEntryStyle::Standard)]);
+      }
+    s_bench_series[busno-1].reset();
+    }
+  }
+
+void OvmsPollers::poller_bench_start(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  uint8_t busses = 0;
+  for (const char *cp = argv[0]; *cp; ++cp)
+    {
+    if (*cp == ',' || *cp == ' ')
+      continue;
+    int busno = *cp - '0';
+    if (busno < 1 || busno > VEHICLE_MAXBUSSES)
+      {
+      writer->printf("Error: invalid bus number '%c'\n", *cp);
+      return;
+      }
+    busses |= 1 << (busno-1);
+    }
+  int pids = (argc > 1) ? atoi(argv[1]) : 20;
+  int delay_ms = (argc > 2) ? atoi(argv[2]) : 10;
+  int length = (argc > 3) ? atoi(argv[3]) : 4;
+  if (busses == 0 || pids < 1 || pids > 1000 || delay_ms < 0 || delay_ms > 5000 || length < 0 || length > 4000)
+    {
+    writer->puts("Error: invalid parameters");
+    return;
+    }
+
+  MyPollers.BenchStop();
+
+  for (uint8_t busno = 1; busno <= VEHICLE_MAXBUSSES; ++busno)
+    {
+    if (!(busses & (1 << (busno-1))))
+      continue;
+
+    // The simulated ECU replaces the bus, so it needs to be known but not started:
+    bus_info_t &info = MyPollers.m_canbusses[busno-1];
+    if (!info.can)
+      {
+      std::string busname = string_format("can%d", busno);
+      info.can = (canbus*)MyPcpApp.FindDeviceByName(busname.c_str());
+      if (!info.can)
+        {
+        writer->printf("Error: cannot find CAN bus %d\n", busno);
+        continue;
+        }
+      }
+    auto poller = MyPollers.GetPoller(info.can, true);
+    if (!poller)
+      {
+      writer->printf("Error: no poller for CAN bus %d\n", busno);
+      continue;
+      }
+    if (poller->HasPollList())
+      {
+      writer->printf("Error: CAN bus %d has active polls, skipped\n", busno);
+      continue;
+      }
+
+    poller->SimStart(delay_ms, length);
+    poller->PollSetThrottling(0);
+    poller->RoundStatsReset();
+    auto series = std::shared_ptr<BenchPollSeries>(new BenchPollSeries(poller, busno, pids));
+    if (!poller->PollRequest("!bench", series))
+      {
+      poller->SimStop();
+      writer->printf("Error: failed to add bench polls to CAN bus %d\n", busno);
+      continue;
+      }
+    s_bench_series[busno-1] = series;
+    MyPollers.m_bench_busses |= 1 << (busno-1);
+    }
+
+  if (MyPollers.m_bench_busses == 0)
+    return;
+  writer->printf("Poller bench started (%s mode): %d PIDs per round, %dms response delay, %d bytes\n",
+    MyPollers.IsParallel() ? "parallel" : "serial", pids, delay_ms, length);
+  }
+
+void OvmsPollers::poller_bench_stop(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyPollers.m_bench_busses == 0)
+    {
+    writer->puts("Poller bench not running");
+    return;
+    }
+  poller_bench_status(verbosity, writer, cmd, argc, argv);
+  MyPollers.BenchStop();
+  writer->puts("Poller bench stopped");
+  }
+
+void OvmsPollers::poller_bench_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  uint8_t busses = MyPollers.m_bench_busses;
+  if (busses == 0)
+    {
+    writer->puts("Poller bench not running");
+    return;
+    }
+  writer->printf("Mode: %s", MyPollers.IsParallel() ? "parallel" : "serial");
+  if (MyPollers.m_budget_max)
+    writer->printf(", budget %" PRIu16 " polls/s\n", MyPollers.m_budget_max);
+  else
+    writer->puts("");
+  for (uint8_t busno = 1; busno <= VEHICLE_MAXBUSSES; ++busno)
+    {
+    if (!(busses & (1 << (busno-1))))
+      continue;
+    auto poller = MyPollers.GetPoller(MyPollers.GetBus(busno), false);
+    auto series = s_bench_series[busno-1];
+    if (!poller || !series)
+      continue;
+    poller->RoundStatus(writer, true);
+    writer->printf("  Responses: %" PRIu32 ", errors: %" PRIu32 "\n", series->m_responses, series->m_errors);
+    }
+  }
@@ -56,8 +56,9 @@ void OvmsPoller::PollerVWTPStart(bool fromTicker)
       PollerVWTPEnter(VWTP_ChannelSetup);
     else
       {
+      OvmsPollers::SignalLock signal(m_parent);
       OvmsRecMutexLock lock(&m_poll_mutex);
-      m_polls.IncomingError(m_poll, POLLSINGLE_OK);
+      IncomingPollError(m_poll, POLLSINGLE_OK);
       }
     return;
     }
@@ -510,8 +511,9 @@ bool OvmsPoller::PollerVWTPReceive(CAN_frame_t* frame, uint32_t msgid)
           PollerVWTPEnter(VWTP_ChannelSetup);
         else
           {
+          OvmsPollers::SignalLock signal(m_parent);
           OvmsRecMutexLock lock(&m_poll_mutex);
-          m_polls.IncomingError(m_poll, POLLSINGLE_OK);
+          IncomingPollError(m_poll, POLLSINGLE_OK);
           }
         }
       else
@@ -617,6 +619,11 @@ bool OvmsPoller::PollerVWTPReceive(CAN_frame_t* frame, uint32_t msgid)
         if ((opcode & 0x0f) != (rxseqnr & 0x0f))
           {
           logFrameDump("received out of sequence frame, abort");
+            {
+            OvmsPollers::SignalLock signal(m_parent);
+            OvmsRecMutexLock lock(&m_poll_mutex);
+            DropPollResponse(NULL);
+            }
           PollerVWTPEnter(VWTP_AbortXfer);
           return true;
           }
@@ -705,9 +712,10 @@ bool OvmsPoller::PollerVWTPReceive(CAN_frame_t* frame, uint32_t msgid)
                       m_poll_vwtp.moduleid, m_poll.type, m_poll.pid, error_code);
 
               {
+              OvmsPollers::SignalLock signal(m_parent);
               OvmsRecMutexLock lock(&m_poll_mutex);
               m_poll.moduleid_rec = m_poll.moduleid_sent;
-              m_polls.IncomingError(m_poll, error_code);
+              IncomingPollError(m_poll, error_code);
               }
             // abort receive:
             m_poll.mlremain = 0;
@@ -726,9 +734,10 @@ bool OvmsPoller::PollerVWTPReceive(CAN_frame_t* frame, uint32_t msgid)
                     m_poll_vwtp.moduleid, m_poll.type, m_poll.pid,
                     m_poll.mlframe, response_datalen, m_poll.mloffset, m_poll.mlremain);
             {
+            OvmsPollers::SignalLock signal(m_parent);
             OvmsRecMutexLock lock(&m_poll_mutex);
             m_poll.moduleid_rec = msgid;
-            m_polls.IncomingPacket(m_poll, response_data, response_datalen);
+            IncomingPollData(response_data, response_datalen);
             }
           }
         else
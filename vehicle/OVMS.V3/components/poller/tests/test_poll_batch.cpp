@@ -0,0 +1,287 @@
+// test_poll_batch.cpp — Native laptop tests for UDS multi-DID batching (PollBatch).
+//
+// Drives PollBatch the way StandardPollSeries does (learn from single responses,
+// collect due DIDs, split the response & deliver), and checks:
+//   - nothing is batched before the lengths are learned, multi frame DIDs never are
+//   - probing: a matching response marks the ECU supported, requests then use max DIDs
+//   - probing: a negative, lost or mismatching response marks the ECU unsupported
+//   - the split delivers each DID with the data learned
+//   - stale lengths (DID grew / shrank, wrong DID, truncated data) deliver nothing,
+//     the DIDs are relearned, a supported ECU stays supported
+//
+// Run:  make test   (from the tests/ directory)
+
+#include "vehicle_poller_batch.h"
+#include <cstdio>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; \
+    printf("  FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+// Same layout as OvmsPoller::poll_pid_t
+#define NSTATES 4
+typedef struct __attribute__ ((__packed__))
+  {
+  uint32_t txmoduleid;
+  uint32_t rxmoduleid;
+  uint16_t type;
+  union
+    {
+    uint16_t pid;
+    struct
+      {
+      uint16_t pid;
+      uint8_t datalen;
+      uint8_t data[6];
+      } args;
+    };
+  union
+    {
+    uint16_t polltime[NSTATES];
+    struct
+      {
+      uint16_t cycle[NSTATES];
+      uint8_t  shift[NSTATES];
+      } ts;
+    };
+  uint8_t  pollbus;
+  uint8_t  protocol;
+  } poll_pid_t;
+
+typedef PollBatch<poll_pid_t> Batch;
+
+struct Item {
+    uint16_t pid;
+    std::vector<uint8_t> data;
+};
+
+// ---------------------------------------------------------------------------
+// Series: the StandardPollSeries side (all list entries due every ticker)
+// ---------------------------------------------------------------------------
+
+struct Series {
+    std::vector<poll_pid_t> list;
+    Batch batch;
+    std::vector<Item> delivered;
+
+    uint16_t Size() const { return list.size() - 1; }
+
+    static bool Compatible(const poll_pid_t &entry, const poll_pid_t &first) {
+        return entry.args.datalen == 0
+            && entry.txmoduleid == first.txmoduleid
+            && entry.rxmoduleid == first.rxmoduleid;
+    }
+
+    // Next request from list index 'first', returns the request entry,
+    // 'last' the last list index covered.
+    poll_pid_t Next(int first, int &last) {
+        poll_pid_t entry = list[first];
+        last = batch.Collect(entry, list.data(), Size(), first,
+            [this](int index) { return (index + 1 < Size()) ? index + 1 : -1; },
+            Compatible);
+        if (last < 0)
+            last = first;
+        return entry;
+    }
+
+    // Single response: learn
+    void Single(int index, uint16_t length, bool single = true) {
+        batch.Learn(Size(), index, length, single);
+    }
+
+    // Batched response (data after the first DID)
+    void Response(const std::vector<uint8_t> &data) {
+        Batch::item_t items[Batch::dids_max];
+        uint8_t item;
+        uint16_t pos;
+        uint8_t count = batch.Split(list.data(), data.data(), data.size(), items, item, pos);
+        for (uint8_t i = 0; i < count; ++i) {
+            Item it;
+            it.pid = list[items[i].index].pid;
+            it.data.assign(data.begin() + items[i].offset, data.begin() + items[i].offset + items[i].length);
+            delivered.push_back(it);
+        }
+    }
+
+    const Batch::ecu_t* Ecu() const { return batch.Ecus().empty() ? nullptr : &batch.Ecus()[0]; }
+};
+
+static Series MakeSeries(size_t count, uint8_t max = 4) {
+    Series s;
+    for (size_t i = 0; i < count; ++i) {
+        poll_pid_t p = {};
+        p.txmoduleid = 0x7e0;
+        p.rxmoduleid = 0x7e8;
+        p.type = 0x22;
+        p.pid = 0x1001 + i;
+        p.ts.cycle[0] = 1;
+        s.list.push_back(p);
+    }
+    s.list.push_back(poll_pid_t{});
+    s.batch.SetMax(max);
+    return s;
+}
+
+// Response data of the DIDs (list indices) with the given lengths, first DID without header.
+static std::vector<uint8_t> Build(const Series &s, std::initializer_list<std::pair<int,int>> dids) {
+    std::vector<uint8_t> data;
+    bool first = true;
+    for (auto &d : dids) {
+        if (!first) {
+            data.push_back(s.list[d.first].pid >> 8);
+            data.push_back(s.list[d.first].pid & 0xff);
+        }
+        first = false;
+        for (int i = 0; i < d.second; ++i)
+            data.push_back((d.first << 4) + i);
+    }
+    return data;
+}
+
+static int Dids(const poll_pid_t &req) {
+    return 1 + req.args.datalen / 2;
+}
+
+static void TestLearning() {
+    printf("learning\n");
+    Series s = MakeSeries(4);
+    int last;
+    s.Next(0, last);
+    CHECK(!s.batch.Pending() && last == 0, "batched before lengths are known");
+    s.Single(0, 3);
+    s.Single(1, 20, false);   // multi frame
+    s.Single(2, 2);
+    s.Single(3, 4);
+    s.Next(0, last);
+    CHECK(!s.batch.Pending(), "batched with a multi frame DID next");
+    s.Next(1, last);
+    CHECK(!s.batch.Pending(), "multi frame DID batched");
+    poll_pid_t req = s.Next(2, last);
+    CHECK(s.batch.Pending() && Dids(req) == 2 && last == 3, "no probe for DIDs 3+4");
+    CHECK(req.args.data[0] == 0x10 && req.args.data[1] == 0x04, "probe DID list wrong");
+
+    // Batching off:
+    Series o = MakeSeries(2, 0);
+    o.Single(0, 3);
+    o.Single(1, 3);
+    o.Next(0, last);
+    CHECK(!o.batch.Pending(), "batched while off");
+}
+
+static void TestProbeSupported() {
+    printf("probe: supported\n");
+    Series s = MakeSeries(6);
+    for (int i = 0; i < 6; ++i)
+        s.Single(i, 1 + i);
+    int last;
+    poll_pid_t req = s.Next(0, last);
+    CHECK(Dids(req) == 2 && s.Ecu() && s.Ecu()->support == Batch::Probing, "no probe");
+    s.Response(Build(s, {{0,1}, {1,2}}));
+    CHECK(s.Ecu()->support == Batch::Supported && s.Ecu()->requests == 1, "not supported after probe");
+    CHECK(s.delivered.size() == 2, "%zu DIDs delivered", s.delivered.size());
+    if (s.delivered.size() == 2) {
+        CHECK(s.delivered[0].pid == 0x1001 && s.delivered[0].data == std::vector<uint8_t>({0x00}), "DID 1 wrong");
+        CHECK(s.delivered[1].pid == 0x1002 && s.delivered[1].data == std::vector<uint8_t>({0x10, 0x11}), "DID 2 wrong");
+    }
+    CHECK(!s.batch.Pending(), "still pending after response");
+
+    // Supported: max DIDs per request
+    s.delivered.clear();
+    req = s.Next(2, last);
+    CHECK(Dids(req) == 4 && last == 5, "%d DIDs requested", Dids(req));
+    s.Response(Build(s, {{2,3}, {3,4}, {4,5}, {5,6}}));
+    CHECK(s.delivered.size() == 4 && s.Ecu()->requests == 2, "%zu DIDs delivered", s.delivered.size());
+    if (s.delivered.size() == 4)
+        CHECK(s.delivered[3].pid == 0x1006 && s.delivered[3].data.size() == 6, "DID 6 wrong");
+}
+
+static void TestProbeUnsupported() {
+    printf("probe: unsupported\n");
+    int last;
+
+    // Negative response
+    Series n = MakeSeries(3);
+    for (int i = 0; i < 3; ++i) n.Single(i, 2);
+    n.Next(0, last);
+    CHECK(n.batch.Error(), "negative response: not marked unsupported");
+    CHECK(n.Ecu()->support == Batch::Unsupported && !n.batch.Pending(), "negative response: still probing");
+    n.Next(0, last);
+    CHECK(!n.batch.Pending(), "negative response: batched again");
+
+    // No response
+    Series l = MakeSeries(3);
+    for (int i = 0; i < 3; ++i) l.Single(i, 2);
+    l.Next(0, last);
+    CHECK(l.batch.Lost() && l.Ecu()->support == Batch::Unsupported, "no response: not marked unsupported");
+
+    // Response of the first DID only (ECU ignores the DID list)
+    Series m = MakeSeries(3);
+    for (int i = 0; i < 3; ++i) m.Single(i, 2);
+    m.Next(0, last);
+    m.Response(Build(m, {{0,2}}));
+    CHECK(m.delivered.empty(), "mismatch: %zu DIDs delivered", m.delivered.size());
+    CHECK(m.Ecu()->support == Batch::Unsupported, "mismatch: not marked unsupported");
+    CHECK(m.batch.Length(0) == 0 && m.batch.Length(1) == 0, "mismatch: lengths not relearned");
+}
+
+static void TestStaleLength() {
+    printf("stale lengths on a supported ECU\n");
+    int last;
+    Series s = MakeSeries(4);
+    for (int i = 0; i < 4; ++i) s.Single(i, 2);
+    s.Next(0, last);
+    s.Response(Build(s, {{0,2}, {1,2}}));
+    CHECK(s.Ecu()->support == Batch::Supported, "probe failed");
+    s.delivered.clear();
+
+    struct Case { const char* name; std::vector<uint8_t> data; };
+    std::vector<Case> cases = {
+        { "first DID grew", Build(s, {{0,3}, {1,2}, {2,2}, {3,2}}) },
+        { "last DID grew", Build(s, {{0,2}, {1,2}, {2,2}, {3,3}}) },
+        { "last DID shrank", Build(s, {{0,2}, {1,2}, {2,2}, {3,1}}) },
+        { "DID missing", Build(s, {{0,2}, {1,2}, {3,2}}) },
+        { "truncated", Build(s, {{0,2}, {1,2}, {2,2}}) },
+    };
+    for (auto &c : cases) {
+        s.Single(0, 2); s.Single(1, 2); s.Single(2, 2); s.Single(3, 2);
+        poll_pid_t req = s.Next(0, last);
+        CHECK(Dids(req) == 4, "%s: %d DIDs requested", c.name, Dids(req));
+        s.Response(c.data);
+        CHECK(s.delivered.empty(), "%s: %zu DIDs delivered", c.name, s.delivered.size());
+        CHECK(s.Ecu()->support == Batch::Supported, "%s: ECU no longer supported", c.name);
+        bool relearn = true;
+        for (int i = 0; i < 4; ++i)
+            relearn = relearn && s.batch.Length(i) == 0;
+        CHECK(relearn, "%s: lengths not relearned", c.name);
+        s.Next(0, last);
+        CHECK(!s.batch.Pending(), "%s: batched before relearning", c.name);
+        s.delivered.clear();
+    }
+
+    // Fallback to single requests, then batching again once relearned:
+    s.Single(0, 3); s.Single(1, 2);
+    poll_pid_t req = s.Next(0, last);
+    CHECK(Dids(req) == 2 && last == 1, "not batched after relearning");
+    s.Response(Build(s, {{0,3}, {1,2}}));
+    CHECK(s.delivered.size() == 2 && s.delivered[0].data.size() == 3, "relearned batch not delivered");
+
+    // A lost response does not drop support of an ECU with answered requests:
+    s.Single(2, 2); s.Single(3, 2);
+    s.Next(2, last);
+    CHECK(!s.batch.Lost() && s.Ecu()->support == Batch::Supported, "lost response dropped support");
+}
+
+int main() {
+    TestLearning();
+    TestProbeSupported();
+    TestProbeUnsupported();
+    TestStaleLength();
+    if (failures) {
+        printf("%d FAILURES\n", failures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,274 @@
+// test_poll_schedule.cpp — Native laptop tests for the precomputed poll schedule.
+//
+// Walks random poll lists the way StandardPollSeries::NextPollEntry does, once with
+// the original full list scan (reference) and once via PollSchedule, and checks:
+//   - identical entry sequences for every ticker of the max_ticker cycle, bus & state
+//   - identical results when ticker, poll state or list change in the middle of a run
+//   - the time spent per ticker cycle by both (informational)
+//
+// Run:  make test   (from the tests/ directory)
+
+#include "vehicle_poller_schedule.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; \
+    printf("  FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+// Same layout as OvmsPoller::poll_pid_t
+#define NSTATES 4
+typedef struct __attribute__ ((__packed__))
+  {
+  uint32_t txmoduleid;
+  uint32_t rxmoduleid;
+  uint16_t type;
+  union
+    {
+    uint16_t pid;
+    struct
+      {
+      uint16_t pid;
+      uint8_t datalen;
+      uint8_t data[6];
+      } args;
+    };
+  union
+    {
+    uint16_t polltime[NSTATES];
+    struct
+      {
+      uint16_t cycle[NSTATES];
+      uint8_t  shift[NSTATES];
+      } ts;
+    };
+  uint8_t  pollbus;
+  uint8_t  protocol;
+  } poll_pid_t;
+
+static const uint32_t max_ticker = 3600;
+
+// ---------------------------------------------------------------------------
+// Reference: the original list scan of StandardPollSeries::NextPollEntry
+// ---------------------------------------------------------------------------
+
+struct RefWalker {
+    const poll_pid_t* plist = nullptr;
+    const poll_pid_t* plcur = nullptr;
+    uint8_t defaultbus = 1;
+
+    void Reset() { plcur = nullptr; }
+
+    // 1 = found, 0 = reached end, -1 = still at end
+    int Next(int &index, uint8_t mybus, uint32_t pollticker, uint8_t pollstate) {
+        if (plcur == nullptr)
+            plcur = plist;
+        else if (plcur->txmoduleid == 0)
+            return -1;
+        else
+            ++plcur;
+        while (plcur->txmoduleid != 0) {
+            uint8_t bus = plcur->pollbus;
+            if (bus == 0)
+                bus = defaultbus;
+            if (mybus == bus) {
+                uint16_t polltime = plcur->polltime[pollstate];
+                uint8_t pollshift = plcur->ts.shift[pollstate];
+                if ( ((polltime > 0) && (pollticker >= pollshift) && (((pollticker - pollshift) % polltime) == 0))
+                  || ((polltime == 0) && (pollshift > 0) && (pollticker == pollshift)) ) {
+                    index = plcur - plist;
+                    return 1;
+                }
+            }
+            ++plcur;
+        }
+        return 0;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Schedule based walk, as in StandardPollSeries::NextPollEntry
+// ---------------------------------------------------------------------------
+
+struct SchedWalker {
+    const poll_pid_t* plist = nullptr;
+    const poll_pid_t* plcur = nullptr;
+    uint8_t defaultbus = 1;
+    PollSchedule<poll_pid_t> schedule;
+
+    void Reset() { plcur = nullptr; }
+    void SetList(const poll_pid_t* list) { plist = list; plcur = nullptr; schedule.Invalidate(); }
+
+    int Next(int &index, uint8_t mybus, uint32_t pollticker, uint8_t pollstate) {
+        int after;
+        if (plcur == nullptr)
+            after = -1;
+        else if (plcur->txmoduleid == 0)
+            return -1;
+        else
+            after = plcur - plist;
+        schedule.Prepare(plist, mybus, defaultbus, pollstate);
+        int next = schedule.Next(pollticker, after);
+        if (next < 0) {
+            plcur = plist + schedule.Size();
+            return 0;
+        }
+        plcur = plist + next;
+        index = next;
+        return 1;
+    }
+};
+
+static std::vector<poll_pid_t> RandomList(std::mt19937 &rng, size_t count) {
+    static const uint16_t cycles[] = { 0, 0, 1, 1, 2, 3, 5, 10, 10, 30, 60, 60, 120, 300, 600, 3600 };
+    std::vector<poll_pid_t> list;
+    for (size_t i = 0; i < count; ++i) {
+        poll_pid_t p = {};
+        p.txmoduleid = 0x700 + (rng() % 0x100);
+        p.rxmoduleid = p.txmoduleid + 8;
+        p.type = 0x22;
+        p.pid = i;
+        for (int s = 0; s < NSTATES; ++s) {
+            p.ts.cycle[s] = cycles[rng() % (sizeof(cycles)/sizeof(cycles[0]))];
+            p.ts.shift[s] = (rng() % 3 == 0) ? (rng() % 40) : 0;
+        }
+        p.pollbus = rng() % 3;   // 0 = default bus
+        list.push_back(p);
+    }
+    list.push_back(poll_pid_t{});
+    return list;
+}
+
+// Full walk of one ticker, returns the entry sequence.
+template <typename W>
+static std::vector<int> Walk(W &walker, uint8_t bus, uint32_t ticker, uint8_t state) {
+    std::vector<int> seq;
+    walker.Reset();
+    int index, res;
+    while ((res = walker.Next(index, bus, ticker, state)) == 1)
+        seq.push_back(index);
+    seq.push_back(res == 0 ? -2 : -3);
+    // Calls after the end must report "still at end":
+    seq.push_back(walker.Next(index, bus, ticker, state));
+    return seq;
+}
+
+static void TestFullCycle(std::mt19937 &rng) {
+    printf("full ticker cycle equivalence\n");
+    for (size_t count : { 0, 1, 7, 60, 200 }) {
+        auto list = RandomList(rng, count);
+        RefWalker ref;
+        SchedWalker sched;
+        ref.plist = list.data();
+        sched.SetList(list.data());
+        int mismatches = 0;
+        for (uint8_t bus = 1; bus <= 2; ++bus)
+            for (uint8_t state = 0; state < NSTATES; ++state)
+                for (uint32_t ticker = 0; ticker <= max_ticker; ++ticker)
+                    if (Walk(ref, bus, ticker, state) != Walk(sched, bus, ticker, state))
+                        ++mismatches;
+        CHECK(mismatches == 0, "list size %zu: %d ticker mismatches", count, mismatches);
+    }
+}
+
+static void TestMidRunChanges(std::mt19937 &rng) {
+    printf("mid-run ticker, state & list changes\n");
+    auto list1 = RandomList(rng, 120);
+    auto list2 = RandomList(rng, 80);
+    RefWalker ref;
+    SchedWalker sched;
+    ref.plist = list1.data();
+    sched.SetList(list1.data());
+    uint32_t ticker = 0;
+    uint8_t state = 0, bus = 1;
+    int mismatches = 0;
+    for (int step = 0; step < 200000; ++step) {
+        switch (rng() % 20) {
+            case 0:  ticker = (ticker + 1) % (max_ticker + 1); break;     // tick without reset
+            case 1:  state = rng() % NSTATES; break;                     // state change
+            case 2:  ref.Reset(); sched.Reset(); ticker = (ticker + 1) % (max_ticker + 1); break;
+            case 3:  bus = 1 + rng() % 2; ref.Reset(); sched.Reset(); break;
+            case 4:
+                if (rng() % 50 == 0) {
+                    auto &list = (ref.plist == list1.data()) ? list2 : list1;
+                    ref.plist = list.data();
+                    ref.Reset();
+                    sched.SetList(list.data());
+                }
+                break;
+            default: {
+                int i1 = -1, i2 = -1;
+                int r1 = ref.Next(i1, bus, ticker, state);
+                int r2 = sched.Next(i2, bus, ticker, state);
+                if (r1 != r2 || (r1 == 1 && i1 != i2))
+                    ++mismatches;
+            }
+        }
+    }
+    CHECK(mismatches == 0, "%d step mismatches", mismatches);
+}
+
+template <typename W>
+static double TimeCycle(W &walker, uint8_t state) {
+    auto start = std::chrono::steady_clock::now();
+    volatile int sink = 0;
+    for (int rep = 0; rep < 5; ++rep)
+        for (uint32_t ticker = 0; ticker <= max_ticker; ++ticker) {
+            walker.Reset();
+            int index;
+            while (walker.Next(index, 1, ticker, state) == 1)
+                sink = sink + index;
+        }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 5;
+}
+
+// Typical vehicle list: few distinct intervals, rarely shifted.
+static std::vector<poll_pid_t> VehicleList(std::mt19937 &rng, size_t count, bool dense) {
+    static const uint16_t cycles_dense[] = { 0, 1, 2, 10, 10, 10, 30, 60, 60, 300 };
+    static const uint16_t cycles_sparse[] = { 0, 5, 10, 10, 30, 30, 60, 60, 300, 600 };
+    const uint16_t *cycles = dense ? cycles_dense : cycles_sparse;
+    std::vector<poll_pid_t> list;
+    for (size_t i = 0; i < count; ++i) {
+        poll_pid_t p = {};
+        p.txmoduleid = 0x7e0 + (rng() % 8);
+        p.rxmoduleid = p.txmoduleid + 8;
+        p.type = 0x22;
+        p.pid = i;
+        for (int s = 0; s < NSTATES; ++s)
+            p.ts.cycle[s] = cycles[rng() % 10];
+        if (rng() % 20 == 0)
+            p.ts.shift[3] = 1 + rng() % 5;
+        p.pollbus = 0;
+        list.push_back(p);
+    }
+    list.push_back(poll_pid_t{});
+    return list;
+}
+
+static void BenchCycle(std::mt19937 &rng, bool dense) {
+    auto list = VehicleList(rng, 200, dense);
+    RefWalker ref;
+    SchedWalker sched;
+    ref.plist = list.data();
+    sched.SetList(list.data());
+    double tref = TimeCycle(ref, 3), tsched = TimeCycle(sched, 3);
+    printf("200 entries (%s), %u tickers: list scan %.2f ms, schedule %.2f ms (%zu timing classes)\n",
+        dense ? "dense" : "sparse", max_ticker + 1, tref, tsched, sched.schedule.Classes());
+}
+
+int main() {
+    std::mt19937 rng(4711);
+    TestFullCycle(rng);
+    TestMidRunChanges(rng);
+    BenchCycle(rng, true);
+    BenchCycle(rng, false);
+    if (failures) {
+        printf("%d FAILURES\n", failures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -141,17 +141,21 @@ void re::Task()
 void re::DoAnalyse(CAN_frame_t* frame)
   {
   char vbuf[256];
+  uint32_t now = (uint32_t)esp_timer_get_time();
 
   OvmsRecMutexLock lock(&m_mutex);
-  std::string key = GetKey(frame);
-  auto k = m_rmap.find(key);
-  re_record_t* r;
+  uint64_t key = GetKey(frame);
+  re_record_t* r = m_rmap.Find(key);
+  uint8_t changed = 0;
   if (m_rmap.size() == 0) m_started = monotonictime;
-  if (k == m_rmap.end())
+  if (r == NULL)
     {
-    r = k->second;
-    r = new re_record_t;
-    memset(r,0,sizeof(re_record_t));
+    r = m_rmap.Insert(key);
+    if (r == NULL)
+      {
+      m_dropped++;
+      return;
+      }
     r->attr.b.Changed = 1; // Mark the whole ID as changed
     r->attr.dc = 0xff;
     switch (MyRE->m_mode)
@@ -163,65 +167,59 @@ void re::DoAnalyse(CAN_frame_t* frame)
         r->attr.dd = 0xff;
         HighlightDump(vbuf, (const char*)frame->data.u8, frame->FIR.B.DLC, r->attr.dc, r->attr.dd);
         ESP_LOGV(TAG, "Discovered new %s%s%s %s",
-          re_green[0][0], key.c_str(), re_green[0][1], vbuf);
+          re_green[0][0], GetKeyName(key).c_str(), re_green[0][1], vbuf);
         break;
       }
-    m_rmap[key] = r;
     }
   else
     {
-    r = k->second;
+    for (int k=0;k<r->last.FIR.B.DLC;k++)
+      {
+      if (r->last.data.u8[k] != frame->data.u8[k])
+        changed |= (1<<k);
+      }
     switch (MyRE->m_mode)
       {
       case Analyse:
-        for (int k=0;k<r->last.FIR.B.DLC;k++)
-          {
-          if (r->last.data.u8[k] != frame->data.u8[k])
-            r->attr.dc |= (1<<k); // Mark the byte as changed
-          }
+        r->attr.dc |= changed; // Mark the bytes as changed
         break;
       case Discover:
         {
-        bool found = false;
-        for (int j=0;j<r->last.FIR.B.DLC;j++)
-          {
-          uint8_t mask = (j==0)?1:(1<<j);
-          if (((r->attr.dc & mask)==0) &&
-              (r->last.data.u8[j] != frame->data.u8[j]))
-            {
-            r->attr.dc |= mask; // Mark the byte as changed
-            r->attr.dd |= mask; // Mark the byte as discovered
-            found = true;
-            }
-          }
+        uint8_t found = changed & ~r->attr.dc;
         if (found)
           {
+          r->attr.dc |= found; // Mark the bytes as changed
+          r->attr.dd |= found; // Mark the bytes as discovered
           HighlightDump(vbuf, (const char*)frame->data.u8, frame->FIR.B.DLC, r->attr.dc, r->attr.dd);
-          ESP_LOGV(TAG, "Discovered change %s %s", k->first.c_str(), vbuf);
+          ESP_LOGV(TAG, "Discovered change %s %s", GetKeyName(key).c_str(), vbuf);
           }
         break;
         }
       }
     }
+  re_stats_update(&r->stats, r->rxcount, now, changed);
   memcpy(&r->last,frame,sizeof(CAN_frame_t));
   r->rxcount++;
   }
 
-std::string re::GetKey(CAN_frame_t* frame)
+uint64_t re::GetKey(CAN_frame_t* frame)
   {
-  std::string key;
+  unsigned int bus = 0;
   if (frame->origin != NULL)
-    key = std::string(frame->origin->GetName());
-  else
-    key = std::string("can?");
-  key.append("/");
+    {
+    for (bus=1; bus<=RE_KEY_MAXBUS; bus++)
+      {
+      if (m_buses[bus] == frame->origin) break;
+      if (m_buses[bus] == NULL)
+        {
+        m_buses[bus] = frame->origin;
+        break;
+        }
+      }
+    if (bus > RE_KEY_MAXBUS) bus = 0;
+    }
 
-  char id[9];
-  if (frame->FIR.B.FF == CAN_frame_std)
-    sprintf(id,"%03" PRIx32,frame->MsgID);
-  else
-    sprintf(id,"%08" PRIx32,frame->MsgID);
-  key.append(id);
+  uint64_t key = re_key(bus, frame->FIR.B.FF == CAN_frame_ext, frame->MsgID);
 
   if (((m_obdii_std_min>0) &&
        (frame->FIR.B.FF == CAN_frame_std) &&
@@ -234,31 +232,7 @@ std::string re::GetKey(CAN_frame_t* frame)
        (frame->MsgID <= m_obdii_ext_max)))
     {
     // It is an OBDII request
-    if (frame->data.u8[0] > 8)
-      {
-      // Probably just a continuation frame. Ignore it.
-      return key;
-      }
-    uint8_t mode = frame->data.u8[1];
-    char req[16];
-    if (mode > 0x4a)
-      {
-      sprintf(req,":O2Pm%d:%d",mode-0x40,((int)frame->data.u8[2]<<8)+frame->data.u8[3]);
-      }
-    else if (mode > 0x40)
-      {
-      sprintf(req,":O2Pm%d:%d",mode-0x40,(int)frame->data.u8[2]);
-      }
-    else if (mode > 0x0a)
-      {
-      sprintf(req,":O2Qm%d:%d",mode,((int)frame->data.u8[2]<<8)+frame->data.u8[3]);
-      }
-    else
-      {
-      sprintf(req,":O2Qm%d:%d",mode,(int)frame->data.u8[2]);
-      }
-    key.append(req);
-    return key;
+    return re_key_obd(key, frame->data.u8);
     }
 
   // Check for, and process, multiplexed signal
@@ -273,10 +247,7 @@ std::string re::GetKey(CAN_frame_t* frame)
         // We have a multiplexed signal
         dbcSignal* s = m->GetMultiplexorSignal();
         dbcNumber muxn = s->Decode(frame->data.u8, 8);
-        uint32_t mux = muxn.GetUnsignedInteger();
-        char b[8];
-        sprintf(b,":%04" PRIx32,mux);
-        key.append(b);
+        key = re_key_mux(key, muxn.GetUnsignedInteger());
         }
       }
     }
@@ -284,6 +255,27 @@ std::string re::GetKey(CAN_frame_t* frame)
   return key;
   }
 
+std::string re::GetKeyName(uint64_t key)
+  {
+  unsigned int bus = re_key_bus(key);
+  return re_key_format(key, (bus && m_buses[bus]) ? m_buses[bus]->GetName() : NULL);
+  }
+
+/**
+ * GetRecords: collect the records sorted by key name for listing.
+ *  Caller needs to hold m_mutex while using the list.
+ */
+void re::GetRecords(re_record_list_t& list)
+  {
+  for (size_t i=0; i<m_rmap.Capacity(); i++)
+    {
+    uint64_t key;
+    re_record_t* r = m_rmap.At(i, &key);
+    if (r != NULL)
+      list[GetKeyName(key)] = r;
+    }
+  }
+
 re::re(const char* name, canfilter* filter)
   : pcp(name)
   {
@@ -295,9 +287,11 @@ re::re(const char* name, canfilter* filter)
   m_started = monotonictime;
   m_finished = monotonictime;
   m_mode = Analyse;
+  m_dropped = 0;
+  memset(m_buses, 0, sizeof(m_buses));
   m_rxqueue = xQueueCreate(20,sizeof(CAN_frame_t));
   xTaskCreatePinnedToCore(RE_task, "OVMS RE", 4096, (void*)this, 5, &m_task, CORE(1));
-  MyCan.RegisterListener(m_rxqueue, true);
+  MyCan.RegisterListener(m_rxqueue, true, NULL, TAG);
   }
 
 re::~re()
@@ -335,11 +329,8 @@ void re::SetPowerMode(PowerMode powermode)
 
 void re::Clear()
   {
-  for (re_record_map_t::iterator it=m_rmap.begin(); it!=m_rmap.end(); ++it)
-    {
-    delete it->second;
-    }
-  m_rmap.clear();
+  m_rmap.Clear();
+  m_dropped = 0;
   m_started = monotonictime;
   m_finished = monotonictime;
   }
@@ -422,7 +413,9 @@ void re_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, cons
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
     if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
       {
@@ -451,7 +444,9 @@ void re_stream_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
   writer->printf("[");
   int cnt = 0;
   char *ascii = NULL;
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
     if (argc == 0 || strstr(it->first.c_str(),argv[0]) != NULL)
       {
@@ -481,7 +476,9 @@ void re_dbc_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
     if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
       {
@@ -507,6 +504,44 @@ void re_dbc_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
     }
   }
 
+void re_stats(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (!MyRE)
+    {
+    writer->puts("Error: RE tools not running");
+    return;
+    }
+
+  OvmsRecMutexLock lock(&MyRE->m_mutex);
+  writer->printf("%-20.20s %10s %8s %8s %8s %8s %8s %s\n",
+    "key","records","rate/s","min ms","avg ms","max ms","jit ms","byte changes");
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
+    {
+    if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
+      {
+      re_stats_t* st = &it->second->stats;
+      char cbuf[64];
+      char *s = cbuf;
+      for (int k=0;k<it->second->last.FIR.B.DLC;k++)
+        s += sprintf(s, "%s%u", k ? " " : "", st->changes[k]);
+      *s = 0;
+      if (it->second->rxcount < 2)
+        {
+        writer->printf("%-20s %10" PRId32 " %8s %8s %8s %8s %8s %s\n",
+          it->first.c_str(), it->second->rxcount, "-", "-", "-", "-", "-", cbuf);
+        continue;
+        }
+      writer->printf("%-20s %10" PRId32 " %8.1f %8.1f %8.1f %8.1f %8.1f %s\n",
+        it->first.c_str(), it->second->rxcount,
+        st->ival ? 1000000.0 / st->ival : 0.0,
+        (float)st->ivalmin / 1000, (float)st->ival / 1000, (float)st->ivalmax / 1000,
+        (float)st->jitter / 1000, cbuf);
+      }
+    }
+  }
+
 void re_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   if (!MyRE)
@@ -531,7 +566,9 @@ void re_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, co
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  writer->printf("Key Map: %d entries\n",MyRE->m_rmap.size());
+  writer->printf("Key Map: %d entries (%d slots)\n",(int)MyRE->m_rmap.size(),(int)MyRE->m_rmap.Capacity());
+  if (MyRE->m_dropped)
+    writer->printf("         %" PRIu32 " frames dropped (out of memory)\n",MyRE->m_dropped);
   if (MyRE->m_rmap.size() > 0)
     {
     int nignored = 0;
@@ -539,9 +576,10 @@ void re_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, co
     int bchanged = 0;
     int ndiscovered = 0;
     int bdiscovered = 0;
-    for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+    for (size_t i=0; i<MyRE->m_rmap.Capacity(); i++)
       {
-      re_record_t *r = it->second;
+      re_record_t *r = MyRE->m_rmap.At(i);
+      if (r == NULL) continue;
       if (r->attr.b.Ignore) nignored++;
       if (r->attr.b.Changed) nchanged++;
       if (r->attr.b.Discovered) ndiscovered++;
@@ -610,10 +648,12 @@ void re_mode_discover(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (size_t i=0; i<MyRE->m_rmap.Capacity(); i++)
     {
-    it->second->attr.b.Discovered = 0;
-    it->second->attr.dd = 0;
+    re_record_t* r = MyRE->m_rmap.At(i);
+    if (r == NULL) continue;
+    r->attr.b.Discovered = 0;
+    r->attr.dd = 0;
     }
 
   MyRE->m_mode = Discover;
@@ -630,10 +670,12 @@ void re_clear_changed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (size_t i=0; i<MyRE->m_rmap.Capacity(); i++)
     {
-    it->second->attr.b.Changed = 0;
-    it->second->attr.dc = 0;
+    re_record_t* r = MyRE->m_rmap.At(i);
+    if (r == NULL) continue;
+    r->attr.b.Changed = 0;
+    r->attr.dc = 0;
     }
 
   if (MyNotify.HasReader("stream", "retools.list"))
@@ -656,10 +698,12 @@ void re_clear_discovered(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, in
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (size_t i=0; i<MyRE->m_rmap.Capacity(); i++)
     {
-    it->second->attr.b.Discovered = 0;
-    it->second->attr.dd = 0;
+    re_record_t* r = MyRE->m_rmap.At(i);
+    if (r == NULL) continue;
+    r->attr.b.Discovered = 0;
+    r->attr.dd = 0;
     }
 
   if (MyNotify.HasReader("stream", "retools.list"))
@@ -687,7 +731,9 @@ void re_list_changed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int ar
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
     if ((it->second->attr.b.Changed)||(it->second->attr.dc))
       {
@@ -718,7 +764,9 @@ void re_stream_changed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int
   writer->printf("[");
   int cnt = 0;
   char *ascii = NULL;
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
     if ((it->second->attr.b.Changed || it->second->attr.dc) &&
         (argc == 0 || strstr(it->first.c_str(),argv[0]) != NULL))
@@ -750,7 +798,9 @@ void re_list_discovered(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  re_record_list_t list;
+  MyRE->GetRecords(list);
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
     if ((it->second->attr.b.Discovered)||(it->second->attr.dd))
       {
@@ -803,6 +853,7 @@ REInit::REInit()
   cmd_re->RegisterCommand("clear","Clear RE records",re_clear);
   cmd_re->RegisterCommand("list","List RE records",re_list, "", 0, 1);
   cmd_re->RegisterCommand("status","Show RE status",re_status);
+  cmd_re->RegisterCommand("stats","Show RE frame rate & byte change statistics",re_stats, "[<filter>]", 0, 1);
 
   OvmsCommand* cmd_dbc = cmd_re->RegisterCommand("dbc","RE DBC framework");
   cmd_dbc->RegisterCommand("list","List RE DBC records",re_dbc_list, "", 0, 1);
@@ -43,6 +43,7 @@
 #include "ovms.h"
 #include "ovms_mutex.h"
 #include "ovms_netmanager.h"
+#include "retools_keymap.h"
 
 typedef struct
   {
@@ -64,9 +65,11 @@ typedef struct
     uint8_t dd;             // Data bytes discovered
     uint8_t spare;
     } attr;
+  re_stats_t stats;
   } re_record_t;
 
-typedef std::map<std::string, re_record_t*> re_record_map_t;
+typedef re_keymap<re_record_t> re_record_map_t;
+typedef std::map<std::string, re_record_t*> re_record_list_t;
 
 enum REMode { Analyse, Discover };
 
@@ -82,7 +85,9 @@ class re : public pcp, public ExternalRamAllocated
   public:
     void Task();
     void Clear();
-    std::string GetKey(CAN_frame_t* frame);
+    uint64_t GetKey(CAN_frame_t* frame);
+    std::string GetKeyName(uint64_t key);
+    void GetRecords(re_record_list_t& list);
 
   protected:
     void DoAnalyse(CAN_frame_t* frame);
@@ -96,6 +101,8 @@ class re : public pcp, public ExternalRamAllocated
     canfilter* m_filter;
     REMode m_mode;
     re_record_map_t m_rmap;
+    canbus* m_buses[RE_KEY_MAXBUS+1];
+    uint32_t m_dropped;
     uint32_t m_obdii_std_min;
     uint32_t m_obdii_std_max;
     uint32_t m_obdii_ext_min;
@@ -0,0 +1,300 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+#ifndef __RETOOLS_KEYMAP_H__
+#define __RETOOLS_KEYMAP_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include "ovms_malloc.h"
+
+/**
+ * RE record keys are packed into 64 bits:
+ *
+ *   bits  0..28  CAN ID
+ *   bit   29     extended frame
+ *   bits 30..32  bus index (0 = unknown origin, 1..7 = bus table slot)
+ *   bits 33..34  key type (plain / OBD request / OBD response / DBC multiplexor)
+ *   bits 35..63  type value:
+ *                  OBD: mode at 35..42, PID at 43..58
+ *                  mux: multiplexor value at 35..63 (29 bits)
+ *
+ * The string form ("can1/7e8:O2Pm1:12") is produced from the key by
+ * re_key_format() only when listing.
+ */
+
+#define RE_KEY_ID_MASK      0x1fffffffULL
+#define RE_KEY_EXT          (1ULL << 29)
+#define RE_KEY_BUS_SHIFT    30
+#define RE_KEY_BUS_MASK     0x7
+#define RE_KEY_TYPE_SHIFT   33
+#define RE_KEY_TYPE_MASK    0x3
+#define RE_KEY_VAL_SHIFT    35
+#define RE_KEY_MAXBUS       7
+
+#define RE_KEY_PLAIN        0
+#define RE_KEY_OBD_REQ      1
+#define RE_KEY_OBD_RSP      2
+#define RE_KEY_MUX          3
+
+inline uint64_t re_key(unsigned int bus, bool ext, uint32_t id)
+  {
+  return (id & RE_KEY_ID_MASK)
+    | (ext ? RE_KEY_EXT : 0)
+    | ((uint64_t)(bus & RE_KEY_BUS_MASK) << RE_KEY_BUS_SHIFT);
+  }
+
+inline unsigned int re_key_bus(uint64_t key)
+  {
+  return (key >> RE_KEY_BUS_SHIFT) & RE_KEY_BUS_MASK;
+  }
+
+/**
+ * re_key_obd: add the OBDII mode & PID of a request/response frame to the key.
+ *  Continuation frames (length byte > 8) keep the plain key.
+ */
+inline uint64_t re_key_obd(uint64_t key, const uint8_t* data)
+  {
+  if (data[0] > 8)
+    return key; // Probably just a continuation frame.
+  uint8_t mode = data[1];
+  uint64_t type = (mode > 0x40) ? RE_KEY_OBD_RSP : RE_KEY_OBD_REQ;
+  uint16_t pid = (mode > 0x4a || (mode <= 0x40 && mode > 0x0a))
+    ? ((uint16_t)data[2] << 8) + data[3]
+    : data[2];
+  return key
+    | (type << RE_KEY_TYPE_SHIFT)
+    | ((uint64_t)mode << RE_KEY_VAL_SHIFT)
+    | ((uint64_t)pid << (RE_KEY_VAL_SHIFT + 8));
+  }
+
+inline uint64_t re_key_mux(uint64_t key, uint32_t mux)
+  {
+  return key
+    | ((uint64_t)RE_KEY_MUX << RE_KEY_TYPE_SHIFT)
+    | ((uint64_t)(mux & 0x1fffffff) << RE_KEY_VAL_SHIFT);
+  }
+
+inline std::string re_key_format(uint64_t key, const char* busname)
+  {
+  char buf[48];
+  uint32_t id = key & RE_KEY_ID_MASK;
+  int len = snprintf(buf, sizeof(buf), (key & RE_KEY_EXT) ? "%s/%08x" : "%s/%03x",
+    busname ? busname : "can?", (unsigned int)id);
+  unsigned int mode = (key >> RE_KEY_VAL_SHIFT) & 0xff;
+  unsigned int pid = (key >> (RE_KEY_VAL_SHIFT + 8)) & 0xffff;
+  switch ((key >> RE_KEY_TYPE_SHIFT) & RE_KEY_TYPE_MASK)
+    {
+    case RE_KEY_OBD_REQ:
+      snprintf(buf+len, sizeof(buf)-len, ":O2Qm%u:%u", mode, pid);
+      break;
+    case RE_KEY_OBD_RSP:
+      snprintf(buf+len, sizeof(buf)-len, ":O2Pm%u:%u", mode - 0x40, pid);
+      break;
+    case RE_KEY_MUX:
+      snprintf(buf+len, sizeof(buf)-len, ":%04x", (unsigned int)(key >> RE_KEY_VAL_SHIFT));
+      break;
+    default:
+      break;
+    }
+  return std::string(buf);
+  }
+
+/**
+ * re_stats_t: frame timing & byte change statistics of a record
+ *
+ *  Inter-arrival times are in microseconds. The mean interval is an EWMA
+ *  (1/8 weight per frame), the jitter the EWMA (1/16) of the absolute deviation
+ *  from the mean, as used for RTP (RFC 3550). The frame rate is derived from
+ *  the mean interval when listing.
+ */
+typedef struct
+  {
+  uint32_t last;              // time of last frame [us]
+  uint32_t ival;              // mean interval [us]
+  uint32_t ivalmin;           // min interval [us]
+  uint32_t ivalmax;           // max interval [us]
+  uint32_t jitter;            // mean deviation [us]
+  uint16_t changes[8];        // changes per data byte (saturating)
+  } re_stats_t;
+
+inline void re_stats_update(re_stats_t* s, uint32_t rxcount, uint32_t now, uint8_t changed)
+  {
+  if (rxcount > 0)
+    {
+    uint32_t dt = now - s->last;
+    if (rxcount == 1)
+      {
+      s->ival = s->ivalmin = s->ivalmax = dt;
+      }
+    else
+      {
+      int32_t dev = (int32_t)(dt - s->ival);
+      s->ival += dev / 8;
+      if (dev < 0) dev = -dev;
+      s->jitter += (dev - (int32_t)s->jitter) / 16;
+      if (dt < s->ivalmin) s->ivalmin = dt;
+      if (dt > s->ivalmax) s->ivalmax = dt;
+      }
+    }
+  s->last = now;
+  for (int k=0; changed; k++, changed >>= 1)
+    {
+    if ((changed & 1) && s->changes[k] != 0xffff)
+      s->changes[k]++;
+    }
+  }
+
+/**
+ * re_keymap: open addressed hash table of records by packed key
+ *
+ *  Linear probing on a power of two slot array in external RAM, grown at 3/4
+ *  load. Records are allocated zeroed from external RAM on Insert() and stay
+ *  at their address until Clear(), so T needs to be a plain data type.
+ *  Iterate over the slots with Capacity() & At(). Not thread safe.
+ */
+
+#define RE_KEYMAP_INITIAL   256   // initial slots
+
+template <typename T> class re_keymap
+  {
+  public:
+    re_keymap()
+      {
+      m_slots = NULL;
+      m_capacity = 0;
+      m_size = 0;
+      }
+    ~re_keymap()
+      {
+      Clear();
+      }
+
+  private:
+    re_keymap(const re_keymap&) = delete;
+    re_keymap& operator=(const re_keymap&) = delete;
+
+  public:
+    size_t size() const { return m_size; }
+    size_t Capacity() const { return m_capacity; }
+
+    T* At(size_t index, uint64_t* key = NULL) const
+      {
+      if (index >= m_capacity) return NULL;
+      if (key) *key = m_slots[index].key;
+      return m_slots[index].value;
+      }
+
+    T* Find(uint64_t key) const
+      {
+      if (m_size == 0) return NULL;
+      size_t mask = m_capacity - 1;
+      for (size_t i = Hash(key) & mask; m_slots[i].value; i = (i + 1) & mask)
+        {
+        if (m_slots[i].key == key)
+          return m_slots[i].value;
+        }
+      return NULL;
+      }
+
+    // Add a new zeroed record for key (must not exist), NULL if out of memory
+    T* Insert(uint64_t key)
+      {
+      if ((m_size + 1) * 4 > m_capacity * 3)
+        {
+        if (!Resize(m_capacity ? m_capacity * 2 : RE_KEYMAP_INITIAL))
+          return NULL;
+        }
+      T* value = (T*)ExternalRamMalloc(sizeof(T));
+      if (!value) return NULL;
+      memset(value, 0, sizeof(T));
+      Place(m_slots, m_capacity, key, value);
+      m_size++;
+      return value;
+      }
+
+    void Clear()
+      {
+      for (size_t i = 0; i < m_capacity; i++)
+        {
+        if (m_slots[i].value) free(m_slots[i].value);
+        }
+      if (m_slots) free(m_slots);
+      m_slots = NULL;
+      m_capacity = 0;
+      m_size = 0;
+      }
+
+  protected:
+    typedef struct
+      {
+      uint64_t key;
+      T* value;
+      } slot_t;
+
+    static size_t Hash(uint64_t key)
+      {
+      // 64 bit finalizer of MurmurHash3:
+      key ^= key >> 33;
+      key *= 0xff51afd7ed558ccdULL;
+      key ^= key >> 33;
+      key *= 0xc4ceb9fe1a85ec53ULL;
+      key ^= key >> 33;
+      return (size_t)key;
+      }
+
+    static void Place(slot_t* slots, size_t capacity, uint64_t key, T* value)
+      {
+      size_t mask = capacity - 1;
+      size_t i = Hash(key) & mask;
+      while (slots[i].value)
+        i = (i + 1) & mask;
+      slots[i].key = key;
+      slots[i].value = value;
+      }
+
+    bool Resize(size_t capacity)
+      {
+      slot_t* slots = (slot_t*)ExternalRamMalloc(capacity * sizeof(slot_t));
+      if (!slots) return false;
+      memset(slots, 0, capacity * sizeof(slot_t));
+      for (size_t i = 0; i < m_capacity; i++)
+        {
+        if (m_slots[i].value)
+          Place(slots, capacity, m_slots[i].key, m_slots[i].value);
+        }
+      if (m_slots) free(m_slots);
+      m_slots = slots;
+      m_capacity = capacity;
+      return true;
+      }
+
+  protected:
+    slot_t*     m_slots;
+    size_t      m_capacity;
+    size_t      m_size;
+  };
+
+#endif //#ifndef __RETOOLS_KEYMAP_H__
@@ -0,0 +1,289 @@
+// bench_rekeymap.cpp — Native laptop benchmark for the RE tools record lookup.
+//
+// Replays a synthetic multi bus capture (periodic std & ext IDs, OBDII
+// responses in the configured range) through the former string key lookup
+// (bus name + sprintf of the ID & PID into a std::map<std::string>) and the
+// packed 64 bit key with the open addressed re_keymap. For every frame the
+// packed key formatted for listing must equal the former string key, and both
+// must end up with the same records & counts.
+//
+// Run:  make bench   (from the tests/ directory)
+
+#include "retools_keymap.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Frames & records (CAN_frame_t / re_record_t reduced to the used fields)
+// ---------------------------------------------------------------------------
+
+struct Frame {
+    int bus;            // 0 = unknown origin
+    bool ext;
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t data[8];
+    uint32_t time;      // [us]
+};
+
+struct Record {
+    Frame last;
+    uint32_t rxcount;
+    uint8_t dc;
+    re_stats_t stats;
+};
+
+static const char* busnames[RE_KEY_MAXBUS + 1] = { NULL, "can1", "can2", "can3" };
+
+static const uint32_t obd_min = 0x7e8, obd_max = 0x7ef;
+
+static bool IsObd(const Frame& f) {
+    return !f.ext && f.id >= obd_min && f.id <= obd_max;
+}
+
+static uint8_t Changed(const Record* r, const Frame& f) {
+    uint8_t changed = 0;
+    for (int k = 0; k < r->last.dlc; k++)
+        if (r->last.data[k] != f.data[k]) changed |= (1 << k);
+    return changed;
+}
+
+// ---------------------------------------------------------------------------
+// Former: string key, std::map
+// ---------------------------------------------------------------------------
+
+static std::string LegacyKey(const Frame& f) {
+    std::string key = busnames[f.bus] ? std::string(busnames[f.bus]) : std::string("can?");
+    key.append("/");
+    char id[9];
+    if (!f.ext)
+        sprintf(id, "%03" PRIx32, f.id);
+    else
+        sprintf(id, "%08" PRIx32, f.id);
+    key.append(id);
+    if (IsObd(f)) {
+        if (f.data[0] > 8) return key;
+        uint8_t mode = f.data[1];
+        char req[16];
+        if (mode > 0x4a)
+            sprintf(req, ":O2Pm%d:%d", mode - 0x40, ((int)f.data[2] << 8) + f.data[3]);
+        else if (mode > 0x40)
+            sprintf(req, ":O2Pm%d:%d", mode - 0x40, (int)f.data[2]);
+        else if (mode > 0x0a)
+            sprintf(req, ":O2Qm%d:%d", mode, ((int)f.data[2] << 8) + f.data[3]);
+        else
+            sprintf(req, ":O2Qm%d:%d", mode, (int)f.data[2]);
+        key.append(req);
+    }
+    return key;
+}
+
+struct Legacy {
+    std::map<std::string, Record*> rmap;
+
+    ~Legacy() { for (auto& it : rmap) delete it.second; }
+
+    void Analyse(const Frame& f) {
+        std::string key = LegacyKey(f);
+        auto k = rmap.find(key);
+        Record* r;
+        if (k == rmap.end()) {
+            r = new Record;
+            memset(r, 0, sizeof(Record));
+            r->dc = 0xff;
+            rmap[key] = r;
+        } else {
+            r = k->second;
+            r->dc |= Changed(r, f);
+        }
+        r->last = f;
+        r->rxcount++;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Packed key, re_keymap (as re::GetKey() & re::DoAnalyse())
+// ---------------------------------------------------------------------------
+
+static uint64_t PackedKey(const Frame& f) {
+    uint64_t key = re_key(f.bus, f.ext, f.id);
+    if (IsObd(f))
+        return re_key_obd(key, f.data);
+    return key;
+}
+
+struct Packed {
+    re_keymap<Record> rmap;
+    uint64_t lastkey = 0;
+
+    void Analyse(const Frame& f) {
+        uint64_t key = lastkey = PackedKey(f);
+        Record* r = rmap.Find(key);
+        uint8_t changed = 0;
+        if (r == NULL) {
+            r = rmap.Insert(key);
+            r->dc = 0xff;
+        } else {
+            changed = Changed(r, f);
+            r->dc |= changed;
+        }
+        re_stats_update(&r->stats, r->rxcount, f.time, changed);
+        r->last = f;
+        r->rxcount++;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Capture simulation
+// ---------------------------------------------------------------------------
+
+struct Source {
+    Frame frame;
+    uint32_t period;    // [us]
+    uint32_t next;
+};
+
+static std::vector<Frame> Capture(size_t count, int ids) {
+    std::mt19937 rng(4711);
+    std::vector<Source> sources;
+    for (int i = 0; i < ids; i++) {
+        Source s = {};
+        s.frame.bus = (i % 7 == 6) ? 0 : 1 + (i % 3);
+        s.frame.ext = (i % 10 == 9);
+        s.frame.id = s.frame.ext ? (0x18da0000 + rng() % 0xffff) : (0x100 + (i * 7) % 0x6e0);
+        if (!s.frame.ext && s.frame.id >= obd_min && s.frame.id <= obd_max) s.frame.id -= 0x100;
+        s.frame.dlc = 1 + rng() % 8;
+        s.period = 10000 * (1 + rng() % 100);
+        s.next = rng() % s.period;
+        sources.push_back(s);
+    }
+    // OBDII responses (mode 0x41 / 0x62) & continuation frames:
+    for (int i = 0; i < 8; i++) {
+        Source s = {};
+        s.frame.bus = 1;
+        s.frame.id = obd_min + (i % 2);
+        s.frame.dlc = 8;
+        s.period = 50000;
+        s.next = i * 6000;
+        sources.push_back(s);
+    }
+
+    std::vector<Frame> frames;
+    frames.reserve(count);
+    uint32_t pidrot = 0;
+    while (frames.size() < count) {
+        Source* s = &sources[0];
+        for (auto& c : sources) if (c.next < s->next) s = &c;
+        Frame f = s->frame;
+        f.time = s->next;
+        if (IsObd(f)) {
+            switch (pidrot++ % 3) {
+            case 0: f.data[0] = 3; f.data[1] = 0x41; f.data[2] = 0x0c + pidrot % 4; break;
+            case 1: f.data[0] = 6; f.data[1] = 0x62; f.data[2] = 0xf1; f.data[3] = pidrot % 16; break;
+            default: f.data[0] = 0x21; break;
+            }
+            f.data[4] = rng();
+        } else {
+            for (int k = 0; k < f.dlc; k++)
+                if (rng() % 4 == 0) s->frame.data[k] = f.data[k] = rng();
+        }
+        // Some jitter:
+        s->next += s->period + (rng() % 1000) - 500;
+        frames.push_back(f);
+    }
+    return frames;
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename T> static double Run(T& re, const std::vector<Frame>& frames) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (const Frame& f : frames) re.Analyse(f);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / frames.size();
+}
+
+int main() {
+    int failures = 0;
+    const size_t count = 500000;
+
+    // Key equivalence & table growth:
+    {
+        std::vector<Frame> frames = Capture(20000, 600);
+        Packed p;
+        for (const Frame& f : frames) {
+            p.Analyse(f);
+            std::string name = re_key_format(p.lastkey, busnames[re_key_bus(p.lastkey)]);
+            std::string legacy = LegacyKey(f);
+            if (name != legacy && failures++ < 10)
+                printf("FAIL: key %s != %s\n", name.c_str(), legacy.c_str());
+        }
+        if (re_key_format(re_key_mux(re_key(2, false, 0x3b3), 0x1a), "can2") != "can2/3b3:001a"
+            && failures++ < 10)
+            printf("FAIL: mux key\n");
+        re_keymap<Record> m;
+        for (uint32_t i = 0; i < 20000; i++)
+            m.Insert(re_key(1 + i % 3, i & 1, i))->rxcount = i;
+        for (uint32_t i = 0; i < 20000; i++) {
+            Record* r = m.Find(re_key(1 + i % 3, i & 1, i));
+            if ((!r || r->rxcount != i) && failures++ < 10)
+                printf("FAIL: lookup %u after growth\n", i);
+        }
+        if (m.Find(re_key(1, 0, 20001)) != NULL && failures++ < 10)
+            printf("FAIL: found missing key\n");
+        printf("Keys: %zu frames checked, map %zu entries / %zu slots\n",
+               frames.size(), m.size(), m.Capacity());
+    }
+
+    printf("\n%-8s %6s %12s %12s %8s\n", "ids", "keys", "former ns", "packed ns", "speedup");
+    for (int ids : { 50, 300, 1500 }) {
+        std::vector<Frame> frames = Capture(count, ids);
+        Legacy l;
+        Packed p;
+        double tl = Run(l, frames);
+        double tp = Run(p, frames);
+
+        // Same records & counts:
+        if (l.rmap.size() != p.rmap.size() && failures++ < 10)
+            printf("FAIL: %zu != %zu records\n", l.rmap.size(), p.rmap.size());
+        for (size_t i = 0; i < p.rmap.Capacity(); i++) {
+            uint64_t key;
+            Record* r = p.rmap.At(i, &key);
+            if (!r) continue;
+            auto it = l.rmap.find(re_key_format(key, busnames[re_key_bus(key)]));
+            if ((it == l.rmap.end() || it->second->rxcount != r->rxcount || it->second->dc != r->dc)
+                && failures++ < 10)
+                printf("FAIL: record %s differs\n", re_key_format(key, busnames[re_key_bus(key)]).c_str());
+        }
+        printf("%-8d %6zu %12.1f %12.1f %7.1fx\n", ids, p.rmap.size(), tl, tp, tl / tp);
+    }
+
+    // Rate statistics of a periodic ID with +-500 us jitter:
+    {
+        std::vector<Frame> frames = Capture(20000, 1);
+        Packed p;
+        Run(p, frames);
+        size_t first = 0;
+        while (IsObd(frames[first])) first++;
+        Record* r = p.rmap.Find(PackedKey(frames[first]));
+        double rate = r ? 1e6 / r->stats.ival : 0;
+        printf("\nStats: period %.1f ms, rate %.1f/s, min %.2f max %.2f jitter %.3f ms\n",
+               r ? r->stats.ival / 1000.0 : 0, rate,
+               r ? r->stats.ivalmin / 1000.0 : 0, r ? r->stats.ivalmax / 1000.0 : 0,
+               r ? r->stats.jitter / 1000.0 : 0);
+        if (!r || r->stats.ivalmin < r->stats.ival - 600 || r->stats.ivalmax > r->stats.ival + 600
+            || r->stats.jitter == 0 || r->stats.jitter > 500) {
+            failures++;
+            printf("FAIL: statistics\n");
+        }
+    }
+
+    printf("\n%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,8 @@
+// ovms_malloc.h — Heap allocator stand-ins for native laptop builds.
+
+#pragma once
+
+#include <cstdlib>
+
+inline void* ExternalRamMalloc(size_t size) { return malloc(size); }
+inline void* InternalRamMalloc(size_t size) { return malloc(size); }
@@ -311,7 +311,9 @@ OvmsReToolsPidScanner::OvmsReToolsPidScanner(
     xTaskCreatePinnedToCore(
         &OvmsReToolsPidScanner::Task, "OVMS RE PID", 4096, this, 5, &m_task, CORE(1)
     );
-    MyCan.RegisterListener(m_rxqueue, true);
+    canidset* filter = new canidset();
+    filter->Add(m_bus->m_busnumber+1, m_rxid_low, m_rxid_high);
+    MyCan.RegisterListener(m_rxqueue, true, filter, TAG);
     m_currentPid = m_startPid - m_pidStep;
     MyEvents.RegisterEvent(
         TAG, "ticker.1",
@@ -511,6 +511,7 @@ OvmsVehicle::OvmsVehicle()
 
 #ifdef CONFIG_OVMS_COMP_POLLER
   m_poll_state = 0;
+  m_poll_complete_responses = false;
   m_pollsignal = nullptr;
   m_poll_bus_default = nullptr;
 
@@ -607,7 +608,7 @@ OvmsVehicle::OvmsVehicle()
   m_vqueue = xQueueCreate(CONFIG_OVMS_VEHICLE_CAN_RX_QUEUE_SIZE,sizeof(CAN_frame_t));
   xTaskCreatePinnedToCore(OvmsVehicleTask, "OVMS Vehicle Poll",
       CONFIG_OVMS_VEHICLE_RXTASK_STACK, (void*)this, 10, &m_vtask, CORE(1));
-  MyCan.RegisterListener(m_vqueue);
+  MyCan.RegisterListener(m_vqueue, false, NULL, TAG);
   for (int idx = 0; idx < VEHICLE_MAXBUSSES; ++idx)
     m_autopoweroff[idx] = false;
 #endif
@@ -797,6 +798,17 @@ bool OvmsVehicle::OvmsVehicleSignal::Ready() const
   {
   return m_parent->m_ready;
   }
+
+bool OvmsVehicle::OvmsVehicleSignal::WantsPollResponse() const
+  {
+  return m_parent->m_poll_complete_responses;
+  }
+
+void OvmsVehicle::OvmsVehicleSignal::IncomingPollResponse(const OvmsPoller::poll_job_t &job, const uint8_t* data, uint16_t length)
+  {
+  if (Ready())
+    m_parent->IncomingPollResponse(job, data, length);
+  }
 #endif
 
 void OvmsVehicle::IncomingFrameCan1(CAN_frame_t* p_frame)
@@ -2917,6 +2929,24 @@ void OvmsVehicle::IncomingPollReply(const OvmsPoller::poll_job_t &job, uint8_t*
   {
   }
 
+/**
+ * IncomingPollResponse: complete poll response handler (stub, override with vehicle implementation)
+ *  Enabled by PollSetCompleteResponses(true), replaces IncomingPollReply() for the vehicle
+ *  poll list. Multi frame ISO-TP/VWTP responses are reassembled by the poller into a pooled
+ *  per bus buffer and delivered once, so there is no need to collect the fragments.
+ *  The job reflects the last frame received (mlremain = 0).
+ *
+ *  @param job
+ *    Status of the current Poll job
+ *  @param data
+ *    Complete payload, only valid for the duration of the call
+ *  @param length
+ *    Payload size (0…4095)
+ */
+void OvmsVehicle::IncomingPollResponse(const OvmsPoller::poll_job_t &job, const uint8_t* data, uint16_t length)
+  {
+  }
+
 /**
  * IncomingPollError: Calls Vehicle poll response error handler
  *  This is called by PollerReceive() on reception of an OBD/UDS Negative Response Code (NRC),
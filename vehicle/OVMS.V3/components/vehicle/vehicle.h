@@ -301,6 +301,14 @@ class OvmsVehicle : public InternalRamAllocated
     void PollSetResponseSeparationTime(uint8_t septime);
     void PollSetChannelKeepalive(uint16_t keepalive_seconds);
     void PollSetTimeBetweenSuccess(uint16_t tick_between_ms);
+    void PollSetBatching(uint8_t max_dids)
+      {
+      MyPollers.PollSetBatching(max_dids);
+      }
+    void PollSetCompleteResponses(bool enable)
+      {
+      m_poll_complete_responses = enable;
+      }
 #endif
 
     uint8_t GetBusNo(canbus* bus);
@@ -581,6 +589,9 @@ class OvmsVehicle : public InternalRamAllocated
       void IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success) override;
 
       bool Ready() const override;
+
+      bool WantsPollResponse() const override;
+      void IncomingPollResponse(const OvmsPoller::poll_job_t &job, const uint8_t* data, uint16_t length) override;
     };
 #endif
 
@@ -594,12 +605,14 @@ class OvmsVehicle : public InternalRamAllocated
     virtual void IncomingPollReply(const OvmsPoller::poll_job_t &job, uint8_t* data, uint8_t length);
     virtual void IncomingPollError(const OvmsPoller::poll_job_t &job, int32_t code);
     virtual void IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success);
+    virtual void IncomingPollResponse(const OvmsPoller::poll_job_t &job, const uint8_t* data, uint16_t length);
 #endif
 
   protected:
 #ifdef CONFIG_OVMS_COMP_POLLER
     OvmsVehicleSignal*m_pollsignal;
     uint8_t           m_poll_state;           // Current poll state
+    bool              m_poll_complete_responses; // Deliver reassembled responses via IncomingPollResponse()
     void PollRequest(canbus* bus, const std::string &name, const std::shared_ptr<OvmsPoller::PollSeriesEntry> &series);
     void RemovePollRequest(canbus* bus, const std::string &name);
     void IncomingRxFrame(const CAN_frame_t &frame);
@@ -30,6 +30,7 @@
 
 #include "vfsedit.h"
 #include "openemacs.h"
+#include "ovms_events.h"
 
 size_t vfs_edit_write(struct editor_state* E, const char *buf, size_t nbyte)
   {
@@ -54,6 +55,8 @@ bool vfs_edit_insert(OvmsWriter* writer, void* ctx, char ch)
   editor_process_keypress(ed, ch);
   if (ed->editor_completed)
     {
+    if (ed->filename)
+      MyEvents.SignalEvent("system.vfs.file.changed", ed->filename, strlen(ed->filename)+1);
     editor_free(ed);
     free(ed);
     writer->DeregisterTerminationCallback(vfs_edit_terminate);
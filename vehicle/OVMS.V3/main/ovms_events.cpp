@@ -57,7 +57,7 @@ static const char *TAG = "events";
 
 OvmsEvents MyEvents __attribute__ ((init_priority (1200)));
 
-static void CheckQueueOverflow(const char* from, char* event);
+static void CheckQueueOverflow(const char* from, const char* event);
 
 bool EventMap::GetCompletion(OvmsWriter* writer, const char* token) const
   {
@@ -105,10 +105,11 @@ void event_trace(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
 
 void event_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
-  writer->printf("Event map has %d listeners, and queue has %d/%d entries\n",
+  writer->printf("Event map has %d listeners, and queue has %d/%d entries (high water mark %" PRIu32 ")\n",
     MyEvents.Map().size(),
     uxQueueMessagesWaiting(MyEvents.m_taskqueue),
-    CONFIG_OVMS_HW_EVENT_QUEUE_SIZE);
+    CONFIG_OVMS_HW_EVENT_QUEUE_SIZE,
+    MyEvents.Stats().queue_max);
 
   EventCallbackEntry* cbe = MyEvents.m_current_callback;
   if (cbe != NULL)
@@ -120,6 +121,22 @@ void event_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
     }
   }
 
+void event_stats(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (argc > 0)
+    {
+    if (strcmp(argv[0], "-r") != 0)
+      {
+      cmd->PutUsage(writer);
+      return;
+      }
+    MyEvents.ResetStats();
+    writer->puts("Event statistics reset");
+    return;
+    }
+  MyEvents.ShowStats(writer);
+  }
+
 void event_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   std::string event;
@@ -205,6 +222,11 @@ OvmsEvents::OvmsEvents()
   ESP_LOGI(TAG, "Initialising EVENTS (1200)");
 
   m_current_callback = NULL;
+  m_anyhandlers = NULL;
+  for (int i = 0; i < EVENT_MAX_IDS; i++)
+    m_ids[i] = NULL;
+  m_ids_count = 1; // 0 = EVENT_ID_NONE
+  ResetStats();
 
 #ifdef CONFIG_OVMS_DEV_DEBUGEVENTS
   m_trace = true;
@@ -223,6 +245,8 @@ OvmsEvents::OvmsEvents()
   OvmsCommand* cmd_event = MyCommandApp.RegisterCommand("event","EVENT framework", event_status, "", 0, 0, false);
   cmd_event->RegisterCommand("status","Show status of event system",event_status);
   cmd_event->RegisterCommand("list","List registered events",event_list,"[<key>]", 0, 1);
+  cmd_event->RegisterCommand("stats","Show event dispatch statistics",event_stats,"[-r]\n"
+    "-r = reset statistics", 0, 1);
   cmd_event->RegisterCommand("raise","Raise a textual event",event_raise,"[-d<delay_ms>] <event>", 1, 2, true, event_validate);
   OvmsCommand* cmd_eventtrace = cmd_event->RegisterCommand("trace","EVENT trace framework");
   cmd_eventtrace->RegisterCommand("on","Turn event tracing ON",event_trace);
@@ -257,6 +281,9 @@ void OvmsEvents::EventTask()
     if (xQueueReceive(m_taskqueue, &msg, pdMS_TO_TICKS(5000)) == pdTRUE)
       {
       esp_task_wdt_reset(); // Reset WATCHDOG timer for this task
+      uint32_t waiting = uxQueueMessagesWaiting(m_taskqueue) + 1;
+      if (waiting > m_stats.queue_max)
+        m_stats.queue_max = waiting;
       switch(msg.type)
         {
         case EVENT_none:
@@ -268,6 +295,7 @@ void OvmsEvents::EventTask()
           HandleQueueRemoveHandlers(&msg);
           break;
         case EVENT_signal:
+        case EVENT_signalid:
           m_current_event = msg.body.signal.event;
           HandleQueueSignalEvent(&msg);
           esp_task_wdt_reset(); // Reset WATCHDOG timer for this task
@@ -310,6 +338,12 @@ bool OvmsEvents::IsEventsTask()
 
 void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
   {
+  uint32_t started = (uint32_t) esp_timer_get_time();
+  uint32_t wait = started - msg->queued;
+  m_stats.wait_total += wait;
+  if (wait > m_stats.wait_max)
+    m_stats.wait_max = wait;
+
   // Log everything but the ticker & clock signals
   if (!startsWith(m_current_event, "ticker.") && !startsWith(m_current_event, "clock."))
     {
@@ -330,42 +364,43 @@ void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
     OvmsRecMutexLock lock(&m_map_mutex);
 
     // run callbacks registered specifically for the event:
-    auto k = m_map.find(m_current_event);
-    if (k != m_map.end())
+    EventCallbackList* el;
+    if (msg->type == EVENT_signalid)
       {
-      EventCallbackList* el = k->second;
-      if (el)
+      el = m_ids[msg->body.signal.id]->handlers;
+      }
+    else
+      {
+      auto k = m_map.find(m_current_event);
+      el = (k != m_map.end()) ? k->second : NULL;
+      }
+    if (el)
+      {
+      for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
         {
-        for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
+        m_current_started = monotonictime;
+        m_current_callback = *itc;
+        if (m_current_callback->m_callback)
           {
-          m_current_started = monotonictime;
-          m_current_callback = *itc;
-          if (m_current_callback->m_callback)
-            {
-            m_current_callback->m_callback(m_current_event, msg->body.signal.data);
-            }
-          m_current_callback = NULL;
+          m_current_callback->m_callback(m_current_event, msg->body.signal.data);
           }
+        m_current_callback = NULL;
         }
       }
 
     // run callbacks registered for any event:
-    k = m_map.find("*");
-    if (k != m_map.end())
+    el = m_anyhandlers;
+    if (el)
       {
-      EventCallbackList* el = k->second;
-      if (el)
+      for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
         {
-        for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
+        m_current_started = monotonictime;
+        m_current_callback = *itc;
+        if (m_current_callback->m_callback)
           {
-          m_current_started = monotonictime;
-          m_current_callback = *itc;
-          if (m_current_callback->m_callback)
-            {
-            m_current_callback->m_callback(m_current_event, msg->body.signal.data);
-            }
-          m_current_callback = NULL;
+          m_current_callback->m_callback(m_current_event, msg->body.signal.data);
           }
+        m_current_callback = NULL;
         }
       }
     }
@@ -380,6 +415,20 @@ void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
   m_current_started = monotonictime;
   MyScripts.EventScript(m_current_event, msg->body.signal.data);
 
+  uint32_t duration = (uint32_t) esp_timer_get_time() - started;
+  m_stats.count++;
+  m_stats.time_total += duration;
+  if (duration > m_stats.time_max)
+    m_stats.time_max = duration;
+  if (msg->type == EVENT_signalid)
+    {
+    event_id_entry_t* entry = m_ids[msg->body.signal.id];
+    entry->count++;
+    entry->time_total += duration;
+    if (duration > entry->time_max)
+      entry->time_max = duration;
+    }
+
   FreeQueueSignalEvent(msg);
   }
 
@@ -391,7 +440,7 @@ void OvmsEvents::FreeQueueSignalEvent(event_queue_t* msg)
       EVPH_FreeData, &msg->body.phasedsignal.phasedata);
     free(msg->body.phasedsignal.event);
     }
-  else // msg->type == EVENT_signal
+  else // msg->type == EVENT_signal || msg->type == EVENT_signalid
     {
     if (msg->body.signal.donesemaphore != NULL)
       {
@@ -401,7 +450,135 @@ void OvmsEvents::FreeQueueSignalEvent(event_queue_t* msg)
       {
       msg->body.signal.donefn(msg->body.signal.event, msg->body.signal.data);
       }
-    free(msg->body.signal.event);
+    if (msg->type == EVENT_signal)
+      free(msg->body.signal.event);
+    }
+  }
+
+bool OvmsEvents::SendQueue(event_queue_t* msg)
+  {
+  msg->queued = (uint32_t) esp_timer_get_time();
+  return (xQueueSend(m_taskqueue, msg, 0) == pdTRUE);
+  }
+
+/**
+ * UpdateHandlers: update the pre-resolved handler lists for an event
+ *  (called with m_map_mutex held on creation/deletion of a handler list)
+ */
+void OvmsEvents::UpdateHandlers(const std::string& event, EventCallbackList* handlers)
+  {
+  if (event == "*")
+    m_anyhandlers = handlers;
+  for (int i = 1; i < m_ids_count; i++)
+    {
+    if (event == m_ids[i]->name)
+      {
+      m_ids[i]->handlers = handlers;
+      break;
+      }
+    }
+  }
+
+/**
+ * InternEvent: get the handle for an event name, registering it if necessary
+ *  Handles are meant for frequent events, the number is limited to EVENT_MAX_IDS.
+ *  Returns EVENT_ID_NONE if the table is full.
+ */
+event_id_t OvmsEvents::InternEvent(const char* event)
+  {
+  OvmsRecMutexLock lock(&m_map_mutex);
+
+  for (int i = 1; i < m_ids_count; i++)
+    {
+    if (strcmp(m_ids[i]->name, event) == 0)
+      return i;
+    }
+  if (m_ids_count == EVENT_MAX_IDS)
+    {
+    ESP_LOGE(TAG, "InternEvent: no free event ID for '%s'", event);
+    return EVENT_ID_NONE;
+    }
+
+  event_id_entry_t* entry = (event_id_entry_t*) ExternalRamCalloc(1, sizeof(event_id_entry_t));
+  char* name = entry ? strdup(event) : NULL;
+  if (!name)
+    {
+    ESP_LOGE(TAG, "InternEvent: out of memory for '%s'", event);
+    free(entry);
+    return EVENT_ID_NONE;
+    }
+  entry->name = name;
+  auto k = m_map.find(event);
+  entry->handlers = (k != m_map.end()) ? k->second : NULL;
+  m_ids[m_ids_count] = entry;
+  return m_ids_count++;
+  }
+
+const char* OvmsEvents::GetEventName(event_id_t id)
+  {
+  if (id == EVENT_ID_NONE || id >= m_ids_count)
+    return "";
+  return m_ids[id]->name;
+  }
+
+void OvmsEvents::SignalEvent(event_id_t id, void* data, event_signal_done_fn callback /*=NULL*/)
+  {
+  if (id == EVENT_ID_NONE || id >= m_ids_count)
+    {
+    ESP_LOGE(TAG, "SignalEvent: invalid event ID %u, dropped", id);
+    if (callback)
+      callback("", data);
+    return;
+    }
+
+  event_queue_t msg;
+  memset(&msg, 0, sizeof(msg));
+
+  msg.type = EVENT_signalid;
+  msg.body.signal.event = (char*) m_ids[id]->name;
+  msg.body.signal.id = id;
+  msg.body.signal.data = data;
+  msg.body.signal.donefn = callback;
+
+  if (!SendQueue(&msg))
+    {
+    CheckQueueOverflow("SignalEvent", msg.body.signal.event);
+    FreeQueueSignalEvent(&msg);
+    }
+  }
+
+void OvmsEvents::ResetStats()
+  {
+  memset(&m_stats, 0, sizeof(m_stats));
+  m_stats.started = monotonictime;
+  for (int i = 1; i < m_ids_count; i++)
+    {
+    m_ids[i]->count = 0;
+    m_ids[i]->time_total = 0;
+    m_ids[i]->time_max = 0;
+    }
+  }
+
+void OvmsEvents::ShowStats(OvmsWriter* writer)
+  {
+  uint32_t elapsed = monotonictime - m_stats.started;
+  uint32_t count = m_stats.count;
+  writer->printf("Signals:  %" PRIu32 " in %" PRIu32 " seconds = %.1f/s\n",
+    count, elapsed, elapsed ? (float)count / elapsed : 0.0f);
+  writer->printf("Queue:    high water mark %" PRIu32 "/%d, wait avg %" PRIu32 " us, max %" PRIu32 " us\n",
+    m_stats.queue_max, CONFIG_OVMS_HW_EVENT_QUEUE_SIZE,
+    count ? (uint32_t)(m_stats.wait_total / count) : 0, m_stats.wait_max);
+  writer->printf("Dispatch: avg %" PRIu32 " us, max %" PRIu32 " us\n",
+    count ? (uint32_t)(m_stats.time_total / count) : 0, m_stats.time_max);
+  if (m_ids_count > 1)
+    {
+    writer->puts("Interned events:");
+    for (int i = 1; i < m_ids_count; i++)
+      {
+      event_id_entry_t* entry = m_ids[i];
+      writer->printf("  %-24s %8" PRIu32 " signals, avg %6" PRIu32 " us, max %6" PRIu32 " us\n",
+        entry->name, entry->count, entry->count ? entry->time_total / entry->count : 0, entry->time_max);
+      }
     }
   }
 
@@ -437,6 +614,8 @@ void OvmsEvents::HandleQueueAddHandler(event_queue_t* msg)
     {
     m_map[event] = new EventCallbackList();
     k = m_map.find(event);
+    if (k != m_map.end())
+      UpdateHandlers(event, k->second);
     }
   if (k == m_map.end())
     {
@@ -523,6 +702,7 @@ void OvmsEvents::HandleQueueRemoveHandlers(event_queue_t* msg)
       }
     if (el->empty())
       {
+      UpdateHandlers(itm->first, NULL);
       itm = m_map.erase(itm);
       delete el;
       }
@@ -535,7 +715,7 @@ void OvmsEvents::HandleQueueRemoveHandlers(event_queue_t* msg)
   free(msg->body.removehandlers.caller);
   }
 
-static void CheckQueueOverflow(const char* from, char* event)
+static void CheckQueueOverflow(const char* from, const char* event)
   {
   EventCallbackEntry* cbe = MyEvents.m_current_callback;
   if (cbe != NULL)
@@ -583,7 +763,7 @@ void OvmsEvents::SignalScheduledEvent(TimerHandle_t timer)
     }
 
   // … and pass on to event task:
-  if (xQueueSend(MyEvents.m_taskqueue, msg, 0) != pdTRUE)
+  if (!MyEvents.SendQueue(msg))
     {
     CheckQueueOverflow("SignalScheduledEvent", msg->body.signal.event);
     MyEvents.FreeQueueSignalEvent(msg);
@@ -663,7 +843,7 @@ void OvmsEvents::SignalEvent(std::string event, void* data, event_signal_done_fn
 
   if (delay_ms == 0)
     {
-    if (xQueueSend(m_taskqueue, &msg, 0) != pdTRUE)
+    if (!SendQueue(&msg))
       {
       CheckQueueOverflow("SignalEvent", msg.body.signal.event);
       FreeQueueSignalEvent(&msg);
@@ -694,7 +874,7 @@ void OvmsEvents::SignalEvent(std::string event, void* data, event_signal_phase_f
 
   if (delay_ms == 0)
     {
-    if (xQueueSend(m_taskqueue, &msg, 0) != pdTRUE)
+    if (!SendQueue(&msg))
       {
       CheckQueueOverflow("SignalEvent", msg.body.phasedsignal.event);
       FreeQueueSignalEvent(&msg);
@@ -723,7 +903,7 @@ void OvmsEvents::SignalEvent(std::string event, void* data, OvmsSemaphore& semap
 
   if (delay_ms == 0)
     {
-    if (xQueueSend(m_taskqueue, &msg, 0) != pdTRUE)
+    if (!SendQueue(&msg))
       {
       CheckQueueOverflow("SignalEvent", msg.body.signal.event);
       FreeQueueSignalEvent(&msg);
@@ -762,7 +942,7 @@ void OvmsEvents::SignalEvent(std::string event, void* data, size_t length,
 
   if (delay_ms == 0)
     {
-    if (xQueueSend(m_taskqueue, &msg, 0) != pdTRUE)
+    if (!SendQueue(&msg))
       {
       CheckQueueOverflow("SignalEvent", msg.body.signal.event);
       FreeQueueSignalEvent(&msg);
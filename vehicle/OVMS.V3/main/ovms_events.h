@@ -72,6 +72,32 @@ class EventMap : public  std::map<std::string, EventCallbackList*>
 
 typedef void (*event_signal_done_fn)(const char* event, void* data);
 
+// Interned event IDs: register frequent events once by name to get a handle,
+//  signalling by handle avoids the name allocation & handler map lookup.
+typedef uint16_t event_id_t;
+#define EVENT_ID_NONE     0
+#define EVENT_MAX_IDS     128
+
+typedef struct
+  {
+  const char* name;
+  EventCallbackList* handlers;  // pre-resolved handler list, NULL = no handlers
+  uint32_t count;               // signals delivered
+  uint32_t time_total;          // dispatch time [us]
+  uint32_t time_max;            // max dispatch time [us]
+  } event_id_entry_t;
+
+typedef struct
+  {
+  uint32_t count;               // signals delivered
+  uint32_t started;             // monotonictime of stats start/reset
+  uint64_t wait_total;          // queue wait time [us]
+  uint32_t wait_max;
+  uint64_t time_total;          // dispatch time [us]
+  uint32_t time_max;
+  uint32_t queue_max;           // queue high water mark
+  } event_stats_t;
+
 typedef enum
   {
   EVPH_PreCallbackLoop,       // Before execution of all registered listener callbacks
@@ -89,6 +115,7 @@ typedef enum
   EVENT_removehandlers,       // Remove event handlers
   EVENT_signal,               // Raise a signal, optionally with a "done" callback and/or semaphore
   EVENT_phasedsignal,         // Raise a signal with an associated phase callback
+  EVENT_signalid,             // Raise a signal by interned event ID, optionally with a "done" callback
   } event_msg_t;
 
 typedef struct
@@ -110,6 +137,7 @@ typedef struct
       void* data;
       event_signal_done_fn donefn;
       OvmsSemaphore* donesemaphore;
+      event_id_t id;          // EVENT_signalid: event points to the interned name
       } signal;
     struct
       {
@@ -120,6 +148,7 @@ typedef struct
       } phasedsignal;
     } body;
   event_msg_t type;
+  uint32_t queued;            // esp_timer time of queueing [us]
   } event_queue_t;
 
 typedef std::list<TimerHandle_t> TimerList;
@@ -139,6 +168,11 @@ class OvmsEvents
     void SignalEvent(std::string event, void* data, OvmsSemaphore& semaphore, uint32_t delay_ms = 0);
     void SignalEvent(std::string event, void* data, size_t length, uint32_t delay_ms = 0);
 
+  public:
+    event_id_t InternEvent(const char* event);
+    const char* GetEventName(event_id_t id);
+    void SignalEvent(event_id_t id, void* data, event_signal_done_fn callback = NULL);
+
   public:
     void EventTask();
     bool IsEventsTask();
@@ -150,6 +184,9 @@ class OvmsEvents
     void SignalSystemEvent(system_event_t *event);
 #endif
     const EventMap& Map() { return m_map; }
+    const event_stats_t& Stats() { return m_stats; }
+    void ResetStats();
+    void ShowStats(OvmsWriter* writer);
 
   protected:
     void HandleQueueSignalEvent(event_queue_t* msg);
@@ -160,9 +197,17 @@ class OvmsEvents
     bool ScheduleEvent(event_queue_t* msg, uint32_t delay_ms);
     static void SignalScheduledEvent(TimerHandle_t timer);
 
+  protected:
+    bool SendQueue(event_queue_t* msg);
+    void UpdateHandlers(const std::string& event, EventCallbackList* handlers);
+
   protected:
     EventMap m_map;
     OvmsRecMutex m_map_mutex;
+    event_id_entry_t* m_ids[EVENT_MAX_IDS];       // interned events by ID
+    event_id_t m_ids_count;                       // guarded by m_map_mutex on write
+    EventCallbackList* m_anyhandlers;             // pre-resolved handlers for "*"
+    event_stats_t m_stats;
     TimerList m_timers;
     TimerStatusMap m_timer_active;
     OvmsMutex m_timers_mutex;
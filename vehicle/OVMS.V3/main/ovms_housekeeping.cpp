@@ -100,6 +100,8 @@ void HousekeepingUpdate12V()
 #endif // #ifdef CONFIG_OVMS_COMP_ADC
   }
 
+static event_id_t ev_ticker_1, ev_ticker_10, ev_ticker_60, ev_ticker_300, ev_ticker_600, ev_ticker_3600;
+
 void HousekeepingTicker1( TimerHandle_t timer )
   {
   // Workaround for FreeRTOS duplicate timer callback bug
@@ -114,25 +116,25 @@ void HousekeepingTicker1( TimerHandle_t timer )
   StandardMetrics.ms_m_timeutc->SetValue(time(NULL));
 
   HousekeepingUpdate12V();
-  MyEvents.SignalEvent("ticker.1", NULL);
+  MyEvents.SignalEvent(ev_ticker_1, NULL);
 
   tick++;
   if ((tick % 10)==0)
     {
-    MyEvents.SignalEvent("ticker.10", NULL);
+    MyEvents.SignalEvent(ev_ticker_10, NULL);
     if ((tick % 60)==0)
       {
-      MyEvents.SignalEvent("ticker.60", NULL);
+      MyEvents.SignalEvent(ev_ticker_60, NULL);
       if ((tick % 300)==0)
         {
-        MyEvents.SignalEvent("ticker.300", NULL);
+        MyEvents.SignalEvent(ev_ticker_300, NULL);
         if ((tick % 600)==0)
           {
-          MyEvents.SignalEvent("ticker.600", NULL);
+          MyEvents.SignalEvent(ev_ticker_600, NULL);
           if ((tick % 3600)==0)
             {
             tick = 0;
-            MyEvents.SignalEvent("ticker.3600", NULL);
+            MyEvents.SignalEvent(ev_ticker_3600, NULL);
             }
           }
         }
@@ -164,6 +166,14 @@ Housekeeping::Housekeeping()
   MyConfig.RegisterParam("system.adc", "ADC configuration", true, true);
   MyConfig.RegisterParam("auto", "Auto init configuration", true, true);
 
+  // Intern our ticker events:
+  ev_ticker_1 = MyEvents.InternEvent("ticker.1");
+  ev_ticker_10 = MyEvents.InternEvent("ticker.10");
+  ev_ticker_60 = MyEvents.InternEvent("ticker.60");
+  ev_ticker_300 = MyEvents.InternEvent("ticker.300");
+  ev_ticker_600 = MyEvents.InternEvent("ticker.600");
+  ev_ticker_3600 = MyEvents.InternEvent("ticker.3600");
+
   // Register our events
   #undef bind  // Kludgy, but works
   using std::placeholders::_1;
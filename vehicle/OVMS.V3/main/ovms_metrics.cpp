@@ -42,12 +42,16 @@ static const char *TAG = "metrics";
 #include "ovms_events.h"
 #include "ovms_script.h"
 #include "ovms_config.h"
+#include "ovms_pjournal.h"
 #include "rom/rtc.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
 #include "string.h"
 #include <iomanip>
 #include <locale>
 #include <time.h>
 #include <math.h>
+#include <inttypes.h>
 
 using namespace std;
 
@@ -57,9 +61,31 @@ using namespace std;
 RTC_NOINIT_ATTR persistent_metrics      pmetrics;             // persistent storage container
 #define NUM_PERSISTENT_VALUES           sizeof_array(pmetrics.values)
 static const char*                      pmetrics_reason;      // reason pmetrics was zeroed
+static portMUX_TYPE                     modqueue_spinlock = portMUX_INITIALIZER_UNLOCKED;
 std::map<std::size_t, std::string>      pmetrics_keymap       // hash key → metric name map (registry)
                                         __attribute__ ((init_priority (1800)));
 
+// Flash journal (optional "pmetrics" data partition): restores the persistent
+// values on cold boot & provides slots beyond the RTC container
+#define PMETRICS_JOURNAL_PARTITION      "pmetrics"
+#define PMETRICS_JOURNAL_SCALAR         1                     // record types
+#define PMETRICS_JOURNAL_ARRAY          0x80                  //  ORed with the element size
+#define PMETRICS_OVERFLOW_CHUNK         32                    // slots allocated per chunk
+
+typedef std::unordered_map<std::size_t, persistent_values*, std::hash<std::size_t>, std::equal_to<std::size_t>,
+  ExtRamAllocator<std::pair<const std::size_t, persistent_values*>>> pmetrics_index_t;
+
+static OvmsPersistJournal*              pmetrics_journal = NULL;
+static OvmsMutex                        pmetrics_mutex        // index & overflow slots
+                                        __attribute__ ((init_priority (1800)));
+static pmetrics_index_t                 pmetrics_index        // hash key → slot (RTC & overflow)
+                                        __attribute__ ((init_priority (1800)));
+static std::vector<persistent_values*>  pmetrics_overflow     // overflow slot chunks
+                                        __attribute__ ((init_priority (1800)));
+static int                              pmetrics_overflow_used = 0;
+static std::set<std::size_t>            pmetrics_unjournaled  // slots journaled by their metric
+                                        __attribute__ ((init_priority (1800)));
+
 OvmsMetrics                             MyMetrics
                                         __attribute__ ((init_priority (1800)));
 
@@ -647,6 +673,8 @@ void metrics_persist(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int ar
       return;
       }
     pmetrics.magic = 0;
+    if (pmetrics_journal && !pmetrics_journal->Format())
+      writer->puts("ERROR: flash journal format failed");
     }
   if (pmetrics.magic != PERSISTENT_METRICS_MAGIC)
     writer->puts("Persistent metrics will be reset on the next boot");
@@ -656,6 +684,21 @@ void metrics_persist(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int ar
     writer->printf("%s caused reset, ", pmetrics_reason);
   writer->printf("%d bytes, and ", pmetrics.size);
   writer->printf("%d of %d slots used\n", pmetrics.used, NUM_PERSISTENT_VALUES);
+
+  if (!pmetrics_journal)
+    {
+    writer->puts("Flash journal: no '" PMETRICS_JOURNAL_PARTITION "' partition");
+    return;
+    }
+  pjournal_stats_t st;
+  pmetrics_journal->GetStats(&st);
+  writer->printf("Flash journal: %d overflow slots used, %" PRIu32 " records using %" PRIu32 " bytes in %" PRIu32 " sectors\n",
+    pmetrics_overflow_used, st.records, st.livebytes, st.sectors);
+  writer->printf("  since boot: %" PRIu64 " bytes written for %" PRIu64 " bytes of data, %" PRIu32 " records reclaimed,"
+    " %" PRIu32 " unchanged, %" PRIu32 " failed\n",
+    st.flashbytes, st.userbytes, st.collected, st.skipped, st.failed);
+  writer->printf("  erasures: %" PRIu32 " since boot, %" PRIu32 "..%" PRIu32 " per sector\n",
+    st.erasures, st.erasures_min, st.erasures_max);
   }
 
 static int metrics_set_validate(OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv, bool complete)
@@ -749,13 +792,37 @@ bool pmetrics_check()
 
 static persistent_values *pmetrics_find_hash(size_t namehash)
   {
-  int i;
-  persistent_values *vp;
-  for (i = 0, vp = pmetrics.values; i < pmetrics.used; ++i, ++vp) {
-    if (vp->namehash == namehash)
-      return vp;
+  OvmsMutexLock lock(&pmetrics_mutex);
+  auto it = pmetrics_index.find(namehash);
+  if (it == pmetrics_index.end() || it->second->namehash != namehash)
+    return NULL;
+  return it->second;
+  }
+
+static void pmetrics_reindex()
+  {
+  OvmsMutexLock lock(&pmetrics_mutex);
+  pmetrics_index.clear();
+  for (int i = 0; i < pmetrics.used; i++)
+    pmetrics_index[pmetrics.values[i].namehash] = &pmetrics.values[i];
+  for (int i = 0; i < pmetrics_overflow_used; i++)
+    {
+    persistent_values *vp = &pmetrics_overflow[i / PMETRICS_OVERFLOW_CHUNK][i % PMETRICS_OVERFLOW_CHUNK];
+    pmetrics_index[vp->namehash] = vp;
     }
-  return NULL;
+  }
+
+static persistent_values *pmetrics_overflow_alloc()
+  {
+  size_t chunk = pmetrics_overflow_used / PMETRICS_OVERFLOW_CHUNK;
+  if (chunk == pmetrics_overflow.size())
+    {
+    persistent_values *vp = (persistent_values*)ExternalRamCalloc(PMETRICS_OVERFLOW_CHUNK, sizeof(persistent_values));
+    if (!vp)
+      return NULL;
+    pmetrics_overflow.push_back(vp);
+    }
+  return &pmetrics_overflow[chunk][pmetrics_overflow_used++ % PMETRICS_OVERFLOW_CHUNK];
   }
 
 persistent_values *pmetrics_find(const char *name)
@@ -776,6 +843,7 @@ void pmetrics_init(bool refresh = false)
   pmetrics.magic = PERSISTENT_METRICS_MAGIC;
   pmetrics.version = PERSISTENT_VERSION;
   pmetrics.size = sizeof(persistent_metrics);
+  pmetrics_reindex();
   if (refresh)
     {
     for (OvmsMetric* m = MyMetrics.m_first; m != NULL; m = m->m_next)
@@ -783,17 +851,17 @@ void pmetrics_init(bool refresh = false)
     }
   }
 
-persistent_values *pmetrics_register(const char *name)
+persistent_values *pmetrics_register(const char *name, bool journal /*=true*/)
   {
   std::string str_name(name);
-  return pmetrics_register(str_name);
+  return pmetrics_register(str_name, journal);
   }
 
-persistent_values *pmetrics_register(const std::string &name)
+persistent_values *pmetrics_register(const std::string &name, bool journal /*=true*/)
   {
-  int i;
   persistent_values *vp;
   std::size_t namehash = std::hash<std::string>{}(name);
+  OvmsMutexLock lock(&pmetrics_mutex);
 
   // check for hash collision:
   auto it = pmetrics_keymap.find(namehash);
@@ -805,31 +873,180 @@ persistent_values *pmetrics_register(const std::string &name)
     }
 
   // find slot:
-  for (i = 0, vp = pmetrics.values; i < pmetrics.used; ++i, ++vp)
+  auto slot = pmetrics_index.find(namehash);
+  if (slot != pmetrics_index.end() && slot->second->namehash == namehash)
     {
-    if (vp->namehash == namehash)
-      break;
+    vp = slot->second;
     }
-
-  // not found? assign to next free slot:
-  if (i >= pmetrics.used)
+  else
     {
-    if (i >= NUM_PERSISTENT_VALUES)
+    // not found? assign to next free slot, with the flash journal beyond
+    // the RTC container to an overflow slot:
+    if (pmetrics.used < NUM_PERSISTENT_VALUES)
+      vp = &pmetrics.values[pmetrics.used++];
+    else if (pmetrics_journal)
+      vp = pmetrics_overflow_alloc();
+    else
+      vp = NULL;
+    if (!vp)
       {
       ESP_LOGE(TAG, "pmetrics_register: no free slots, cannot persist '%s'", name.c_str());
       return NULL;
       }
     vp->namehash = namehash;
     memset(&vp->value, 0, sizeof(vp->value));
-    ++pmetrics.used;
+    pmetrics_index[namehash] = vp;
+
+    // new slot, i.e. cold boot or overflow: restore from the flash journal
+    uint8_t type;
+    persistent_value_t value;
+    if (pmetrics_journal && journal
+      && pmetrics_journal->Read(namehash, &type, &value, sizeof(value)) == sizeof(value)
+      && type == PMETRICS_JOURNAL_SCALAR)
+      {
+      vp->value = value;
+      }
     }
 
-  ESP_LOGD(TAG, "pmetrics_register: '%s' => slot=%d, used %d/%d",
-    name.c_str(), i, pmetrics.used, NUM_PERSISTENT_VALUES);
+  if (vp >= pmetrics.values && vp < pmetrics.values + NUM_PERSISTENT_VALUES)
+    ESP_LOGD(TAG, "pmetrics_register: '%s' => slot=%d, used %d/%d",
+      name.c_str(), (int)(vp - pmetrics.values), pmetrics.used, NUM_PERSISTENT_VALUES);
+  else
+    ESP_LOGD(TAG, "pmetrics_register: '%s' => overflow slot, %d used",
+      name.c_str(), pmetrics_overflow_used);
   pmetrics_keymap[namehash] = name;
+  if (!journal)
+    pmetrics_unjournaled.insert(namehash);
   return vp;
   }
 
+bool pmetrics_register_array(const char *name)
+  {
+  if (!pmetrics_journal)
+    return false;
+  std::string str_name(name);
+  std::size_t namehash = std::hash<std::string>{}(str_name);
+  OvmsMutexLock lock(&pmetrics_mutex);
+
+  // check for hash collision:
+  auto it = pmetrics_keymap.find(namehash);
+  if (it != pmetrics_keymap.end() && (it->second != str_name) )
+    {
+    ESP_LOGE(TAG, "pmetrics_register_array: cannot persist '%s' due to hash collision with '%s'",
+      name, it->second.c_str());
+    return false;
+    }
+  pmetrics_keymap[namehash] = str_name;
+  return true;
+  }
+
+int pmetrics_array_read(const char *name, void *data, size_t elemsize, size_t count)
+  {
+  if (!pmetrics_journal)
+    return -1;
+  std::size_t namehash = std::hash<std::string>{}(name);
+  uint8_t type;
+  if (pmetrics_journal->Read(namehash, &type, NULL, 0) < 0 || type != (PMETRICS_JOURNAL_ARRAY | elemsize))
+    return -1;
+  int len = pmetrics_journal->Read(namehash, &type, data, count * elemsize);
+  return (len < 0) ? -1 : len / elemsize;
+  }
+
+bool pmetrics_array_write(const char *name, const void *data, size_t elemsize, size_t count)
+  {
+  if (!pmetrics_journal)
+    return false;
+  if (count * elemsize > PJOURNAL_MAX_LENGTH)
+    {
+    ESP_LOGE(TAG, "pmetrics_array_write: cannot persist '%s', %zu elements exceed the record size",
+      name, count);
+    return false;
+    }
+  std::size_t namehash = std::hash<std::string>{}(name);
+  return pmetrics_journal->Write(namehash, PMETRICS_JOURNAL_ARRAY | elemsize, data, count * elemsize);
+  }
+
+/**
+ * pmetrics_sync: write changed persistent values to the flash journal
+ *  (scalar slots & array metrics). Called every 5 minutes & on shutdown, the
+ *  RTC container keeps the current values over crashes & warm reboots.
+ *  The slots are single 32 bit words, so reading them while a metric gets
+ *  set is safe. Metrics using multiple slots (vectors, 64 bit values) are
+ *  not journaled by slot, they write a consistent record in SyncPersist().
+ *  The caller needs to verify the container by pmetrics_check() first.
+ */
+static void pmetrics_sync()
+  {
+  if (!pmetrics_journal)
+    return;
+
+  // Scalar slots:
+  if (pmetrics_mutex.Lock())
+    {
+    for (auto &it : pmetrics_index)
+      {
+      if (it.second->namehash == it.first && pmetrics_unjournaled.count(it.first) == 0)
+        pmetrics_journal->Write(it.first, PMETRICS_JOURNAL_SCALAR, &it.second->value, sizeof(persistent_value_t));
+      }
+    pmetrics_mutex.Unlock();
+    }
+
+  // Vectors & 64 bit metrics:
+  for (OvmsMetric* m = MyMetrics.m_first; m != NULL; m = m->m_next)
+    {
+    if (m->m_persist)
+      m->SyncPersist();
+    }
+  }
+
+class OvmsPersistPartition : public OvmsPersistFlash
+  {
+  public:
+    OvmsPersistPartition(const esp_partition_t* partition) { m_partition = partition; }
+    size_t Size() override
+      {
+      return m_partition->size & ~(PJOURNAL_SECTOR_SIZE-1);
+      }
+    bool Read(size_t offset, void* data, size_t size) override
+      {
+      return esp_partition_read(m_partition, offset, data, size) == ESP_OK;
+      }
+    bool Write(size_t offset, const void* data, size_t size) override
+      {
+      return esp_partition_write(m_partition, offset, data, size) == ESP_OK;
+      }
+    bool Erase(size_t offset) override
+      {
+      return esp_partition_erase_range(m_partition, offset, PJOURNAL_SECTOR_SIZE) == ESP_OK;
+      }
+
+  protected:
+    const esp_partition_t* m_partition;
+  };
+
+static void pmetrics_journal_mount()
+  {
+  const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+    ESP_PARTITION_SUBTYPE_ANY, PMETRICS_JOURNAL_PARTITION);
+  if (!partition)
+    return;
+  int64_t start = esp_timer_get_time();
+  OvmsPersistPartition* flash = new OvmsPersistPartition(partition);
+  OvmsPersistJournal* journal = new OvmsPersistJournal(flash);
+  if (!journal->Mount())
+    {
+    ESP_LOGE(TAG, "Persistent metrics flash journal: mount failed");
+    delete journal;
+    delete flash;
+    return;
+    }
+  pjournal_stats_t st;
+  journal->GetStats(&st);
+  ESP_LOGI(TAG, "Persistent metrics flash journal: %" PRIu32 " records in %" PRIu32 " sectors, mounted in %" PRId64 " ms",
+    st.records, st.sectors, (esp_timer_get_time() - start) / 1000);
+  pmetrics_journal = journal;
+  }
+
 void OvmsMetrics::EventSystemShutDown(std::string event, void* data)
   {
   /* Check for corruption and repair of possible before shutting down */
@@ -838,6 +1055,21 @@ void OvmsMetrics::EventSystemShutDown(std::string event, void* data)
     ESP_LOGI(TAG, "Persistent metrics shutdown check failed");
     pmetrics_init(true);
     }
+
+  pmetrics_sync();
+  }
+
+void OvmsMetrics::EventTicker300(std::string event, void* data)
+  {
+  /* Don't write corrupted values to the journal, the shutdown will repair them */
+  if (!pmetrics_journal)
+    return;
+  if (!pmetrics_check())
+    {
+    ESP_LOGW(TAG, "Persistent metrics check failed, journal sync skipped");
+    return;
+    }
+  pmetrics_sync();
   }
 
 void metrics_trace(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
@@ -1087,6 +1319,9 @@ OvmsMetrics::OvmsMetrics()
   ESP_LOGI(TAG, "Initialising METRICS (1810)");
 
   m_nextmodifier = 1;
+  for (int i = 0; i < METRICS_MAX_MODIFIERS; i++)
+    m_modqueue[i] = NULL;
+  m_modqueue_mask = 0;
   m_first = NULL;
   m_trace = false;
 
@@ -1103,7 +1338,7 @@ OvmsMetrics::OvmsMetrics()
       "-s = show metric staleness\n"
       "-t = display non-printing characters and tabs in string metrics" , 0, 2);
   cmd_metric->RegisterCommand("persist","Show persistent metrics info", metrics_persist, "[-r]\n"
-      "-r = reset persistent metrics", 0, 1);
+      "-r = reset persistent metrics (including the flash journal)", 0, 1);
   cmd_metric->RegisterCommand("set","Set the value of a metric",metrics_set, "<metric> <value> [<unit>]", 2, 3, true, metrics_set_validate);
 
   cmd_metric->RegisterCommand("get","Get the value of a metric",metrics_get, "<metric> [<unit>]", 1, 2, true, metrics_get_validate);
@@ -1130,6 +1365,9 @@ OvmsMetrics::OvmsMetrics()
   /* Initialize persistent metrics on cold boot or corruption */
   if (rtc_get_reset_reason(0) == POWERON_RESET || !pmetrics_check())
     pmetrics_init();
+  else
+    pmetrics_reindex();
+  pmetrics_journal_mount();
   ESP_LOGI(TAG, "Persistent metrics serial %u using %d bytes, %d/%d slots used",
       ++pmetrics.serial, sizeof(pmetrics), pmetrics.used, NUM_PERSISTENT_VALUES);
 
@@ -1141,6 +1379,8 @@ OvmsMetrics::OvmsMetrics()
   using std::placeholders::_2;
   MyEvents.RegisterEvent(TAG, "system.shutdown",
       std::bind(&OvmsMetrics::EventSystemShutDown, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "ticker.300",
+      std::bind(&OvmsMetrics::EventTicker300, this, _1, _2));
 
   }
 
@@ -1156,56 +1396,98 @@ OvmsMetrics::~OvmsMetrics()
 
 void OvmsMetrics::RegisterMetric(OvmsMetric* metric)
   {
-  // Quick simple check for if we are the first metric.
-  if (m_first == NULL)
-    {
-    m_first = metric;
-    return;
-    }
+  OvmsMutexLock lock(&m_index_mutex);
 
-  // Now, check if we are before the first
-  if (strcmp(m_first->m_name,metric->m_name)>=0)
+  // The sorted index holds the first list entry for each name, so the entry
+  // following the insertion point is found in O(log n). Duplicate names are
+  // inserted in front of their siblings, so the newest registration wins.
+  auto it = m_sorted.lower_bound(metric->m_name);
+  OvmsMetric* next = (it != m_sorted.end()) ? it->second : NULL;
+  if (it == m_sorted.begin())
     {
     metric->m_next = m_first;
     m_first = metric;
-    return;
+    }
+  else
+    {
+    OvmsMetric* prev = std::prev(it)->second;
+    while (prev->m_next != next)
+      prev = prev->m_next;
+    metric->m_next = next;
+    prev->m_next = metric;
     }
 
-  // Search for the correct place to insert
-  for (OvmsMetric*m = m_first; m!=NULL; m=m->m_next)
+  // Update indexes:
+  if (next && strcmp(next->m_name, metric->m_name) == 0)
     {
-    if (m->m_next == NULL)
-      {
-      m->m_next = metric;
-      return;
-      }
-    if (strcmp(m->m_next->m_name,metric->m_name)>=0)
-      {
-      metric->m_next = m->m_next;
-      m->m_next = metric;
-      return;
-      }
+    it = m_sorted.erase(it);
+    m_hashed.erase(next->m_name);
     }
+  m_sorted.emplace_hint(it, metric->m_name, metric);
+  m_hashed.emplace(metric->m_name, metric);
   }
 
 void OvmsMetrics::DeregisterMetric(OvmsMetric* metric)
   {
-  if (m_first == metric)
+  OvmsMutexLock lock(&m_index_mutex);
+
+  auto it = m_sorted.find(metric->m_name);
+  if (it == m_sorted.end())
+    return;
+
+  // Find list predecessor:
+  OvmsMetric* prev = NULL;
+  if (it->second != metric)
+    prev = it->second;
+  else if (it != m_sorted.begin())
+    prev = std::prev(it)->second;
+  if (prev)
     {
+    while (prev->m_next && prev->m_next != metric)
+      prev = prev->m_next;
+    if (prev->m_next != metric)
+      return; // not registered
+    }
+
+  // Unlink & update indexes:
+  if (prev)
+    prev->m_next = metric->m_next;
+  else
     m_first = metric->m_next;
-    delete metric;
-    return;
+  if (it->second == metric)
+    {
+    OvmsMetric* next = metric->m_next;
+    it = m_sorted.erase(it);
+    m_hashed.erase(metric->m_name);
+    if (next && strcmp(next->m_name, metric->m_name) == 0)
+      {
+      m_sorted.emplace_hint(it, next->m_name, next);
+      m_hashed.emplace(next->m_name, next);
+      }
     }
+  metric->m_next = NULL;
 
-  for (OvmsMetric* m=m_first;m!=NULL;m=m->m_next)
+  // Remove from modified queues (in chunks, to keep the critical sections short):
+  if (m_modqueue_mask)
     {
-    if (m->m_next == metric)
+    for (int i = 0; i < METRICS_MAX_MODIFIERS; i++)
       {
-      m->m_next = metric->m_next;
-      delete metric;
-      return;
+      OvmsMetricModQueue* queue = m_modqueue[i];
+      if (!queue)
+        continue;
+      bool more = true;
+      for (size_t slot = 0; more; slot += METRICS_MODQUEUE_CHUNK)
+        {
+        portENTER_CRITICAL(&modqueue_spinlock);
+        more = queue->Remove(metric, slot, METRICS_MODQUEUE_CHUNK);
+        portEXIT_CRITICAL(&modqueue_spinlock);
+        }
       }
     }
+
+  // Note: the destructor calls us again, so we need to unlock before deleting
+  lock.Unlock();
+  delete metric;
   }
 
 std::string OvmsMetrics::GetUnitStr(const char* metric, const char *unit)
@@ -1269,28 +1551,36 @@ bool OvmsMetrics::SetFloat(const char* metric, float value)
 
 OvmsMetric* OvmsMetrics::Find(const char* metric)
   {
-  for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
-    {
-    if (strcmp(m->m_name,metric)==0) return m;
-    }
-  return NULL;
+  OvmsMutexLock lock(&m_index_mutex);
+  auto it = m_hashed.find(metric);
+  return (it != m_hashed.end()) ? it->second : NULL;
+  }
+
+/**
+ * FindSortedPrefix: get the first metric in list order whose name is not
+ *  less than the token, i.e. the start of the token prefix range
+ */
+OvmsMetric* OvmsMetrics::FindSortedPrefix(const char* token) const
+  {
+  OvmsMutexLock lock(&m_index_mutex);
+  auto it = m_sorted.lower_bound(token);
+  return (it != m_sorted.end()) ? it->second : NULL;
   }
 
 OvmsMetric* OvmsMetrics::FindUniquePrefix(const char* token) const
   {
   size_t len = strlen(token);
   OvmsMetric* found = NULL;
-  for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
+  for (OvmsMetric* m=FindSortedPrefix(token); m != NULL; m=m->m_next)
     {
-    if (strncmp(m->m_name, token, len) == 0)
-      {
-      if (len == strlen(m->m_name))
-        return m;
-      if (found)
-        return NULL;
-      else
-        found = m;
-      }
+    if (strncmp(m->m_name, token, len) != 0)
+      break;
+    if (len == strlen(m->m_name))
+      return m;
+    if (found)
+      return NULL;
+    else
+      found = m;
     }
   return found;
   }
@@ -1302,13 +1592,12 @@ bool OvmsMetrics::GetCompletion(OvmsWriter* writer, const char* token) const
     if (token)
       {
       size_t len = strlen(token);
-      for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
+      for (OvmsMetric* m=FindSortedPrefix(token); m != NULL; m=m->m_next)
         {
-        if (strncmp(m->m_name, token, len) == 0)
-        {
-          writer->SetCompletion(index++, m->m_name);
-          match = true;
-        }
+        if (strncmp(m->m_name, token, len) != 0)
+          break;
+        writer->SetCompletion(index++, m->m_name);
+        match = true;
       }
     }
     return match;
@@ -1481,6 +1770,166 @@ void OvmsMetrics::InitialiseSlot(size_t modifier)
      if (m->IsDefined())
        m->m_modified |= bit;
     }
+  // Modified queue needs a full scan now:
+  if (m_modqueue_mask & bit)
+    {
+    portENTER_CRITICAL(&modqueue_spinlock);
+    m_modqueue[modifier]->m_overflow = true;
+    m_modqueue[modifier]->m_count = 0;
+    portEXIT_CRITICAL(&modqueue_spinlock);
+    }
+  }
+
+/**
+ * EnableModifiedQueue: start queueing modified metrics for a modifier
+ *  Consumers then drain the changed metrics by NextModified(), falling back
+ *  to a full scan when ModifiedQueueOverflow() returns true. The queue starts
+ *  in overflow state, as there may be modifications pending already.
+ */
+bool OvmsMetrics::EnableModifiedQueue(size_t modifier)
+  {
+  if (modifier >= METRICS_MAX_MODIFIERS)
+    return false;
+  if (m_modqueue[modifier])
+    return true;
+  OvmsMetricModQueue* queue = new OvmsMetricModQueue(METRICS_MODQUEUE_SIZE);
+  if (!queue->m_buffer)
+    {
+    delete queue;
+    return false;
+    }
+  m_modqueue[modifier] = queue;
+  m_modqueue_mask |= (1ul << modifier);
+  return true;
+  }
+
+/**
+ * QueueModified: add metric to the queues of all modifiers given
+ *  (called by OvmsMetric::SetModified for the bits it just set)
+ */
+void OvmsMetrics::QueueModified(OvmsMetric* metric, unsigned long modifiers)
+  {
+  modifiers &= m_modqueue_mask;
+  if (!modifiers)
+    return;
+  portENTER_CRITICAL(&modqueue_spinlock);
+  while (modifiers)
+    {
+    int i = __builtin_ctzl(modifiers);
+    modifiers &= modifiers - 1;
+    m_modqueue[i]->Push(metric);
+    }
+  portEXIT_CRITICAL(&modqueue_spinlock);
+  }
+
+/**
+ * NextModified: get next queued metric modified for the modifier
+ *  The modified flag for the modifier is cleared, metrics already cleared
+ *  by other means are skipped. Returns NULL if no more metrics are queued.
+ */
+OvmsMetric* OvmsMetrics::NextModified(size_t modifier)
+  {
+  if (modifier >= METRICS_MAX_MODIFIERS || !m_modqueue[modifier])
+    return NULL;
+  OvmsMetric* metric;
+  do
+    {
+    portENTER_CRITICAL(&modqueue_spinlock);
+    metric = m_modqueue[modifier]->Pop();
+    portEXIT_CRITICAL(&modqueue_spinlock);
+    } while (metric && !metric->IsModifiedAndClear(modifier));
+  return metric;
+  }
+
+/**
+ * ModifiedQueueOverflow: check & clear the overflow state of the queue
+ *  Returns true if the consumer needs to do a full scan of the metrics.
+ */
+bool OvmsMetrics::ModifiedQueueOverflow(size_t modifier)
+  {
+  if (modifier >= METRICS_MAX_MODIFIERS || !m_modqueue[modifier])
+    return true;
+  portENTER_CRITICAL(&modqueue_spinlock);
+  bool overflow = m_modqueue[modifier]->m_overflow;
+  m_modqueue[modifier]->m_overflow = false;
+  portEXIT_CRITICAL(&modqueue_spinlock);
+  return overflow;
+  }
+
+bool OvmsMetrics::GetModifiedQueueStats(size_t modifier, size_t& count, size_t& highwater, uint32_t& overflows)
+  {
+  if (modifier >= METRICS_MAX_MODIFIERS || !m_modqueue[modifier])
+    return false;
+  portENTER_CRITICAL(&modqueue_spinlock);
+  count = m_modqueue[modifier]->m_count;
+  highwater = m_modqueue[modifier]->m_highwater;
+  overflows = m_modqueue[modifier]->m_overflows;
+  portEXIT_CRITICAL(&modqueue_spinlock);
+  return true;
+  }
+
+OvmsMetricModQueue::OvmsMetricModQueue(size_t capacity)
+  {
+  m_buffer = (OvmsMetric**) ExternalRamMalloc(capacity * sizeof(OvmsMetric*));
+  m_capacity = m_buffer ? capacity : 0;
+  m_head = 0;
+  m_count = 0;
+  m_highwater = 0;
+  m_overflow = true;
+  m_overflows = 0;
+  }
+
+OvmsMetricModQueue::~OvmsMetricModQueue()
+  {
+  if (m_buffer)
+    free(m_buffer);
+  }
+
+void OvmsMetricModQueue::Push(OvmsMetric* metric)
+  {
+  if (m_overflow)
+    return; // full scan pending anyway
+  if (m_count == m_capacity)
+    {
+    m_overflow = true;
+    m_overflows++;
+    m_count = 0;
+    return;
+    }
+  m_buffer[(m_head + m_count) % m_capacity] = metric;
+  if (++m_count > m_highwater)
+    m_highwater = m_count;
+  }
+
+OvmsMetric* OvmsMetricModQueue::Pop()
+  {
+  while (m_count > 0)
+    {
+    OvmsMetric* metric = m_buffer[m_head];
+    m_head = (m_head + 1) % m_capacity;
+    m_count--;
+    if (metric)
+      return metric;
+    }
+  return NULL;
+  }
+
+/**
+ * Remove: mark the entries for a deregistered metric as dead in the buffer
+ *  slots [start, start+count), Pop() skips them. Returns false when there
+ *  are no more slots to check.
+ */
+bool OvmsMetricModQueue::Remove(OvmsMetric* metric, size_t start, size_t count)
+  {
+  if (m_count == 0 || start >= m_capacity)
+    return false;
+  size_t end = (start + count < m_capacity) ? start + count : m_capacity;
+  for (size_t i = start; i < end; i++)
+    {
+    if (m_buffer[i] == metric)
+      m_buffer[i] = NULL;
+    }
+  return (end < m_capacity);
   }
 
 void OvmsMetrics::SetAllUnitSend(size_t modifier)
@@ -1596,7 +2045,9 @@ void OvmsMetric::SetModified(bool changed)
   m_lastmodified = monotonictime;
   if (changed)
     {
-    m_modified = ULONG_MAX;
+    unsigned long modified = m_modified.exchange(ULONG_MAX);
+    if (modified != ULONG_MAX)
+      MyMetrics.QueueModified(this, ~modified);
     MyMetrics.NotifyModified(this);
     }
   }
@@ -2388,6 +2839,7 @@ OvmsMetric64::OvmsMetric64(const char* name, uint16_t autostale, metric_unit_t u
   m_persist = persist;
   m_valuep_lo = nullptr;
   m_valuep_hi = nullptr;
+  m_persist_array = false;
   }
  void OvmsMetric64::InitPersist()
    {
@@ -2396,16 +2848,27 @@ OvmsMetric64::OvmsMetric64(const char* name, uint16_t autostale, metric_unit_t u
     std::string lo_name(m_name);
     std::string hi_name = lo_name + "_hi";
 
-    persistent_values *hi_vp = pmetrics_register(hi_name);
-    persistent_values *lo_vp = pmetrics_register(lo_name);
+    // With the flash journal, both parts are stored as one array record, see SyncPersist()
+    m_persist_array = pmetrics_register_array(m_name);
+    bool coldboot = (pmetrics_find(lo_name) == NULL);
+    persistent_values *hi_vp = pmetrics_register(hi_name, !m_persist_array);
+    persistent_values *lo_vp = pmetrics_register(lo_name, !m_persist_array);
     if (!hi_vp || !lo_vp)
       {
       m_persist = false;
+      m_persist_array = false;
       }
     else
       {
       m_valuep_hi = (&hi_vp->value);
       m_valuep_lo = (&lo_vp->value);
+      persistent_value_t parts[2];
+      if (coldboot && m_persist_array
+        && pmetrics_array_read(m_name, parts, sizeof(persistent_value_t), 2) == 2)
+        {
+        *m_valuep_lo = parts[0];
+        *m_valuep_hi = parts[1];
+        }
       if (SetValueParts(*m_valuep_lo, *m_valuep_hi))
         {
         SetModified(true);
@@ -2462,6 +2925,26 @@ void OvmsMetric64::RefreshPersist()
     }
   }
 
+void OvmsMetric64::SyncPersist()
+  {
+  if (!m_persist_array || !m_persist || !m_valuep_lo || !m_valuep_hi || !IsDefined())
+    return;
+  // The setters update the parts without a lock, so read until both are stable,
+  // a torn value is skipped & written by the next sync:
+  volatile persistent_value_t *lo = m_valuep_lo, *hi = m_valuep_hi;
+  persistent_value_t parts[2];
+  for (int tries = 0; tries < 3; tries++)
+    {
+    parts[0] = *lo;
+    parts[1] = *hi;
+    if (parts[0] == *lo && parts[1] == *hi)
+      {
+      pmetrics_array_write(m_name, parts, sizeof(persistent_value_t), 2);
+      return;
+      }
+    }
+  }
+
 OvmsMetricInt64::OvmsMetricInt64(const char* name, uint16_t autostale, metric_unit_t units, bool persist)
   : OvmsMetric64(name, autostale, units, persist)
   {
@@ -2692,7 +3175,7 @@ bool OvmsMetricInt64::SetValue(std::string value, metric_unit_t units)
 
 bool OvmsMetricInt64::SetValue(const dbcNumber& value, metric_unit_t units)
   {
-  return SetValue(value.GetSignedInteger(), units);
+  return SetValue(value.GetSignedInteger64(), units);
   }
 
 void OvmsMetricInt64::Clear()
@@ -40,6 +40,7 @@
 #include <sstream>
 #include <set>
 #include <vector>
+#include <unordered_map>
 #include <atomic>
 #include "ovms_mutex.h"
 #include "dbc_number.h"
@@ -53,6 +54,8 @@
 #define TAG ((const char*)"metric")
 
 #define METRICS_MAX_MODIFIERS 32
+#define METRICS_MODQUEUE_SIZE 1024
+#define METRICS_MODQUEUE_CHUNK 32
 
 using namespace std;
 
@@ -227,8 +230,14 @@ struct persistent_metrics
 
 extern persistent_values *pmetrics_find(const char *name);
 extern persistent_values *pmetrics_find(const std::string &name);
-extern persistent_values *pmetrics_register(const char *name);
-extern persistent_values *pmetrics_register(const std::string &name);
+// journal=false: the value is journaled by its metric, see SyncPersist()
+extern persistent_values *pmetrics_register(const char *name, bool journal = true);
+extern persistent_values *pmetrics_register(const std::string &name, bool journal = true);
+
+// Array records, only available with the flash journal (see pmetrics_sync()):
+extern bool pmetrics_register_array(const char *name);
+extern int pmetrics_array_read(const char *name, void *data, size_t elemsize, size_t count);
+extern bool pmetrics_array_write(const char *name, const void *data, size_t elemsize, size_t count);
 
 class OvmsMetric
   {
@@ -249,6 +258,7 @@ class OvmsMetric
     virtual void operator=(std::string value);
     virtual bool CheckPersist();
     virtual void RefreshPersist();
+    virtual void SyncPersist() {};
     virtual bool IsString() { return false; };
     virtual void Clear();
 
@@ -646,6 +656,9 @@ class OvmsMetricSet : public OvmsMetric
  * A persistent vector will need 1+size pmetrics slots. It will allocate new slots as
  * needed when growing, but the slots will remain used when shrinking the vector. If any
  * new element cannot allocate a pmetrics slot, the whole vector loses its persistence.
+ * With the flash journal, the slots keep the values over crashes & warm reboots, and
+ * the vector is written as one array record by the journal sync to restore it on a
+ * cold boot.
  *
  * Unit conversion currently casts to and from float for the conversion, it's assumed to
  * only be necessary for floating point values here. If you need int conversion, rework
@@ -664,6 +677,7 @@ class OvmsMetricVector : public OvmsMetric
       : OvmsMetric(name, autostale, units, persist)
       {
       m_valuep_size = NULL;
+      m_persist_array = false;
       if (!persist)
         return;
 
@@ -671,16 +685,35 @@ class OvmsMetricVector : public OvmsMetric
       if (sizeof(ElemType) > sizeof(persistent_value_t))
         return;
 
-      // Vector persistence is currently implemented by a size entry with the metric name
+      // Vector persistence is implemented by a size entry with the metric name
       //  + one additional entry per element using the metric name extended by the element index.
-      // This may be optimized when the persistence system supports arrays.
-      struct persistent_values *vp = pmetrics_register(m_name);
+      // With the flash journal, the vector is additionally stored as one array record to
+      //  restore the entries on a cold boot (the entries themselves are not journaled then).
+      m_persist_array = pmetrics_register_array(m_name);
+      bool coldboot = (pmetrics_find(m_name) == NULL);
+      struct persistent_values *vp = pmetrics_register(m_name, !m_persist_array);
       if (!vp)
+        {
+        m_persist_array = false;
         return;
+        }
       m_valuep_size = reinterpret_cast<std::size_t*>(&vp->value);
+      int asize = -1;
+      if (coldboot && m_persist_array)
+        {
+        asize = pmetrics_array_read(m_name, NULL, sizeof(ElemType), 0);
+        if (asize > 0)
+          *m_valuep_size = asize;
+        }
       std::size_t psize = *m_valuep_size;
       if (SetPersistSize(psize))
         {
+        if (asize > 0)
+          {
+          pmetrics_array_read(m_name, m_value.data(), sizeof(ElemType), asize);
+          for (int i = 0; i < asize; i++)
+            *m_valuep_elem[i] = m_value[i];
+          }
         SetModified(true);
         ESP_LOGI(TAG, "persist %s = %s", m_name, AsUnitString().c_str());
         }
@@ -721,7 +754,7 @@ class OvmsMetricVector : public OvmsMetric
       for (std::size_t i = old_size; i < new_size; i++)
         {
         snprintf(elem_name, sizeof(elem_name), "%s_%u", m_name, i);
-        vp = pmetrics_register(elem_name);
+        vp = pmetrics_register(elem_name, !m_persist_array);
         if (!vp)
           {
           // if any element fails to register, the whole vector persistence fails:
@@ -805,6 +838,15 @@ class OvmsMetricVector : public OvmsMetric
         }
       }
 
+    void SyncPersist() override
+      {
+      if (m_persist && m_persist_array && m_valuep_size && IsDefined())
+        {
+        OvmsMutexLock lock(&m_mutex);
+        pmetrics_array_write(m_name, m_value.data(), sizeof(ElemType), m_value.size());
+        }
+      }
+
   public:
     std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1) override
       {
@@ -1071,6 +1113,7 @@ class OvmsMetricVector : public OvmsMetric
     std::vector<ElemType, Allocator> m_value;
     std::size_t* m_valuep_size;
     std::vector<ElemType*, AllocatorStar> m_valuep_elem;
+    bool m_persist_array;
   };
 
 /* Base class for 64 bit persisted metrics.
@@ -1082,6 +1125,7 @@ class OvmsMetric64 : public OvmsMetric
 
     bool CheckPersist() override;
     void RefreshPersist() override;
+    void SyncPersist() override;
 
     using OvmsMetric::operator=;
     void operator=(std::string value) override { SetValue(value); }
@@ -1096,6 +1140,7 @@ class OvmsMetric64 : public OvmsMetric
 
     persistent_value_t *m_valuep_lo;
     persistent_value_t *m_valuep_hi;
+    bool m_persist_array;
  };
 
 class OvmsMetricInt64 : public OvmsMetric64
@@ -1176,6 +1221,42 @@ class UnitConfigMap
 typedef std::list<MetricCallbackEntry*> MetricCallbackList;
 typedef std::map<std::string, MetricCallbackList*> MetricCallbackMap;
 
+// Metric name indexes: the sorted map provides the list insertion point and
+//  prefix scans, the hash map the exact name lookup for Find().
+typedef std::map<const char*, OvmsMetric*, CmpStrOp,
+  ExtRamAllocator<std::pair<const char* const, OvmsMetric*>>> OvmsMetricSortedIndex;
+typedef std::unordered_map<const char*, OvmsMetric*, HashStrOp, EqStrOp,
+  ExtRamAllocator<std::pair<const char* const, OvmsMetric*>>> OvmsMetricHashIndex;
+
+/**
+ * OvmsMetricModQueue: ring buffer of the metrics modified for a modifier.
+ *  A metric is queued when its modified bit for the modifier gets set, so
+ *  consumers only need to visit changed metrics. On overflow the queue is
+ *  reset and flagged, the consumer then needs to fall back to a full scan.
+ *  Entries of deregistered metrics are set to NULL and skipped by Pop().
+ *  Locking is done by OvmsMetrics.
+ */
+class OvmsMetricModQueue
+  {
+  public:
+    OvmsMetricModQueue(size_t capacity);
+    ~OvmsMetricModQueue();
+
+  public:
+    void Push(OvmsMetric* metric);
+    OvmsMetric* Pop();
+    bool Remove(OvmsMetric* metric, size_t start, size_t count);
+
+  public:
+    OvmsMetric** m_buffer;
+    size_t m_capacity;
+    size_t m_head;
+    size_t m_count;
+    size_t m_highwater;
+    bool m_overflow;                            // full scan needed
+    uint32_t m_overflows;
+  };
+
 class OvmsMetrics
   {
   public:
@@ -1247,12 +1328,31 @@ class OvmsMetrics
     size_t RegisterModifier();
     void InitialiseSlot(size_t modifier);
 
+  public:
+    bool EnableModifiedQueue(size_t modifier);
+    void QueueModified(OvmsMetric* metric, unsigned long modifiers);
+    OvmsMetric* NextModified(size_t modifier);
+    bool ModifiedQueueOverflow(size_t modifier);
+    bool GetModifiedQueueStats(size_t modifier, size_t& count, size_t& highwater, uint32_t& overflows);
+  protected:
+    OvmsMetricModQueue* m_modqueue[METRICS_MAX_MODIFIERS];
+    std::atomic_ulong m_modqueue_mask;
+
   public:
     void EventSystemShutDown(std::string event, void* data);
+    void EventTicker300(std::string event, void* data);
 
   protected:
     size_t m_nextmodifier;
 
+  protected:
+    OvmsMetric* FindSortedPrefix(const char* token) const;
+
+  protected:
+    OvmsMetricSortedIndex m_sorted;             // first metric by name (sorted)
+    OvmsMetricHashIndex m_hashed;               // first metric by name (hashed)
+    mutable OvmsMutex m_index_mutex;            // index & list modification
+
   public:
     OvmsMetric* m_first;
     bool m_trace;
@@ -0,0 +1,564 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Persistent metrics flash journal
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "pjournal";
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "ovms_pjournal.h"
+#include "ovms_malloc.h"
+
+#define PJOURNAL_MAGIC          (('O' << 24) | ('V' << 16) | ('J' << 8) | '1')
+#define PJOURNAL_INDEX_INITIAL  64
+
+#define RECORD_SIZE(length)     ((sizeof(pjournal_record_t) + (length) + 3) & ~3)
+#define SECTOR_OF(offset)       ((offset) / PJOURNAL_SECTOR_SIZE)
+
+static uint32_t pjournal_crc32(uint32_t crc, const void* data, size_t size)
+  {
+  // CRC-32 (IEEE 802.3), nibble table:
+  static const uint32_t table[16] =
+    {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+  const uint8_t* p = (const uint8_t*)data;
+  crc = ~crc;
+  while (size--)
+    {
+    crc ^= *p++;
+    crc = (crc >> 4) ^ table[crc & 0x0f];
+    crc = (crc >> 4) ^ table[crc & 0x0f];
+    }
+  return ~crc;
+  }
+
+static uint32_t pjournal_sector_crc(const pjournal_sector_t* hdr)
+  {
+  return pjournal_crc32(0, hdr, offsetof(pjournal_sector_t, crc));
+  }
+
+static uint32_t pjournal_record_crc(const pjournal_record_t* rec, const void* data)
+  {
+  uint32_t crc = pjournal_crc32(0, rec, offsetof(pjournal_record_t, crc));
+  return pjournal_crc32(crc, data, rec->length);
+  }
+
+static bool pjournal_erased(const void* data, size_t size)
+  {
+  const uint8_t* p = (const uint8_t*)data;
+  while (size--)
+    {
+    if (*p++ != 0xff)
+      return false;
+    }
+  return true;
+  }
+
+OvmsPersistJournal::OvmsPersistJournal(OvmsPersistFlash* flash)
+  {
+  m_flash = flash;
+  m_mounted = false;
+  m_sectors = 0;
+  m_sector = NULL;
+  m_index = NULL;
+  m_capacity = 0;
+  Reset();
+  }
+
+OvmsPersistJournal::~OvmsPersistJournal()
+  {
+  if (m_index) free(m_index);
+  if (m_sector) free(m_sector);
+  }
+
+/**
+ * Reset: clear the index & head state (keeps the sector erase counts)
+ */
+void OvmsPersistJournal::Reset()
+  {
+  if (m_index) memset(m_index, 0, m_capacity * sizeof(entry_t));
+  m_used = 0;
+  m_size = 0;
+  m_livebytes = 0;
+  m_seq = 0;
+  m_head = -1;
+  m_wpos = 0;
+  m_sealed = false;
+  memset(&m_stats, 0, sizeof(m_stats));
+  for (uint32_t s = 0; s < m_sectors; s++)
+    {
+    m_sector[s].seq = 0;
+    m_sector[s].livebytes = 0;
+    }
+  }
+
+/**
+ * Mount: read the sector headers & replay all records in sector sequence
+ *  order to build the index. Finishes an interrupted sector reclaim.
+ *  An unformatted area is an empty journal.
+ */
+bool OvmsPersistJournal::Mount()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  m_mounted = false;
+
+  uint32_t sectors = m_flash->Size() / PJOURNAL_SECTOR_SIZE;
+  if (sectors < PJOURNAL_MIN_SECTORS)
+    {
+    ESP_LOGE(TAG, "Mount: area too small (%" PRIu32 " sectors)", sectors);
+    return false;
+    }
+  if (sectors != m_sectors)
+    {
+    if (m_sector) free(m_sector);
+    m_sector = (sector_t*)ExternalRamMalloc(sectors * sizeof(sector_t));
+    if (!m_sector)
+      {
+      m_sectors = 0;
+      return false;
+      }
+    memset(m_sector, 0, sectors * sizeof(sector_t));
+    m_sectors = sectors;
+    }
+  Reset();
+
+  uint8_t* buf = (uint8_t*)ExternalRamMalloc(PJOURNAL_SECTOR_SIZE);
+  uint32_t* order = (uint32_t*)ExternalRamMalloc(m_sectors * sizeof(uint32_t));
+  if (!buf || !order)
+    {
+    if (buf) free(buf);
+    if (order) free(order);
+    return false;
+    }
+
+  // Find sectors in use, sort by sequence:
+  uint32_t used = 0;
+  for (uint32_t s = 0; s < m_sectors; s++)
+    {
+    pjournal_sector_t hdr;
+    if (!m_flash->Read(s * PJOURNAL_SECTOR_SIZE, &hdr, sizeof(hdr)))
+      continue;
+    if (hdr.magic != PJOURNAL_MAGIC || hdr.crc != pjournal_sector_crc(&hdr) || hdr.seq == 0)
+      continue;
+    m_sector[s].seq = hdr.seq;
+    m_sector[s].erasures = hdr.erasures;
+    if (hdr.seq > m_seq) m_seq = hdr.seq;
+    uint32_t i = used++;
+    while (i > 0 && m_sector[order[i-1]].seq > hdr.seq)
+      {
+      order[i] = order[i-1];
+      i--;
+      }
+    order[i] = s;
+    }
+
+  // Replay:
+  for (uint32_t i = 0; i < used; i++)
+    {
+    uint32_t s = order[i];
+    if (!m_flash->Read(s * PJOURNAL_SECTOR_SIZE, buf, PJOURNAL_SECTOR_SIZE))
+      {
+      ESP_LOGE(TAG, "Mount: sector %" PRIu32 " read failed", s);
+      continue;
+      }
+    Scan(s, buf, (i == used-1));
+    }
+  free(order);
+  free(buf);
+
+  m_mounted = true;
+  if (m_head >= 0)
+    {
+    uint32_t next = (m_head + 1) % m_sectors;
+    if (m_sector[next].seq)
+      Reclaim(next);
+    }
+  ESP_LOGD(TAG, "Mount: %" PRIu32 " sectors, %" PRIu32 " in use, %" PRIu32 " records, head %" PRId32 " at %" PRIu32,
+    m_sectors, used, m_size, m_head, m_wpos);
+  return true;
+  }
+
+/**
+ * Scan: index the records of a sector image. The first corrupted record ends
+ *  the sector, a head sector with a corrupted record or programmed bits after
+ *  the last record (interrupted write) is sealed.
+ */
+void OvmsPersistJournal::Scan(uint32_t sector, const uint8_t* buf, bool head)
+  {
+  uint32_t pos = sizeof(pjournal_sector_t);
+  bool corrupted = false;
+  while (pos + sizeof(pjournal_record_t) <= PJOURNAL_SECTOR_SIZE)
+    {
+    pjournal_record_t rec;
+    memcpy(&rec, buf + pos, sizeof(rec));
+    if (pjournal_erased(&rec, sizeof(rec)))
+      break;
+    if (rec.type == 0 || rec.length > PJOURNAL_MAX_LENGTH
+      || pos + RECORD_SIZE(rec.length) > PJOURNAL_SECTOR_SIZE
+      || rec.crc != pjournal_record_crc(&rec, buf + pos + sizeof(rec)))
+      {
+      ESP_LOGW(TAG, "Scan: sector %" PRIu32 " corrupted at %" PRIu32, sector, pos);
+      corrupted = true;
+      break;
+      }
+    Index(rec.key, rec.type, sector * PJOURNAL_SECTOR_SIZE + pos, rec.length);
+    pos += RECORD_SIZE(rec.length);
+    }
+
+  if (head)
+    {
+    m_head = sector;
+    m_wpos = pos;
+    m_sealed = corrupted || !pjournal_erased(buf + pos, PJOURNAL_SECTOR_SIZE - pos);
+    }
+  }
+
+/**
+ * Format: erase the area
+ */
+bool OvmsPersistJournal::Format()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  if (!m_sectors)
+    return false;
+  bool ok = true;
+  for (uint32_t s = 0; s < m_sectors; s++)
+    {
+    if (m_flash->Erase(s * PJOURNAL_SECTOR_SIZE))
+      m_sector[s].erasures++;
+    else
+      ok = false;
+    }
+  Reset();
+  m_mounted = ok;
+  return ok;
+  }
+
+OvmsPersistJournal::entry_t* OvmsPersistJournal::Find(uint32_t key)
+  {
+  if (!m_capacity)
+    return NULL;
+  uint32_t mask = m_capacity - 1;
+  for (uint32_t i = (key * 2654435761u) & mask; m_index[i].offset; i = (i + 1) & mask)
+    {
+    if (m_index[i].key == key)
+      return &m_index[i];
+    }
+  return NULL;
+  }
+
+OvmsPersistJournal::entry_t* OvmsPersistJournal::Insert(uint32_t key)
+  {
+  if ((m_used + 1) * 4 > m_capacity * 3 && !Grow())
+    return NULL;
+  uint32_t mask = m_capacity - 1;
+  uint32_t i = (key * 2654435761u) & mask;
+  while (m_index[i].offset)
+    i = (i + 1) & mask;
+  m_index[i].key = key;
+  m_used++;
+  return &m_index[i];
+  }
+
+bool OvmsPersistJournal::Grow()
+  {
+  uint32_t capacity = m_capacity ? m_capacity * 2 : PJOURNAL_INDEX_INITIAL;
+  entry_t* index = (entry_t*)ExternalRamMalloc(capacity * sizeof(entry_t));
+  if (!index)
+    return false;
+  memset(index, 0, capacity * sizeof(entry_t));
+  uint32_t mask = capacity - 1;
+  for (uint32_t k = 0; k < m_capacity; k++)
+    {
+    if (!m_index[k].offset)
+      continue;
+    uint32_t i = (m_index[k].key * 2654435761u) & mask;
+    while (index[i].offset)
+      i = (i + 1) & mask;
+    index[i] = m_index[k];
+    }
+  if (m_index) free(m_index);
+  m_index = index;
+  m_capacity = capacity;
+  return true;
+  }
+
+/**
+ * Index: point the key to a new record, update the live byte counts
+ */
+void OvmsPersistJournal::Index(uint32_t key, uint8_t type, uint32_t offset, uint16_t length)
+  {
+  entry_t* e = Find(key);
+  if (e && e->type)
+    {
+    m_sector[SECTOR_OF(e->offset)].livebytes -= RECORD_SIZE(e->length);
+    m_livebytes -= RECORD_SIZE(e->length);
+    }
+  else
+    {
+    if (!e && (e = Insert(key)) == NULL)
+      {
+      ESP_LOGE(TAG, "Index: out of memory");
+      return;
+      }
+    m_size++;
+    }
+  e->offset = offset;
+  e->length = length;
+  e->type = type;
+  m_sector[SECTOR_OF(offset)].livebytes += RECORD_SIZE(length);
+  m_livebytes += RECORD_SIZE(length);
+  }
+
+int OvmsPersistJournal::Read(uint32_t key, uint8_t* type, void* data, size_t size)
+  {
+  OvmsMutexLock lock(&m_mutex);
+  entry_t* e = Find(MapKey(key));
+  if (!e || !e->type)
+    return -1;
+  if (size > e->length)
+    size = e->length;
+  if (size && !m_flash->Read(e->offset + sizeof(pjournal_record_t), data, size))
+    return -1;
+  if (type)
+    *type = e->type;
+  return e->length;
+  }
+
+bool OvmsPersistJournal::Equals(const entry_t* e, const void* data)
+  {
+  uint8_t buf[64];
+  const uint8_t* p = (const uint8_t*)data;
+  size_t offset = e->offset + sizeof(pjournal_record_t);
+  for (size_t done = 0, n; done < e->length; done += n)
+    {
+    n = e->length - done;
+    if (n > sizeof(buf)) n = sizeof(buf);
+    if (!m_flash->Read(offset + done, buf, n) || memcmp(buf, p + done, n) != 0)
+      return false;
+    }
+  return true;
+  }
+
+/**
+ * Write: store a record for the key, unless the current one has the same
+ *  type & data.
+ */
+bool OvmsPersistJournal::Write(uint32_t key, uint8_t type, const void* data, size_t length)
+  {
+  OvmsMutexLock lock(&m_mutex);
+  if (!m_mounted || type == 0 || length > PJOURNAL_MAX_LENGTH)
+    {
+    m_stats.failed++;
+    return false;
+    }
+  key = MapKey(key);
+  entry_t* e = Find(key);
+  if (e && e->type == type && e->length == length && Equals(e, data))
+    {
+    m_stats.skipped++;
+    return true;
+    }
+  m_stats.userbytes += length;
+  if (!Append(key, type, data, length))
+    {
+    m_stats.failed++;
+    return false;
+    }
+  return true;
+  }
+
+bool OvmsPersistJournal::Append(uint32_t key, uint8_t type, const void* data, size_t length)
+  {
+  // Keep two sectors of slack, so reclaims always make progress:
+  entry_t* e = Find(key);
+  uint32_t need = RECORD_SIZE(length);
+  uint32_t prev = (e && e->type) ? RECORD_SIZE(e->length) : 0;
+  uint32_t limit = (m_sectors - 2) * (PJOURNAL_SECTOR_SIZE - sizeof(pjournal_sector_t));
+  if (m_livebytes - prev + need > limit)
+    {
+    ESP_LOGE(TAG, "Append: journal full, can't write key %08" PRIx32, key);
+    return false;
+    }
+
+  for (uint32_t tries = 0; m_head < 0 || m_sealed || m_wpos + need > PJOURNAL_SECTOR_SIZE; tries++)
+    {
+    if (tries == 2 * m_sectors || !Open())
+      return false;
+    }
+  return Program(key, type, data, length);
+  }
+
+bool OvmsPersistJournal::Program(uint32_t key, uint8_t type, const void* data, size_t length)
+  {
+  pjournal_record_t rec;
+  rec.key = key;
+  rec.length = length;
+  rec.type = type;
+  rec.reserved = 0;
+  rec.crc = pjournal_record_crc(&rec, data);
+
+  uint32_t offset = m_head * PJOURNAL_SECTOR_SIZE + m_wpos;
+  if (!m_flash->Write(offset, &rec, sizeof(rec))
+    || (length && !m_flash->Write(offset + sizeof(rec), data, length)))
+    {
+    ESP_LOGE(TAG, "Program: write failed at %" PRIu32, offset);
+    m_sealed = true;
+    return false;
+    }
+  m_stats.flashbytes += sizeof(rec) + length;
+  m_wpos += RECORD_SIZE(length);
+  Index(key, type, offset, length);
+  return true;
+  }
+
+/**
+ * Open: erase the sector following the head and make it the new head,
+ *  then reclaim the (oldest) sector following that.
+ */
+bool OvmsPersistJournal::Open()
+  {
+  uint32_t s = (m_head < 0) ? 0 : (m_head + 1) % m_sectors;
+  if (m_sector[s].seq)
+    {
+    // Only after a failed reclaim:
+    if (m_sector[s].livebytes)
+      Drop(s);
+    m_sector[s].seq = 0;
+    }
+
+  if (!m_flash->Erase(s * PJOURNAL_SECTOR_SIZE))
+    {
+    ESP_LOGE(TAG, "Open: erase of sector %" PRIu32 " failed", s);
+    return false;
+    }
+  m_stats.erasures++;
+  m_sector[s].erasures++;
+
+  pjournal_sector_t hdr;
+  hdr.magic = PJOURNAL_MAGIC;
+  hdr.seq = m_seq + 1;
+  hdr.erasures = m_sector[s].erasures;
+  hdr.crc = pjournal_sector_crc(&hdr);
+  if (!m_flash->Write(s * PJOURNAL_SECTOR_SIZE, &hdr, sizeof(hdr)))
+    {
+    ESP_LOGE(TAG, "Open: header write to sector %" PRIu32 " failed", s);
+    return false;
+    }
+  m_stats.flashbytes += sizeof(hdr);
+  m_seq = hdr.seq;
+  m_sector[s].seq = hdr.seq;
+  m_head = s;
+  m_wpos = sizeof(hdr);
+  m_sealed = false;
+
+  uint32_t next = (s + 1) % m_sectors;
+  if (m_sector[next].seq)
+    Reclaim(next);
+  return true;
+  }
+
+/**
+ * Reclaim: copy the live records of a sector into the head sector, retire
+ *  the sector if all could be copied.
+ */
+void OvmsPersistJournal::Reclaim(uint32_t sector)
+  {
+  uint8_t* buf = (uint8_t*)ExternalRamMalloc(PJOURNAL_SECTOR_SIZE);
+  if (!buf)
+    return;
+  if (m_sector[sector].livebytes
+    && m_flash->Read(sector * PJOURNAL_SECTOR_SIZE, buf, PJOURNAL_SECTOR_SIZE))
+    {
+    uint32_t pos = sizeof(pjournal_sector_t);
+    while (pos + sizeof(pjournal_record_t) <= PJOURNAL_SECTOR_SIZE)
+      {
+      pjournal_record_t rec;
+      memcpy(&rec, buf + pos, sizeof(rec));
+      if (rec.type == 0 || rec.length > PJOURNAL_MAX_LENGTH
+        || pos + RECORD_SIZE(rec.length) > PJOURNAL_SECTOR_SIZE)
+        break;
+      entry_t* e = Find(rec.key);
+      if (e && e->type && e->offset == sector * PJOURNAL_SECTOR_SIZE + pos)
+        {
+        if (m_sealed || m_wpos + RECORD_SIZE(rec.length) > PJOURNAL_SECTOR_SIZE
+          || !Program(rec.key, rec.type, buf + pos + sizeof(rec), rec.length))
+          break;
+        m_stats.collected++;
+        }
+      pos += RECORD_SIZE(rec.length);
+      }
+    }
+  free(buf);
+
+  if (m_sector[sector].livebytes)
+    {
+    ESP_LOGE(TAG, "Reclaim: sector %" PRIu32 " incomplete, %" PRIu32 " bytes left", sector, m_sector[sector].livebytes);
+    return;
+    }
+  pjournal_sector_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  if (m_flash->Write(sector * PJOURNAL_SECTOR_SIZE, &hdr, sizeof(hdr)))
+    m_sector[sector].seq = 0;
+  }
+
+/**
+ * Drop: remove the records of a sector from the index
+ */
+void OvmsPersistJournal::Drop(uint32_t sector)
+  {
+  uint32_t dropped = 0;
+  for (uint32_t i = 0; i < m_capacity; i++)
+    {
+    entry_t* e = &m_index[i];
+    if (e->offset && e->type && SECTOR_OF(e->offset) == sector)
+      {
+      m_livebytes -= RECORD_SIZE(e->length);
+      e->type = 0;
+      m_size--;
+      dropped++;
+      }
+    }
+  m_sector[sector].livebytes = 0;
+  ESP_LOGE(TAG, "Drop: %" PRIu32 " records of sector %" PRIu32 " lost", dropped, sector);
+  }
+
+void OvmsPersistJournal::GetStats(pjournal_stats_t* stats)
+  {
+  OvmsMutexLock lock(&m_mutex);
+  *stats = m_stats;
+  stats->sectors = m_sectors;
+  stats->records = m_size;
+  stats->livebytes = m_livebytes;
+  stats->erasures_min = m_sectors ? m_sector[0].erasures : 0;
+  stats->erasures_max = stats->erasures_min;
+  for (uint32_t s = 1; s < m_sectors; s++)
+    {
+    if (m_sector[s].erasures < stats->erasures_min) stats->erasures_min = m_sector[s].erasures;
+    if (m_sector[s].erasures > stats->erasures_max) stats->erasures_max = m_sector[s].erasures;
+    }
+  }
@@ -0,0 +1,170 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Persistent metrics flash journal
+;    Date:          17th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __OVMS_PJOURNAL_H__
+#define __OVMS_PJOURNAL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ovms_mutex.h"
+
+/**
+ * OvmsPersistJournal: log structured key/value store on a raw flash area
+ *
+ *  Records (32 bit key, type, up to PJOURNAL_MAX_LENGTH bytes of data) are
+ *  appended to the head sector. A newer record for a key supersedes the older
+ *  ones, a RAM index maps each key to its current record, so reads & updates
+ *  are O(1) and unchanged values are not written again.
+ *
+ *  Sectors are used round robin, one sector is always kept erased: when a new
+ *  head sector is opened, the live records of the sector following it (the
+ *  oldest one) are copied into the new head and the old sector is retired.
+ *  That spreads erase cycles evenly over the area.
+ *
+ *  All headers & records carry a CRC, the sector sequence numbers define the
+ *  replay order on Mount(), so a power cut at any point loses at most the
+ *  record being written. Erased flash is all 1 bits; a sector is retired by
+ *  programming its header to zero, it's erased when opened again.
+ *
+ *  Record type 0 & key 0xffffffff are reserved.
+ */
+
+#define PJOURNAL_SECTOR_SIZE    4096
+#define PJOURNAL_MIN_SECTORS    3
+#define PJOURNAL_MAX_LENGTH     (PJOURNAL_SECTOR_SIZE - sizeof(pjournal_sector_t) - sizeof(pjournal_record_t))
+
+typedef struct
+  {
+  uint32_t magic;
+  uint32_t seq;                 // sector sequence number (replay order)
+  uint32_t erasures;            // erase count of this sector
+  uint32_t crc;                 // CRC32 of the above
+  } pjournal_sector_t;
+
+typedef struct
+  {
+  uint32_t key;
+  uint16_t length;              // data length (record is padded to 4 bytes)
+  uint8_t type;                 // user type, 0 = invalid
+  uint8_t reserved;
+  uint32_t crc;                 // CRC32 of key, length, type & data
+  } pjournal_record_t;
+
+typedef struct
+  {
+  uint32_t sectors;             // sectors in the area
+  uint32_t records;             // live records
+  uint32_t livebytes;           // flash bytes used by live records
+  uint32_t erasures;            // erasures done since mount
+  uint32_t erasures_min;        // lowest sector erase count
+  uint32_t erasures_max;        // highest sector erase count
+  uint32_t collected;           // records copied by sector reclaims
+  uint32_t skipped;             // unchanged record writes skipped
+  uint32_t failed;              // failed record writes
+  uint64_t userbytes;           // data bytes written by the user
+  uint64_t flashbytes;          // bytes programmed (headers & reclaims included)
+  } pjournal_stats_t;
+
+/**
+ * OvmsPersistFlash: flash area access for the journal
+ *
+ *  Offsets are relative to the area start, the size is a multiple of
+ *  PJOURNAL_SECTOR_SIZE. Write() may only clear bits (NOR flash semantics).
+ */
+class OvmsPersistFlash
+  {
+  public:
+    virtual ~OvmsPersistFlash() {}
+    virtual size_t Size() = 0;
+    virtual bool Read(size_t offset, void* data, size_t size) = 0;
+    virtual bool Write(size_t offset, const void* data, size_t size) = 0;
+    virtual bool Erase(size_t offset) = 0;
+  };
+
+class OvmsPersistJournal
+  {
+  public:
+    OvmsPersistJournal(OvmsPersistFlash* flash);
+    ~OvmsPersistJournal();
+
+  public:
+    bool Mount();
+    bool Format();
+    bool IsMounted() const { return m_mounted; }
+
+  public:
+    int Read(uint32_t key, uint8_t* type, void* data, size_t size);
+    bool Write(uint32_t key, uint8_t type, const void* data, size_t length);
+    void GetStats(pjournal_stats_t* stats);
+
+  protected:
+    typedef struct
+      {
+      uint32_t key;
+      uint32_t offset;          // record offset, 0 = free index slot
+      uint16_t length;
+      uint8_t type;             // 0 = record dropped
+      } entry_t;
+
+    typedef struct
+      {
+      uint32_t seq;             // 0 = free
+      uint32_t erasures;
+      uint32_t livebytes;
+      } sector_t;
+
+  protected:
+    static uint32_t MapKey(uint32_t key) { return (key == 0xffffffff) ? 0xfffffffe : key; }
+    entry_t* Find(uint32_t key);
+    entry_t* Insert(uint32_t key);
+    bool Grow();
+    void Index(uint32_t key, uint8_t type, uint32_t offset, uint16_t length);
+    void Scan(uint32_t sector, const uint8_t* buf, bool head);
+    bool Append(uint32_t key, uint8_t type, const void* data, size_t length);
+    bool Program(uint32_t key, uint8_t type, const void* data, size_t length);
+    bool Open();
+    void Reclaim(uint32_t sector);
+    void Drop(uint32_t sector);
+    bool Equals(const entry_t* e, const void* data);
+    void Reset();
+
+  protected:
+    OvmsMutex           m_mutex;
+    OvmsPersistFlash*   m_flash;
+    bool                m_mounted;
+    uint32_t            m_sectors;
+    sector_t*           m_sector;
+    uint32_t            m_seq;
+    int32_t             m_head;         // head sector, -1 = none
+    uint32_t            m_wpos;         // write position in head sector
+    bool                m_sealed;       // head sector can't take more records
+    entry_t*            m_index;
+    uint32_t            m_capacity;     // index slots (power of 2)
+    uint32_t            m_used;         // index slots used
+    uint32_t            m_size;         // live records
+    uint32_t            m_livebytes;
+    pjournal_stats_t    m_stats;
+  };
+
+#endif //#ifndef __OVMS_PJOURNAL_H__
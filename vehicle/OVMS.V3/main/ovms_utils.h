@@ -97,6 +97,28 @@ struct CmpStrCaseOp
     }
   };
 
+// C string hashing for std::unordered_map et al (FNV-1a):
+struct HashStrOp
+  {
+  std::size_t operator()(char const *s) const
+    {
+    uint32_t h = 2166136261u;
+    while (*s)
+      {
+      h ^= (uint8_t) *s++;
+      h *= 16777619u;
+      }
+    return h;
+    }
+  };
+struct EqStrOp
+  {
+  bool operator()(char const *a, char const *b) const
+    {
+    return std::strcmp(a, b) == 0;
+    }
+  };
+
 // Equality test for two std::map<K,V> with K,V both being BooleanTestible
 // (using std::pair operator==)
 // Source/credit: Sebastian Mach https://stackoverflow.com/a/8473603
@@ -45,6 +45,7 @@ static const char *TAG = "vfs";
 #include "ovms_config.h"
 #include "ovms_command.h"
 #include "ovms_peripherals.h"
+#include "ovms_events.h"
 #include "crypt_md5.h"
 #include "glob_match.h"
 
@@ -178,6 +179,13 @@ static void read_entries(std::set<Direntry> &entries, std::string startpath, std
   }
 }
 
+/**
+ * vfs_changed: signal a modified path (file or directory) to listeners
+ */
+static void vfs_changed(const std::string &path) {
+  MyEvents.SignalEvent("system.vfs.file.changed", (void*)path.c_str(), path.size()+1);
+}
+
 static bool has_glob_end(const std::string &str) {
 
   for (auto it = str.rbegin(); it != str.rend(); ++it) {
@@ -469,7 +477,10 @@ void vfs_rm(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const
       return;
       }
     if (unlink(filename.c_str()) == 0)
-      { writer->puts("VFS File deleted"); }
+      {
+      writer->puts("VFS File deleted");
+      vfs_changed(filename);
+      }
     else
       { writer->puts("Error: Could not delete VFS file"); }
     }
@@ -503,7 +514,10 @@ void vfs_rm(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const
       }
 
     if (delcount > 0)
+      {
       writer->printf("VFS: Deleted %d files\n", delcount );
+      vfs_changed(filename);
+      }
     }
   }
 
@@ -520,7 +534,11 @@ void vfs_mv(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const
     return;
     }
   if (rename(argv[0],argv[1]) == 0)
-    { writer->puts("VFS File renamed"); }
+    {
+    writer->puts("VFS File renamed");
+    vfs_changed(argv[0]);
+    vfs_changed(argv[1]);
+    }
   else
     { writer->puts("Error: Could not rename VFS file"); }
   }
@@ -552,7 +570,10 @@ void vfs_mkdir(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, co
   int res = (parents) ? mkpath(dirpath,0) : mkdir(dirpath,0);
 
   if (res == 0)
-    { writer->puts("VFS directory created"); }
+    {
+    writer->puts("VFS directory created");
+    vfs_changed(dirpath);
+    }
   else
     { writer->puts("Error: Could not create VFS directory"); }
   }
@@ -584,7 +605,10 @@ void vfs_rmdir(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, co
   int res = (recursive) ? rmtree(dirpath) : rmdir(dirpath);
 
   if (res == 0)
-    { writer->puts("VFS directory removed"); }
+    {
+    writer->puts("VFS directory removed");
+    vfs_changed(dirpath);
+    }
   else
     { writer->puts("Error: Could not remove VFS directory"); }
   }
@@ -625,6 +649,7 @@ void vfs_cp(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const
   fclose(w);
   fclose(f);
   writer->puts("VFS copy complete");
+  vfs_changed(argv[1]);
   }
 
 /**
@@ -664,6 +689,7 @@ void vfs_write(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, co
   fwrite(argv[0], len, 1, w);
   fwrite("\n", 1, 1, w);
   fclose(w);
+  vfs_changed(argv[1]);
   }
 
 
@@ -465,6 +465,177 @@ void test_filewriter(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int ar
   writer->printf("Done, check log and vfs cat %s\n", argv[0]);
   }
 
+void test_metrics(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int count = (argc > 0) ? atoi(argv[0]) : 2000;
+  int loops = (argc > 1) ? atoi(argv[1]) : 5;
+  if (count < 1 || loops < 1)
+    {
+    writer->puts("Error: invalid count/loops");
+    return;
+    }
+
+  // Prepare names, registered in scattered order to exercise sorted insertion:
+  char** names = (char**) ExternalRamMalloc(count * sizeof(char*));
+  OvmsMetric** metrics = (OvmsMetric**) ExternalRamMalloc(count * sizeof(OvmsMetric*));
+  if (!names || !metrics)
+    {
+    writer->puts("ERROR: out of memory!");
+    free(names);
+    free(metrics);
+    return;
+    }
+  for (int i = 0; i < count; i++)
+    {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "xtest.metric.%05d", (int)(((int64_t)i * 7919) % count));
+    names[i] = strdup(buf);
+    }
+
+  int nummetrics = 0;
+  for (OvmsMetric* m = MyMetrics.m_first; m; m = m->m_next)
+    nummetrics++;
+  writer->printf("Registering %d test metrics (%d existing)...\n", count, nummetrics);
+
+  int64_t t0 = esp_timer_get_time();
+  for (int i = 0; i < count; i++)
+    metrics[i] = new OvmsMetricInt(names[i]);
+  int64_t t_reg = esp_timer_get_time() - t0;
+
+  // Indexed lookup:
+  int errors = 0;
+  t0 = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    for (int i = 0; i < count; i++)
+      if (MyMetrics.Find(names[i]) != metrics[i]) errors++;
+  int64_t t_find = esp_timer_get_time() - t0;
+
+  // Reference: linear list walk (previous implementation)
+  t0 = esp_timer_get_time();
+  for (int i = 0; i < count; i++)
+    {
+    OvmsMetric* m;
+    for (m = MyMetrics.m_first; m && strcmp(m->m_name, names[i]) != 0; m = m->m_next);
+    if (m != metrics[i]) errors++;
+    }
+  int64_t t_walk = (esp_timer_get_time() - t0) * loops;
+
+  // Prefix completion:
+  t0 = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    for (int i = 0; i < count; i++)
+      if (MyMetrics.FindUniquePrefix(names[i]) != metrics[i]) errors++;
+  int64_t t_prefix = esp_timer_get_time() - t0;
+
+  t0 = esp_timer_get_time();
+  for (int i = 0; i < count; i++)
+    MyMetrics.DeregisterMetric(metrics[i]);
+  int64_t t_dereg = esp_timer_get_time() - t0;
+
+  for (int i = 0; i < count; i++)
+    free(names[i]);
+  free(names);
+  free(metrics);
+
+  int lookups = count * loops;
+  writer->printf("Register:    %7lld us total, %5.2f us/metric\n", t_reg, (float)t_reg / count);
+  writer->printf("Find:        %7lld us total, %5.2f us/lookup\n", t_find, (float)t_find / lookups);
+  writer->printf("Find (walk): %7lld us total, %5.2f us/lookup (extrapolated)\n", t_walk, (float)t_walk / lookups);
+  writer->printf("Prefix:      %7lld us total, %5.2f us/lookup\n", t_prefix, (float)t_prefix / lookups);
+  writer->printf("Deregister:  %7lld us total, %5.2f us/metric\n", t_dereg, (float)t_dereg / count);
+  writer->printf("%s: %d lookup errors\n", errors ? "FAILED" : "OK", errors);
+  }
+
+void test_metricmod(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  static size_t s_modifier = 0;
+  int count = (argc > 0) ? atoi(argv[0]) : 800;
+  int rate = (argc > 1) ? atoi(argv[1]) : 200;
+  int seconds = (argc > 2) ? atoi(argv[2]) : 10;
+  if (count < 1 || rate < 1 || seconds < 1)
+    {
+    writer->puts("Error: invalid arguments");
+    return;
+    }
+
+  if (s_modifier == 0)
+    {
+    s_modifier = MyMetrics.RegisterModifier();
+    if (!MyMetrics.EnableModifiedQueue(s_modifier))
+      {
+      writer->puts("ERROR: cannot create modified queue");
+      return;
+      }
+    }
+
+  char** names = (char**) ExternalRamMalloc(count * sizeof(char*));
+  OvmsMetricInt** metrics = (OvmsMetricInt**) ExternalRamMalloc(count * sizeof(OvmsMetricInt*));
+  if (!names || !metrics)
+    {
+    writer->puts("ERROR: out of memory!");
+    free(names);
+    free(metrics);
+    return;
+    }
+  for (int i = 0; i < count; i++)
+    {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "xtest.mod.%05d", i);
+    names[i] = strdup(buf);
+    metrics[i] = new OvmsMetricInt(names[i]);
+    }
+
+  writer->printf("Simulating %d updates/s on %d test metrics for %d seconds...\n", rate, count, seconds);
+
+  // Start clean:
+  MyMetrics.ModifiedQueueOverflow(s_modifier);
+  for (OvmsMetric* m = MyMetrics.m_first; m; m = m->m_next)
+    m->ClearModified(s_modifier);
+  while (MyMetrics.NextModified(s_modifier)) {}
+
+  int64_t t_update = 0, t_drain = 0, t_scan = 0, t0;
+  int drained = 0, scanned = 0, value = 0;
+  for (int sec = 0; sec < seconds; sec++)
+    {
+    // Queue consumer:
+    t0 = esp_timer_get_time();
+    for (int k = 0; k < rate; k++)
+      metrics[rand() % count]->SetValue(++value);
+    t_update += esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    while (MyMetrics.NextModified(s_modifier))
+      drained++;
+    t_drain += esp_timer_get_time() - t0;
+
+    // Reference: full list scan consumer
+    for (int k = 0; k < rate; k++)
+      metrics[rand() % count]->SetValue(++value);
+    t0 = esp_timer_get_time();
+    for (OvmsMetric* m = MyMetrics.m_first; m; m = m->m_next)
+      if (m->IsModifiedAndClear(s_modifier))
+        scanned++;
+    t_scan += esp_timer_get_time() - t0;
+    while (MyMetrics.NextModified(s_modifier)) {}
+    }
+
+  size_t qcount, qhighwater;
+  uint32_t qoverflows;
+  MyMetrics.GetModifiedQueueStats(s_modifier, qcount, qhighwater, qoverflows);
+
+  for (int i = 0; i < count; i++)
+    {
+    MyMetrics.DeregisterMetric(metrics[i]);
+    free(names[i]);
+    }
+  free(names);
+  free(metrics);
+
+  writer->printf("Update:     %6lld us/s (incl. queueing)\n", t_update / seconds);
+  writer->printf("Queue:      %6lld us/s for %d metrics/s\n", t_drain / seconds, drained / seconds);
+  writer->printf("Full scan:  %6lld us/s for %d metrics/s\n", t_scan / seconds, scanned / seconds);
+  writer->printf("Queue high water mark %u, %u overflows\n", qhighwater, qoverflows);
+  }
+
 class TestFrameworkInit
   {
   public: TestFrameworkInit();
@@ -497,4 +668,9 @@ TestFrameworkInit::TestFrameworkInit()
     "mode: 1=m.AsJSON, 2=m.AsString, 3=m.name, 4=const cfg string, 5=const local cstr, 6=const local string", 2, 2);
   cmd_test->RegisterCommand("commands", "List command tree", test_command);
   cmd_test->RegisterCommand("filewriter", "Test file writer", test_filewriter, "<path>", 1, 1);
+  cmd_test->RegisterCommand("metrics", "Benchmark metrics registry", test_metrics, "[<count>] [<loops>]\n"
+    "Registers <count> (default 2000) temporary metrics and measures lookups (default 5 loops)", 0, 2);
+  cmd_test->RegisterCommand("metricmod", "Benchmark modified metrics processing", test_metricmod,
+    "[<count>] [<updates/s>] [<seconds>]\n"
+    "Compares modified queue & full scan consumer CPU time per second (defaults: 800 200 10)", 0, 3);
   }
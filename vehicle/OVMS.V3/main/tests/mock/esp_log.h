@@ -0,0 +1,13 @@
+// esp_log.h — Logging stubs for native laptop builds of the metrics journal.
+// Discarded: the simulation cuts the power on purpose.
+
+#pragma once
+
+#include <cstdint>
+
+typedef enum { ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG, ESP_LOG_VERBOSE } esp_log_level_t;
+
+#define LOG_FORMAT(letter, format) format
+
+inline uint32_t esp_log_timestamp() { return 0; }
+inline void esp_log_write(esp_log_level_t, const char*, const char*, ...) {}
@@ -0,0 +1,9 @@
+// FreeRTOS.h — Type stand-ins for native laptop builds (see host_runtime.cpp).
+
+#pragma once
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef void* QueueHandle_t;
+#define portMAX_DELAY 0xffffffffUL
@@ -0,0 +1,3 @@
+// queue.h — Empty stand-in for native laptop builds.
+
+#pragma once
@@ -0,0 +1,3 @@
+// semphr.h — Empty stand-in for native laptop builds.
+
+#pragma once
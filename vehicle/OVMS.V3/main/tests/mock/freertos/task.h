@@ -0,0 +1,3 @@
+// task.h — Empty stand-in for native laptop builds.
+
+#pragma once
@@ -0,0 +1,18 @@
+// host_runtime.cpp — OvmsMutex (std::mutex) & heap allocators for native laptop builds.
+
+#include "ovms_mutex.h"
+#include "ovms_malloc.h"
+
+#include <cstdlib>
+#include <mutex>
+
+OvmsMutex::OvmsMutex() { m_mutex = new std::mutex; }
+OvmsMutex::~OvmsMutex() { delete (std::mutex*)m_mutex; }
+bool OvmsMutex::Lock(TickType_t timeout) { (void)timeout; ((std::mutex*)m_mutex)->lock(); return true; }
+void OvmsMutex::Unlock() { ((std::mutex*)m_mutex)->unlock(); }
+
+OvmsMutexLock::OvmsMutexLock(OvmsMutex* mutex, TickType_t timeout)
+  : m_mutex(mutex), m_locked(mutex->Lock(timeout)) {}
+OvmsMutexLock::~OvmsMutexLock() { if (m_locked) m_mutex->Unlock(); }
+
+void* ExternalRamMalloc(size_t size) { return malloc(size); }
@@ -0,0 +1,349 @@
+// sim_pjournal.cpp — Native laptop simulation of the persistent metrics flash journal.
+//
+// Runs OvmsPersistJournal on a simulated NOR flash partition (writes can only
+// clear bits, 4 KB sector erase, per sector erase counters, SPI flash timing
+// model) with a metrics workload: scalar metrics of different change rates
+// plus a cell voltage vector, synced every 5 minutes as the metrics framework
+// does. Reports:
+//
+//   - write amplification: bytes programmed & erased per data byte changed
+//   - wear: erase counts per sector, projected lifetime at 100k cycles
+//   - cold boot restore time: Mount() of a filled partition (CPU time plus
+//     modelled flash read time)
+//   - power cuts: the partition is cut off at random points (record writes,
+//     sector reclaims, erases), remounted and checked. Every key must hold its
+//     last committed value, or the one being written at the cut.
+//
+// Run:  make sim   (from the tests/ directory)
+
+#include "ovms_pjournal.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Simulated flash partition
+// ---------------------------------------------------------------------------
+
+// SPI flash timing (ESP32, 40 MHz QIO, typical datasheet values):
+#define T_READ_CALL_US      2.0     // per read transaction
+#define T_READ_BYTE_US      0.05    // 20 MB/s
+#define T_PROGRAM_BYTE_US   2.5     // 0.6 ms per 256 byte page
+#define T_ERASE_US          45000.0 // 4 KB sector
+
+class SimFlash : public OvmsPersistFlash {
+public:
+    SimFlash(size_t size) : m_mem(size, 0xff), m_erasures(size / PJOURNAL_SECTOR_SIZE, 0) {}
+
+    size_t Size() override { return m_mem.size(); }
+
+    bool Read(size_t offset, void* data, size_t size) override {
+        if (offset + size > m_mem.size()) return false;
+        memcpy(data, &m_mem[offset], size);
+        m_time += T_READ_CALL_US + size * T_READ_BYTE_US;
+        return true;
+    }
+
+    bool Write(size_t offset, const void* data, size_t size) override {
+        if (m_dead || offset + size > m_mem.size()) return false;
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++) {
+            if (m_budget == 0) { m_dead = true; return false; }
+            if (m_budget > 0) m_budget--;
+            m_mem[offset + i] &= p[i];
+        }
+        m_programmed += size;
+        m_time += size * T_PROGRAM_BYTE_US;
+        return true;
+    }
+
+    bool Erase(size_t offset) override {
+        if (m_dead || offset % PJOURNAL_SECTOR_SIZE) return false;
+        if (m_budget >= 0 && m_budget < 64) {
+            // Cut during the erase: sector content undefined
+            for (size_t i = 0; i < PJOURNAL_SECTOR_SIZE; i++)
+                m_mem[offset + i] = ((int64_t)i < m_budget * 64) ? 0xff : (uint8_t)m_rng();
+            m_dead = true;
+            return false;
+        }
+        if (m_budget > 0) m_budget -= 64;
+        memset(&m_mem[offset], 0xff, PJOURNAL_SECTOR_SIZE);
+        m_erasures[offset / PJOURNAL_SECTOR_SIZE]++;
+        m_time += T_ERASE_US;
+        return true;
+    }
+
+    // Cut the power after budget byte writes (an erase counts 64), -1 = never
+    void Cut(int64_t budget) { m_budget = budget; m_dead = false; }
+    bool Dead() const { return m_dead; }
+
+    std::vector<uint8_t> m_mem;
+    std::vector<uint32_t> m_erasures;
+    uint64_t m_programmed = 0;
+    double m_time = 0;          // [us]
+    int64_t m_budget = -1;
+    bool m_dead = false;
+    std::mt19937 m_rng{ 99 };
+};
+
+// ---------------------------------------------------------------------------
+// Metrics workload
+// ---------------------------------------------------------------------------
+
+#define TYPE_SCALAR     1
+#define TYPE_ARRAY4     (0x80 | 4)
+
+struct Metric {
+    uint32_t key;
+    uint8_t type;
+    double change;              // change probability per sync
+    std::vector<uint32_t> value;
+};
+
+static uint32_t NameHash(const std::string& name) {
+    return (uint32_t)std::hash<std::string>{}(name);
+}
+
+static std::vector<Metric> Workload(int scalars) {
+    std::mt19937 rng(4711);
+    std::vector<Metric> metrics;
+    for (int i = 0; i < scalars; i++) {
+        Metric m;
+        m.key = NameHash("v.sim.metric." + std::to_string(i));
+        m.type = TYPE_SCALAR;
+        // Few counters & energy values change on most syncs, most metrics seldom:
+        m.change = (i % 10 == 0) ? 0.6 : (i % 4 == 0) ? 0.1 : 0.01;
+        m.value.assign(1, rng());
+        metrics.push_back(m);
+    }
+    Metric cells;
+    cells.key = NameHash("v.b.c.voltage.max");
+    cells.type = TYPE_ARRAY4;
+    cells.change = 0.3;
+    cells.value.assign(96, 0x40533333);
+    metrics.push_back(cells);
+    return metrics;
+}
+
+static uint64_t g_changed;      // data bytes of changed values
+
+static void Change(std::vector<Metric>& metrics, std::mt19937& rng) {
+    std::uniform_real_distribution<double> p(0, 1);
+    for (auto& m : metrics) {
+        if (p(rng) >= m.change) continue;
+        if (m.type == TYPE_SCALAR)
+            m.value[0] += 1 + rng() % 100;
+        else
+            m.value[rng() % m.value.size()] ^= 1 + rng() % 0xff;
+        g_changed += m.value.size() * 4;
+    }
+}
+
+// Expected journal content: last committed & in flight value per key
+struct Expect {
+    std::map<uint32_t, std::vector<uint32_t>> committed;
+    uint32_t inflight_key = 0;
+    std::vector<uint32_t> inflight;
+};
+
+static bool Sync(OvmsPersistJournal& j, const std::vector<Metric>& metrics, Expect* expect) {
+    for (const auto& m : metrics) {
+        if (expect) { expect->inflight_key = m.key; expect->inflight = m.value; }
+        if (!j.Write(m.key, m.type, m.value.data(), m.value.size() * 4))
+            return false;
+        if (expect) expect->committed[m.key] = m.value;
+    }
+    if (expect) expect->inflight_key = 0;
+    return true;
+}
+
+static int Verify(OvmsPersistJournal& j, const Expect& expect, const char* context) {
+    int failures = 0;
+    std::vector<uint32_t> buf(PJOURNAL_MAX_LENGTH / 4);
+    for (const auto& it : expect.committed) {
+        uint8_t type;
+        int len = j.Read(it.first, &type, buf.data(), buf.size() * 4);
+        std::vector<uint32_t> value;
+        if (len >= 0) value.assign(buf.begin(), buf.begin() + len / 4);
+        bool ok = (value == it.second)
+            || (it.first == expect.inflight_key && value == expect.inflight);
+        if (!ok && failures++ < 5)
+            printf("FAIL: %s: key %08x %s\n", context, it.first, len < 0 ? "lost" : "wrong value");
+    }
+    return failures;
+}
+
+// ---------------------------------------------------------------------------
+
+static int Endurance(size_t size, int scalars, int days) {
+    int failures = 0;
+    SimFlash flash(size);
+    OvmsPersistJournal j(&flash);
+    j.Mount();
+    std::vector<Metric> metrics = Workload(scalars);
+    std::mt19937 rng(1);
+    Expect expect;
+    g_changed = 0;
+    int syncs = days * 24 * 12;
+    for (int i = 0; i < syncs; i++) {
+        Change(metrics, rng);
+        if (!Sync(j, metrics, &expect)) {
+            failures++;
+            printf("FAIL: sync %d\n", i);
+            break;
+        }
+    }
+    pjournal_stats_t st;
+    j.GetStats(&st);
+
+    // Remount (cold boot):
+    OvmsPersistJournal j2(&flash);
+    j2.Mount();
+    failures += Verify(j2, expect, "endurance remount");
+
+    uint32_t emin = ~0u, emax = 0;
+    for (uint32_t e : flash.m_erasures) { if (e < emin) emin = e; if (e > emax) emax = e; }
+    double perday = (double)emax / days;
+    printf("%6zuK %8d %10.1f %10.1f %8.2f %8.2f %6u %6u %9.1f\n",
+           size / 1024, scalars + 1,
+           g_changed / 1024.0, flash.m_programmed / 1024.0,
+           (double)flash.m_programmed / g_changed,
+           (double)(flash.m_programmed + (uint64_t)st.erasures * PJOURNAL_SECTOR_SIZE) / g_changed,
+           emin, emax, perday > 0 ? 100000.0 / perday / 365 : 0.0);
+    if (emax > emin + 1) {
+        failures++;
+        printf("FAIL: uneven wear (%u..%u erasures)\n", emin, emax);
+    }
+    return failures;
+}
+
+static int ColdBoot(size_t size, int scalars) {
+    int failures = 0;
+    SimFlash flash(size);
+    Expect expect;
+    {
+        OvmsPersistJournal j(&flash);
+        j.Mount();
+        std::vector<Metric> metrics = Workload(scalars);
+        std::mt19937 rng(2);
+        // Churn until the partition has wrapped a few times:
+        while (flash.m_erasures[0] < 3) {
+            Change(metrics, rng);
+            if (!Sync(j, metrics, &expect)) { failures++; printf("FAIL: fill\n"); break; }
+        }
+    }
+    flash.m_time = 0;
+    const int runs = 20;
+    double cpu = 0;
+    pjournal_stats_t st;
+    for (int r = 0; r < runs; r++) {
+        OvmsPersistJournal j(&flash);
+        auto t0 = std::chrono::steady_clock::now();
+        if (!j.Mount()) failures++;
+        auto t1 = std::chrono::steady_clock::now();
+        cpu += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        j.GetStats(&st);
+        if (r == 0) failures += Verify(j, expect, "cold boot");
+    }
+    printf("%6zuK %8u %9u %12.0f %12.0f\n", size / 1024, st.records, st.livebytes,
+           cpu / runs, flash.m_time / runs);
+    return failures;
+}
+
+static int PowerCuts(int trials) {
+    int failures = 0, cuts = 0;
+    std::mt19937 rng(3);
+    for (int t = 0; t < trials && failures < 10; t++) {
+        SimFlash flash(8 * PJOURNAL_SECTOR_SIZE);
+        std::vector<Metric> metrics = Workload(60);
+        Expect expect;
+        std::mt19937 wrng(t);
+        OvmsPersistJournal* j = new OvmsPersistJournal(&flash);
+        j->Mount();
+        // Some history, then cut the power somewhere in the next syncs:
+        int history = 20 + rng() % 200;
+        for (int i = 0; i < history; i++) { Change(metrics, wrng); Sync(*j, metrics, &expect); }
+        flash.Cut(rng() % 40000);
+        for (int i = 0; i < 100 && !flash.Dead(); i++) { Change(metrics, wrng); Sync(*j, metrics, &expect); }
+        delete j;
+        if (flash.Dead()) cuts++;
+        flash.Cut(-1);
+
+        // Reboot, check, continue writing, reboot & check again:
+        j = new OvmsPersistJournal(&flash);
+        if (!j->Mount()) { failures++; printf("FAIL: trial %d mount\n", t); }
+        char context[48];
+        snprintf(context, sizeof(context), "trial %d after cut", t);
+        failures += Verify(*j, expect, context);
+        for (int i = 0; i < 50; i++) {
+            Change(metrics, wrng);
+            if (!Sync(*j, metrics, &expect)) { failures++; printf("FAIL: trial %d sync after cut\n", t); break; }
+        }
+        delete j;
+        j = new OvmsPersistJournal(&flash);
+        j->Mount();
+        snprintf(context, sizeof(context), "trial %d resumed", t);
+        failures += Verify(*j, expect, context);
+        delete j;
+    }
+    printf("%d trials, %d power cuts, %d failures\n", trials, cuts, failures);
+    return failures;
+}
+
+static int Full() {
+    // Area too small for the data: writes must fail cleanly, committed data survive.
+    int failures = 0;
+    SimFlash flash(3 * PJOURNAL_SECTOR_SIZE);
+    OvmsPersistJournal j(&flash);
+    j.Mount();
+    Expect expect;
+    uint32_t value[64] = { 0 };
+    int written = 0;
+    for (uint32_t k = 1; k < 1000; k++) {
+        value[0] = k;
+        if (!j.Write(k, TYPE_ARRAY4, value, sizeof(value))) break;
+        expect.committed[k].assign(value, value + 64);
+        written++;
+    }
+    // Overwriting existing keys must still work when full:
+    value[0] = 4711;
+    if (!j.Write(1, TYPE_ARRAY4, value, sizeof(value))) { failures++; printf("FAIL: update when full\n"); }
+    else expect.committed[1].assign(value, value + 64);
+    OvmsPersistJournal j2(&flash);
+    j2.Mount();
+    failures += Verify(j2, expect, "full");
+    printf("Full: %d records of %zu bytes fit into 3 sectors\n", written, sizeof(value));
+    if (written == 0 || written > 3 * PJOURNAL_SECTOR_SIZE / (int)sizeof(value)) failures++;
+    return failures;
+}
+
+int main() {
+    int failures = 0;
+
+    printf("Write amplification & wear (5 minute syncs for 30 days):\n");
+    printf("%7s %8s %10s %10s %8s %8s %6s %6s %9s\n", "area", "metrics", "changed K",
+           "written K", "W-amp", "E-amp", "e.min", "e.max", "years");
+    failures += Endurance(64 * 1024, 150, 30);
+    failures += Endurance(64 * 1024, 400, 30);
+    failures += Endurance(128 * 1024, 400, 30);
+
+    printf("\nCold boot restore (Mount):\n");
+    printf("%7s %8s %9s %12s %12s\n", "area", "records", "bytes", "cpu us", "flash us");
+    failures += ColdBoot(32 * 1024, 150);
+    failures += ColdBoot(64 * 1024, 400);
+    failures += ColdBoot(256 * 1024, 1500);
+
+    printf("\nPower cuts: ");
+    failures += PowerCuts(400);
+
+    printf("\n");
+    failures += Full();
+
+    printf("\n%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}